@@ -27,6 +27,7 @@
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/VecId.h>
 #include <sofa/core/behavior/MultiVec.h>
+#include <sofa/core/CollisionModel.h>
 
 #include <sofa/helper/ScopedAdvancedTimer.h>
 #include <sofa/simulation/UpdateInternalDataVisitor.h>
@@ -45,6 +46,9 @@
 #include <sofa/simulation/SolveVisitor.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 
+#include <algorithm>
+#include <set>
+
 #include <sofa/simulation/mechanicalvisitor/MechanicalVInitVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalVInitVisitor;
 
@@ -74,10 +78,12 @@ FreeMotionAnimationLoop::FreeMotionAnimationLoop() :
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
     , d_parallelCollisionDetectionAndFreeMotion(initData(&d_parallelCollisionDetectionAndFreeMotion, false, "parallelCollisionDetectionAndFreeMotion", "If true, executes free motion step and collision detection step in parallel."))
     , d_parallelODESolving(initData(&d_parallelODESolving, false, "parallelODESolving", "If true, solves all the ODEs in parallel during the free motion step."))
+    , d_pipelinedVisualUpdate(initData(&d_pipelinedVisualUpdate, false, "pipelinedVisualUpdate", "If true, the visual mappings of a time step are applied during the next time step, in parallel with its free motion, collision detection and constraint solving, from a snapshot of the mechanical states. The visual models are then one time step late. Not compatible with topological changes."))
     , l_constraintSolver(initLink("constraintSolver", "The ConstraintSolver used in this animation loop (required)"))
 {
     d_parallelCollisionDetectionAndFreeMotion.setGroup("Multithreading");
     d_parallelODESolving.setGroup("Multithreading");
+    d_pipelinedVisualUpdate.setGroup("Multithreading");
 
     m_solveVelocityConstraintFirst.setParent(&d_solveVelocityConstraintFirst);
 }
@@ -132,7 +138,7 @@ void FreeMotionAnimationLoop::init()
 
     auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
     assert(taskScheduler != nullptr);
-    if (d_parallelCollisionDetectionAndFreeMotion.getValue() || d_parallelODESolving.getValue())
+    if (d_parallelCollisionDetectionAndFreeMotion.getValue() || d_parallelODESolving.getValue() || d_pipelinedVisualUpdate.getValue())
     {
         if (taskScheduler->getThreadCount() < 1)
         {
@@ -148,6 +154,23 @@ void FreeMotionAnimationLoop::init()
     this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Valid);
 }
 
+void FreeMotionAnimationLoop::cleanup()
+{
+    waitPipelinedVisualUpdate();
+    m_pipelinedVisualMappings.clear();
+
+    if (!m_visualSnapshotPosition.isNull())
+    {
+        simulation::common::VectorOperations vop(core::execparams::defaultInstance(), this->getContext());
+        vop.v_free(m_visualSnapshotPosition, false, true);
+        vop.v_free(m_visualSnapshotVelocity, false, true);
+        m_visualSnapshotPosition = sofa::core::MultiVecCoordId();
+        m_visualSnapshotVelocity = sofa::core::MultiVecDerivId();
+    }
+
+    Inherit::cleanup();
+}
+
 
 void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal dt)
 {
@@ -163,6 +186,14 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
     simulation::common::VectorOperations vop(params, node);
     simulation::common::MechanicalOperations mop(params, getContext());
 
+    if (d_pipelinedVisualUpdate.getValue() && m_visualSnapshotPosition.isNull())
+    {
+        // Allocated before the computations of the first step, so that the temporary vectors of the solvers get
+        // the same ids in all the steps. They then exist in the states before the pipelined update starts.
+        vop.v_alloc(m_visualSnapshotPosition);
+        vop.v_alloc(m_visualSnapshotVelocity);
+    }
+
     MultiVecCoord pos(&vop, core::VecCoordId::position() );
     MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
     MultiVecCoord freePos(&vop, core::VecCoordId::freePosition() );
@@ -233,6 +264,10 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
     dmsg_info() << "updateInternal performed - beginVisitor called" ;
 
 
+    // The visual mappings of the previous time step run during the free motion, the collision detection and the
+    // constraint solving of this one. The events and the behavior updates, which may change the topologies, are done.
+    startPipelinedVisualUpdate(cparams, &vop);
+
     // MechanicalBeginIntegrationVisitor
     MechanicalBeginIntegrationVisitor beginVisitor(params, dt);
     node->execute(&beginVisitor);
@@ -278,6 +313,15 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
     MechanicalEndIntegrationVisitor endVisitor(params, dt);
     node->execute(&endVisitor);
 
+    if (m_pipelinedVisualUpdateStarted)
+    {
+        waitPipelinedVisualUpdate();
+
+        UpdateMappingEndEvent ev ( dt );
+        PropagateEventVisitor act ( params , &ev );
+        node->execute ( act );
+    }
+
     mop.projectPositionAndVelocity(pos, vel);
     mop.propagateXAndV(pos, vel);
     
@@ -291,6 +335,11 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
         node->execute ( act );
     }
 
+    if (d_pipelinedVisualUpdate.getValue())
+    {
+        snapshotVisualMappingInputs(params, &vop);
+    }
+    else
     {
         SCOPED_TIMER("UpdateMapping");
         //Visual Information update: Ray Pick add a MechanicalMapping used as VisualMapping
@@ -403,6 +452,150 @@ void FreeMotionAnimationLoop::computeFreeMotion(const sofa::core::ExecParams* pa
     }
 }
 
+void FreeMotionAnimationLoop::snapshotVisualMappingInputs(const sofa::core::ExecParams* params, simulation::common::VectorOperations* vop)
+{
+    SCOPED_TIMER("SnapshotVisualMappingInputs");
+
+    auto node = dynamic_cast<sofa::simulation::Node*>(this->l_node.get());
+    const auto mappings = node->getTreeObjects<sofa::core::BaseMapping>();
+
+    // The states read by the collision models, and the inputs of the mappings leading to them. The collision
+    // detection of the next step reads them: the mappings writing them cannot be delayed.
+    std::set<sofa::core::BaseState*> collisionStates;
+    for (const auto* collisionModel : node->getTreeObjects<sofa::core::CollisionModel>())
+    {
+        if (auto* state = collisionModel->getContext()->getState())
+        {
+            collisionStates.insert(state);
+        }
+    }
+    bool hasNewCollisionStates = !collisionStates.empty();
+    while (hasNewCollisionStates)
+    {
+        hasNewCollisionStates = false;
+        for (auto* mapping : mappings)
+        {
+            const auto to = mapping->getTo();
+            if (std::any_of(to.begin(), to.end(), [&collisionStates](auto* state) { return collisionStates.count(state) > 0; }))
+            {
+                for (auto* from : mapping->getFrom())
+                {
+                    hasNewCollisionStates = collisionStates.insert(from).second || hasNewCollisionStates;
+                }
+            }
+        }
+    }
+
+    const auto isPipelined = [&collisionStates](sofa::core::BaseMapping* mapping)
+    {
+        const auto to = mapping->getTo();
+        return !mapping->isMechanical()
+            && std::none_of(to.begin(), to.end(), [&collisionStates](auto* state) { return collisionStates.count(state) > 0; });
+    };
+
+    // the other visual mappings are applied now, as UpdateMappingVisitor does
+    for (auto* mapping : mappings)
+    {
+        if (!mapping->isMechanical() && !isPipelined(mapping))
+        {
+            mapping->apply(core::mechanicalparams::defaultInstance(), core::VecCoordId::position(), core::ConstVecCoordId::position());
+            mapping->applyJ(core::mechanicalparams::defaultInstance(), core::VecDerivId::velocity(), core::ConstVecDerivId::velocity());
+        }
+    }
+
+    // the snapshot vectors are reallocated in all the states, including the mapped ones and the ones
+    // created since the previous time step
+    MultiVecCoord snapshotPosition(vop, m_visualSnapshotPosition);
+    snapshotPosition.realloc(vop, !d_threadSafeVisitor.getValue(), true);
+    MultiVecDeriv snapshotVelocity(vop, m_visualSnapshotVelocity);
+    snapshotVelocity.realloc(vop, !d_threadSafeVisitor.getValue(), true);
+
+    {
+        MechanicalVOpVisitor copyPosition(params, m_visualSnapshotPosition, core::ConstVecCoordId::position());
+        copyPosition.setMapped(true);
+        node->executeVisitor(&copyPosition);
+
+        MechanicalVOpVisitor copyVelocity(params, m_visualSnapshotVelocity, core::ConstVecDerivId::velocity());
+        copyVelocity.setMapped(true);
+        node->executeVisitor(&copyVelocity);
+    }
+
+    // the delayed mappings, in the order of UpdateMappingVisitor. Their mechanical inputs are read from the
+    // snapshot, the other ones (a visual model mapped on another one) from the output of the previous mappings.
+    m_pipelinedVisualMappings.clear();
+    for (auto* mapping : mappings)
+    {
+        if (!isPipelined(mapping))
+        {
+            continue;
+        }
+
+        PipelinedVisualMapping pipelinedMapping { mapping, core::ConstVecCoordId::position(), core::ConstVecDerivId::velocity() };
+        for (auto* from : mapping->getFrom())
+        {
+            if (dynamic_cast<sofa::core::behavior::BaseMechanicalState*>(from))
+            {
+                pipelinedMapping.inPosition.setId(from, m_visualSnapshotPosition.getDefaultId());
+                pipelinedMapping.inVelocity.setId(from, m_visualSnapshotVelocity.getDefaultId());
+            }
+        }
+        m_pipelinedVisualMappings.push_back(pipelinedMapping);
+    }
+}
+
+void FreeMotionAnimationLoop::startPipelinedVisualUpdate(const core::ConstraintParams& cparams, simulation::common::VectorOperations* vop)
+{
+    if (m_pipelinedVisualMappings.empty())
+    {
+        return;
+    }
+
+    // Allocating a vector can resize the table of vectors of a state, which the task reads: all the vectors used
+    // by the step must exist before it starts. The free motion vectors, dx and dforce are allocated at the
+    // beginning of the step, the temporary vectors of the solvers during the previous steps, with the same ids.
+    {
+        MultiVecDeriv lambda(vop, cparams.lambda());
+        lambda.realloc(vop, !d_threadSafeVisitor.getValue(), true);
+        MultiVecDeriv constraintDx(vop, cparams.dx());
+        constraintDx.realloc(vop, !d_threadSafeVisitor.getValue(), true);
+    }
+
+    auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler != nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    m_pipelinedVisualUpdateStarted = true;
+    taskScheduler->addTask(m_pipelinedVisualUpdateStatus, [this]()
+    {
+        SCOPED_TIMER("PipelinedUpdateMapping");
+        for (const auto& pipelinedMapping : m_pipelinedVisualMappings)
+        {
+            pipelinedMapping.mapping->apply(core::mechanicalparams::defaultInstance(), core::VecCoordId::position(), pipelinedMapping.inPosition);
+            pipelinedMapping.mapping->applyJ(core::mechanicalparams::defaultInstance(), core::VecDerivId::velocity(), pipelinedMapping.inVelocity);
+        }
+    });
+}
+
+void FreeMotionAnimationLoop::waitPipelinedVisualUpdate()
+{
+    if (!m_pipelinedVisualUpdateStarted)
+    {
+        return;
+    }
+
+    SCOPED_TIMER("WaitPipelinedUpdateMapping");
+
+    auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler != nullptr);
+    taskScheduler->workUntilDone(&m_pipelinedVisualUpdateStatus);
+
+    m_pipelinedVisualMappings.clear();
+    m_pipelinedVisualUpdateStarted = false;
+}
+
 int FreeMotionAnimationLoopClass = core::RegisterObject(R"(
 The animation loop to use with constraints.
 You must add this loop at the beginning of the scene if you are using constraints.")")
@@ -23,16 +23,34 @@
 #include <sofa/component/animationloop/config.h>
 
 #include <sofa/simulation/CollisionAnimationLoop.h>
+#include <sofa/simulation/CpuTaskStatus.h>
 #include <sofa/core/MultiVecId.h>
+#include <sofa/core/BaseMapping.h>
 
 namespace sofa::core::behavior
 {
     class ConstraintSolver;
 }
 
+namespace sofa::simulation::common
+{
+    class VectorOperations;
+}
+
 namespace sofa::component::animationloop
 {
 
+/**
+ * The animation loop to use with constraints: the free motion of the objects is computed, then the constraints
+ * are solved and the corrections are applied.
+ *
+ * With pipelinedVisualUpdate, the visual mappings of a time step are not applied at the end of this step, but
+ * during the next one, in parallel with its free motion, collision detection and constraint solving. They read
+ * a snapshot of the positions and velocities of the mechanical states taken at the end of the step, so that
+ * they are not affected by the computations of the next step. The visual models are then one time step late,
+ * and must not be modified by topological changes during the steps. The visual mappings whose outputs are read,
+ * directly or through other mappings, by a collision model are still applied at the end of the step.
+ */
 class SOFA_COMPONENT_ANIMATIONLOOP_API FreeMotionAnimationLoop : public sofa::simulation::CollisionAnimationLoop
 {
 public:
@@ -41,6 +59,7 @@ public:
 public:
     void step (const sofa::core::ExecParams* params, SReal dt) override;
     void init() override;
+    void cleanup() override;
 
 
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA()
@@ -50,6 +69,7 @@ public:
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
     Data<bool> d_parallelCollisionDetectionAndFreeMotion; ///<If true, executes free motion and collision detection in parallel
     Data<bool> d_parallelODESolving; ///<If true, executes all free motions in parallel
+    Data<bool> d_pipelinedVisualUpdate; ///< If true, the visual mappings of a time step are applied during the next time step, in parallel
 
 protected:
     FreeMotionAnimationLoop();
@@ -69,6 +89,29 @@ protected:
                                          sofa::core::MultiVecId freePos,
                                          sofa::core::MultiVecDerivId freeVel,
                                          simulation::common::MechanicalOperations* mop);
+
+    /// Applies the visual mappings read by collision models, copies the positions and velocities read by the other
+    /// visual mappings, and prepares their update
+    void snapshotVisualMappingInputs(const sofa::core::ExecParams* params, simulation::common::VectorOperations* vop);
+
+    /// Starts the update of the visual mappings prepared at the previous time step, in a separate task
+    void startPipelinedVisualUpdate(const core::ConstraintParams& cparams, simulation::common::VectorOperations* vop);
+
+    /// Waits for the end of the update of the visual mappings, if any
+    void waitPipelinedVisualUpdate();
+
+    struct PipelinedVisualMapping
+    {
+        sofa::core::BaseMapping::SPtr mapping;
+        sofa::core::ConstMultiVecCoordId inPosition;
+        sofa::core::ConstMultiVecDerivId inVelocity;
+    };
+
+    sofa::core::MultiVecCoordId m_visualSnapshotPosition;
+    sofa::core::MultiVecDerivId m_visualSnapshotVelocity;
+    sofa::type::vector<PipelinedVisualMapping> m_pipelinedVisualMappings;
+    sofa::simulation::CpuTaskStatus m_pipelinedVisualUpdateStatus;
+    bool m_pipelinedVisualUpdateStarted { false };
 };
 
 } // namespace sofa::component::animationloop
@@ -0,0 +1,153 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/animationloop/FreeMotionAnimationLoop.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/Node.h>
+
+namespace sofa
+{
+
+using component::animationloop::FreeMotionAnimationLoop;
+using MechanicalObject3 = component::statecontainer::MechanicalObject<defaulttype::Vec3Types>;
+
+/// Free fall of particles mapped on visual particles, with or without the pipelined visual update
+struct FreeMotionAnimationLoop_test : public BaseSimulationTest
+{
+    SceneInstance m_si{};
+    MechanicalObject3* m_dofs { nullptr };
+    MechanicalObject3* m_visualDofs { nullptr };
+
+    void createScene(bool pipelinedVisualUpdate)
+    {
+        sofa::simpleapi::importPlugin("Sofa.Component.AnimationLoop");
+        sofa::simpleapi::importPlugin("Sofa.Component.Constraint.Lagrangian.Solver");
+        sofa::simpleapi::importPlugin("Sofa.Component.ODESolver.Backward");
+        sofa::simpleapi::importPlugin("Sofa.Component.LinearSolver.Iterative");
+        sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+        sofa::simpleapi::importPlugin("Sofa.Component.Mass");
+        sofa::simpleapi::importPlugin("Sofa.Component.Mapping.Linear");
+
+        m_si.root->setGravity({ 0, -10, 0 });
+        simpleapi::createObject(m_si.root, "FreeMotionAnimationLoop", {
+            { "pipelinedVisualUpdate", pipelinedVisualUpdate ? "true" : "false"}
+        });
+        simpleapi::createObject(m_si.root, "GenericConstraintSolver", {});
+
+        const auto node = simpleapi::createChild(m_si.root, "Particles");
+        simpleapi::createObject(node, "EulerImplicitSolver", {});
+        simpleapi::createObject(node, "CGLinearSolver", { { "iterations", "25"}, { "tolerance", "1e-10"}, { "threshold", "1e-10"} });
+        simpleapi::createObject(node, "MechanicalObject", {
+            { "name", "dofs"},
+            { "template", "Vec3"},
+            { "position", "0 0 0  1 0 0  2 0 0"}
+        });
+        simpleapi::createObject(node, "UniformMass", { { "totalMass", "3"} });
+
+        const auto visual = simpleapi::createChild(node, "Visual");
+        simpleapi::createObject(visual, "MechanicalObject", { { "name", "visualDofs"}, { "template", "Vec3"} });
+        simpleapi::createObject(visual, "IdentityMapping", { { "isMechanical", "false"} });
+
+        m_si.initScene();
+
+        m_dofs = dynamic_cast<MechanicalObject3*>(node->getMechanicalState());
+        m_visualDofs = dynamic_cast<MechanicalObject3*>(visual->getMechanicalState());
+        ASSERT_NE(m_dofs, nullptr);
+        ASSERT_NE(m_visualDofs, nullptr);
+    }
+
+    static type::vector<type::Vec3> positions(const MechanicalObject3* dofs)
+    {
+        return dofs->read(core::ConstVecCoordId::position())->getValue();
+    }
+
+    /// Positions of the visual particles after each step
+    type::vector<type::vector<type::Vec3>> simulate(bool pipelinedVisualUpdate, unsigned int nbSteps)
+    {
+        createScene(pipelinedVisualUpdate);
+
+        type::vector<type::vector<type::Vec3>> visualPositions;
+        type::vector<type::Vec3> previousPositions = positions(m_dofs);
+        for (unsigned int i = 0; i < nbSteps; ++i)
+        {
+            m_si.simulate(0.01);
+
+            // the visual particles are one step late with the pipelined update
+            const auto expected = pipelinedVisualUpdate ? previousPositions : positions(m_dofs);
+            const auto visual = positions(m_visualDofs);
+            EXPECT_EQ(visual.size(), expected.size());
+            for (std::size_t j = 0; j < std::min(visual.size(), expected.size()); ++j)
+            {
+                EXPECT_NEAR((visual[j] - expected[j]).norm(), 0, 1e-12) << "step " << i << ", particle " << j;
+            }
+
+            previousPositions = positions(m_dofs);
+            visualPositions.push_back(visual);
+        }
+        return visualPositions;
+    }
+};
+
+TEST_F(FreeMotionAnimationLoop_test, visualUpdate)
+{
+    const auto visualPositions = simulate(false, 5);
+    ASSERT_EQ(visualPositions.size(), 5);
+    EXPECT_LT(visualPositions.back()[0][1], 0);
+}
+
+TEST_F(FreeMotionAnimationLoop_test, pipelinedVisualUpdate)
+{
+    const auto visualPositions = simulate(true, 5);
+    ASSERT_EQ(visualPositions.size(), 5);
+    EXPECT_LT(visualPositions.back()[0][1], 0);
+
+    // the cleanup joins the pipelined update, and can be called again when the scene is unloaded
+    auto* loop = m_si.root->get<FreeMotionAnimationLoop>();
+    ASSERT_NE(loop, nullptr);
+    loop->cleanup();
+    simulation::node::unload(m_si.root);
+    m_si.root.reset();
+}
+
+/// The visual particles of the pipelined scene follow the ones of the default scene with a one step lag
+TEST_F(FreeMotionAnimationLoop_test, pipelinedVisualUpdateLag)
+{
+    const auto visualPositions = simulate(false, 5);
+    simulation::node::unload(m_si.root);
+    m_si.root = simulation::getSimulation()->createNewGraph("root");
+
+    const auto pipelinedVisualPositions = simulate(true, 5);
+    ASSERT_EQ(visualPositions.size(), pipelinedVisualPositions.size());
+    for (std::size_t i = 1; i < visualPositions.size(); ++i)
+    {
+        ASSERT_EQ(pipelinedVisualPositions[i].size(), visualPositions[i - 1].size());
+        for (std::size_t j = 0; j < visualPositions[i - 1].size(); ++j)
+        {
+            EXPECT_NEAR((pipelinedVisualPositions[i][j] - visualPositions[i - 1][j]).norm(), 0, 1e-12) << "step " << i;
+        }
+    }
+}
+
+} // namespace sofa
@@ -26,10 +26,13 @@
 #include <sofa/core/objectmodel/DataFileName.h>
 
 #include <sofa/linearalgebra/FullMatrix.h>
+#include <sofa/linearalgebra/PrecomputedMatrixFile.h>
 
 #include <sofa/type/Mat.h>
 #include <sofa/type/Vec.h>
 
+#include <memory>
+
 namespace sofa::component::constraint::lagrangian::correction
 {
 
@@ -65,6 +68,11 @@ public:
 	Data<SReal> debugViewFrameScale; ///< Scale on computed node's frame
 	sofa::core::objectmodel::DataFileName f_fileCompliance; ///< Precomputed compliance matrix data file
 	Data<std::string> fileDir; ///< If not empty, the compliance will be saved in this repertory
+
+    Data<bool> d_memoryMapped; ///< Save the compliance in a file which is memory-mapped instead of being loaded in memory
+    Data<bool> d_singlePrecision; ///< Store the memory-mapped compliance in single precision
+    Data<unsigned int> d_compressionBlockSize; ///< Size of the blocks of the low-rank compression of the memory-mapped compliance (0 for no compression)
+    Data<SReal> d_compressionTolerance; ///< Relative tolerance of the low-rank compression of the memory-mapped compliance
     
 protected:
     PrecomputedConstraintCorrection(sofa::core::behavior::MechanicalState<DataTypes> *mm = nullptr);
@@ -121,12 +129,15 @@ public:
     {
         Real* data;
         int nbref;
+        /// memory-mapped compliance, shared by all the instances using the same file (data is then nullptr)
+        std::unique_ptr<linearalgebra::PrecomputedMatrixFile> file;
         InverseStorage() : data(nullptr), nbref(0) {}
     };
 
     std::string invName;
     InverseStorage* invM;
-    Real* appCompliance;
+    /// compliance values, row by row, or nullptr if they are only available through invM->file
+    const Real* appCompliance;
     unsigned int dimensionAppCompliance;
 
     static std::map<std::string, InverseStorage>& getInverseMap()
@@ -162,11 +173,19 @@ public:
     {
         if (invM->data)
             return invM->data;
+        else if (invM->file)
+            msg_error() << "Inverse is memory-mapped, use compliance() to access it";
         else
             msg_error() << "Inverse is not computed yet";
         return nullptr;
     }
 
+    /// Value of the compliance at the given index (row * nbCols + column), whatever its storage
+    Real compliance(std::size_t index) const
+    {
+        return appCompliance ? appCompliance[index] : Real(invM->file->element(index / nbCols, index % nbCols));
+    }
+
 protected:
     /**
      * @brief Load compliance matrix from memory or external file according to fileName.
@@ -180,6 +199,13 @@ protected:
      */
     void saveCompliance(const std::string& fileName);
 
+    /**
+     * @brief Map the compliance file at the given path if it has been saved in the memory-mapped format.
+     *
+     * @return true if the file is memory-mapped.
+     */
+    bool mapCompliance(const std::string& path);
+
     /**
      * @brief Builds the compliance file name using the SOFA component internal data.
      */
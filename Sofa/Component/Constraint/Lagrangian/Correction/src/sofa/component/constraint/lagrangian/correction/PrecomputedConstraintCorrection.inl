@@ -59,6 +59,10 @@ PrecomputedConstraintCorrection<DataTypes>::PrecomputedConstraintCorrection(sofa
     , debugViewFrameScale(initData(&debugViewFrameScale, 1.0_sreal, "debugViewFrameScale", "Scale on computed node's frame"))
     , f_fileCompliance(initData(&f_fileCompliance, "fileCompliance", "Precomputed compliance matrix data file"))
     , fileDir(initData(&fileDir, "fileDir", "If not empty, the compliance will be saved in this repertory"))
+    , d_memoryMapped(initData(&d_memoryMapped, false, "memoryMapped", "Save the compliance in a file which is memory-mapped instead of being loaded in memory: its pages are read on demand and shared between all the instances and processes using it"))
+    , d_singlePrecision(initData(&d_singlePrecision, false, "singlePrecision", "Store the memory-mapped compliance in single precision"))
+    , d_compressionBlockSize(initData(&d_compressionBlockSize, 0u, "compressionBlockSize", "Size of the blocks of the memory-mapped compliance replaced by a low-rank approximation, for the blocks not on the diagonal (0 for no compression)"))
+    , d_compressionTolerance(initData(&d_compressionTolerance, 1e-6_sreal, "compressionTolerance", "Singular values of the compressed blocks below this tolerance, relatively to the largest value of the compliance, are dropped"))
     , invM(nullptr)
     , appCompliance(nullptr)
     , nbRows(0), nbCols(0), dof_on_node(0), nbNodes(0)
@@ -110,7 +114,7 @@ std::string PrecomputedConstraintCorrection<DataTypes>::buildFileName()
     const std::string name = this->getContext()->getName();
 
     std::stringstream ss;
-    ss << name << "-" << nbRows << "-" << dt <<".comp";
+    ss << name << "-" << nbRows << "-" << dt << (d_memoryMapped.getValue() ? ".mcomp" : ".comp");
 
     return ss.str();
 }
@@ -126,7 +130,7 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
     invM = getInverse(fileName);
     dimensionAppCompliance = nbRows;
 
-    if (invM->data == nullptr)
+    if (invM->data == nullptr && invM->file == nullptr)
     {
         // Try to load from file
         msg_info() << "Try to load compliance from : " << fileName ;
@@ -135,6 +139,11 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
         if (!dir.empty())
         {
             const std::string path = helper::system::FileSystem::append(dir, fileName);
+
+            // a precomputed matrix file which cannot be mapped is recomputed, not read as raw values
+            if (linearalgebra::PrecomputedMatrixFile::hasFileTag(path))
+                return mapCompliance(path);
+
             std::ifstream compFileIn(path, std::ifstream::binary);
             if (compFileIn.is_open())
             {
@@ -155,6 +164,9 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
             std::stringstream ss;
             if (sofa::helper::system::DataRepository.findFile(fileName, "", &ss))
             {
+                if (linearalgebra::PrecomputedMatrixFile::hasFileTag(fileName))
+                    return mapCompliance(fileName);
+
                 invM->data = new Real[nbRows * nbCols];
 
                 std::ifstream compFileIn(fileName.c_str(), std::ifstream::binary);
@@ -201,12 +213,50 @@ void PrecomputedConstraintCorrection<DataTypes>::saveCompliance(const std::strin
     msg_info() << "Compliance file has been saved in " << filePathInSofaShare << ". Load this file using fileCompliance if you don't want to recompute the compliance matrice at next start.";
     this->f_printLog.setValue(printLog);
 
+    if (d_memoryMapped.getValue())
+    {
+        linearalgebra::PrecomputedMatrixFile::Options options;
+        options.singlePrecision = d_singlePrecision.getValue();
+        options.blockSize = d_compressionBlockSize.getValue();
+        options.tolerance = d_compressionTolerance.getValue();
+
+        // the instance which computed the compliance uses the mapped file as well, so that it shares its pages
+        if (linearalgebra::PrecomputedMatrixFile::write(filePathInSofaShare, invM->data, nbRows, nbCols, options)
+            && mapCompliance(filePathInSofaShare))
+        {
+            delete[] invM->data;
+            invM->data = nullptr;
+        }
+        return;
+    }
+
     std::ofstream compFileOut(filePathInSofaShare.c_str(), std::fstream::out | std::fstream::binary);
     compFileOut.write((char*)invM->data, nbCols * nbRows * sizeof(Real));
     compFileOut.close();
 }
 
 
+template<class DataTypes>
+bool PrecomputedConstraintCorrection<DataTypes>::mapCompliance(const std::string& path)
+{
+    auto file = std::make_unique<linearalgebra::PrecomputedMatrixFile>();
+    if (!file->open(path))
+        return false;
+
+    if (file->rowSize() != nbRows || file->colSize() != nbCols)
+    {
+        msg_error() << "The compliance of " << path << " has a size of " << file->rowSize() << "x" << file->colSize()
+                    << " instead of " << nbRows << "x" << nbCols;
+        return false;
+    }
+
+    msg_info() << "File " << path << " memory-mapped (" << file->storageSize() << " bytes"
+               << (file->isSinglePrecision() ? ", single precision" : "") << (file->isCompressed() ? ", compressed" : "") << ")";
+    invM->file = std::move(file);
+    return true;
+}
+
+
 
 template<class DataTypes>
 void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
@@ -402,7 +452,8 @@ void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
             pos[i] = prev_pos[i];
     }
 
-    appCompliance = invM->data;
+    // values read in place when the storage allows it, through compliance() otherwise
+    appCompliance = invM->data ? invM->data : (invM->file ? invM->file->template data<Real>() : nullptr);
 
     // Optimisation for the computation of W
     _indexNodeSparseCompliance.resize(v0.size());
@@ -506,7 +557,7 @@ void PrecomputedConstraintCorrection< DataTypes >::addComplianceInConstraintSpac
 
                     for (jj = 0; jj < dof_on_node; jj++)
                     {
-                        Vbuf[ii] += appCompliance[offset2 + jj] * n2[jj];
+                        Vbuf[ii] += compliance(offset2 + jj) * n2[jj];
                     }
                 }
             }
@@ -586,7 +637,7 @@ void PrecomputedConstraintCorrection<DataTypes>::computeDx(Data<VecDeriv>& dx_d
 
                 for (i = 0; i < dof_on_node; i++)
                 {
-                    DXbuf += appCompliance[ offset2 + i ] * Fbuf[i];
+                    DXbuf += compliance(offset2 + i) * Fbuf[i];
                 }
 
                 dx[v][j] += DXbuf;
@@ -748,7 +799,7 @@ void PrecomputedConstraintCorrection<DataTypes>::applyContactForce(const lineara
                 DXbuf=0.0;
                 for (unsigned int k = 0; k < dof_on_node; k++)
                 {
-                    DXbuf += appCompliance[ offset2 + k ] * Fbuf[k];
+                    DXbuf += compliance(offset2 + k) * Fbuf[k];
                 }
                 dx[i][j]+=DXbuf;
             }
@@ -781,7 +832,7 @@ void PrecomputedConstraintCorrection<DataTypes>::getComplianceMatrix(linearalgeb
     {
         for (unsigned int c = 0; c < dimensionAppCompliance; ++c)
         {
-            m->set(l, c, appCompliance[l * dimensionAppCompliance + c]);
+            m->set(l, c, compliance(l * dimensionAppCompliance + c));
         }
     }
 }
@@ -1066,7 +1117,7 @@ void PrecomputedConstraintCorrection<DataTypes>::resetForUnbuiltResolution(SReal
 
                     for (unsigned int jj = 0; jj < dof_on_node; jj++)
                     {
-                        Vbuf[ii] += appCompliance[offset2 + jj] * colIt.val()[jj];
+                        Vbuf[ii] += compliance(offset2 + jj) * colIt.val()[jj];
                     }
                 }
             }
@@ -1220,7 +1271,7 @@ void PrecomputedConstraintCorrection<DataTypes>::setConstraintDForce(SReal * /*d
                         DXbuf = 0.0;
                         for (unsigned int k = 0; k < dof_on_node; k++)
                         {
-                            DXbuf += appCompliance[ offset2 + k ] * Fbuf[k];
+                            DXbuf += compliance(offset2 + k) * Fbuf[k];
                         }
 
                         constraint_D[dof2][j] += DXbuf;
@@ -1316,7 +1367,7 @@ void PrecomputedConstraintCorrection<DataTypes>::getBlockDiagonalCompliance(line
 
                         for (unsigned int jj = 0; jj < dof_on_node; jj++)
                         {
-                            Vbuf[ii] += appCompliance[offset2 + jj] * n2[jj];
+                            Vbuf[ii] += compliance(offset2 + jj) * n2[jj];
                         }
                     }
                 }
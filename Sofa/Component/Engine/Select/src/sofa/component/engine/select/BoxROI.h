@@ -28,6 +28,7 @@
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/defaulttype/RigidTypes.h>
+#include <algorithm>
 
 namespace sofa::component::engine::select::boxroi
 {
@@ -161,10 +162,39 @@ protected:
         Vec3 normal;
         Vec3 plane0, plane1, plane2, plane3;
         double width, length, depth;
+        Vec3 minBounds, maxBounds; ///< bounds of the eight corners
     };
 
     vector<OrientedBox> m_orientedBoxes;
 
+    /// Bounding volume hierarchy over the input positions, with a single level of leaves: the
+    /// bounds of ranges of consecutive points. The points of a mesh are numbered with spatial
+    /// coherence, so these ranges are compact. The hierarchy is refitted in one pass over the
+    /// positions at each update, then only the points of the leaves overlapping a box are tested
+    /// against it, and the leaves inside an aligned box are selected without any test.
+    struct PointBVH
+    {
+        static constexpr sofa::Size dimensions = std::min<sofa::Size>(DataTypes::spatial_dimensions, 3);
+        static constexpr unsigned int leafSize = 64;
+
+        vector<std::pair<CPos, CPos> > leafBounds;
+
+        void refit(const VecCoord& x);
+    };
+    PointBVH m_pointBVH;
+
+    /// Bounds of each box: the aligned boxes, then the oriented boxes
+    vector<std::pair<CPos, CPos> > m_boxesBounds;
+
+    /// Selection of the points computed at the last update, reused by the strict element tests
+    vector<char> m_isPointInBoxes;
+
+    void computeBoxesBounds();
+    void updatePointsSelection(const VecCoord& x0);
+    template<class Element>
+    void updateElementsSelection(const VecCoord& x0, const vector<Element>& elements, bool strict,
+                                 SetIndex& elementIndices, vector<Element>& elementsInROI);
+
     BoxROI();
     ~BoxROI() override {}
 
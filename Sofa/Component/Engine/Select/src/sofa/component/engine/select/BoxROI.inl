@@ -24,6 +24,7 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/type/BoundingBox.h>
 #include <limits>
+#include <algorithm>
 #include <sofa/core/topology/BaseTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
 #include <sofa/helper/accessor.h>
@@ -364,6 +365,22 @@ void BoxROI<DataTypes>::computeOrientedBoxes()
         m_orientedBoxes[i].width = fabs(dot((p2-p0),plane0));
         m_orientedBoxes[i].length = fabs(dot((p2-p0),plane2));
         m_orientedBoxes[i].depth = depth;
+
+        vector<type::Vec3> corners;
+        getPointsFromOrientedBox(box, corners);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            m_orientedBoxes[i].minBounds[j] = std::numeric_limits<Real>::max();
+            m_orientedBoxes[i].maxBounds[j] = std::numeric_limits<Real>::lowest();
+        }
+        for (const auto& corner : corners)
+        {
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                m_orientedBoxes[i].minBounds[j] = std::min(m_orientedBoxes[i].minBounds[j], static_cast<Real>(corner[j]));
+                m_orientedBoxes[i].maxBounds[j] = std::max(m_orientedBoxes[i].maxBounds[j], static_cast<Real>(corner[j]));
+            }
+        }
     }
 }
 
@@ -567,6 +584,169 @@ bool BoxROI<DataTypes>::isQuadInBoxesStrict(const Quad& q)
     return (isPointInBoxes(p0) && isPointInBoxes(p1) && isPointInBoxes(p2) && isPointInBoxes(p3));
 }
 
+template <class DataTypes>
+void BoxROI<DataTypes>::PointBVH::refit(const VecCoord& x)
+{
+    const std::size_t nbPoints = x.size();
+    leafBounds.resize((nbPoints + leafSize - 1) / leafSize);
+
+    for (std::size_t leaf = 0; leaf < leafBounds.size(); ++leaf)
+    {
+        const std::size_t begin = leaf * leafSize;
+        const std::size_t end = std::min(begin + leafSize, nbPoints);
+
+        auto& [minBounds, maxBounds] = leafBounds[leaf];
+        minBounds = DataTypes::getCPos(x[begin]);
+        maxBounds = minBounds;
+        for (std::size_t i = begin + 1; i < end; ++i)
+        {
+            const CPos& p = DataTypes::getCPos(x[i]);
+            for (unsigned int d = 0; d < dimensions; ++d)
+            {
+                minBounds[d] = std::min(minBounds[d], p[d]);
+                maxBounds[d] = std::max(maxBounds[d], p[d]);
+            }
+        }
+    }
+}
+
+template <class DataTypes>
+void BoxROI<DataTypes>::computeBoxesBounds()
+{
+    constexpr sofa::Size dimensions = PointBVH::dimensions;
+    const vector<type::Vec6>& alignedBoxes = d_alignedBoxes.getValue();
+
+    m_boxesBounds.clear();
+    for (const auto& box : alignedBoxes)
+    {
+        std::pair<CPos, CPos> bounds;
+        for (unsigned int d = 0; d < dimensions; ++d)
+        {
+            bounds.first[d] = static_cast<Real>(box[d]);
+            bounds.second[d] = static_cast<Real>(box[d + 3]);
+        }
+        m_boxesBounds.push_back(bounds);
+    }
+
+    if constexpr (DataTypes::spatial_dimensions == 3)
+    {
+        for (const auto& box : m_orientedBoxes)
+        {
+            std::pair<CPos, CPos> bounds;
+            for (unsigned int d = 0; d < dimensions; ++d)
+            {
+                // the box test is not done on the exact corners: its rounding errors are covered
+                const Real margin = std::max(static_cast<Real>(1), box.maxBounds[d] - box.minBounds[d]) * static_cast<Real>(1e-6);
+                bounds.first[d] = box.minBounds[d] - margin;
+                bounds.second[d] = box.maxBounds[d] + margin;
+            }
+            m_boxesBounds.push_back(bounds);
+        }
+    }
+}
+
+template <class DataTypes>
+void BoxROI<DataTypes>::updatePointsSelection(const VecCoord& x0)
+{
+    const vector<type::Vec6>& alignedBoxes = d_alignedBoxes.getValue();
+    m_isPointInBoxes.assign(x0.size(), 0);
+
+    // Refitting the hierarchy costs about one test against an aligned box per point, and an
+    // oriented box test about two: with fewer boxes, testing every point is faster.
+    constexpr std::size_t minBoxesCostForBVH = 5;
+    if (alignedBoxes.size() + 2 * m_orientedBoxes.size() < minBoxesCostForBVH)
+    {
+        for (unsigned int i = 0; i < x0.size(); ++i)
+            m_isPointInBoxes[i] = isPointInBoxes(DataTypes::getCPos(x0[i]));
+        return;
+    }
+
+    computeBoxesBounds();
+    m_pointBVH.refit(x0);
+
+    const auto selectCandidates = [this, &x0](const std::pair<CPos, CPos>& boxBounds, bool isAligned, const auto& isPointInBox)
+    {
+        constexpr sofa::Size dimensions = PointBVH::dimensions;
+        const auto& leafBounds = m_pointBVH.leafBounds;
+        for (std::size_t leaf = 0; leaf < leafBounds.size(); ++leaf)
+        {
+            const auto& [minBounds, maxBounds] = leafBounds[leaf];
+
+            bool isOverlapping = true;
+            bool isInside = isAligned && DataTypes::spatial_dimensions <= 3;
+            for (unsigned int d = 0; d < dimensions; ++d)
+            {
+                isOverlapping = isOverlapping && maxBounds[d] >= boxBounds.first[d] && minBounds[d] <= boxBounds.second[d];
+                isInside = isInside && minBounds[d] >= boxBounds.first[d] && maxBounds[d] <= boxBounds.second[d];
+            }
+            if (!isOverlapping)
+                continue;
+
+            const std::size_t begin = leaf * PointBVH::leafSize;
+            const std::size_t end = std::min(begin + PointBVH::leafSize, x0.size());
+            if (isInside)
+            {
+                std::fill(m_isPointInBoxes.begin() + begin, m_isPointInBoxes.begin() + end, 1);
+                continue;
+            }
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                if (!m_isPointInBoxes[i] && isPointInBox(DataTypes::getCPos(x0[i])))
+                    m_isPointInBoxes[i] = 1;
+            }
+        }
+    };
+
+    for (unsigned int i = 0; i < alignedBoxes.size(); ++i)
+    {
+        const type::Vec6& box = alignedBoxes[i];
+        selectCandidates(m_boxesBounds[i], true, [&box](const CPos& p) { return isPointInAlignedBox(p, box); });
+    }
+
+    if constexpr (DataTypes::spatial_dimensions == 3)
+    {
+        for (unsigned int i = 0; i < m_orientedBoxes.size(); ++i)
+        {
+            const OrientedBox& box = m_orientedBoxes[i];
+            selectCandidates(m_boxesBounds[alignedBoxes.size() + i], false, [this, &box](const CPos& p) { return isPointInOrientedBox(p, box); });
+        }
+    }
+}
+
+template <class DataTypes>
+template <class Element>
+void BoxROI<DataTypes>::updateElementsSelection(const VecCoord& x0, const vector<Element>& elements, bool strict,
+                                                SetIndex& elementIndices, vector<Element>& elementsInROI)
+{
+    for (unsigned int i = 0; i < elements.size(); ++i)
+    {
+        const Element& element = elements[i];
+        bool isElementInBoxes;
+        if (strict)
+        {
+            // an element is inside if all its nodes are: the selection of the points is reused
+            isElementInBoxes = std::all_of(element.begin(), element.end(),
+                [this](const auto pid) { return m_isPointInBoxes[pid] != 0; });
+        }
+        else
+        {
+            // same summation order as the former per-element tests, for identical results
+            CPos center = DataTypes::getCPos(x0[element[element.size() - 1]]);
+            for (int j = static_cast<int>(element.size()) - 2; j >= 0; --j)
+                center += DataTypes::getCPos(x0[element[j]]);
+            center /= static_cast<Real>(element.size());
+
+            isElementInBoxes = isPointInBoxes(center);
+        }
+
+        if (isElementInBoxes)
+        {
+            elementIndices.push_back(i);
+            elementsInROI.push_back(element);
+        }
+    }
+}
+
 // The update method is called when the engine is marked as dirty.
 template <class DataTypes>
 void BoxROI<DataTypes>::doUpdate()
@@ -637,11 +817,11 @@ void BoxROI<DataTypes>::doUpdate()
 
         const VecCoord& x0 = d_X0.getValue();
 
-
         //Points
+        updatePointsSelection(x0);
         for( unsigned i=0; i<x0.size(); ++i )
         {
-            if (isPointInBoxes(i))
+            if (m_isPointInBoxes[i])
             {
                 indices.push_back(i);
                 pointsInROI.push_back(x0[i]);
@@ -651,79 +831,33 @@ void BoxROI<DataTypes>::doUpdate()
         //Edges
         if (d_computeEdges.getValue())
         {
-            for(unsigned int i=0 ; i<edges.size() ; i++)
-            {
-                Edge e = edges[i];
-                const bool is_in_box = (strict) ? isEdgeInBoxesStrict(e) : isEdgeInBoxes(e);
-                if (is_in_box)
-                {
-                    edgeIndices.push_back(i);
-                    edgesInROI.push_back(e);
-                }
-            }
+            updateElementsSelection(x0, edges.ref(), strict, edgeIndices, edgesInROI.wref());
         }
 
         //Triangles
         if (d_computeTriangles.getValue())
         {
-            for(unsigned int i=0 ; i<triangles.size() ; i++)
-            {
-                Triangle t = triangles[i];
-                const bool is_in_box = (strict) ? isTriangleInBoxesStrict(t) : isTriangleInBoxes(t);
-                if (is_in_box)
-                {
-                    triangleIndices.push_back(i);
-                    trianglesInROI.push_back(t);
-                }
-            }
+            updateElementsSelection(x0, triangles.ref(), strict, triangleIndices, trianglesInROI.wref());
         }
 
         //Tetrahedra
         if (d_computeTetrahedra.getValue())
         {
-            for(unsigned int i=0 ; i<tetrahedra.size() ; i++)
-            {
-                Tetra t = tetrahedra[i];
-                const bool is_in_box = (strict) ? isTetrahedronInBoxesStrict(t) : isTetrahedronInBoxes(t);
-                if (is_in_box)
-                {
-                    tetrahedronIndices.push_back(i);
-                    tetrahedraInROI.push_back(t);
-                }
-            }
+            updateElementsSelection(x0, tetrahedra.ref(), strict, tetrahedronIndices, tetrahedraInROI.wref());
         }
 
         //Hexahedra
         if (d_computeHexahedra.getValue())
         {
-            for(unsigned int i=0 ; i<hexahedra.size() ; i++)
-            {
-                Hexa t = hexahedra[i];
-                const bool is_in_box = (strict) ? isHexahedronInBoxesStrict(t) : isHexahedronInBoxes(t);
-                if (is_in_box)
-                {
-                    hexahedronIndices.push_back(i);
-                    hexahedraInROI.push_back(t);
-                }
-            }
+            updateElementsSelection(x0, hexahedra.ref(), strict, hexahedronIndices, hexahedraInROI.wref());
         }
 
         //Quads
         if (d_computeQuad.getValue())
         {
-            for(unsigned int i=0 ; i<quad.size() ; i++)
-            {
-                Quad q = quad[i];
-                const bool is_in_box = (strict) ? isQuadInBoxesStrict(q) : isQuadInBoxes(q);
-                if (is_in_box)
-                {
-                    quadIndices.push_back(i);
-                    quadInROI.push_back(q);
-                }
-            }
+            updateElementsSelection(x0, quad.ref(), strict, quadIndices, quadInROI.wref());
         }
 
-
         d_nbIndices.setValue(sofa::Size(indices.size()));
     }
 }
@@ -0,0 +1,82 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/engine/select/config.h>
+
+#include <sofa/core/DataEngine.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/defaulttype/VecTypes.h>
+
+namespace sofa::component::engine::select
+{
+
+/**
+ * Cubature of a tetrahedral mesh: a few weighted tetrahedra standing for the whole mesh, to evaluate the
+ * internal forces of a reduced model (see ModalMapping) at a fraction of the cost.
+ *
+ * The samples are selected by farthest point sampling of the centroids of the tetrahedra. The weight of a sample
+ * is the volume of its Voronoi cell (the tetrahedra closer to it than to any other sample) divided by its own
+ * volume, so that the weighted volumes sum up to the volume of the mesh. The weighted Young modulus can be given
+ * to a TetrahedronFEMForceField defined on the output tetrahedra, whose forces are linear in the Young modulus.
+ */
+template <class DataTypes>
+class TetrahedronCubature : public core::DataEngine
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE(TetrahedronCubature,DataTypes),core::DataEngine);
+
+    typedef typename DataTypes::Real Real;
+    typedef typename DataTypes::Coord Coord;
+    typedef typename DataTypes::VecCoord VecCoord;
+    typedef core::topology::BaseMeshTopology::Tetrahedron Tetrahedron;
+    typedef core::topology::BaseMeshTopology::SeqTetrahedra SeqTetrahedra;
+    typedef core::topology::BaseMeshTopology::SetIndices SetIndices;
+    typedef type::vector<Real> VecReal;
+
+    /// inputs
+    Data<VecCoord> d_position; ///< rest positions of the mesh
+    Data<SeqTetrahedra> d_tetrahedra; ///< tetrahedra of the mesh
+    Data<unsigned int> d_nbSamples; ///< number of tetrahedra of the cubature
+    Data<Real> d_youngModulus; ///< Young modulus of the material
+
+    /// outputs
+    Data<SetIndices> d_tetrahedronIndices; ///< indices of the selected tetrahedra
+    Data<VecReal> d_weights; ///< weights of the selected tetrahedra
+    Data<SetIndices> d_pointIndices; ///< vertices of the selected tetrahedra, in the input mesh
+    Data<VecCoord> d_outputPosition; ///< rest positions of the vertices of the selected tetrahedra
+    Data<SeqTetrahedra> d_outputTetrahedra; ///< selected tetrahedra, indexing the output positions
+    Data<VecReal> d_weightedYoungModulus; ///< Young modulus of each selected tetrahedron multiplied by its weight
+
+    void init() override;
+    void reinit() override { update(); }
+    void doUpdate() override;
+
+protected:
+    TetrahedronCubature();
+    ~TetrahedronCubature() override = default;
+};
+
+#if !defined(SOFA_COMPONENT_ENGINE_SELECT_TETRAHEDRONCUBATURE_CPP)
+extern template class SOFA_COMPONENT_ENGINE_SELECT_API TetrahedronCubature<defaulttype::Vec3Types>;
+#endif
+
+} //namespace sofa::component::engine::select
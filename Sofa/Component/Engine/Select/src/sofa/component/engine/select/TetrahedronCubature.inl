@@ -0,0 +1,166 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/engine/select/TetrahedronCubature.h>
+#include <sofa/geometry/Tetrahedron.h>
+
+#include <limits>
+#include <map>
+
+namespace sofa::component::engine::select
+{
+
+template <class DataTypes>
+TetrahedronCubature<DataTypes>::TetrahedronCubature()
+    : d_position(initData(&d_position, "position", "Rest positions of the mesh"))
+    , d_tetrahedra(initData(&d_tetrahedra, "tetrahedra", "Tetrahedra of the mesh"))
+    , d_nbSamples(initData(&d_nbSamples, 10u, "nbSamples", "Number of tetrahedra of the cubature"))
+    , d_youngModulus(initData(&d_youngModulus, (Real)5000, "youngModulus", "Young modulus of the material"))
+    , d_tetrahedronIndices(initData(&d_tetrahedronIndices, "tetrahedronIndices", "Indices of the selected tetrahedra"))
+    , d_weights(initData(&d_weights, "weights", "Weights of the selected tetrahedra"))
+    , d_pointIndices(initData(&d_pointIndices, "pointIndices", "Vertices of the selected tetrahedra, in the input mesh"))
+    , d_outputPosition(initData(&d_outputPosition, "outputPosition", "Rest positions of the vertices of the selected tetrahedra"))
+    , d_outputTetrahedra(initData(&d_outputTetrahedra, "outputTetrahedra", "Selected tetrahedra, indexing the output positions"))
+    , d_weightedYoungModulus(initData(&d_weightedYoungModulus, "weightedYoungModulus", "Young modulus of each selected tetrahedron multiplied by its weight"))
+{
+    addInput(&d_position);
+    addInput(&d_tetrahedra);
+    addInput(&d_nbSamples);
+    addInput(&d_youngModulus);
+    addOutput(&d_tetrahedronIndices);
+    addOutput(&d_weights);
+    addOutput(&d_pointIndices);
+    addOutput(&d_outputPosition);
+    addOutput(&d_outputTetrahedra);
+    addOutput(&d_weightedYoungModulus);
+}
+
+template <class DataTypes>
+void TetrahedronCubature<DataTypes>::init()
+{
+    setDirtyValue();
+}
+
+template <class DataTypes>
+void TetrahedronCubature<DataTypes>::doUpdate()
+{
+    const auto position = sofa::helper::getReadAccessor(d_position);
+    const auto tetrahedra = sofa::helper::getReadAccessor(d_tetrahedra);
+
+    auto tetrahedronIndices = sofa::helper::getWriteOnlyAccessor(d_tetrahedronIndices);
+    auto weights = sofa::helper::getWriteOnlyAccessor(d_weights);
+    auto pointIndices = sofa::helper::getWriteOnlyAccessor(d_pointIndices);
+    auto outputPosition = sofa::helper::getWriteOnlyAccessor(d_outputPosition);
+    auto outputTetrahedra = sofa::helper::getWriteOnlyAccessor(d_outputTetrahedra);
+    auto weightedYoungModulus = sofa::helper::getWriteOnlyAccessor(d_weightedYoungModulus);
+
+    tetrahedronIndices.clear();
+    weights.clear();
+    pointIndices.clear();
+    outputPosition.clear();
+    outputTetrahedra.clear();
+    weightedYoungModulus.clear();
+
+    const std::size_t nbTetrahedra = tetrahedra.size();
+    const std::size_t nbSamples = std::min<std::size_t>(d_nbSamples.getValue(), nbTetrahedra);
+    if (nbSamples == 0)
+    {
+        return;
+    }
+
+    type::vector<Coord> centroids(nbTetrahedra);
+    VecReal volumes(nbTetrahedra);
+    std::size_t first = 0;
+    for (std::size_t t = 0; t < nbTetrahedra; ++t)
+    {
+        const Tetrahedron& tetra = tetrahedra[t];
+        centroids[t] = (position[tetra[0]] + position[tetra[1]] + position[tetra[2]] + position[tetra[3]]) * (Real)0.25;
+        volumes[t] = std::abs(sofa::geometry::Tetrahedron::volume(position[tetra[0]], position[tetra[1]], position[tetra[2]], position[tetra[3]]));
+        if (volumes[t] > volumes[first])
+        {
+            first = t;
+        }
+    }
+
+    // farthest point sampling of the centroids, starting from the largest tetrahedron
+    VecReal distances(nbTetrahedra, std::numeric_limits<Real>::max());
+    type::vector<std::size_t> cell(nbTetrahedra, 0);
+    tetrahedronIndices.push_back(Index(first));
+    while (true)
+    {
+        const std::size_t sample = tetrahedronIndices.size() - 1;
+        const Coord& c = centroids[tetrahedronIndices[sample]];
+        std::size_t farthest = 0;
+        for (std::size_t t = 0; t < nbTetrahedra; ++t)
+        {
+            const Real d = (centroids[t] - c).norm2();
+            if (d < distances[t])
+            {
+                distances[t] = d;
+                cell[t] = sample;
+            }
+            if (distances[t] > distances[farthest])
+            {
+                farthest = t;
+            }
+        }
+
+        if (tetrahedronIndices.size() == nbSamples || distances[farthest] == 0)
+        {
+            break;
+        }
+        tetrahedronIndices.push_back(Index(farthest));
+    }
+
+    // weight of a sample: volume of its Voronoi cell relatively to its own volume
+    VecReal cellVolumes(tetrahedronIndices.size(), 0);
+    for (std::size_t t = 0; t < nbTetrahedra; ++t)
+    {
+        cellVolumes[cell[t]] += volumes[t];
+    }
+
+    // vertices of the samples, renumbered in the order of their first use
+    std::map<Index, Index> renumbering;
+    for (std::size_t s = 0; s < tetrahedronIndices.size(); ++s)
+    {
+        const Index t = tetrahedronIndices[s];
+        weights.push_back(volumes[t] > 0 ? cellVolumes[s] / volumes[t] : 0);
+        weightedYoungModulus.push_back(weights.back() * d_youngModulus.getValue());
+
+        Tetrahedron local;
+        for (unsigned int v = 0; v < 4; ++v)
+        {
+            const auto it = renumbering.emplace(tetrahedra[t][v], Index(pointIndices.size())).first;
+            if (it->second == pointIndices.size())
+            {
+                pointIndices.push_back(it->first);
+                outputPosition.push_back(position[it->first]);
+            }
+            local[v] = it->second;
+        }
+        outputTetrahedra.push_back(local);
+    }
+
+    msg_info() << tetrahedronIndices.size() << " tetrahedra selected among " << nbTetrahedra;
+}
+
+} //namespace sofa::component::engine::select
@@ -25,6 +25,7 @@ using std::vector;
 
 #include <string>
 using std::string;
+#include <sstream>
 
 #include <gtest/gtest.h>
 using ::testing::Types;
@@ -324,6 +325,69 @@ struct BoxROITest :  public sofa::testing::BaseTest
     }
 
 
+    /// Test that the selection follows the points and the boxes modified between two updates
+    void refittedBoundingVolumesTest()
+    {
+        m_boxroi->findData("box")->read("0. 0. 0. 1. 1. 1.");
+        m_boxroi->findData("strict")->read("0");
+        m_boxroi->findData("position")->read("0. 0. 0. 1. 0. 0. 2. 0. 0.");
+        m_boxroi->findData("edges")->read("0 1 1 2");
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"0");
+
+        /// only the last point moved
+        m_boxroi->findData("position")->read("0. 0. 0. 1. 0. 0. 0.5 0. 0.");
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1 2");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"0 1");
+
+        /// the box moved
+        m_boxroi->findData("box")->read("0.8 -1. -1. 3. 1. 1.");
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"1");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"");
+
+        /// switch to the strict mode
+        m_boxroi->findData("box")->read("-1. -1. -1. 3. 1. 1.");
+        m_boxroi->findData("strict")->read("1");
+        m_boxroi->findData("position")->read("0. 0. 0. 1. 0. 0. 5. 0. 0.");
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("indices")->getValueString(),"0 1");
+        EXPECT_EQ(m_boxroi->findData("edgeIndices")->getValueString(),"0");
+    }
+
+
+    /// Test the selection with enough boxes to use the bounding volumes of the points
+    void manyBoxesTest()
+    {
+        const auto readPositions = [this](double shift)
+        {
+            std::ostringstream positions;
+            for (unsigned int i = 0; i < 200; ++i)
+                positions << i + shift << " 0 0 ";
+            m_boxroi->findData("position")->read(positions.str());
+        };
+
+        m_boxroi->findData("box")->read("9.5 -1 -1 19.5 1 1   29.5 -1 -1 39.5 1 1   59.5 -1 -1 300 1 1"
+                                        "   -10 5 5 -5 6 6   100 -1 -1 120 1 1");
+        readPositions(0.);
+        m_boxroi->init();
+
+        EXPECT_EQ(m_boxroi->findData("nbIndices")->getValueString(),"160");
+
+        /// all the points moved
+        readPositions(1.);
+        m_boxroi->update();
+
+        EXPECT_EQ(m_boxroi->findData("nbIndices")->getValueString(),"161");
+    }
+
+
     /// Test computeBBox computation with a simple example
     void computeBBoxTest()
     {
@@ -412,6 +476,14 @@ TYPED_TEST(BoxROITest, isPointInBoxesTest) {
     ASSERT_NO_THROW(this->isPointInBoxesTest());
 }
 
+TYPED_TEST(BoxROITest, refittedBoundingVolumesTest) {
+    ASSERT_NO_THROW(this->refittedBoundingVolumesTest());
+}
+
+TYPED_TEST(BoxROITest, manyBoxesTest) {
+    ASSERT_NO_THROW(this->manyBoxesTest());
+}
+
 TYPED_TEST(BoxROITest, computeBBoxTest) {
     ASSERT_NO_THROW(this->computeBBoxTest());
 }
@@ -0,0 +1,134 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <sofa/component/engine/select/TetrahedronCubature.h>
+using sofa::component::engine::select::TetrahedronCubature;
+
+#include <sofa/geometry/Tetrahedron.h>
+#include <set>
+
+namespace sofa
+{
+
+struct TetrahedronCubature_test : public BaseTest
+{
+    typedef TetrahedronCubature<defaulttype::Vec3Types> Cubature;
+    typedef defaulttype::Vec3Types::VecCoord VecCoord;
+    typedef Cubature::SeqTetrahedra SeqTetrahedra;
+
+    /// Cube of n^3 unit cells, each one split in 6 tetrahedra along its diagonal
+    static void createCube(unsigned int n, VecCoord& positions, SeqTetrahedra& tetrahedra)
+    {
+        const auto index = [n](unsigned int i, unsigned int j, unsigned int k) { return i + (n + 1) * (j + (n + 1) * k); };
+        for (unsigned int k = 0; k <= n; ++k)
+            for (unsigned int j = 0; j <= n; ++j)
+                for (unsigned int i = 0; i <= n; ++i)
+                    positions.emplace_back(i, j, k);
+
+        const unsigned int axes[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+        for (unsigned int k = 0; k < n; ++k)
+            for (unsigned int j = 0; j < n; ++j)
+                for (unsigned int i = 0; i < n; ++i)
+                    for (const auto& a : axes)
+                    {
+                        type::Vec3u c(i, j, k);
+                        const Index v0 = index(c[0], c[1], c[2]);
+                        c[a[0]]++;
+                        const Index v1 = index(c[0], c[1], c[2]);
+                        c[a[1]]++;
+                        const Index v2 = index(c[0], c[1], c[2]);
+                        tetrahedra.emplace_back(v0, v1, v2, index(i + 1, j + 1, k + 1));
+                    }
+    }
+};
+
+TEST_F(TetrahedronCubature_test, weightsAndSubMesh)
+{
+    VecCoord positions;
+    SeqTetrahedra tetrahedra;
+    createCube(3, positions, tetrahedra);
+
+    const Cubature::SPtr cubature = core::objectmodel::New<Cubature>();
+    cubature->d_position.setValue(positions);
+    cubature->d_tetrahedra.setValue(tetrahedra);
+    cubature->d_nbSamples.setValue(12);
+    cubature->d_youngModulus.setValue(100);
+    cubature->init();
+    cubature->update();
+
+    const auto& selected = cubature->d_tetrahedronIndices.getValue();
+    const auto& weights = cubature->d_weights.getValue();
+    const auto& pointIndices = cubature->d_pointIndices.getValue();
+    const auto& outputPosition = cubature->d_outputPosition.getValue();
+    const auto& outputTetrahedra = cubature->d_outputTetrahedra.getValue();
+    const auto& youngModulus = cubature->d_weightedYoungModulus.getValue();
+
+    ASSERT_EQ(selected.size(), 12);
+    ASSERT_EQ(weights.size(), 12);
+    ASSERT_EQ(outputTetrahedra.size(), 12);
+    ASSERT_EQ(youngModulus.size(), 12);
+    ASSERT_EQ(outputPosition.size(), pointIndices.size());
+    EXPECT_EQ(std::set<Index>(selected.begin(), selected.end()).size(), 12);
+    EXPECT_EQ(std::set<Index>(pointIndices.begin(), pointIndices.end()).size(), pointIndices.size());
+
+    // the weighted volumes sum up to the volume of the cube
+    SReal volume = 0;
+    for (std::size_t s = 0; s < selected.size(); ++s)
+    {
+        const auto& t = tetrahedra[selected[s]];
+        const auto& local = outputTetrahedra[s];
+        for (unsigned int v = 0; v < 4; ++v)
+        {
+            EXPECT_EQ(outputPosition[local[v]], positions[t[v]]);
+        }
+        EXPECT_GE(weights[s], 1);
+        EXPECT_DOUBLE_EQ(youngModulus[s], 100 * weights[s]);
+        volume += weights[s] * std::abs(geometry::Tetrahedron::volume(positions[t[0]], positions[t[1]], positions[t[2]], positions[t[3]]));
+    }
+    EXPECT_NEAR(volume, 27, 1e-10);
+}
+
+TEST_F(TetrahedronCubature_test, allTetrahedra)
+{
+    VecCoord positions;
+    SeqTetrahedra tetrahedra;
+    createCube(1, positions, tetrahedra);
+
+    const Cubature::SPtr cubature = core::objectmodel::New<Cubature>();
+    cubature->d_position.setValue(positions);
+    cubature->d_tetrahedra.setValue(tetrahedra);
+    cubature->d_nbSamples.setValue(100);
+    cubature->init();
+    cubature->update();
+
+    // more samples than tetrahedra: the whole mesh is kept with unit weights
+    ASSERT_EQ(cubature->d_tetrahedronIndices.getValue().size(), tetrahedra.size());
+    for (const SReal w : cubature->d_weights.getValue())
+    {
+        EXPECT_NEAR(w, 1, 1e-12);
+    }
+    EXPECT_EQ(cubature->d_pointIndices.getValue().size(), positions.size());
+}
+
+} // namespace sofa
@@ -25,6 +25,7 @@
 #include <sofa/component/haptics/MechanicalStateForceFeedback.h>
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/helper/system/thread/CTime.h>
+#include <atomic>
 #include <mutex>
 
 #include <sofa/component/constraint/lagrangian/solver/ConstraintSolverImpl.h>
@@ -119,9 +120,11 @@ protected:
     std::vector<int> mId_buf[3];
     component::constraint::lagrangian::solver::ConstraintProblem* mCP[3];
 
-    unsigned char mNextBufferId; // Next buffer id to be use
-    unsigned char mCurBufferId; // Current buffer id in use
-    bool mIsCuBufferInUse; // Is current buffer currently in use right now
+    // The buffers are handed over from the simulation thread to the haptic thread without lock: the simulation
+    // thread fills a buffer which is neither the current nor the next one, then publishes it as the next one.
+    std::atomic<unsigned char> mNextBufferId; // Next buffer id to be use
+    std::atomic<unsigned char> mCurBufferId; // Current buffer id in use
+    std::atomic<bool> mIsCuBufferInUse; // Is current buffer currently in use right now
 
     sofa::component::constraint::lagrangian::solver::ConstraintSolverImpl* constraintSolver;
 
@@ -216,25 +216,24 @@ void LCPForceFeedback<DataTypes>::updateStats()
 template <class DataTypes>
 bool LCPForceFeedback<DataTypes>::updateConstraintProblem()
 {
-    const int prevId = mCurBufferId;
+    const int prevId = mCurBufferId.load(std::memory_order_relaxed);
 
     //
     // Retrieve the last LCP and constraints computed by the Sofa thread.
     //
-    mIsCuBufferInUse = true;
+    mIsCuBufferInUse.store(true, std::memory_order_relaxed);
 
-    {
-        // TODO: Lock and/or memory barrier HERE
-        mCurBufferId = mNextBufferId;
-    }
+    // acquire: the content of the buffer written before its publication by the Sofa thread is visible
+    const unsigned char curBufferId = mNextBufferId.load(std::memory_order_acquire);
+    mCurBufferId.store(curBufferId, std::memory_order_release);
 
-    const bool changed = (prevId != mCurBufferId);
+    const bool changed = (prevId != curBufferId);
 
-    const sofa::component::constraint::lagrangian::solver::ConstraintProblem* cp = mCP[mCurBufferId];
+    const sofa::component::constraint::lagrangian::solver::ConstraintProblem* cp = mCP[curBufferId];
 
     if(!cp)
     {
-        mIsCuBufferInUse = false;
+        mIsCuBufferInUse.store(false, std::memory_order_relaxed);
     }
 
     return changed;
@@ -253,9 +252,10 @@ void LCPForceFeedback<DataTypes>::doComputeForce(const VecCoord& state,  VecDeri
     if(!constraintSolver||!mState)
         return;
 
-    const MatrixDeriv& constraints = mConstraints[mCurBufferId];
-    VecCoord &val = mVal[mCurBufferId];
-    sofa::component::constraint::lagrangian::solver::ConstraintProblem* cp = mCP[mCurBufferId];
+    const unsigned char curBufferId = mCurBufferId.load(std::memory_order_relaxed);
+    const MatrixDeriv& constraints = mConstraints[curBufferId];
+    VecCoord &val = mVal[curBufferId];
+    sofa::component::constraint::lagrangian::solver::ConstraintProblem* cp = mCP[curBufferId];
 
     if(!cp)
     {
@@ -346,8 +346,8 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
     // Find available buffer
 
     unsigned char buf_index=0;
-    const unsigned char cbuf_index=mCurBufferId;
-    const unsigned char nbuf_index=mNextBufferId;
+    const unsigned char cbuf_index=mCurBufferId.load(std::memory_order_acquire);
+    const unsigned char nbuf_index=mNextBufferId.load(std::memory_order_relaxed);
 
     if (buf_index == cbuf_index || buf_index == nbuf_index)
     {
@@ -387,16 +387,14 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
 
     // valid buffer
 
-    {
-        // TODO: Lock and/or memory barrier HERE
-        mNextBufferId = buf_index;
-    }
+    // release: the buffer content is written before its publication
+    mNextBufferId.store(buf_index, std::memory_order_release);
 
     // Lock lcp to prevent its use by the SOFA thread while it is used by haptic thread
-    if(mIsCuBufferInUse)
-        constraintSolver->lockConstraintProblem(this, mCP[mCurBufferId], mCP[mNextBufferId]);
+    if(mIsCuBufferInUse.load(std::memory_order_relaxed))
+        constraintSolver->lockConstraintProblem(this, mCP[mCurBufferId.load(std::memory_order_acquire)], mCP[buf_index]);
     else
-        constraintSolver->lockConstraintProblem(this, mCP[mNextBufferId]);
+        constraintSolver->lockConstraintProblem(this, mCP[buf_index]);
 }
 
 
@@ -0,0 +1,37 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_COMPONENT_HAPTICS_MULTIRATEHAPTICLOOP_CPP
+
+#include <sofa/component/haptics/MultiRateHapticLoop.inl>
+#include <sofa/core/ObjectFactory.h>
+
+namespace sofa::component::haptics
+{
+
+int MultiRateHapticLoopClass = sofa::core::RegisterObject("Runs the force feedback of a device at a high rate in its own thread, on the last constraint problem computed by the simulation")
+        .add< MultiRateHapticLoop<defaulttype::Vec1Types> >()
+        .add< MultiRateHapticLoop<defaulttype::Rigid3Types> >(true);
+
+template class SOFA_COMPONENT_HAPTICS_API MultiRateHapticLoop<defaulttype::Vec1Types>;
+template class SOFA_COMPONENT_HAPTICS_API MultiRateHapticLoop<defaulttype::Rigid3Types>;
+
+} // namespace sofa::component::haptics
@@ -0,0 +1,125 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/haptics/config.h>
+
+#include <sofa/component/haptics/MechanicalStateForceFeedback.h>
+#include <sofa/component/haptics/TripleBuffer.h>
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/objectmodel/Link.h>
+#include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/defaulttype/VecTypes.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace sofa::component::haptics
+{
+
+/**
+ * Multi-rate loop running the force feedback of a device at a high rate in its own thread.
+ *
+ * The simulation runs at its own rate (typically 30-60 Hz) in the animation loop. At each of its steps, the
+ * force feedback (for instance LCPForceFeedback) takes a copy of the constraint problem: compliance W,
+ * free violations dfree and constraint directions. This loop calls the force feedback at a fixed rate
+ * (typically 1 kHz): the violations are updated with the displacement of the device since the simulation
+ * step, and the reduced constraint problem is solved on the cached compliance.
+ *
+ * The state of the device is given by a driver with setDeviceState, or by a scripted stand-in interpolating
+ * key positions over the elapsed time, for tests. The forces are given to the driver by a callback called in
+ * the haptic thread, and are reported in the forces Data at the end of each simulation step. The exchanges
+ * with the haptic thread are lock-free.
+ */
+template<class TDataTypes>
+class MultiRateHapticLoop : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE(MultiRateHapticLoop, TDataTypes), core::objectmodel::BaseObject);
+
+    typedef TDataTypes DataTypes;
+    typedef typename DataTypes::Coord Coord;
+    typedef typename DataTypes::VecCoord VecCoord;
+    typedef typename DataTypes::VecDeriv VecDeriv;
+    typedef typename DataTypes::Real Real;
+
+    using ForceCallback = std::function<void(const VecDeriv&)>;
+
+    Data<SReal> d_frequency; ///< Rate of the haptic loop, in Hz.
+    Data<VecCoord> d_scriptedPositions; ///< Key positions of a scripted device (one device state per key).
+    Data<type::vector<SReal> > d_scriptedTimes; ///< Times of the key positions, in seconds since the start of the loop.
+    Data<VecDeriv> d_forces; ///< Output: last forces computed by the haptic loop.
+    Data<unsigned int> d_nbIterations; ///< Output: number of iterations of the haptic loop.
+    Data<SReal> d_measuredFrequency; ///< Output: measured rate of the haptic loop, in Hz.
+
+    SingleLink<MultiRateHapticLoop<DataTypes>, MechanicalStateForceFeedback<DataTypes>, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_forceFeedback;
+
+    void init() override;
+    void bwdInit() override;
+    void cleanup() override;
+    void handleEvent(core::objectmodel::Event* event) override;
+
+    /// Starts the haptic thread. Called by bwdInit.
+    void start();
+
+    /// Stops the haptic thread and waits for its end
+    void stop();
+
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /// Thread-safe: gives the current state of the device to the haptic loop (single producer)
+    void setDeviceState(const VecCoord& state);
+
+    /// Callback receiving the forces in the haptic thread, at each iteration. To be set before the start:
+    /// ignored while the haptic thread is running.
+    void setForceCallback(ForceCallback callback);
+
+    /// State of the scripted device at the given time, interpolated between the key positions
+    static Coord interpolateScript(const VecCoord& positions, const type::vector<SReal>& times, SReal time);
+
+protected:
+    MultiRateHapticLoop();
+    ~MultiRateHapticLoop() override;
+
+    void run();
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop { false };
+    std::atomic<unsigned int> m_nbIterations { 0 };
+    std::chrono::steady_clock::time_point m_startTime;
+
+    /// copies of the script, read by the haptic thread
+    VecCoord m_scriptedPositions;
+    type::vector<SReal> m_scriptedTimes;
+
+    TripleBuffer<VecCoord> m_deviceState;
+    TripleBuffer<VecDeriv> m_hapticForces;
+    ForceCallback m_forceCallback;
+};
+
+#if !defined(SOFA_COMPONENT_HAPTICS_MULTIRATEHAPTICLOOP_CPP)
+extern template class SOFA_COMPONENT_HAPTICS_API MultiRateHapticLoop<defaulttype::Vec1Types>;
+extern template class SOFA_COMPONENT_HAPTICS_API MultiRateHapticLoop<defaulttype::Rigid3Types>;
+#endif
+
+} // namespace sofa::component::haptics
@@ -0,0 +1,250 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/haptics/MultiRateHapticLoop.h>
+
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+
+#include <algorithm>
+
+namespace sofa::component::haptics
+{
+
+template<class DataTypes>
+MultiRateHapticLoop<DataTypes>::MultiRateHapticLoop()
+    : d_frequency(initData(&d_frequency, (SReal)1000, "frequency", "Rate of the haptic loop, in Hz."))
+    , d_scriptedPositions(initData(&d_scriptedPositions, "scriptedPositions", "Key positions of a scripted device replacing a real one (one device state per key). If empty, the device state is given by a driver."))
+    , d_scriptedTimes(initData(&d_scriptedTimes, "scriptedTimes", "Times of the key positions of the scripted device, in seconds since the start of the loop."))
+    , d_forces(initData(&d_forces, "forces", "Output: last forces computed by the haptic loop, updated at the end of each simulation step."))
+    , d_nbIterations(initData(&d_nbIterations, 0u, "nbIterations", "Output: number of iterations of the haptic loop."))
+    , d_measuredFrequency(initData(&d_measuredFrequency, (SReal)0, "measuredFrequency", "Output: measured rate of the haptic loop, in Hz."))
+    , l_forceFeedback(initLink("forceFeedback", "Force feedback called by the haptic loop (found in the context if not set)"))
+{
+    d_forces.setReadOnly(true);
+    d_nbIterations.setReadOnly(true);
+    d_measuredFrequency.setReadOnly(true);
+    this->f_listening.setValue(true);
+}
+
+template<class DataTypes>
+MultiRateHapticLoop<DataTypes>::~MultiRateHapticLoop()
+{
+    stop();
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::init()
+{
+    Inherit1::init();
+
+    if (!l_forceFeedback)
+    {
+        l_forceFeedback.set(this->getContext()->template get<MechanicalStateForceFeedback<DataTypes> >());
+    }
+    if (!l_forceFeedback)
+    {
+        msg_error() << "No force feedback found for the device.";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    if (d_frequency.getValue() <= 0)
+    {
+        msg_error() << "The frequency must be positive.";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    const auto& times = d_scriptedTimes.getValue();
+    if (d_scriptedPositions.getValue().size() != times.size() || !std::is_sorted(times.begin(), times.end()))
+    {
+        msg_error() << "The scripted device requires as many increasing times as key positions.";
+        this->d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    this->d_componentState.setValue(core::objectmodel::ComponentState::Valid);
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::bwdInit()
+{
+    start();
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::cleanup()
+{
+    stop();
+    Inherit1::cleanup();
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::start()
+{
+    if (isRunning() || !this->isComponentStateValid())
+    {
+        return;
+    }
+
+    m_scriptedPositions = d_scriptedPositions.getValue();
+    m_scriptedTimes = d_scriptedTimes.getValue();
+
+    m_stop.store(false);
+    m_nbIterations.store(0);
+    m_startTime = std::chrono::steady_clock::now();
+    m_thread = std::thread([this]() { run(); });
+
+    msg_info() << "Haptic loop started at " << d_frequency.getValue() << " Hz";
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::stop()
+{
+    if (!isRunning())
+    {
+        return;
+    }
+
+    m_stop.store(true, std::memory_order_release);
+    m_thread.join();
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::setDeviceState(const VecCoord& state)
+{
+    m_deviceState.writeBuffer() = state;
+    m_deviceState.publish();
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::setForceCallback(ForceCallback callback)
+{
+    if (isRunning())
+    {
+        msg_error() << "The force callback cannot be changed while the haptic thread is running: call stop() first.";
+        return;
+    }
+    m_forceCallback = std::move(callback);
+}
+
+template<class DataTypes>
+auto MultiRateHapticLoop<DataTypes>::interpolateScript(const VecCoord& positions, const type::vector<SReal>& times, SReal time) -> Coord
+{
+    if (positions.empty())
+    {
+        return Coord();
+    }
+
+    const auto next = std::upper_bound(times.begin(), times.end(), time);
+    if (next == times.begin())
+    {
+        return positions.front();
+    }
+    if (next == times.end())
+    {
+        return positions.back();
+    }
+
+    const std::size_t i = std::distance(times.begin(), next);
+    const SReal duration = times[i] - times[i - 1];
+    const Real coef = static_cast<Real>(duration > 0 ? (time - times[i - 1]) / duration : 1);
+    return DataTypes::interpolate({ positions[i - 1], positions[i] }, { 1 - coef, coef });
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::run()
+{
+    using clock = std::chrono::steady_clock;
+
+    MechanicalStateForceFeedback<DataTypes>* forceFeedback = l_forceFeedback.get();
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / d_frequency.getValue()));
+    const bool scripted = !m_scriptedPositions.empty();
+
+    VecCoord scriptedState(1);
+    VecDeriv forces;
+    auto next = m_startTime;
+
+    while (!m_stop.load(std::memory_order_acquire))
+    {
+        if (scripted)
+        {
+            const SReal time = std::chrono::duration<double>(clock::now() - m_startTime).count();
+            scriptedState[0] = interpolateScript(m_scriptedPositions, m_scriptedTimes, time);
+        }
+        else
+        {
+            m_deviceState.update();
+        }
+
+        const VecCoord& state = scripted ? scriptedState : m_deviceState.readBuffer();
+        if (!state.empty())
+        {
+            // reduced constraint solve on the last constraint problem of the simulation
+            forceFeedback->computeForce(state, forces);
+
+            if (m_forceCallback)
+            {
+                m_forceCallback(forces);
+            }
+
+            m_hapticForces.writeBuffer() = forces;
+            m_hapticForces.publish();
+        }
+
+        m_nbIterations.fetch_add(1, std::memory_order_relaxed);
+
+        // fixed rate: a late iteration is not caught up
+        next += period;
+        const auto now = clock::now();
+        if (next < now)
+        {
+            next = now;
+        }
+        else
+        {
+            std::this_thread::sleep_until(next);
+        }
+    }
+}
+
+template<class DataTypes>
+void MultiRateHapticLoop<DataTypes>::handleEvent(core::objectmodel::Event* event)
+{
+    if (!simulation::AnimateEndEvent::checkEventType(event) || !isRunning())
+    {
+        return;
+    }
+
+    if (m_hapticForces.update())
+    {
+        d_forces.setValue(m_hapticForces.readBuffer());
+    }
+
+    const unsigned int nbIterations = m_nbIterations.load(std::memory_order_relaxed);
+    const SReal elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    d_nbIterations.setValue(nbIterations);
+    d_measuredFrequency.setValue(elapsed > 0 ? nbIterations / elapsed : 0);
+}
+
+} // namespace sofa::component::haptics
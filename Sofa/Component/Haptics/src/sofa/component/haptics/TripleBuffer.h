@@ -0,0 +1,75 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/haptics/config.h>
+
+#include <array>
+#include <atomic>
+
+namespace sofa::component::haptics
+{
+
+/**
+ * Lock-free handoff of a value from one producer thread to one consumer thread.
+ *
+ * The producer fills its own buffer and publishes it by swapping it with the middle one. The consumer takes
+ * the middle buffer if a new value has been published since its last update. Neither thread ever waits for
+ * the other one, and the consumer always reads the last complete value.
+ */
+template<class T>
+class TripleBuffer
+{
+public:
+    /// Producer: the buffer to fill before calling publish
+    T& writeBuffer() { return m_buffers[m_writeIndex]; }
+
+    /// Producer: makes the content of the write buffer available to the consumer
+    void publish()
+    {
+        m_writeIndex = m_middle.exchange(m_writeIndex | NewValue, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    /// Consumer: takes the last published value, if any. Returns true if a new value has been taken.
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & NewValue) == 0)
+        {
+            return false;
+        }
+        m_readIndex = m_middle.exchange(m_readIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    /// Consumer: the last value taken by update
+    const T& readBuffer() const { return m_buffers[m_readIndex]; }
+
+private:
+    static constexpr unsigned char IndexMask = 3;
+    static constexpr unsigned char NewValue = 4;
+
+    std::array<T, 3> m_buffers {};
+    unsigned char m_writeIndex { 0 };
+    std::atomic<unsigned char> m_middle { 1 };
+    unsigned char m_readIndex { 2 };
+};
+
+} // namespace sofa::component::haptics
@@ -0,0 +1,254 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+
+#include <sofa/testing/BaseTest.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/Node.h>
+
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/component/haptics/LCPForceFeedback.h>
+#include <sofa/component/haptics/MultiRateHapticLoop.h>
+#include <sofa/component/haptics/TripleBuffer.h>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <thread>
+
+namespace sofa
+{
+using sofa::simulation::Node;
+using sofa::component::haptics::TripleBuffer;
+
+class MultiRateHapticLoop_test : public sofa::testing::BaseTest
+{
+public:
+    typedef sofa::component::statecontainer::MechanicalObject<sofa::defaulttype::Rigid3Types> MecaRig;
+    typedef sofa::component::haptics::LCPForceFeedback<sofa::defaulttype::Rigid3Types> LCPRig;
+    typedef sofa::component::haptics::MultiRateHapticLoop<sofa::defaulttype::Rigid3Types> LoopRig;
+
+    typedef typename MecaRig::Coord    Coord;
+    typedef typename MecaRig::VecCoord VecCoord;
+    typedef typename MecaRig::VecDeriv VecDeriv;
+
+    void onTearDown() override
+    {
+        if (m_root)
+        {
+            sofa::simulation::node::unload(m_root);
+        }
+    }
+
+protected:
+    /// Internal method to load a scene test file
+    void loadTestScene(const std::string& filename)
+    {
+        const std::string sceneFilename = std::string(SOFA_COMPONENT_HAPTICS_TEST_SCENES_DIR) + "/" + filename;
+        m_root = sofa::simulation::node::load(sceneFilename.c_str());
+        ASSERT_NE(m_root, nullptr);
+        sofa::simulation::node::initRoot(m_root.get());
+    }
+
+    Node::SPtr m_root;
+};
+
+
+TEST_F(MultiRateHapticLoop_test, tripleBuffer)
+{
+    TripleBuffer<int> buffer;
+
+    // nothing published yet
+    EXPECT_FALSE(buffer.update());
+
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+
+    // the consumer gets the last published value only
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2);
+
+    buffer.writeBuffer() = 3;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 3);
+}
+
+
+TEST_F(MultiRateHapticLoop_test, tripleBufferThreads)
+{
+    // each frame is filled with its number: a torn frame would mix two numbers
+    using Frame = std::array<int, 256>;
+    TripleBuffer<Frame> buffer;
+    constexpr int nbFrames = 10000;
+
+    std::thread producer([&buffer]()
+    {
+        for (int frame = 1; frame <= nbFrames; ++frame)
+        {
+            buffer.writeBuffer().fill(frame);
+            buffer.publish();
+        }
+    });
+
+    int nbIncompleteFrames = 0;
+    int nbOutOfOrderFrames = 0;
+    int lastFrame = 0;
+    while (lastFrame != nbFrames)
+    {
+        if (!buffer.update())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const Frame& frame = buffer.readBuffer();
+        if (std::any_of(frame.begin(), frame.end(), [&frame](int value) { return value != frame.front(); }))
+        {
+            ++nbIncompleteFrames;
+        }
+        if (frame.front() <= lastFrame)
+        {
+            ++nbOutOfOrderFrames;
+        }
+        lastFrame = frame.front();
+    }
+    producer.join();
+
+    EXPECT_EQ(nbIncompleteFrames, 0);
+    EXPECT_EQ(nbOutOfOrderFrames, 0);
+    EXPECT_FALSE(buffer.update());
+}
+
+
+TEST_F(MultiRateHapticLoop_test, interpolateScript)
+{
+    const VecCoord positions { Coord(type::Vec3(0, 0, 0), type::Quat<SReal>()), Coord(type::Vec3(0, -2, 0), type::Quat<SReal>()) };
+    const type::vector<SReal> times { 1.0, 2.0 };
+
+    EXPECT_EQ(LoopRig::interpolateScript(positions, times, 0.0).getCenter(), positions[0].getCenter());
+    EXPECT_EQ(LoopRig::interpolateScript(positions, times, 3.0).getCenter(), positions[1].getCenter());
+    EXPECT_NEAR(LoopRig::interpolateScript(positions, times, 1.5).getCenter()[1], -1.0, 1e-12);
+}
+
+
+TEST_F(MultiRateHapticLoop_test, forcesFromDriverThread)
+{
+    loadTestScene("ToolvsFloorCollision_test.scn");
+
+    const Node::SPtr instruNode = m_root->getChild("Instrument");
+    ASSERT_NE(instruNode, nullptr);
+    const MecaRig::SPtr meca = instruNode->get<MecaRig>(instruNode->SearchDown);
+    const LCPRig::SPtr lcp = instruNode->get<LCPRig>(instruNode->SearchDown);
+    ASSERT_NE(meca, nullptr);
+    ASSERT_NE(lcp, nullptr);
+
+    // Force only 2 iteration max for ci tests
+    lcp->d_solverMaxIt.setValue(2);
+
+    const LoopRig::SPtr loop = sofa::core::objectmodel::New<LoopRig>();
+    instruNode->addObject(loop);
+    loop->init();
+    ASSERT_TRUE(loop->isComponentStateValid());
+
+    // the callback is read by the haptic thread: set it before the start. It is called on each force computed by
+    // the haptic thread, before the force is published
+    std::mutex framesMutex;
+    std::vector<VecDeriv> computedForces;
+    loop->setForceCallback([&framesMutex, &computedForces](const VecDeriv& forces)
+    {
+        const std::lock_guard lock(framesMutex);
+        computedForces.push_back(forces);
+    });
+
+    // a force consumed by the simulation is one of the forces completely computed by the haptic thread
+    unsigned int nbConsumedForces = 0;
+    unsigned int nbUnknownForces = 0;
+    const auto checkConsumedForces = [&]()
+    {
+        const VecDeriv& consumed = loop->d_forces.getValue();
+        if (consumed.empty())
+        {
+            return;
+        }
+        ++nbConsumedForces;
+
+        const std::lock_guard lock(framesMutex);
+        if (std::find(computedForces.begin(), computedForces.end(), consumed) == computedForces.end())
+        {
+            ++nbUnknownForces;
+        }
+    };
+
+    loop->bwdInit();
+    ASSERT_TRUE(loop->isRunning());
+
+    constexpr int nbSteps = 200;
+    for (int step = 0; step < nbSteps; step++)
+    {
+        sofa::simulation::node::animate(m_root.get());
+        checkConsumedForces();
+
+        // device slightly inside the floor, below the simulated instrument
+        VecCoord device = meca->x.getValue();
+        device[0].getCenter()[1] -= 1.0;
+        loop->setDeviceState(device);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    loop->stop();
+    EXPECT_FALSE(loop->isRunning());
+
+    // the number of iterations of the haptic thread depends on the load of the machine: only the handoff is checked
+    EXPECT_EQ(nbUnknownForces, 0u) << nbConsumedForces << " forces consumed";
+    const std::lock_guard lock(framesMutex);
+    for (const VecDeriv& forces : computedForces)
+    {
+        EXPECT_EQ(forces.size(), 1);
+    }
+}
+
+
+TEST_F(MultiRateHapticLoop_test, invalidScript)
+{
+    loadTestScene("ToolvsFloorCollision_test.scn");
+
+    const Node::SPtr instruNode = m_root->getChild("Instrument");
+    ASSERT_NE(instruNode, nullptr);
+
+    const LoopRig::SPtr loop = sofa::core::objectmodel::New<LoopRig>();
+    loop->d_scriptedPositions.setValue(VecCoord(2));
+    loop->d_scriptedTimes.setValue({ 1.0 });
+    instruNode->addObject(loop);
+
+    {
+        EXPECT_MSG_EMIT(Error);
+        loop->init();
+    }
+    loop->bwdInit();
+    EXPECT_FALSE(loop->isRunning());
+}
+
+} // namespace sofa
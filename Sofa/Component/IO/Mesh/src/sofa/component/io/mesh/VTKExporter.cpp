@@ -26,6 +26,12 @@
 #include <sofa/simulation/events/SimulationInitDoneEvent.h>
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/core/objectmodel/KeypressedEvent.h>
+#include <sofa/helper/system/SetDirectory.h>
+
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace sofa::component::_vtkexporter_
 {
@@ -49,11 +55,20 @@ VTKExporter::VTKExporter()
     , exportAtBegin( initData(&exportAtBegin, false, "exportAtBegin", "export file at the initialization"))
     , exportAtEnd( initData(&exportAtEnd, false, "exportAtEnd", "export file when the simulation is finished"))
     , overwrite( initData(&overwrite, false, "overwrite", "overwrite the file, otherwise create a new file at each export, with suffix in the filename"))
+    , d_xmlEncoding( initData(&d_xmlEncoding, {"ascii", "binary", "compressed"}, "xmlEncoding", "Encoding of the arrays in XML format: ascii, binary (appended raw) or compressed (appended raw, zlib)"))
+    , d_asynchronous( initData(&d_asynchronous, false, "asynchronous", "Write XML files in a background thread, from a copy of the exported data"))
+    , d_maxQueueSize( initData(&d_maxQueueSize, 2u, "maxQueueSize", "Maximum number of asynchronous exports waiting to be written before the simulation is blocked"))
+    , d_writePVD( initData(&d_writePVD, false, "pvd", "Write a PVD file referencing all the exported XML files with their simulation time"))
+    , d_nbStalledExports( initData(&d_nbStalledExports, 0u, "nbStalledExports", "Number of asynchronous exports which had to wait for the writer thread because the queue was full"))
+    , d_stallTime( initData(&d_stallTime, 0.0, "stallTime", "Total time (in ms) the simulation waited for the writer thread"))
 {
+    d_nbStalledExports.setReadOnly(true);
+    d_stallTime.setReadOnly(true);
 }
 
 VTKExporter::~VTKExporter()
 {
+    stopWriter();
     if (outfile)
         delete outfile;
 }
@@ -80,6 +95,13 @@ void VTKExporter::init()
 
     nbFiles = 0;
 
+    // the exports still pending belong to the previous time series
+    stopWriter();
+    {
+        std::lock_guard<std::mutex> lock(m_pvdMutex);
+        m_pvdDataSets.clear();
+    }
+
     const type::vector<std::string>& pointsData = dPointsDataFields.getValue();
     const type::vector<std::string>& cellsData = dCellsDataFields.getValue();
 
@@ -211,102 +233,6 @@ void VTKExporter::writeData(const type::vector<std::string>& objects, const type
     }
 }
 
-void VTKExporter::writeDataArray(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names)
-{
-    const sofa::core::objectmodel::BaseContext* context = this->getContext();
-
-    for (unsigned int i=0 ; i<objects.size() ; i++)
-    {
-        const core::objectmodel::BaseObject* obj = context->get<core::objectmodel::BaseObject> (objects[i]);
-        core::objectmodel::BaseData* field = nullptr;
-        if (obj)
-        {
-            field = obj->findData(fields[i]);
-        }
-
-        if (!obj || !field)
-        {
-            if (!obj)
-                msg_error() << "VTKExporter : error while fetching data field '" << msgendl
-                            << fields[i] << "' of object '" << objects[i] << msgendl
-                            << "', check object name" << msgendl;
-            else if (!field)
-                msg_error()  << "VTKExporter : error while fetching data field " << msgendl
-                             << fields[i] << " of object '" << objects[i] << msgendl
-                             << "', check field name " << msgendl;
-        }
-        else
-        {
-            //Scalars
-            std::string type;
-            unsigned int sizeSeg=0;
-            if (dynamic_cast<sofa::core::objectmodel::Data< type::vector<int> >* >(field))
-            {
-                type = "Int32";
-                sizeSeg = 1;
-            }
-            if (dynamic_cast<sofa::core::objectmodel::Data< type::vector<unsigned int> >* >(field))
-            {
-                type = "UInt32";
-                sizeSeg = 1;
-            }
-            if (dynamic_cast<sofa::core::objectmodel::Data< type::vector<float> >* >(field))
-            {
-                type = "Float32";
-                sizeSeg = 1;
-            }
-            if (dynamic_cast<sofa::core::objectmodel::Data<type::vector<double> >* >(field))
-            {
-                type = "Float64";
-                sizeSeg = 1;
-            }
-
-            //Vectors
-            if (type.empty())
-            {
-                if (dynamic_cast<sofa::core::objectmodel::Data<type::vector< type::Vec1f> >* >(field))
-                {
-                    type = "Float32";
-                    sizeSeg = 1;
-                }
-                if (dynamic_cast<sofa::core::objectmodel::Data<type::vector< type::Vec1d> >* >(field))
-                {
-                    type = "Float64";
-                    sizeSeg = 1;
-                }
-
-                if (dynamic_cast<sofa::core::objectmodel::Data<type::vector< type::Vec2f> >* >(field))
-                {
-                    type = "Float32";
-                    sizeSeg = 2;
-                }
-                if (dynamic_cast<sofa::core::objectmodel::Data<type::vector< type::Vec2d> >* >(field))
-                {
-                    type = "Float64";
-                    sizeSeg = 2;
-                }
-
-                if (dynamic_cast<sofa::core::objectmodel::Data<type::vector< type::Vec3f > >* > (field))
-                {
-                    type = "Float32";
-                    sizeSeg = 3;
-                }
-                if (dynamic_cast<sofa::core::objectmodel::Data<type::vector< type::Vec3d > >* >(field))
-                {
-                    type = "Float64";
-                    sizeSeg = 3;
-                }
-            }
-            *outfile << "        <DataArray type=\""<< type << "\" Name=\"" << names[i];
-            if(sizeSeg > 1)
-                *outfile << "\" NumberOfComponents=\"" << sizeSeg;
-            *outfile << "\" format=\"ascii\">" << std::endl;
-            *outfile << segmentString(field->getValueString(),sizeSeg) << std::endl;
-            *outfile << "        </DataArray>" << std::endl;
-        }
-    }
-}
-
 
 std::string VTKExporter::segmentString(std::string str, unsigned int n)
 {
@@ -529,17 +455,198 @@ void VTKExporter::writeVTKSimple()
     msg_info() << "Export VTK in file " << filename << "  done.";
 }
 
+namespace
+{
+
+enum XMLEncoding : unsigned int
+{
+    ASCII = 0,
+    BINARY = 1,
+    COMPRESSED = 2
+};
+
+/// Size of the blocks compressed independently, as expected by vtkZLibDataCompressor
+constexpr std::size_t compressionBlockSize = 1 << 15;
+
+template<class T>
+bool copyDataArray(const core::objectmodel::BaseData* field, const char* vtkType, unsigned int nbComponents, std::vector<char>& values, std::string& typeName, unsigned int& components)
+{
+    const auto* data = dynamic_cast<const core::objectmodel::Data<type::vector<T> >*>(field);
+    if (!data)
+        return false;
+
+    const type::vector<T>& v = data->getValue();
+    values.resize(v.size() * sizeof(T));
+    if (!v.empty())
+        std::memcpy(values.data(), v.data(), values.size());
+    typeName = vtkType;
+    components = nbComponents;
+    return true;
+}
+
+template<class T>
+void writeASCIIValues(std::ostream& out, const std::vector<char>& values, unsigned int nbComponents)
+{
+    const std::size_t nbValues = values.size() / sizeof(T);
+    const T* v = reinterpret_cast<const T*>(values.data());
+    for (std::size_t i = 0; i < nbValues; ++i)
+    {
+        out << v[i] << (((i + 1) % nbComponents == 0) ? '\n' : ' ');
+    }
+}
+
+/// Append a block of the AppendedData section: a UInt64 size header followed by the raw bytes,
+/// or the vtkZLibDataCompressor header followed by the compressed blocks.
+/// Return false if zlib failed to compress the block, in which case nothing is appended.
+bool appendBlock(std::vector<char>& appended, const char* data, std::size_t size, bool compress)
+{
+    if (!compress)
+    {
+        const uint64_t header = size;
+        appended.insert(appended.end(), reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header));
+        appended.insert(appended.end(), data, data + size);
+        return true;
+    }
+
+    const std::size_t nbBlocks = (size + compressionBlockSize - 1) / compressionBlockSize;
+    std::vector<uint64_t> header(3 + nbBlocks, 0);
+    header[0] = nbBlocks;
+    header[1] = compressionBlockSize;
+    header[2] = size % compressionBlockSize;
+
+    std::vector<Bytef> compressed;
+    std::vector<Bytef> block(compressBound(compressionBlockSize));
+    for (std::size_t b = 0; b < nbBlocks; ++b)
+    {
+        const std::size_t begin = b * compressionBlockSize;
+        const std::size_t blockSize = std::min(compressionBlockSize, size - begin);
+        uLongf compressedSize = static_cast<uLongf>(block.size());
+        if (compress2(block.data(), &compressedSize, reinterpret_cast<const Bytef*>(data + begin), static_cast<uLong>(blockSize), Z_BEST_SPEED) != Z_OK)
+            return false;
+        header[3 + b] = compressedSize;
+        compressed.insert(compressed.end(), block.begin(), block.begin() + compressedSize);
+    }
+
+    appended.insert(appended.end(), reinterpret_cast<const char*>(header.data()), reinterpret_cast<const char*>(header.data() + header.size()));
+    appended.insert(appended.end(), compressed.begin(), compressed.end());
+    return true;
+}
+
+bool isLittleEndian()
+{
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+}
+
+} // anonymous namespace
+
+void VTKExporter::fetchDataArrays(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names, type::vector<XMLSnapshot::DataArray>& arrays)
+{
+    const sofa::core::objectmodel::BaseContext* context = this->getContext();
+
+    arrays.clear();
+    for (unsigned int i=0 ; i<objects.size() ; i++)
+    {
+        const core::objectmodel::BaseObject* obj = context->get<core::objectmodel::BaseObject> (objects[i]);
+        const core::objectmodel::BaseData* field = nullptr;
+        if (obj)
+        {
+            field = obj->findData(fields[i]);
+        }
+
+        if (!obj)
+        {
+            msg_error() << "VTKExporter : error while fetching data field '" << msgendl
+                        << fields[i] << "' of object '" << objects[i] << msgendl
+                        << "', check object name" << msgendl;
+            continue;
+        }
+        if (!field)
+        {
+            msg_error()  << "VTKExporter : error while fetching data field " << msgendl
+                         << fields[i] << " of object '" << objects[i] << msgendl
+                         << "', check field name " << msgendl;
+            continue;
+        }
+
+        XMLSnapshot::DataArray array;
+        array.name = names[i];
+        const bool copied =
+                copyDataArray<int>(field, "Int32", 1, array.values, array.type, array.nbComponents)
+                || copyDataArray<unsigned int>(field, "UInt32", 1, array.values, array.type, array.nbComponents)
+                || copyDataArray<float>(field, "Float32", 1, array.values, array.type, array.nbComponents)
+                || copyDataArray<double>(field, "Float64", 1, array.values, array.type, array.nbComponents)
+                || copyDataArray<type::Vec1f>(field, "Float32", 1, array.values, array.type, array.nbComponents)
+                || copyDataArray<type::Vec1d>(field, "Float64", 1, array.values, array.type, array.nbComponents)
+                || copyDataArray<type::Vec2f>(field, "Float32", 2, array.values, array.type, array.nbComponents)
+                || copyDataArray<type::Vec2d>(field, "Float64", 2, array.values, array.type, array.nbComponents)
+                || copyDataArray<type::Vec3f>(field, "Float32", 3, array.values, array.type, array.nbComponents)
+                || copyDataArray<type::Vec3d>(field, "Float64", 3, array.values, array.type, array.nbComponents);
+
+        if (!copied)
+        {
+            msg_error() << "VTKExporter : unsupported type for data field '" << fields[i] << "' of object '" << objects[i] << "'";
+            continue;
+        }
+        arrays.push_back(std::move(array));
+    }
+}
+
+void VTKExporter::updateXMLCells()
+{
+    const unsigned int flags = (writeEdges.getValue() ? 1 : 0)
+            | (writeTriangles.getValue() ? 2 : 0)
+            | (writeQuads.getValue() ? 4 : 0)
+            | (writeTetras.getValue() ? 8 : 0)
+            | (writeHexas.getValue() ? 16 : 0);
+    const int revision = m_topology->getRevision();
+
+    if (m_xmlCells && revision == m_xmlCellsRevision && flags == m_xmlCellsFlags)
+        return;
+
+    auto cells = std::make_shared<XMLSnapshot::Cells>();
+    int offset = 0;
+    const auto addCells = [&cells, &offset](const auto& elements, unsigned char vtkType)
+    {
+        for (const auto& element : elements)
+        {
+            for (const auto index : element)
+                cells->connectivity.push_back(static_cast<int>(index));
+            offset += static_cast<int>(element.size());
+            cells->offsets.push_back(offset);
+            cells->types.push_back(vtkType);
+        }
+    };
+
+    if (writeEdges.getValue())
+        addCells(m_topology->getEdges(), 3);
+    if (writeTriangles.getValue())
+        addCells(m_topology->getTriangles(), 5);
+    if (writeQuads.getValue())
+        addCells(m_topology->getQuads(), 9);
+    if (writeTetras.getValue())
+        addCells(m_topology->getTetrahedra(), 10);
+    if (writeHexas.getValue())
+        addCells(m_topology->getHexahedra(), 12);
+
+    m_xmlCells = cells;
+    m_xmlCellsRevision = revision;
+    m_xmlCellsFlags = flags;
+}
+
 void VTKExporter::writeVTKXML()
 {
     std::string filename = vtkFilename.getFullPath();
+    std::string baseName = filename;
 
     std::ostringstream oss;
     oss << nbFiles;
 
     if ( filename.size() > 3 && filename.substr(filename.size()-4)==".vtu")
     {
+        baseName = filename.substr(0,filename.size()-4);
         if (!overwrite.getValue())
-            filename = filename.substr(0,filename.size()-4) + oss.str() + ".vtu";
+            filename = baseName + oss.str() + ".vtu";
     }
     else
     {
@@ -548,27 +655,38 @@ void VTKExporter::writeVTKXML()
         filename += ".vtu";
     }
 
-    outfile = new std::ofstream(filename.c_str());
-    if( !outfile->is_open() )
-    {
-        msg_error() << "Error creating file "<<filename;
-        delete outfile;
-        outfile = nullptr;
-        return;
-    }
-    const type::vector<std::string>& pointsData = dPointsDataFields.getValue();
-    const type::vector<std::string>& cellsData = dCellsDataFields.getValue();
+    std::unique_ptr<XMLSnapshot> snapshot = acquireSnapshot();
+    snapshot->filename = filename;
+    snapshot->pvdFilename = d_writePVD.getValue() ? baseName + ".pvd" : std::string();
+    snapshot->time = this->getContext()->getTime();
+    snapshot->encoding = d_xmlEncoding.getValue().getSelectedId();
 
     helper::ReadAccessor<Data<defaulttype::Vec3Types::VecCoord> > pointsPos = position;
-
     const size_t nbp = (!pointsPos.empty()) ? pointsPos.size() : m_topology->getNbPoints();
 
-    size_t numberOfCells;
-    numberOfCells = ( (writeEdges.getValue()) ? m_topology->getNbEdges() : 0 )
-            +( (writeTriangles.getValue()) ? m_topology->getNbTriangles() : 0 )
-            +( (writeQuads.getValue()) ? m_topology->getNbQuads() : 0 )
-            +( (writeTetras.getValue()) ? m_topology->getNbTetras() : 0 )
-            +( (writeHexas.getValue()) ? m_topology->getNbHexas() : 0 );
+    auto& points = snapshot->points;
+    if (!pointsPos.empty())
+    {
+        points.assign(pointsPos.begin(), pointsPos.end());
+    }
+    else if (m_mstate && m_mstate->getSize() == (size_t)nbp)
+    {
+        points.resize(nbp);
+        for (size_t i = 0; i < nbp; i++)
+            points[i] = { m_mstate->getPX(i), m_mstate->getPY(i), m_mstate->getPZ(i) };
+    }
+    else
+    {
+        points.resize(nbp);
+        for (size_t i = 0; i < nbp; i++)
+            points[i] = { m_topology->getPX(i), m_topology->getPY(i), m_topology->getPZ(i) };
+    }
+
+    updateXMLCells();
+    snapshot->cells = m_xmlCells;
+
+    fetchDataArrays(pointsDataObject, pointsDataField, pointsDataName, snapshot->pointsData);
+    fetchDataArrays(cellsDataObject, cellsDataField, cellsDataName, snapshot->cellsData);
 
     msg_info() << "### VTKExporter[" << this->getName() << "] ###" << msgendl
                << "Nb points: " << nbp << msgendl
@@ -578,172 +696,303 @@ void VTKExporter::writeVTKXML()
                << "Nb tetras: " << ( (writeTetras.getValue()) ? m_topology->getNbTetras() : 0 ) << msgendl
                << "Nb hexas: " << ( (writeHexas.getValue()) ? m_topology->getNbHexas() : 0 ) << msgendl
                << "### ###" << msgendl
-               << "Total nb cells: " << numberOfCells << msgendl;
+               << "Total nb cells: " << m_xmlCells->types.size() << msgendl;
 
-    //write header
-    *outfile << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">" << std::endl;
-    *outfile << "  <UnstructuredGrid>" << std::endl;
+    ++nbFiles;
 
-    //write piece
-    *outfile << "    <Piece NumberOfPoints=\"" << nbp << "\" NumberOfCells=\""<< numberOfCells << "\">" << std::endl;
+    if (d_asynchronous.getValue())
+    {
+        enqueueSnapshot(std::move(snapshot));
+    }
+    else
+    {
+        // files and time series must be written in order
+        stopWriter();
+        writeXMLSnapshot(*snapshot);
+        releaseSnapshot(std::move(snapshot));
+    }
+}
 
-    //write point data
-    if (!pointsData.empty())
+void VTKExporter::writeXMLSnapshot(const XMLSnapshot& snapshot)
+{
+    std::ofstream out(snapshot.filename.c_str(), std::ios::binary);
+    if( !out.is_open() )
     {
-        *outfile << "      <PointData>" << std::endl;
-        writeDataArray(pointsDataObject, pointsDataField, pointsDataName);
-        *outfile << "      </PointData>" << std::endl;
+        msg_error() << "Error creating file " << snapshot.filename;
+        return;
     }
-    //write cell data
-    if (!cellsData.empty())
+
+    if (!writeXMLFile(out, snapshot, snapshot.encoding))
     {
-        *outfile << "      <CellData>" << std::endl;
-        writeDataArray(cellsDataObject, cellsDataField, cellsDataName);
-        *outfile << "      </CellData>" << std::endl;
+        msg_warning() << "zlib failed to compress the arrays of " << snapshot.filename << ": the file is written uncompressed.";
+        out.close();
+        out.open(snapshot.filename.c_str(), std::ios::binary | std::ios::trunc);
+        if( !out.is_open() )
+        {
+            msg_error() << "Error creating file " << snapshot.filename;
+            return;
+        }
+        writeXMLFile(out, snapshot, XMLEncoding::BINARY);
     }
+    out.close();
 
+    if (!snapshot.pvdFilename.empty())
+        writePVDFile(snapshot);
 
+    msg_info() << "Export VTK XML in file " << snapshot.filename << "  done.";
+}
 
-    //write points
-    *outfile << "      <Points>" << std::endl;
-    *outfile << "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">" << std::endl;
-    if (!pointsPos.empty())
+bool VTKExporter::writeXMLFile(std::ostream& out, const XMLSnapshot& snapshot, unsigned int encoding) const
+{
+    const bool ascii = encoding == XMLEncoding::ASCII;
+    const bool compress = encoding == XMLEncoding::COMPRESSED;
+    const XMLSnapshot::Cells& cells = *snapshot.cells;
+
+    std::vector<char> appended;
+    bool compressionSucceeded = true;
+    const auto writeDataArray = [&](const std::string& type, const std::string& name, unsigned int nbComponents,
+                                    const char* data, std::size_t size, const auto& writeASCII)
     {
-        for (size_t i = 0 ; i < nbp; i++)
+        out << "        <DataArray type=\"" << type << "\"";
+        if (!name.empty())
+            out << " Name=\"" << name << "\"";
+        if (nbComponents > 1)
+            out << " NumberOfComponents=\"" << nbComponents << "\"";
+        if (ascii)
         {
-            *outfile << "\t" << pointsPos[i] << std::endl;
+            out << " format=\"ascii\">" << std::endl;
+            writeASCII();
+            out << "        </DataArray>" << std::endl;
         }
-    }
-    else if (m_mstate && m_mstate->getSize() == (size_t)nbp)
+        else
+        {
+            out << " format=\"appended\" offset=\"" << appended.size() << "\"/>" << std::endl;
+            compressionSucceeded = appendBlock(appended, data, size, compress) && compressionSucceeded;
+        }
+    };
+
+    const auto writeSnapshotArray = [&](const XMLSnapshot::DataArray& array)
     {
-        for (size_t i = 0; i < m_mstate->getSize(); i++)
-            *outfile << "          " << m_mstate->getPX(i) << " " << m_mstate->getPY(i) << " " << m_mstate->getPZ(i) << std::endl;
+        writeDataArray(array.type, array.name, array.nbComponents, array.values.data(), array.values.size(), [&]()
+        {
+            if (array.type == "Int32")
+                writeASCIIValues<int>(out, array.values, array.nbComponents);
+            else if (array.type == "UInt32")
+                writeASCIIValues<unsigned int>(out, array.values, array.nbComponents);
+            else if (array.type == "Float32")
+                writeASCIIValues<float>(out, array.values, array.nbComponents);
+            else
+                writeASCIIValues<double>(out, array.values, array.nbComponents);
+        });
+    };
+
+    //write header
+    if (ascii)
+    {
+        out << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">" << std::endl;
     }
     else
     {
-        for (size_t i = 0; i < nbp; i++)
-            *outfile << "          " << m_topology->getPX(i) << " " << m_topology->getPY(i) << " " << m_topology->getPZ(i) << std::endl;
+        out << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << (isLittleEndian() ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\"";
+        if (compress)
+            out << " compressor=\"vtkZLibDataCompressor\"";
+        out << ">" << std::endl;
     }
-    *outfile << "        </DataArray>" << std::endl;
-    *outfile << "      </Points>" << std::endl;
+    out << "  <UnstructuredGrid>" << std::endl;
 
-    //write cells
-    *outfile << "      <Cells>" << std::endl;
-    //write connectivity
-    *outfile << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">" << std::endl;
-    if (writeEdges.getValue())
-    {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
-            *outfile << "          " << m_topology->getEdge(i) << std::endl;
-    }
+    //write piece
+    out << "    <Piece NumberOfPoints=\"" << snapshot.points.size() << "\" NumberOfCells=\""<< cells.types.size() << "\">" << std::endl;
 
-    if (writeTriangles.getValue())
+    //write point data
+    if (!snapshot.pointsData.empty())
     {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-            *outfile << "          " <<  m_topology->getTriangle(i) << std::endl;
+        out << "      <PointData>" << std::endl;
+        for (const auto& array : snapshot.pointsData)
+            writeSnapshotArray(array);
+        out << "      </PointData>" << std::endl;
     }
-    if (writeQuads.getValue())
+    //write cell data
+    if (!snapshot.cellsData.empty())
     {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-            *outfile << "          " << m_topology->getQuad(i) << std::endl;
+        out << "      <CellData>" << std::endl;
+        for (const auto& array : snapshot.cellsData)
+            writeSnapshotArray(array);
+        out << "      </CellData>" << std::endl;
     }
-    if (writeTetras.getValue())
+
+    //write points
+    out << "      <Points>" << std::endl;
+    std::vector<float> points;
+    if (!ascii)
     {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-            *outfile << "          " <<  m_topology->getTetra(i) << std::endl;
+        points.resize(3 * snapshot.points.size());
+        for (size_t i = 0; i < snapshot.points.size(); i++)
+            for (unsigned int c = 0; c < 3; c++)
+                points[3 * i + c] = static_cast<float>(snapshot.points[i][c]);
     }
-    if (writeHexas.getValue())
+    writeDataArray("Float32", "", 3, reinterpret_cast<const char*>(points.data()), points.size() * sizeof(float), [&]()
     {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-            *outfile << "          " <<  m_topology->getHexa(i) << std::endl;
-    }
-    *outfile << "        </DataArray>" << std::endl;
-    //write offsets
-    int num = 0;
-    *outfile << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">" << std::endl;
-    *outfile << "          ";
-    if (writeEdges.getValue())
+        for (const auto& p : snapshot.points)
+            out << "          " << p << std::endl;
+    });
+    out << "      </Points>" << std::endl;
+
+    //write cells
+    out << "      <Cells>" << std::endl;
+    writeDataArray("Int32", "connectivity", 1, reinterpret_cast<const char*>(cells.connectivity.data()), cells.connectivity.size() * sizeof(int), [&]()
     {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
+        std::size_t begin = 0;
+        for (const int offset : cells.offsets)
         {
-            num += 2;
-            *outfile << num << " ";
+            out << "         ";
+            for (std::size_t i = begin; i < static_cast<std::size_t>(offset); ++i)
+                out << " " << cells.connectivity[i];
+            out << std::endl;
+            begin = offset;
         }
-    }
-    if (writeTriangles.getValue())
+    });
+    writeDataArray("Int32", "offsets", 1, reinterpret_cast<const char*>(cells.offsets.data()), cells.offsets.size() * sizeof(int), [&]()
     {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-        {
-            num += 3;
-            *outfile << num << " ";
-        }
-    }
-    if (writeQuads.getValue())
+        out << "          ";
+        for (const int offset : cells.offsets)
+            out << offset << " ";
+        out << std::endl;
+    });
+    writeDataArray("UInt8", "types", 1, reinterpret_cast<const char*>(cells.types.data()), cells.types.size(), [&]()
     {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-        {
-            num += 4;
-            *outfile << num << " ";
-        }
-    }
-    if (writeTetras.getValue())
+        out << "          ";
+        for (const unsigned char type : cells.types)
+            out << static_cast<int>(type) << " ";
+        out << std::endl;
+    });
+    out << "      </Cells>" << std::endl;
+    if (!compressionSucceeded)
+        return false;
+
+    //write end
+    out << "    </Piece>" << std::endl;
+    out << "  </UnstructuredGrid>" << std::endl;
+    if (!ascii)
     {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-        {
-            num += 4;
-            *outfile << num << " ";
-        }
+        out << "  <AppendedData encoding=\"raw\">" << std::endl << "   _";
+        out.write(appended.data(), static_cast<std::streamsize>(appended.size()));
+        out << std::endl << "  </AppendedData>" << std::endl;
     }
-    if (writeHexas.getValue())
+    out << "</VTKFile>" << std::endl;
+    return true;
+}
+
+void VTKExporter::writePVDFile(const XMLSnapshot& snapshot)
+{
+    std::lock_guard<std::mutex> lock(m_pvdMutex);
+
+    // when the file is overwritten, the time series references it once, at its last time
+    const std::string file = sofa::helper::system::SetDirectory::GetFileName(snapshot.filename.c_str());
+    const auto dataSet = std::find_if(m_pvdDataSets.begin(), m_pvdDataSets.end(),
+        [&file](const auto& pvdDataSet) { return pvdDataSet.first == file; });
+    if (dataSet != m_pvdDataSets.end())
     {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-        {
-            num += 8;
-            *outfile << num << " ";
-        }
+        dataSet->second = snapshot.time;
     }
-    *outfile << std::endl;
-    *outfile << "        </DataArray>" << std::endl;
-    //write types
-    *outfile << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">" << std::endl;
-    *outfile << "          ";
-    if (writeEdges.getValue())
+    else
     {
-        for (unsigned int i=0 ; i<m_topology->getNbEdges() ; i++)
-            *outfile << 3 << " ";
+        m_pvdDataSets.emplace_back(file, snapshot.time);
     }
-    if (writeTriangles.getValue())
+
+    std::ofstream out(snapshot.pvdFilename.c_str());
+    if( !out.is_open() )
     {
-        for (unsigned int i=0 ; i<m_topology->getNbTriangles() ; i++)
-            *outfile << 5 << " ";
+        msg_error() << "Error creating file " << snapshot.pvdFilename;
+        return;
     }
-    if (writeQuads.getValue())
+
+    out << "<?xml version=\"1.0\"?>" << std::endl;
+    out << "<VTKFile type=\"Collection\" version=\"0.1\">" << std::endl;
+    out << "  <Collection>" << std::endl;
+    for (const auto& [file, time] : m_pvdDataSets)
     {
-        for (unsigned int i=0 ; i<m_topology->getNbQuads() ; i++)
-            *outfile << 9 << " ";
+        out << "    <DataSet timestep=\"" << time << "\" group=\"\" part=\"0\" file=\"" << file << "\"/>" << std::endl;
     }
-    if (writeTetras.getValue())
+    out << "  </Collection>" << std::endl;
+    out << "</VTKFile>" << std::endl;
+}
+
+std::unique_ptr<VTKExporter::XMLSnapshot> VTKExporter::acquireSnapshot()
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (m_freeSnapshots.empty())
+        return std::make_unique<XMLSnapshot>();
+
+    std::unique_ptr<XMLSnapshot> snapshot = std::move(m_freeSnapshots.back());
+    m_freeSnapshots.pop_back();
+    return snapshot;
+}
+
+void VTKExporter::releaseSnapshot(std::unique_ptr<XMLSnapshot> snapshot)
+{
+    snapshot->cells.reset();
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_freeSnapshots.push_back(std::move(snapshot));
+}
+
+void VTKExporter::enqueueSnapshot(std::unique_ptr<XMLSnapshot> snapshot)
+{
+    const std::size_t maxQueueSize = std::max(1u, d_maxQueueSize.getValue());
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    if (!m_writerThread.joinable())
     {
-        for (unsigned int i=0 ; i<m_topology->getNbTetras() ; i++)
-            *outfile << 10 << " ";
+        m_stopWriter = false;
+        m_writerThread = std::thread(&VTKExporter::writerLoop, this);
     }
-    if (writeHexas.getValue())
+
+    if (m_pendingSnapshots.size() >= maxQueueSize)
     {
-        for (unsigned int i=0 ; i<m_topology->getNbHexas() ; i++)
-            *outfile << 12 << " ";
+        // backpressure: the simulation waits for the writer instead of accumulating copies
+        const auto start = std::chrono::steady_clock::now();
+        m_queueNotFull.wait(lock, [this, maxQueueSize]() { return m_pendingSnapshots.size() < maxQueueSize; });
+        const std::chrono::duration<double, std::milli> waited = std::chrono::steady_clock::now() - start;
+
+        d_nbStalledExports.setValue(d_nbStalledExports.getValue() + 1);
+        d_stallTime.setValue(d_stallTime.getValue() + waited.count());
     }
-    *outfile << std::endl;
-    *outfile << "        </DataArray>" << std::endl;
-    *outfile << "      </Cells>" << std::endl;
 
-    //write end
-    *outfile << "    </Piece>" << std::endl;
-    *outfile << "  </UnstructuredGrid>" << std::endl;
-    *outfile << "</VTKFile>" << std::endl;
-    outfile->close();
-    ++nbFiles;
+    m_pendingSnapshots.push_back(std::move(snapshot));
+    m_queueNotEmpty.notify_one();
+}
+
+void VTKExporter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    while (true)
+    {
+        m_queueNotEmpty.wait(lock, [this]() { return m_stopWriter || !m_pendingSnapshots.empty(); });
+        if (m_pendingSnapshots.empty())
+            return; // stop requested and all the exports are written
 
-    msg_info() << "Export VTK XML in file " << filename << "  done.";
+        std::unique_ptr<XMLSnapshot> snapshot = std::move(m_pendingSnapshots.front());
+        m_pendingSnapshots.pop_front();
+        m_queueNotFull.notify_one();
+
+        lock.unlock();
+        writeXMLSnapshot(*snapshot);
+        snapshot->cells.reset();
+        lock.lock();
+
+        m_freeSnapshots.push_back(std::move(snapshot));
+    }
+}
+
+void VTKExporter::stopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_writerThread.joinable())
+            return;
+        m_stopWriter = true;
+    }
+    m_queueNotEmpty.notify_one();
+    m_writerThread.join();
 }
 
 void VTKExporter::writeParallelFile()
@@ -997,6 +1246,9 @@ void VTKExporter::cleanup()
 {
     if (exportAtEnd.getValue())
         (fileFormat.getValue()) ? writeVTKXML() : writeVTKSimple();
+
+    // make sure all the asynchronous exports are written
+    stopWriter();
 }
 
 } // namespace sofa::component::_vtkexporter_
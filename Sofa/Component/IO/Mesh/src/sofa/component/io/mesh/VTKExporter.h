@@ -27,8 +27,14 @@
 #include <sofa/core/objectmodel/DataFileName.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/helper/OptionsGroup.h>
 
 #include <fstream>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 namespace sofa::component::_vtkexporter_
 {
@@ -45,12 +51,73 @@ protected:
 
     std::ofstream* outfile;
 
+    /// Copy of everything needed to write one XML file, taken on the simulation thread so that
+    /// the file can be encoded and written later, possibly by the writer thread.
+    struct XMLSnapshot
+    {
+        struct DataArray
+        {
+            std::string name;
+            std::string type; ///< VTK type name (Int32, UInt32, Float32 or Float64)
+            unsigned int nbComponents { 1 };
+            std::vector<char> values; ///< raw values, as stored in the exported Data
+        };
+
+        /// Cells are only rebuilt when the topology changes, so snapshots share them
+        struct Cells
+        {
+            type::vector<int> connectivity;
+            type::vector<int> offsets;
+            type::vector<unsigned char> types;
+        };
+
+        std::string filename;
+        std::string pvdFilename; ///< empty if no time series file must be updated
+        SReal time { 0 };
+        unsigned int encoding { 0 };
+        defaulttype::Vec3Types::VecCoord points;
+        std::shared_ptr<const Cells> cells;
+        type::vector<DataArray> pointsData;
+        type::vector<DataArray> cellsData;
+    };
+
+    std::shared_ptr<const XMLSnapshot::Cells> m_xmlCells;
+    int m_xmlCellsRevision { -1 };
+    unsigned int m_xmlCellsFlags { 0 };
+
+    /// Time series (file, time) already written in the PVD file, updated by the thread writing the files
+    type::vector<std::pair<std::string, SReal> > m_pvdDataSets;
+    std::mutex m_pvdMutex;
+
+    /// @name Asynchronous XML export
+    /// @{
+    std::thread m_writerThread;
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueNotEmpty;
+    std::condition_variable m_queueNotFull;
+    std::deque<std::unique_ptr<XMLSnapshot> > m_pendingSnapshots;
+    type::vector<std::unique_ptr<XMLSnapshot> > m_freeSnapshots; ///< recycled snapshots, to reuse their buffers
+    bool m_stopWriter { false };
+
+    std::unique_ptr<XMLSnapshot> acquireSnapshot();
+    void releaseSnapshot(std::unique_ptr<XMLSnapshot> snapshot);
+    void enqueueSnapshot(std::unique_ptr<XMLSnapshot> snapshot);
+    void writerLoop();
+    void stopWriter();
+    /// @}
+
+    void updateXMLCells();
+    void fetchDataArrays(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names, type::vector<XMLSnapshot::DataArray>& arrays);
+    void writeXMLSnapshot(const XMLSnapshot& snapshot);
+    /// Write the snapshot with the given encoding, return false if the arrays could not be compressed
+    bool writeXMLFile(std::ostream& out, const XMLSnapshot& snapshot, unsigned int encoding) const;
+    void writePVDFile(const XMLSnapshot& snapshot);
+
     void fetchDataFields(const type::vector<std::string>& strData, type::vector<std::string>& objects, type::vector<std::string>& fields, type::vector<std::string>& names);
     void writeVTKSimple();
     void writeVTKXML();
     void writeParallelFile();
     void writeData(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names);
-    void writeDataArray(const type::vector<std::string>& objects, const type::vector<std::string>& fields, const type::vector<std::string>& names);
     std::string segmentString(std::string str, unsigned int n);
 
 public:
@@ -68,6 +135,12 @@ public:
     Data<bool> exportAtBegin; ///< export file at the initialization
     Data<bool> exportAtEnd; ///< export file when the simulation is finished
     Data<bool> overwrite; ///< overwrite the file, otherwise create a new file at each export, with suffix in the filename
+    Data<sofa::helper::OptionsGroup> d_xmlEncoding; ///< Encoding of the arrays in XML format: ascii, binary (appended raw) or compressed (appended raw, zlib)
+    Data<bool> d_asynchronous; ///< Write XML files in a background thread, from a copy of the exported data
+    Data<unsigned int> d_maxQueueSize; ///< Maximum number of asynchronous exports waiting to be written before the simulation is blocked
+    Data<bool> d_writePVD; ///< Write a PVD file referencing all the exported XML files with their simulation time
+    Data<unsigned int> d_nbStalledExports; ///< Number of asynchronous exports which had to wait for the writer thread because the queue was full
+    Data<double> d_stallTime; ///< Total time (in ms) the simulation waited for the writer thread
 
     int nbFiles;
 
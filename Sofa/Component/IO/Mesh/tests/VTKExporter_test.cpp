@@ -0,0 +1,169 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/simulation/Node.h>
+using sofa::simulation::Node ;
+
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <sofa/simulation/common/SceneLoaderXML.h>
+using sofa::simulation::SceneLoaderXML ;
+
+#include <sofa/helper/system/FileSystem.h>
+using sofa::helper::system::FileSystem ;
+
+#include <sofa/helper/system/FileRepository.h>
+using sofa::helper::system::FileRepository;
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+const std::string tempdir = FileRepository().getTempPath() ;
+
+class VTKExporter_test : public BaseSimulationTest
+{
+public:
+    std::vector<std::string> dataPath ;
+
+    void SetUp() override
+    {
+        sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+        sofa::simpleapi::importPlugin("Sofa.Component.Topology.Container.Constant");
+    }
+
+    void TearDown() override
+    {
+        for (const auto& pathToRemove : dataPath)
+        {
+            if (FileSystem::exists(pathToRemove))
+                FileSystem::removeFile(pathToRemove);
+        }
+    }
+
+    static std::string readFile(const std::string& filename)
+    {
+        std::ifstream in(filename, std::ios::binary);
+        std::stringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+    /// Export every 2 steps during 4 steps, and unload the scene to flush the asynchronous writer
+    void exportScene(const std::string& attributes)
+    {
+        EXPECT_MSG_NOEMIT(Error, Warning) ;
+        std::stringstream scene;
+        scene <<
+                "<?xml version='1.0'?> \n"
+                "<Node name='Root' gravity='0 0 0' time='0' animate='0' >                 \n"
+                "   <DefaultAnimationLoop/>                                               \n"
+                "   <RequiredPlugin name='Sofa.Component.IO.Mesh' />                      \n"
+                "   <MechanicalObject position='0 0 0  1 0 0  0 1 0  1 1 0'/>             \n"
+                "   <MeshTopology name='topology' position='0 0 0  1 0 0  0 1 0  1 1 0' triangles='0 1 2  1 3 2'/> \n"
+                "   <VTKExporter name='exporter' printLog='false' filename='" << tempdir << "/vtkexport' \n"
+                "                edges='false' triangles='true' exportEveryNumberOfSteps='2' " << attributes << "/> \n"
+                "</Node>                                                                  \n" ;
+
+        const Node::SPtr root = SceneLoaderXML::loadFromMemory("testscene", scene.str().c_str());
+        ASSERT_NE(root.get(), nullptr) << scene.str() ;
+        sofa::simulation::node::initRoot(root.get());
+
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            sofa::simulation::node::animate(root.get(), 0.5);
+        }
+        sofa::simulation::node::unload(root);
+    }
+};
+
+TEST_F(VTKExporter_test, asciiSynchronous)
+{
+    dataPath = {tempdir + "/vtkexport0.vtu", tempdir + "/vtkexport1.vtu"};
+    exportScene("");
+
+    for (const auto& path : dataPath)
+    {
+        ASSERT_TRUE(FileSystem::exists(path)) << path;
+        const std::string content = readFile(path);
+        EXPECT_NE(content.find("format=\"ascii\""), std::string::npos);
+        EXPECT_EQ(content.find("AppendedData"), std::string::npos);
+        EXPECT_NE(content.find("NumberOfPoints=\"4\" NumberOfCells=\"2\""), std::string::npos);
+    }
+}
+
+TEST_F(VTKExporter_test, binaryAsynchronousWithPVD)
+{
+    dataPath = {tempdir + "/vtkexport0.vtu", tempdir + "/vtkexport1.vtu", tempdir + "/vtkexport.pvd"};
+    exportScene("xmlEncoding='binary' asynchronous='true' maxQueueSize='1' pvd='true'");
+
+    for (const auto& path : dataPath)
+    {
+        ASSERT_TRUE(FileSystem::exists(path)) << path;
+    }
+
+    const std::string vtu = readFile(dataPath[0]);
+    EXPECT_NE(vtu.find("format=\"appended\" offset=\"0\""), std::string::npos);
+    EXPECT_NE(vtu.find("<AppendedData encoding=\"raw\">"), std::string::npos);
+    EXPECT_EQ(vtu.find("compressor"), std::string::npos);
+
+    const std::string pvd = readFile(dataPath[2]);
+    EXPECT_NE(pvd.find("file=\"vtkexport0.vtu\""), std::string::npos);
+    EXPECT_NE(pvd.find("file=\"vtkexport1.vtu\""), std::string::npos);
+}
+
+TEST_F(VTKExporter_test, overwriteWithPVD)
+{
+    dataPath = {tempdir + "/vtkexport.vtu", tempdir + "/vtkexport.pvd"};
+    exportScene("overwrite='true' asynchronous='true' pvd='true'");
+
+    for (const auto& path : dataPath)
+    {
+        ASSERT_TRUE(FileSystem::exists(path)) << path;
+    }
+
+    /// the overwritten file is referenced once in the time series
+    const std::string pvd = readFile(dataPath[1]);
+    const auto dataSet = pvd.find("<DataSet");
+    ASSERT_NE(dataSet, std::string::npos);
+    EXPECT_EQ(pvd.find("<DataSet", dataSet + 1), std::string::npos);
+    EXPECT_NE(pvd.find("file=\"vtkexport.vtu\""), std::string::npos);
+}
+
+TEST_F(VTKExporter_test, compressed)
+{
+    dataPath = {tempdir + "/vtkexport0.vtu", tempdir + "/vtkexport1.vtu"};
+    exportScene("xmlEncoding='compressed' asynchronous='true'");
+
+    for (const auto& path : dataPath)
+    {
+        ASSERT_TRUE(FileSystem::exists(path)) << path;
+        const std::string content = readFile(path);
+        EXPECT_NE(content.find("compressor=\"vtkZLibDataCompressor\""), std::string::npos);
+        EXPECT_NE(content.find("<AppendedData encoding=\"raw\">"), std::string::npos);
+    }
+}
+
+}
@@ -30,7 +30,9 @@
 #include <sofa/helper/map.h>
 #include <cmath>
 #include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/linearalgebra/PrecomputedMatrixFile.h>
 #include <fstream>
+#include <algorithm>
 
 namespace sofa::component::linearsolver::direct
 {
@@ -67,6 +69,54 @@ public :
         compFileOut.write((char*) Minv[0], systemSize * systemSize*sizeof(Real));
         compFileOut.close();
     }
+
+    /// Use the inverse saved by writeMappedFile, without loading it: Minv points to the mapped values, which are
+    /// read-only. Minv must not be allocated yet, nor modified before a call to detachMappedFile.
+    bool mapFile(const char * filename, unsigned systemSize)
+    {
+        if (!sofa::linearalgebra::PrecomputedMatrixFile::hasValidHeader(filename) || !mappedFile.open(filename))
+        {
+            return false;
+        }
+
+        const Real* values = mappedFile.data<Real>();
+        if (mappedFile.rowSize() != systemSize || mappedFile.colSize() != systemSize || values == nullptr)
+        {
+            msg_error("PrecomputedLinearSolverInternalData") << "file '" << filename << "' does not contain an uncompressed inverse of size " << systemSize;
+            mappedFile.close();
+            return false;
+        }
+
+        msg_info("PrecomputedLinearSolverInternalData") << "file '" << filename << "' with compliance being memory-mapped." ;
+
+        // the matrix is only read: it can wrap the read-only mapping, which it does not own
+        Minv = TBaseMatrix(const_cast<Real*>(values), systemSize, systemSize);
+        return true;
+    }
+
+    /// Copy the mapped inverse in memory, so that Minv can be modified
+    void detachMappedFile(unsigned systemSize)
+    {
+        if (!mappedFile.isOpen())
+        {
+            return;
+        }
+
+        const Real* values = mappedFile.data<Real>();
+        Minv = TBaseMatrix();
+        Minv.resize(systemSize, systemSize);
+        std::copy(values, values + std::size_t(systemSize) * systemSize, Minv[0]);
+        mappedFile.close();
+    }
+
+    void writeMappedFile(const char * filename, unsigned systemSize)
+    {
+        sofa::linearalgebra::PrecomputedMatrixFile::Options options;
+        options.singlePrecision = std::is_same_v<Real, float>;
+        sofa::linearalgebra::PrecomputedMatrixFile::write(filename, Minv[0], systemSize, systemSize, options);
+    }
+
+    sofa::linearalgebra::PrecomputedMatrixFile mappedFile;
 };
 
 /// Linear system solver based on a precomputed inverse matrix
@@ -83,6 +133,7 @@ public:
     Data<bool> jmjt_twostep; ///< Use two step algorithm to compute JMinvJt
     Data<bool> use_file; ///< Dump system matrix in a file
     Data<double> init_Tolerance;
+    Data<bool> d_memoryMapped; ///< Save the inverse in a file which is memory-mapped instead of being loaded in memory
 
     SOFA_ATTRIBUTE_DISABLED__SOLVER_DIRECT_VERBOSEDATA()
     sofa::core::objectmodel::lifecycle::RemovedData f_verbose{this, "v23.12", "v24.06", "verbose", "This Data is no longer used"};
@@ -103,7 +154,14 @@ public:
         return TVector::Name();
     }
 
+    /// The inverse can be modified: if it is memory-mapped, it is first copied in memory (copy-on-write)
     TBaseMatrix * getSystemMatrixInv()
+    {
+        internalData.detachMappedFile(systemSize);
+        return &internalData.Minv;
+    }
+
+    const TBaseMatrix * getSystemMatrixInv() const
     {
         return &internalData.Minv;
     }
@@ -48,6 +48,7 @@ template<class TMatrix,class TVector>
 PrecomputedLinearSolver<TMatrix,TVector>::PrecomputedLinearSolver()
     : jmjt_twostep( initData(&jmjt_twostep,true,"jmjt_twostep","Use two step algorithm to compute JMinvJt") )
     , use_file( initData(&use_file,true,"use_file","Dump system matrix in a file") )
+    , d_memoryMapped( initData(&d_memoryMapped, false, "memoryMapped", "Save the inverse in a file which is memory-mapped instead of being loaded in memory: its pages are read on demand and shared between all the instances and processes using it") )
 {
     first = true;
 }
@@ -75,7 +76,6 @@ template<class TMatrix,class TVector>
 void PrecomputedLinearSolver<TMatrix,TVector >::loadMatrix(TMatrix& M)
 {
     systemSize = this->getSystemMatrix()->rowSize();
-    internalData.Minv.resize(systemSize,systemSize);
     dt = this->getContext()->getDt();
 
     sofa::core::behavior::OdeSolver::SPtr odeSolver;
@@ -83,12 +83,21 @@ void PrecomputedLinearSolver<TMatrix,TVector >::loadMatrix(TMatrix& M)
     factInt = 1.0; // christian : it is not a compliance... but an admittance that is computed !
     if (odeSolver) factInt = odeSolver->getPositionIntegrationFactor(); // here, we compute a compliance
 
+    const bool memoryMapped = use_file.getValue() && d_memoryMapped.getValue();
     std::stringstream ss;
-    ss << this->getContext()->getName() << "-" << systemSize << "-" << dt << ".comp";
-    if(! use_file.getValue() || ! internalData.readFile(ss.str().c_str(),systemSize) )
+    ss << this->getContext()->getName() << "-" << systemSize << "-" << dt << (memoryMapped ? ".mcomp" : ".comp");
+
+    // the memory-mapped file stores the final inverse, already divided by the integration factor
+    if (memoryMapped && internalData.mapFile(ss.str().c_str(), systemSize))
+    {
+        return;
+    }
+
+    internalData.Minv.resize(systemSize,systemSize);
+    if(memoryMapped || ! use_file.getValue() || ! internalData.readFile(ss.str().c_str(),systemSize) )
     {
         loadMatrixWithCholeskyDecomposition(M);
-        if (use_file.getValue()) internalData.writeFile(ss.str().c_str(),systemSize);
+        if (use_file.getValue() && !memoryMapped) internalData.writeFile(ss.str().c_str(),systemSize);
     }
 
     for (unsigned int j=0; j<systemSize; j++)
@@ -98,6 +107,11 @@ void PrecomputedLinearSolver<TMatrix,TVector >::loadMatrix(TMatrix& M)
             internalData.Minv.set(j,i,internalData.Minv.element(j,i)/factInt);
         }
     }
+
+    if (memoryMapped)
+    {
+        internalData.writeMappedFile(ss.str().c_str(), systemSize);
+    }
 }
 
 template<class TMatrix,class TVector>
@@ -0,0 +1,66 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsolver/direct/PrecomputedLinearSolver.h>
+
+#include <filesystem>
+
+
+TEST(PrecomputedLinearSolver, memoryMappedInverseIsCopiedOnWrite)
+{
+    using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+    using InternalData = sofa::component::linearsolver::direct::PrecomputedLinearSolverInternalData<MatrixType, sofa::linearalgebra::FullVector<SReal> >;
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "PrecomputedLinearSolver_test.mcomp").string();
+    constexpr unsigned int systemSize = 3;
+
+    InternalData saved;
+    saved.Minv.resize(systemSize, systemSize);
+    for (unsigned int i = 0; i < systemSize; ++i)
+    {
+        for (unsigned int j = 0; j < systemSize; ++j)
+        {
+            saved.Minv.set(i, j, static_cast<SReal>(i * systemSize + j));
+        }
+    }
+    saved.writeMappedFile(filename.c_str(), systemSize);
+
+    InternalData mapped;
+    ASSERT_TRUE(mapped.mapFile(filename.c_str(), systemSize));
+    EXPECT_TRUE(mapped.mappedFile.isOpen());
+    EXPECT_EQ(mapped.Minv.element(1, 2), 5);
+
+    // the mapping is read-only: the values are copied before being modified
+    mapped.detachMappedFile(systemSize);
+    EXPECT_FALSE(mapped.mappedFile.isOpen());
+    EXPECT_EQ(mapped.Minv.element(1, 2), 5);
+    mapped.Minv.set(1, 2, 42);
+    EXPECT_EQ(mapped.Minv.element(1, 2), 42);
+
+    // the file is not modified
+    InternalData remapped;
+    ASSERT_TRUE(remapped.mapFile(filename.c_str(), systemSize));
+    EXPECT_EQ(remapped.Minv.element(1, 2), 5);
+    remapped.mappedFile.close();
+
+    std::filesystem::remove(filename);
+}
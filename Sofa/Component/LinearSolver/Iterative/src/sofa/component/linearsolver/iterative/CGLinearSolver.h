@@ -60,6 +60,10 @@ protected:
     int timeStepCount{0};
     bool equilibriumReached{false};
 
+    /// Tolerance overriding d_tolerance for the next solve only (negative if not set)
+    Real m_nextTolerance{-1};
+    unsigned int m_nbIterations{0};
+
 public:
     void init() override;
     void reinit() override {};
@@ -70,6 +74,9 @@ public:
 
     /// Solve iteratively the linear system Ax=b following a conjugate gradient descent
     void solve (Matrix& A, Vector& x, Vector& b) override;
+
+    bool setNextRelativeTolerance(SReal tolerance) override;
+    unsigned int getNbIterations() const override { return m_nbIterations; }
 };
 
 template<>
@@ -36,6 +36,7 @@
 #include <sofa/core/behavior/BaseLocalForceFieldMatrix.h>
 #include <sofa/core/behavior/BaseLocalMassMatrix.h>
 #include <sofa/core/MechanicalParams.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/ParallelForEach.h>
 
@@ -100,6 +101,9 @@ void MatrixLinearSystem<TMatrix, TVector>::contribute(
         {
             if (Inherit1::template getContributionFactor<c>(mparams, component) != 0._sreal)
             {
+                core::objectmodel::PerformanceCounters::Scope performance(component,
+                    core::objectmodel::PerformanceCounterType::BuildStiffnessMatrix,
+                    [component] { return core::objectmodel::PerformanceCounters::getForceFieldBytes(component, 1, 0); });
                 component->buildStiffnessMatrix(&stiffnessMatrix);
             }
         }
@@ -0,0 +1,39 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_COMPONENT_MAPPING_LINEAR_MODALMAPPING_CPP
+#include <sofa/component/mapping/linear/ModalMapping.inl>
+
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/defaulttype/VecTypes.h>
+
+namespace sofa::component::mapping::linear
+{
+
+using namespace sofa::defaulttype;
+
+int ModalMappingClass = core::RegisterObject("Reconstruct the positions of a deformable model from reduced coordinates on a modal or POD basis")
+        .add< ModalMapping< Vec1Types, Vec3Types > >(true)
+        ;
+
+template class SOFA_COMPONENT_MAPPING_LINEAR_API ModalMapping< Vec1Types, Vec3Types >;
+
+} // namespace sofa::component::mapping::linear
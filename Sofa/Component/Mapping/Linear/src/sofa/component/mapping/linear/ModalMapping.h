@@ -0,0 +1,117 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/mapping/linear/config.h>
+#include <sofa/component/mapping/linear/LinearMapping.h>
+#include <sofa/component/mapping/linear/ReducedBasis.h>
+
+#include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/linearalgebra/EigenSparseMatrix.h>
+#include <sofa/type/vector.h>
+
+
+namespace sofa::component::mapping::linear
+{
+
+/**
+ * @class ModalMapping
+ * @brief Reconstruct the positions of a deformable model from reduced coordinates on a modal or POD basis
+ *
+ * x = x0 + sum_k q_k * mode_k, where q are the reduced coordinates (input) and x0 the rest positions of the output.
+ * The basis is loaded from basisFile, or computed at init by POD of the states recorded by WriteState in
+ * snapshotsFile (and then saved in basisFile if set, to be reused by the next runs).
+ *
+ * The output can be a subset of the points of the basis (indices), e.g. the vertices of the elements selected by
+ * TetrahedronCubature, to evaluate the internal forces on a few elements only, while another ModalMapping
+ * reconstructs the full-resolution visual model.
+ * The reduced mass is the projection of the full mass on the basis: with orthonormal POD modes and a uniform mass,
+ * it is a UniformMass on the reduced coordinates, of the mass of a vertex of the full model.
+ */
+template <class TIn, class TOut>
+class ModalMapping : public LinearMapping<TIn, TOut>
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE2(ModalMapping,TIn,TOut), SOFA_TEMPLATE2(LinearMapping,TIn,TOut));
+
+    typedef LinearMapping<TIn, TOut> Inherit;
+    typedef TIn In;
+    typedef TOut Out;
+
+    typedef typename Out::Real        Real;
+    typedef typename In::VecCoord     InVecCoord;
+    typedef typename In::VecDeriv     InVecDeriv;
+    typedef typename In::MatrixDeriv  InMatrixDeriv;
+    typedef typename Out::VecCoord    OutVecCoord;
+    typedef typename Out::VecDeriv    OutVecDeriv;
+    typedef typename Out::MatrixDeriv OutMatrixDeriv;
+
+    enum { NIn = sofa::defaulttype::DataTypeInfo<typename In::Deriv>::Size };
+    enum { NOut = sofa::defaulttype::DataTypeInfo<typename Out::Deriv>::Size };
+
+    typedef linearalgebra::EigenSparseMatrix<TIn,TOut> SparseMatrixEigen;
+
+    core::objectmodel::DataFileName d_basisFile; ///< File of the reduced basis, read if it exists, written after a POD otherwise
+    core::objectmodel::DataFileName d_snapshotsFile; ///< States recorded by WriteState, used to compute a POD basis if basisFile does not exist
+    Data<unsigned int> d_nbModes; ///< Maximum number of modes of the POD basis (0 for no limit)
+    Data<Real> d_energyRatio; ///< Ratio of the energy of the snapshots captured by the POD basis
+    Data<type::vector<Index> > d_indices; ///< Points of the basis mapped to the output (all of them if empty)
+    Data<Real> d_sparsityThreshold; ///< Coefficients of the modes below this value are ignored in the Jacobian
+    Data<type::vector<SReal> > d_singularValues; ///< Output: singular values of the modes used
+
+    /// Set the basis directly, instead of reading or computing it at init
+    void setBasis(const ReducedBasis& basis) { m_basis = basis; }
+    const ReducedBasis& getBasis() const { return m_basis; }
+
+    void init() override;
+
+    void apply(const core::MechanicalParams* mparams, Data<OutVecCoord>& out, const Data<InVecCoord>& in) override;
+
+    void applyJ(const core::MechanicalParams* mparams, Data<OutVecDeriv>& out, const Data<InVecDeriv>& in) override;
+
+    void applyJT(const core::MechanicalParams* mparams, Data<InVecDeriv>& out, const Data<OutVecDeriv>& in) override;
+
+    void applyJT(const core::ConstraintParams* cparams, Data<InMatrixDeriv>& out, const Data<OutMatrixDeriv>& in) override;
+
+    const sofa::linearalgebra::BaseMatrix* getJ() override;
+    const type::vector<sofa::linearalgebra::BaseMatrix*>* getJs() override;
+
+protected:
+    ModalMapping();
+    ~ModalMapping() override = default;
+
+    /// Read or compute the basis. Returns false if no basis is available.
+    bool initBasis();
+
+    /// Build the Jacobian (the rows of the modes for the mapped points)
+    void buildJacobian();
+
+    ReducedBasis m_basis;
+    OutVecCoord m_restPositions;
+    SparseMatrixEigen m_jacobian;
+    type::vector<sofa::linearalgebra::BaseMatrix*> m_baseMatrices;
+};
+
+#if !defined(SOFA_COMPONENT_MAPPING_LINEAR_MODALMAPPING_CPP)
+extern template class SOFA_COMPONENT_MAPPING_LINEAR_API ModalMapping< sofa::defaulttype::Vec1Types, sofa::defaulttype::Vec3Types >;
+#endif
+
+} // namespace sofa::component::mapping::linear
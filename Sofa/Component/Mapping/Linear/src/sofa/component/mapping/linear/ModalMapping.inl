@@ -0,0 +1,225 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/mapping/linear/ModalMapping.h>
+#include <sofa/core/Mapping.inl>
+#include <sofa/core/ConstraintParams.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrixConstraintEigenUtils.h>
+
+namespace sofa::component::mapping::linear
+{
+
+template <class TIn, class TOut>
+ModalMapping<TIn, TOut>::ModalMapping()
+    : Inherit()
+    , d_basisFile(initData(&d_basisFile, "basisFile", "File of the reduced basis, read if it exists, written after a POD of the snapshots otherwise"))
+    , d_snapshotsFile(initData(&d_snapshotsFile, "snapshotsFile", "States recorded by WriteState (uncompressed), used to compute a POD basis if basisFile does not exist. The first state is the reference configuration"))
+    , d_nbModes(initData(&d_nbModes, 0u, "nbModes", "Maximum number of modes of the POD basis (0 for no limit)"))
+    , d_energyRatio(initData(&d_energyRatio, (Real)0.9999, "energyRatio", "Ratio of the energy of the snapshots captured by the POD basis"))
+    , d_indices(initData(&d_indices, "indices", "Points of the basis mapped to the output (all of them if empty)"))
+    , d_sparsityThreshold(initData(&d_sparsityThreshold, (Real)0, "sparsityThreshold", "Coefficients of the modes whose absolute value is not greater than this threshold are ignored in the Jacobian"))
+    , d_singularValues(initData(&d_singularValues, "singularValues", "Singular values of the modes used"))
+{
+    d_singularValues.setReadOnly(true);
+}
+
+template <class TIn, class TOut>
+bool ModalMapping<TIn, TOut>::initBasis()
+{
+    if (!m_basis.empty())
+    {
+        return true;
+    }
+
+    const std::string& basisFile = d_basisFile.getFullPath();
+    if (!basisFile.empty() && sofa::helper::system::FileSystem::exists(basisFile))
+    {
+        msg_info() << "Reading the basis from " << basisFile;
+        return m_basis.load(basisFile);
+    }
+
+    const std::string& snapshotsFile = d_snapshotsFile.getFullPath();
+    if (snapshotsFile.empty())
+    {
+        msg_error() << "No basis: either basisFile or snapshotsFile must be set";
+        return false;
+    }
+
+    type::vector<ReducedBasis::VecReal> snapshots;
+    if (!ReducedBasis::readSnapshots(snapshotsFile, snapshots))
+    {
+        return false;
+    }
+
+    m_basis = ReducedBasis::computePOD(snapshots, d_nbModes.getValue(), d_energyRatio.getValue());
+    if (m_basis.empty())
+    {
+        msg_error() << "No displacement in the snapshots of " << snapshotsFile;
+        return false;
+    }
+    msg_info() << m_basis.nbModes() << " modes computed from " << snapshots.size() << " snapshots";
+
+    if (!basisFile.empty())
+    {
+        m_basis.save(basisFile);
+    }
+    return true;
+}
+
+template <class TIn, class TOut>
+void ModalMapping<TIn, TOut>::init()
+{
+    if (!initBasis())
+    {
+        this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    const std::size_t nbPoints = m_basis.nbDofs() / NOut;
+    const auto& indices = d_indices.getValue();
+    for (const Index index : indices)
+    {
+        if (index >= nbPoints)
+        {
+            msg_error() << "Incorrect index " << index << " (the basis has " << nbPoints << " points)";
+            this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+            return;
+        }
+    }
+
+    const std::size_t outSize = indices.empty() ? nbPoints : indices.size();
+    if (this->toModel->getSize() != outSize)
+    {
+        msg_error() << "The output has " << this->toModel->getSize() << " points, " << outSize << " are expected from the basis";
+        this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Invalid);
+        return;
+    }
+
+    this->fromModel->resize(Size(m_basis.nbModes()));
+    m_restPositions = this->toModel->read(core::ConstVecCoordId::restPosition())->getValue();
+    d_singularValues.setValue(m_basis.singularValues);
+
+    buildJacobian();
+
+    Inherit::init();
+
+    this->d_componentState.setValue(sofa::core::objectmodel::ComponentState::Valid);
+}
+
+template <class TIn, class TOut>
+void ModalMapping<TIn, TOut>::buildJacobian()
+{
+    const auto& indices = d_indices.getValue();
+    const Real threshold = d_sparsityThreshold.getValue();
+    const std::size_t outSize = m_restPositions.size();
+
+    m_jacobian.resizeBlocks(outSize, m_basis.nbModes());
+    for (std::size_t i = 0; i < outSize; ++i)
+    {
+        const std::size_t point = indices.empty() ? i : indices[i];
+        for (unsigned int c = 0; c < NOut; ++c)
+        {
+            const std::size_t row = i * NOut + c;
+            const std::size_t dof = point * NOut + c;
+            m_jacobian.beginRow(row);
+            for (std::size_t k = 0; k < m_basis.nbModes(); ++k)
+            {
+                const SReal value = m_basis.modes[k][dof];
+                if (std::abs(value) > threshold)
+                {
+                    m_jacobian.insertBack(row, k * NIn, value);
+                }
+            }
+        }
+    }
+    m_jacobian.compress();
+
+    m_baseMatrices.resize(1);
+    m_baseMatrices[0] = &m_jacobian;
+
+    msg_info() << "Jacobian of " << m_jacobian.rowSize() << "x" << m_jacobian.colSize() << " with " << m_jacobian.compressedMatrix.nonZeros() << " non-zeros";
+}
+
+template <class TIn, class TOut>
+void ModalMapping<TIn, TOut>::apply(const core::MechanicalParams* /*mparams*/, Data<OutVecCoord>& dOut, const Data<InVecCoord>& dIn)
+{
+    if (!this->isComponentStateValid())
+    {
+        return;
+    }
+
+    auto out = sofa::helper::getWriteOnlyAccessor(dOut);
+    auto in = sofa::helper::getReadAccessor(dIn);
+
+    // the displacements are linear in the reduced coordinates
+    m_jacobian.mult(out.wref(), in.ref());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        out[i] += m_restPositions[i];
+    }
+}
+
+template <class TIn, class TOut>
+void ModalMapping<TIn, TOut>::applyJ(const core::MechanicalParams* /*mparams*/, Data<OutVecDeriv>& dOut, const Data<InVecDeriv>& dIn)
+{
+    if (m_jacobian.rowSize())
+    {
+        auto out = sofa::helper::getWriteOnlyAccessor(dOut);
+        auto in = sofa::helper::getReadAccessor(dIn);
+        m_jacobian.mult(out.wref(), in.ref());
+    }
+}
+
+template <class TIn, class TOut>
+void ModalMapping<TIn, TOut>::applyJT(const core::MechanicalParams* /*mparams*/, Data<InVecDeriv>& dOut, const Data<OutVecDeriv>& dIn)
+{
+    if (m_jacobian.rowSize())
+    {
+        auto in = sofa::helper::getReadAccessor(dIn);
+        auto out = sofa::helper::getWriteAccessor(dOut);
+        m_jacobian.addMultTranspose(out.wref(), in.ref());
+    }
+}
+
+template <class TIn, class TOut>
+void ModalMapping<TIn, TOut>::applyJT(const core::ConstraintParams* /*cparams*/, Data<InMatrixDeriv>& dOut, const Data<OutMatrixDeriv>& dIn)
+{
+    auto in = sofa::helper::getReadAccessor(dIn);
+    auto out = sofa::helper::getWriteAccessor(dOut);
+    addMultTransposeEigen(out.wref(), m_jacobian.compressedMatrix, in.ref());
+}
+
+template <class TIn, class TOut>
+const sofa::linearalgebra::BaseMatrix* ModalMapping<TIn, TOut>::getJ()
+{
+    return &m_jacobian;
+}
+
+template <class TIn, class TOut>
+const type::vector<sofa::linearalgebra::BaseMatrix*>* ModalMapping<TIn, TOut>::getJs()
+{
+    return &m_baseMatrices;
+}
+
+} // namespace sofa::component::mapping::linear
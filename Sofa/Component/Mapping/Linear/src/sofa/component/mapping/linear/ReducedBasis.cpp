@@ -0,0 +1,196 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/mapping/linear/ReducedBasis.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace sofa::component::mapping::linear
+{
+
+namespace
+{
+constexpr char basisFileTag[] = "SOFA_REDUCED_BASIS";
+}
+
+bool ReducedBasis::save(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        msg_error("ReducedBasis") << "Cannot write the file " << filename;
+        return false;
+    }
+
+    const std::uint64_t sizes[2] { nbModes(), nbDofs() };
+    file.write(basisFileTag, sizeof(basisFileTag));
+    file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    file.write(reinterpret_cast<const char*>(singularValues.data()), std::streamsize(nbModes() * sizeof(SReal)));
+    for (const auto& mode : modes)
+    {
+        file.write(reinterpret_cast<const char*>(mode.data()), std::streamsize(mode.size() * sizeof(SReal)));
+    }
+    return file.good();
+}
+
+bool ReducedBasis::load(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        msg_error("ReducedBasis") << "Cannot read the file " << filename;
+        return false;
+    }
+
+    char tag[sizeof(basisFileTag)] {};
+    std::uint64_t sizes[2] {};
+    file.read(tag, sizeof(tag));
+    file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    if (!file.good() || std::string(tag) != basisFileTag)
+    {
+        msg_error("ReducedBasis") << "The file " << filename << " does not contain a reduced basis";
+        return false;
+    }
+
+    singularValues.resize(sizes[0]);
+    modes.resize(sizes[0]);
+    file.read(reinterpret_cast<char*>(singularValues.data()), std::streamsize(sizes[0] * sizeof(SReal)));
+    for (auto& mode : modes)
+    {
+        mode.resize(sizes[1]);
+        file.read(reinterpret_cast<char*>(mode.data()), std::streamsize(sizes[1] * sizeof(SReal)));
+    }
+
+    if (!file.good())
+    {
+        msg_error("ReducedBasis") << "The file " << filename << " is truncated";
+        modes.clear();
+        singularValues.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ReducedBasis::readSnapshots(const std::string& filename, type::vector<VecReal>& snapshots)
+{
+    if (filename.size() >= 3 && filename.substr(filename.size() - 3) == ".gz")
+    {
+        msg_error("ReducedBasis") << "Compressed snapshots are not supported, decompress " << filename << " first";
+        return false;
+    }
+
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        msg_error("ReducedBasis") << "Cannot read the file " << filename;
+        return false;
+    }
+
+    snapshots.clear();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream str(line);
+        std::string tag;
+        if (!(str >> tag) || tag != "X=")
+        {
+            continue;
+        }
+
+        VecReal& snapshot = snapshots.emplace_back();
+        SReal value;
+        while (str >> value)
+        {
+            snapshot.push_back(value);
+        }
+
+        if (snapshot.size() != snapshots.front().size())
+        {
+            msg_error("ReducedBasis") << "The snapshots of " << filename << " do not have the same size";
+            return false;
+        }
+    }
+
+    return !snapshots.empty();
+}
+
+ReducedBasis ReducedBasis::computePOD(const type::vector<VecReal>& snapshots, std::size_t maxNbModes, SReal energyRatio)
+{
+    using Matrix = Eigen::Matrix<SReal, Eigen::Dynamic, Eigen::Dynamic>;
+
+    ReducedBasis basis;
+    if (snapshots.size() < 2)
+    {
+        return basis;
+    }
+
+    // displacements relatively to the first snapshot, one per column
+    const Eigen::Index nbDofs = Eigen::Index(snapshots.front().size());
+    const Eigen::Index nbColumns = Eigen::Index(snapshots.size() - 1);
+    Matrix displacements(nbDofs, nbColumns);
+    for (Eigen::Index j = 0; j < nbColumns; ++j)
+    {
+        for (Eigen::Index i = 0; i < nbDofs; ++i)
+        {
+            displacements(i, j) = snapshots[j + 1][i] - snapshots[0][i];
+        }
+    }
+
+    // the eigen values of the Gram matrix are the squared singular values of the displacements
+    const Matrix gram = displacements.transpose() * displacements;
+    const Eigen::SelfAdjointEigenSolver<Matrix> eigenSolver(gram);
+    const auto& eigenValues = eigenSolver.eigenvalues();   // increasing order
+    const Matrix& eigenVectors = eigenSolver.eigenvectors();
+
+    const SReal totalEnergy = eigenValues.sum();
+    if (totalEnergy <= 0)
+    {
+        return basis;
+    }
+
+    const SReal tolerance = eigenValues(nbColumns - 1) * std::numeric_limits<SReal>::epsilon() * SReal(nbColumns);
+    SReal energy = 0;
+    for (Eigen::Index k = nbColumns - 1; k >= 0; --k)
+    {
+        if (eigenValues(k) <= tolerance || (maxNbModes > 0 && basis.nbModes() >= maxNbModes) || energy >= energyRatio * totalEnergy)
+        {
+            break;
+        }
+
+        const SReal singularValue = std::sqrt(eigenValues(k));
+        const Eigen::Matrix<SReal, Eigen::Dynamic, 1> mode = displacements * eigenVectors.col(k) / singularValue;
+
+        basis.modes.emplace_back(mode.data(), mode.data() + nbDofs);
+        basis.singularValues.push_back(singularValue);
+        energy += eigenValues(k);
+    }
+
+    return basis;
+}
+
+} // namespace sofa::component::mapping::linear
@@ -0,0 +1,72 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/mapping/linear/config.h>
+
+#include <sofa/type/vector.h>
+#include <string>
+
+namespace sofa::component::mapping::linear
+{
+
+/**
+ * Reduced basis of a deformable model: a set of displacement modes, each one holding one scalar per
+ * degree of freedom of the full model.
+ *
+ * The basis is either computed by Proper Orthogonal Decomposition (POD) of recorded states, or loaded from
+ * a file written by a previous run, or by an external modal analysis.
+ */
+class SOFA_COMPONENT_MAPPING_LINEAR_API ReducedBasis
+{
+public:
+    typedef type::vector<SReal> VecReal;
+
+    /// modes[k] is the k-th displacement mode
+    type::vector<VecReal> modes;
+
+    /// singular value associated to each mode (1 for modes without any)
+    VecReal singularValues;
+
+    std::size_t nbModes() const { return modes.size(); }
+    std::size_t nbDofs() const { return modes.empty() ? 0 : modes.front().size(); }
+    bool empty() const { return modes.empty(); }
+
+    /// Write the basis in a binary file. Returns false in case of failure.
+    bool save(const std::string& filename) const;
+
+    /// Read a basis from a binary file written by save. Returns false in case of failure.
+    bool load(const std::string& filename);
+
+    /// Read the positions recorded by the WriteState component in a (non compressed) file.
+    /// Returns false in case of failure.
+    static bool readSnapshots(const std::string& filename, type::vector<VecReal>& snapshots);
+
+    /**
+     * Compute the POD basis of the displacements of the snapshots relatively to the first one, using the
+     * method of snapshots (eigen decomposition of the small Gram matrix of the displacements).
+     * The modes are orthonormal and sorted by decreasing singular value. The number of modes is the smallest one
+     * capturing energyRatio of the energy of the displacements, bounded by maxNbModes (if not 0).
+     */
+    static ReducedBasis computePOD(const type::vector<VecReal>& snapshots, std::size_t maxNbModes, SReal energyRatio);
+};
+
+} // namespace sofa::component::mapping::linear
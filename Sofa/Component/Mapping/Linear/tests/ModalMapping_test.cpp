@@ -0,0 +1,184 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/mapping/linear/ModalMapping.h>
+#include <sofa/component/mapping/linear/ReducedBasis.h>
+
+#include <sofa/component/mapping/testing/MappingTestCreation.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace sofa {
+namespace {
+
+using component::mapping::linear::ModalMapping;
+using component::mapping::linear::ReducedBasis;
+
+/// Two modes on three points: a translation along x of all the points, and a bending of the last point along y
+ReducedBasis createBasis()
+{
+    ReducedBasis basis;
+    basis.modes.push_back({ 1,0,0, 1,0,0, 1,0,0 });
+    basis.modes.push_back({ 0,0,0, 0,0.5,0, 0,1,0 });
+    basis.singularValues = ReducedBasis::VecReal({ 2, 1 });
+    return basis;
+}
+
+/**  Test suite for ModalMapping.
+  */
+struct ModalMappingTest : public sofa::mapping_test::Mapping_test<ModalMapping<defaulttype::Vec1Types, defaulttype::Vec3Types> >
+{
+    typedef ModalMapping<defaulttype::Vec1Types, defaulttype::Vec3Types> ModalMappingType;
+
+    ModalMappingType* modalMapping() { return static_cast<ModalMappingType*>(this->mapping); }
+
+    bool testAllPoints()
+    {
+        modalMapping()->setBasis(createBasis());
+
+        const OutVecCoord rest { {0,0,0}, {1,0,0}, {2,0,0} };
+        const InVecCoord parentInit(2);
+        const InVecCoord parentNew { type::Vec1(0.5), type::Vec1(2) };
+        const OutVecCoord expected { {0.5,0,0}, {1.5,1,0}, {2.5,2,0} };
+
+        return this->runTest(parentInit, rest, parentNew, expected);
+    }
+
+    bool testSubset()
+    {
+        modalMapping()->setBasis(createBasis());
+        modalMapping()->d_indices.setValue({ 2, 0 });
+
+        const OutVecCoord rest { {2,0,0}, {0,0,0} };
+        const InVecCoord parentInit(2);
+        const InVecCoord parentNew { type::Vec1(-1), type::Vec1(3) };
+        const OutVecCoord expected { {1,3,0}, {-1,0,0} };
+
+        return this->runTest(parentInit, rest, parentNew, expected);
+    }
+};
+
+TEST_F(ModalMappingTest, allPoints)
+{
+    ASSERT_TRUE(this->testAllPoints());
+}
+
+TEST_F(ModalMappingTest, subset)
+{
+    ASSERT_TRUE(this->testSubset());
+}
+
+
+TEST(ReducedBasis, pod)
+{
+    const ReducedBasis reference = createBasis();
+
+    // snapshots spanned by the two modes of the reference basis
+    type::vector<ReducedBasis::VecReal> snapshots;
+    const ReducedBasis::VecReal rest { 0,0,0, 1,0,0, 2,0,0 };
+    const SReal coefficients[][2] = { {0,0}, {1,0.2}, {-0.5,1}, {0.3,-2}, {2,0.5} };
+    for (const auto& c : coefficients)
+    {
+        ReducedBasis::VecReal snapshot = rest;
+        for (std::size_t i = 0; i < snapshot.size(); ++i)
+        {
+            snapshot[i] += c[0] * reference.modes[0][i] + c[1] * reference.modes[1][i];
+        }
+        snapshots.push_back(snapshot);
+    }
+
+    const ReducedBasis basis = ReducedBasis::computePOD(snapshots, 0, 1);
+    ASSERT_EQ(basis.nbModes(), 2);
+    ASSERT_EQ(basis.nbDofs(), 9);
+    EXPECT_GE(basis.singularValues[0], basis.singularValues[1]);
+
+    // orthonormal modes, spanning the reference ones
+    for (std::size_t k = 0; k < 2; ++k)
+    {
+        for (std::size_t l = 0; l < 2; ++l)
+        {
+            SReal dot = 0;
+            for (std::size_t i = 0; i < 9; ++i)
+            {
+                dot += basis.modes[k][i] * basis.modes[l][i];
+            }
+            EXPECT_NEAR(dot, k == l ? 1 : 0, 1e-10);
+        }
+
+        ReducedBasis::VecReal residual = reference.modes[k];
+        for (const auto& mode : basis.modes)
+        {
+            SReal dot = 0;
+            for (std::size_t i = 0; i < 9; ++i)
+            {
+                dot += reference.modes[k][i] * mode[i];
+            }
+            for (std::size_t i = 0; i < 9; ++i)
+            {
+                residual[i] -= dot * mode[i];
+            }
+        }
+        for (const SReal r : residual)
+        {
+            EXPECT_NEAR(r, 0, 1e-10);
+        }
+    }
+
+    // limited number of modes
+    EXPECT_EQ(ReducedBasis::computePOD(snapshots, 1, 1).nbModes(), 1);
+}
+
+
+TEST(ReducedBasis, files)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+
+    // states written as WriteState does
+    const std::string snapshotsFile = (directory / "ReducedBasis_test.state").string();
+    {
+        std::ofstream file(snapshotsFile);
+        file << "T= 0\n  X= 0 0 0 1 0 0\n  V= 0 0 0 0 0 0\n";
+        file << "T= 0.1\n  X= 0 0 0 1 0.5 0\n  V= 0 0 0 0 5 0\n";
+    }
+
+    type::vector<ReducedBasis::VecReal> snapshots;
+    ASSERT_TRUE(ReducedBasis::readSnapshots(snapshotsFile, snapshots));
+    ASSERT_EQ(snapshots.size(), 2);
+    EXPECT_EQ(snapshots[1], ReducedBasis::VecReal({ 0,0,0, 1,0.5,0 }));
+
+    const ReducedBasis basis = ReducedBasis::computePOD(snapshots, 0, 1);
+    ASSERT_EQ(basis.nbModes(), 1);
+    EXPECT_NEAR(std::abs(basis.modes[0][4]), 1, 1e-12);
+
+    const std::string basisFile = (directory / "ReducedBasis_test.basis").string();
+    ASSERT_TRUE(basis.save(basisFile));
+    ReducedBasis loaded;
+    ASSERT_TRUE(loaded.load(basisFile));
+    EXPECT_EQ(loaded.modes, basis.modes);
+    EXPECT_EQ(loaded.singularValues, basis.singularValues);
+
+    std::filesystem::remove(snapshotsFile);
+    std::filesystem::remove(basisFile);
+}
+
+} // namespace
+} // namespace sofa
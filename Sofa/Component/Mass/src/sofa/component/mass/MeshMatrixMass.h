@@ -107,6 +107,8 @@ public:
     Data< bool >         d_lumping;
     /// if specific mass information should be outputed
     Data< bool >         d_printMass; ///< Boolean to print the mass
+    /// if addMDx should process the rows of the mass matrix in parallel
+    Data< bool >         d_parallel;
     Data< std::map < std::string, sofa::type::vector<double> > > f_graph; ///< Graph of the controlled potential
 
     /// Link to be set to the topology container in the component graph.
@@ -127,6 +129,36 @@ protected:
     void initTopologyHandlers(sofa::geometry::ElementType topologyType);
     void massInitialization();
 
+    /// Mass matrix stored by rows (compressed sparse rows), reused as long as the masses and the topology do not change.
+    /// Each row only writes its own vertex, so the rows can be processed in parallel without coloring the edges.
+    struct MassMatrixRows
+    {
+        struct Entry
+        {
+            Index column;
+            MassType value;
+        };
+
+        type::vector<MassType> diagonal;      ///< vertex masses, multiplied by the lumping coefficient if lumped
+        type::vector<Index> begin;            ///< off-diagonal entries of the row i: [begin[i], begin[i+1])
+        type::vector<Entry> entries;          ///< edge masses, sorted by column in each row
+        SReal massTotal { 0 };
+
+        int vertexMassCounter { -1 };
+        int edgeMassCounter { -1 };
+        int topologyRevision { -1 };
+        Real lumpingCoeff { 0 };
+        bool lumped { false };
+    };
+    MassMatrixRows m_massMatrixRows;
+
+    /// Rebuild the mass matrix rows if the masses, the topology or the lumping changed since the last call
+    void updateMassMatrixRows();
+
+    /// Call f(begin, end) on ranges of rows of [0, size), in parallel if requested
+    template<class Function>
+    void forEachRowRange(std::size_t size, const Function& f);
+
     /// Internal data required for Cuda computation (copy of vertex mass for deviceRead)
     MeshMatrixMassInternalData<DataTypes, MassType, GeometricalTypes> data;
     friend class MeshMatrixMassInternalData<DataTypes, MassType, GeometricalTypes>;
@@ -35,6 +35,9 @@
 #include <numeric>
 
 #include <sofa/core/behavior/BaseLocalMassMatrix.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <algorithm>
 
 namespace sofa::component::mass
 {
@@ -53,6 +56,7 @@ MeshMatrixMass<DataTypes, GeometricalTypes>::MeshMatrixMass()
     , d_showAxisSize( initData(&d_showAxisSize, Real(1.0), "showAxisSizeFactor", "factor length of the axis displayed (only used for rigids)" ) )
     , d_lumping( initData(&d_lumping, false, "lumping","boolean if you need to use a lumped mass matrix") )
     , d_printMass( initData(&d_printMass, false, "printMass","boolean if you want to check the mass conservation") )
+    , d_parallel( initData(&d_parallel, false, "parallel", "Compute the product of the mass matrix with a vector (addMDx) in parallel") )
     , f_graph( initData(&f_graph,"graph","Graph of the controlled potential") )
     , l_topology(initLink("topology", "link to the topology container"))
     , l_geometryState(initLink("geometryState", "link to the MechanicalObject associated with the geometry"))
@@ -1996,54 +2000,128 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::clear()
 }
 
 
-// -- Mass interface
 template <class DataTypes, class GeometricalTypes>
-void MeshMatrixMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalParams*, DataVecDeriv& vres, const DataVecDeriv& vdx, SReal factor)
+void MeshMatrixMass<DataTypes, GeometricalTypes>::updateMassMatrixRows()
 {
-    const auto &vertexMass= d_vertexMass.getValue();
-    const auto &edgeMass= d_edgeMass.getValue();
+    const auto& vertexMass = d_vertexMass.getValue();
+    const auto& edgeMass = d_edgeMass.getValue();
+    auto& rows = m_massMatrixRows;
 
-    helper::WriteAccessor< DataVecDeriv > res = vres;
-    helper::ReadAccessor< DataVecDeriv > dx = vdx;
+    const bool lumped = isLumped();
+    const int topologyRevision = l_topology ? l_topology->getRevision() : 0;
+    if (rows.vertexMassCounter == d_vertexMass.getCounter() && rows.edgeMassCounter == d_edgeMass.getCounter()
+        && rows.topologyRevision == topologyRevision && rows.lumped == lumped && rows.lumpingCoeff == m_massLumpingCoeff
+        && rows.diagonal.size() == vertexMass.size())
+    {
+        return;
+    }
 
-    SReal massTotal = 0.0;
+    rows.vertexMassCounter = d_vertexMass.getCounter();
+    rows.edgeMassCounter = d_edgeMass.getCounter();
+    rows.topologyRevision = topologyRevision;
+    rows.lumped = lumped;
+    rows.lumpingCoeff = m_massLumpingCoeff;
 
-    //using a lumped matrix (default)-----
-    if(isLumped())
+    const std::size_t nbVertices = vertexMass.size();
+    rows.diagonal.resize(nbVertices);
+    rows.massTotal = 0;
+    for (std::size_t i = 0; i < nbVertices; ++i)
     {
-        for (size_t i=0; i<dx.size(); i++)
-        {
-            res[i] += dx[i] * vertexMass[i] * m_massLumpingCoeff * Real(factor);
-            massTotal += vertexMass[i]*m_massLumpingCoeff * Real(factor);
-        }
+        rows.diagonal[i] = lumped ? vertexMass[i] * m_massLumpingCoeff : vertexMass[i];
+        rows.massTotal += rows.diagonal[i];
+    }
 
+    rows.begin.assign(nbVertices + 1, 0);
+    rows.entries.clear();
+    if (lumped || !l_topology)
+    {
+        return;
     }
-    //using a sparse matrix---------------
-    else
+
+    // counting sort of the edge masses by row: each edge gives an entry in the rows of both its vertices
+    const auto& edges = l_topology->getEdges();
+    const std::size_t nbEdges = std::min<std::size_t>(edges.size(), edgeMass.size());
+    for (std::size_t j = 0; j < nbEdges; ++j)
     {
-        const size_t nbEdges=l_topology->getNbEdges();
-        const auto& edges = l_topology->getEdges();
+        ++rows.begin[edges[j][0] + 1];
+        ++rows.begin[edges[j][1] + 1];
+    }
+    std::partial_sum(rows.begin.begin(), rows.begin.end(), rows.begin.begin());
 
-        for (unsigned int i=0; i<dx.size(); i++)
-        {
-            res[i] += dx[i] * vertexMass[i] * Real(factor);
-            massTotal += vertexMass[i] * Real(factor);
-        }
+    rows.entries.resize(rows.begin.back());
+    type::vector<Index> next(rows.begin.begin(), rows.begin.end() - 1);
+    for (std::size_t j = 0; j < nbEdges; ++j)
+    {
+        const auto& e = edges[j];
+        rows.entries[next[e[0]]++] = { e[1], edgeMass[j] };
+        rows.entries[next[e[1]]++] = { e[0], edgeMass[j] };
+        rows.massTotal += 2 * edgeMass[j];
+    }
 
-        Real tempMass=0.0;
+    // sorted rows are inserted in order in the compressed system matrices
+    for (std::size_t i = 0; i < nbVertices; ++i)
+    {
+        std::sort(rows.entries.begin() + rows.begin[i], rows.entries.begin() + rows.begin[i + 1],
+                  [](const auto& a, const auto& b) { return a.column < b.column; });
+    }
+}
+
+template <class DataTypes, class GeometricalTypes>
+template<class Function>
+void MeshMatrixMass<DataTypes, GeometricalTypes>::forEachRowRange(std::size_t size, const Function& f)
+{
+    if (!d_parallel.getValue())
+    {
+        f(std::size_t(0), size);
+        return;
+    }
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
 
-        for (unsigned int j=0; j<nbEdges; ++j)
+    simulation::parallelForEachRange(*taskScheduler, std::size_t(0), size,
+        [&f](const simulation::Range<std::size_t>& range)
         {
-            const auto& e = edges[j];
+            f(range.start, range.end);
+        });
+}
 
-            tempMass = edgeMass[j] * Real(factor);
 
-            res[e[0]] += dx[e[1]] * tempMass;
-            res[e[1]] += dx[e[0]] * tempMass;
+// -- Mass interface
+template <class DataTypes, class GeometricalTypes>
+void MeshMatrixMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalParams*, DataVecDeriv& vres, const DataVecDeriv& vdx, SReal factor)
+{
+    updateMassMatrixRows();
+    const auto& rows = m_massMatrixRows;
 
-            massTotal += 2 * tempMass;
+    helper::WriteAccessor< DataVecDeriv > res = vres;
+    helper::ReadAccessor< DataVecDeriv > dx = vdx;
+
+    VecDeriv& resValues = res.wref();
+    const VecDeriv& dxValues = dx.ref();
+    const Real massFactor = Real(factor);
+    const std::size_t nbRows = std::min(dxValues.size(), rows.diagonal.size());
+
+    // res[i] only depends on the row i of the mass matrix (a lumped matrix has diagonal rows only)
+    forEachRowRange(nbRows, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Deriv row = dxValues[i] * rows.diagonal[i];
+            for (Index k = rows.begin[i]; k < rows.begin[i + 1]; ++k)
+            {
+                const auto& entry = rows.entries[k];
+                row += dxValues[entry.column] * entry.value;
+            }
+            resValues[i] += row * massFactor;
         }
-    }
+    });
+
+    const SReal massTotal = rows.massTotal * factor;
 
     if(d_printMass.getValue() && (this->getContext()->getTime()==0.0))
     {
@@ -2192,11 +2270,8 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::addGravityToV(const core::Mech
 template <class DataTypes, class GeometricalTypes>
 void MeshMatrixMass<DataTypes, GeometricalTypes>::addMToMatrix(const core::MechanicalParams *mparams, const sofa::core::behavior::MultiMatrixAccessor* matrix)
 {
-    const auto &vertexMass= d_vertexMass.getValue();
-    const auto &edgeMass= d_edgeMass.getValue();
-
-    const size_t nbEdges=l_topology->getNbEdges();
-    sofa::Index v0,v1;
+    updateMassMatrixRows();
+    const auto& rows = m_massMatrixRows;
 
     static constexpr auto N = Deriv::total_size;
     AddMToMatrixFunctor<Deriv,MassType, sofa::linearalgebra::BaseMatrix> calc;
@@ -2210,105 +2285,48 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::addMToMatrix(const core::Mecha
         mat->resize(l_topology->getNbPoints()*N,l_topology->getNbPoints()*N);
     }
 
-    SReal massTotal=0.0;
-
-    if(isLumped())
+    // row by row, with sorted columns: the entries are appended in order to compressed matrices
+    for (std::size_t i = 0; i < rows.diagonal.size(); ++i)
     {
-        unsigned int i {};
-        for (const auto& v : vertexMass)
-        {
-            calc(r.matrix, v * m_massLumpingCoeff, r.offset + N * i, mFactor);
-            massTotal += v * m_massLumpingCoeff;
-            ++i;
-        }
-
-        if(d_printMass.getValue() && (this->getContext()->getTime()==0.0))
-            msg_info() <<"Total Mass = "<<massTotal ;
-
-        if(d_printMass.getValue())
+        calc(r.matrix, rows.diagonal[i], r.offset + N * i, mFactor);
+        for (Index k = rows.begin[i]; k < rows.begin[i + 1]; ++k)
         {
-            std::map < std::string, sofa::type::vector<double> >& graph = *f_graph.beginEdit();
-            sofa::type::vector<double>& graph_error = graph["Mass variations"];
-            graph_error.push_back(massTotal);
-
-            f_graph.endEdit();
+            const auto& entry = rows.entries[k];
+            calc(r.matrix, entry.value, r.offset + N * i, r.offset + N * entry.column, mFactor);
         }
     }
-    else
-    {
-        unsigned int i {};
-        for (const auto& v : vertexMass)
-        {
-            calc(r.matrix, v, r.offset + N * i, mFactor);
-            massTotal += v;
-            ++i;
-        }
-
-        const auto& edges = l_topology->getEdges();
-        for (size_t j = 0; j < nbEdges; ++j)
-        {
-            v0 = edges[j][0];
-            v1 = edges[j][1];
-
-            calc(r.matrix, edgeMass[j], r.offset + N*v0, r.offset + N*v1, mFactor);
-            calc(r.matrix, edgeMass[j], r.offset + N*v1, r.offset + N*v0, mFactor);
 
-            massTotal += 2 * edgeMass[j];
-        }
-
-        if(d_printMass.getValue() && (this->getContext()->getTime()==0.0))
-            msg_info() <<"Total Mass  = "<<massTotal ;
+    const SReal massTotal = rows.massTotal;
 
-        if(d_printMass.getValue())
-        {
-            std::map < std::string, sofa::type::vector<double> >& graph = *f_graph.beginEdit();
-            sofa::type::vector<double>& graph_error = graph["Mass variations"];
-            graph_error.push_back(massTotal+0.000001);
+    if(d_printMass.getValue() && (this->getContext()->getTime()==0.0))
+        msg_info() <<"Total Mass = "<<massTotal ;
 
-            f_graph.endEdit();
-        }
+    if(d_printMass.getValue())
+    {
+        std::map < std::string, sofa::type::vector<double> >& graph = *f_graph.beginEdit();
+        sofa::type::vector<double>& graph_error = graph["Mass variations"];
+        graph_error.push_back(isLumped() ? massTotal : massTotal+0.000001);
 
+        f_graph.endEdit();
     }
-
-
 }
 
 template <class DataTypes, class GeometricalTypes>
 void MeshMatrixMass<DataTypes, GeometricalTypes>::buildMassMatrix(sofa::core::behavior::MassMatrixAccumulator* matrices)
 {
-    const MassVector &vertexMass= d_vertexMass.getValue();
-    const MassVector &edgeMass= d_edgeMass.getValue();
+    updateMassMatrixRows();
+    const auto& rows = m_massMatrixRows;
 
     static constexpr auto N = Deriv::total_size;
     AddMToMatrixFunctor<Deriv,MassType, sofa::core::behavior::MassMatrixAccumulator> calc;
 
-    if (isLumped())
-    {
-        for (size_t index=0; index < vertexMass.size(); index++)
-        {
-            const auto vm = vertexMass[index] * m_massLumpingCoeff;
-            calc(matrices, vm, N * index, 1.);
-        }
-    }
-    else
+    for (std::size_t i = 0; i < rows.diagonal.size(); ++i)
     {
-        for (size_t index=0; index < vertexMass.size(); index++)
+        calc(matrices, rows.diagonal[i], N * i, 1.);
+        for (Index k = rows.begin[i]; k < rows.begin[i + 1]; ++k)
         {
-            const auto& vm = vertexMass[index];
-            calc(matrices, vm, N * index, 1.);
-        }
-
-        const size_t nbEdges = l_topology->getNbEdges();
-        for (size_t j = 0; j < nbEdges; ++j)
-        {
-            const auto e = l_topology->getEdge(j);
-            const sofa::Index v0 = e[0];
-            const sofa::Index v1 = e[1];
-
-            const auto em = edgeMass[j];
-
-            calc(matrices, em, N * v0, N * v1, 1.);
-            calc(matrices, em, N * v1, N * v0, 1.);
+            const auto& entry = rows.entries[k];
+            calc(matrices, entry.value, N * i, N * entry.column, 1.);
         }
     }
 }
@@ -47,6 +47,8 @@ using sofa::testing::BaseSimulationTest;
 #include <sofa/simulation/Node.h>
 using sofa::simulation::Node ;
 
+#include <sofa/core/MechanicalParams.h>
+
 #include <sofa/simulation/Simulation.h>
 #include <sofa/simulation/graph/DAGSimulation.h>
 
@@ -1919,6 +1921,94 @@ public:
         EXPECT_EQ(eMasses.size(), 0);
         EXPECT_NEAR(mass->getTotalMass(), 0, 1e-4);
     }
+
+    /// Compare addMDx with the product computed edge by edge, before and after a change of the masses
+    void checkAddMDx(bool parallel)
+    {
+        const string scene =
+                "<?xml version='1.0'?>                                                                              "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                        "
+                "    <RequiredPlugin name='Sofa.Component.Topology.Mapping'/>                                       "
+                "    <DefaultAnimationLoop />                                                                       "
+                "    <RegularGridTopology name='grid' n='4 3 3' min='0 0 0' max='3 2 2' p0='0 0 0' />               "
+                "    <Node name='Tetra' >                                                                           "
+                "            <MechanicalObject position = '@../grid.position' />                                    "
+                "            <TetrahedronSetTopologyContainer name='Container' />                                   "
+                "            <TetrahedronSetTopologyModifier name='Modifier' />                                     "
+                "            <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />                  "
+                "            <Hexa2TetraTopologicalMapping input='@../grid' output='@Container' />                  "
+                "            <MeshMatrixMass name='m_mass' massDensity='1.0' parallel='" + std::string(parallel ? "true" : "false") + "'/>"
+                "    </Node>                                                                                        "
+                "</Node>                                                                                            ";
+        Node::SPtr root = SceneLoaderXML::loadFromMemory("loadWithNoParam", scene.c_str());
+        ASSERT_NE(root.get(), nullptr);
+        sofa::simulation::node::initRoot(root.get());
+
+        TheMeshMatrixMass* mass = root->getTreeObject<TheMeshMatrixMass>();
+        ASSERT_NE(mass, nullptr);
+        auto* topology = mass->l_topology.get();
+        ASSERT_NE(topology, nullptr);
+        ASSERT_GT(topology->getNbEdges(), 0);
+
+        const auto nbVertices = mass->d_vertexMass.getValue().size();
+        VecCoord dx(nbVertices);
+        for (std::size_t i = 0; i < nbVertices; ++i)
+        {
+            dx[i] = Coord(Real(i % 5), Real(1) - Real(i % 3), Real(i) * Real(0.1));
+        }
+
+        const auto expectedMDx = [&](SReal factor)
+        {
+            const VecMass& vMasses = mass->d_vertexMass.getValue();
+            const VecMass& eMasses = mass->d_edgeMass.getValue();
+            VecCoord expected(nbVertices);
+            for (std::size_t i = 0; i < nbVertices; ++i)
+            {
+                expected[i] = dx[i] * vMasses[i] * Real(factor);
+            }
+            for (std::size_t j = 0; j < topology->getNbEdges(); ++j)
+            {
+                const auto& e = topology->getEdge(j);
+                expected[e[0]] += dx[e[1]] * eMasses[j] * Real(factor);
+                expected[e[1]] += dx[e[0]] * eMasses[j] * Real(factor);
+            }
+            return expected;
+        };
+
+        const auto checkMDx = [&](SReal factor)
+        {
+            core::objectmodel::Data<VecCoord> res;
+            res.setValue(VecCoord(nbVertices));
+            core::objectmodel::Data<VecCoord> dxData;
+            dxData.setValue(dx);
+            mass->addMDx(core::MechanicalParams::defaultInstance(), res, dxData, factor);
+
+            const VecCoord expected = expectedMDx(factor);
+            const VecCoord& result = res.getValue();
+            for (std::size_t i = 0; i < nbVertices; ++i)
+            {
+                for (std::size_t c = 0; c < 3; ++c)
+                {
+                    EXPECT_NEAR(expected[i][c], result[i][c], 1e-10);
+                }
+            }
+        };
+
+        checkMDx(1.0);
+        checkMDx(-0.5);
+
+        // the cached mass matrix must follow the changes of the masses
+        {
+            auto vMasses = sofa::helper::getWriteAccessor(mass->d_vertexMass);
+            for (auto& m : vMasses)
+            {
+                m *= 2;
+            }
+            auto eMasses = sofa::helper::getWriteAccessor(mass->d_edgeMass);
+            eMasses[0] *= 3;
+        }
+        checkMDx(1.0);
+    }
 };
 
 
@@ -2209,5 +2299,15 @@ TEST_F(MeshMatrixMass3_test, checkTopologicalChanges_Edge_lumped) {
     checkTopologicalChanges_Edge(true);
 }
 
+TEST_F(MeshMatrixMass3_test, addMDx) {
+    EXPECT_MSG_NOEMIT(Error);
+    checkAddMDx(false);
+}
+
+TEST_F(MeshMatrixMass3_test, addMDx_parallel) {
+    EXPECT_MSG_NOEMIT(Error);
+    checkAddMDx(true);
+}
+
 
 } // namespace sofa
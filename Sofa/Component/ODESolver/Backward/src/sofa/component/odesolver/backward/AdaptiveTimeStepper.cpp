@@ -0,0 +1,152 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/backward/AdaptiveTimeStepper.h>
+
+#include <sofa/core/behavior/MultiVec.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/simulation/MechanicalOperations.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/UpdateContextVisitor.h>
+#include <sofa/simulation/VectorOperations.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sofa::component::odesolver::backward
+{
+
+bool AdaptiveTimeStepper::supports(core::MultiVecCoordId xResult, core::MultiVecDerivId vResult)
+{
+    return !xResult.hasIdMap() && xResult.getDefaultId() == core::VecCoordId::position()
+        && !vResult.hasIdMap() && vResult.getDefaultId() == core::VecDerivId::velocity();
+}
+
+void AdaptiveTimeStepper::integrate(const core::ExecParams* params, core::objectmodel::BaseContext* context, SReal dt,
+                                    const Parameters& parameters, const StepFunction& step, const RejectFunction& reject)
+{
+    using core::behavior::MultiVecCoord;
+    using core::behavior::MultiVecDeriv;
+
+    SCOPED_TIMER("AdaptiveTimeStep");
+
+    sofa::simulation::common::VectorOperations vop(params, context);
+    sofa::simulation::common::MechanicalOperations mop(params, context);
+
+    MultiVecCoord pos(&vop, core::VecCoordId::position());
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity());
+    MultiVecCoord startPos(&vop);
+    MultiVecDeriv startVel(&vop);
+
+    m_statistics = Statistics();
+
+    const SReal exponent = -1 / static_cast<SReal>(parameters.order + 1);
+    const SReal minDt = std::min(parameters.minDt, dt);
+    // the remaining time is compared with a tolerance to avoid a tiny last sub-step due to rounding errors
+    const SReal timeTolerance = dt * 1e-9;
+
+    // the time of the context is moved to the beginning of each sub-step, for the components depending on it
+    auto* node = dynamic_cast<sofa::simulation::Node*>(context);
+    const SReal startTime = context->getTime();
+    const auto setTime = [node, params](SReal time)
+    {
+        if (node && node->getTime() != time)
+        {
+            node->setTime(time);
+            node->execute<sofa::simulation::UpdateSimulationContextVisitor>(params);
+        }
+    };
+
+    SReal remaining = dt;
+    SReal proposedDt = (m_nextDt > 0) ? std::min(m_nextDt, dt) : dt;
+    unsigned int nbTrials = 0;
+
+    while (remaining > timeTolerance)
+    {
+        // a rejected sub-step is retried from the same time
+        setTime(startTime + (dt - remaining));
+
+        // the sub-step is shortened to end exactly at the end of the animation step, avoiding to
+        // leave a remainder much smaller than the sub-step
+        SReal h = std::min(proposedDt, remaining);
+        if (remaining - h < 0.1 * h)
+            h = remaining;
+        const bool shortened = h < proposedDt;
+
+        startPos.eq(pos);
+        startVel.eq(vel);
+
+        const SReal error = step(h, startVel);
+        ++nbTrials;
+
+        const SReal scale = parameters.absoluteTolerance + parameters.relativeTolerance * pos.norm(0);
+        const SReal normalizedError = scale > 0 ? error / scale : 0;
+        const bool finite = std::isfinite(normalizedError);
+
+        // when the budget of sub-steps is exhausted, the sub-step is accepted whatever its error
+        const bool lastTrial = nbTrials >= parameters.maxSubSteps;
+        const bool accepted = lastTrial || (finite && (normalizedError <= 1 || h <= minDt));
+
+        SReal factor = parameters.maxFactor;
+        if (!finite)
+            factor = parameters.minFactor;
+        else if (normalizedError > 0)
+            factor = std::clamp(0.9 * std::pow(normalizedError, exponent), parameters.minFactor, parameters.maxFactor);
+        const SReal nextDt = std::max(h * factor, minDt);
+
+        if (accepted)
+        {
+            remaining -= h;
+            ++m_statistics.nbSubSteps;
+            m_statistics.lastDt = h;
+
+            if (remaining > timeTolerance)
+            {
+                // the next sub-step starts from the new state, as the animation loop would do
+                mop.projectPositionAndVelocity(pos, vel);
+                mop.propagateXAndV(pos, vel);
+            }
+
+            // a sub-step shortened to reach the end of the animation step does not reduce the next ones, unless its error requires it
+            proposedDt = (shortened && factor >= 1) ? proposedDt : nextDt;
+            if (lastTrial)
+                proposedDt = remaining;
+        }
+        else
+        {
+            ++m_statistics.nbRejectedSubSteps;
+            pos.eq(startPos);
+            vel.eq(startVel);
+            mop.propagateXAndV(pos, vel);
+            if (reject)
+                reject();
+
+            proposedDt = nextDt;
+        }
+    }
+
+    // the animation loop advances the time over the whole step
+    setTime(startTime);
+
+    m_nextDt = proposedDt;
+}
+
+} // namespace sofa::component::odesolver::backward
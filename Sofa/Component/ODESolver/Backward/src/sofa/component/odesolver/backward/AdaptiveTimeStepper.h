@@ -0,0 +1,95 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/backward/config.h>
+
+#include <sofa/core/ExecParams.h>
+#include <sofa/core/MultiVecId.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+
+#include <functional>
+
+namespace sofa::component::odesolver::backward
+{
+
+/**
+ * Adaptive sub-stepping of an implicit time integrator, with error control.
+ *
+ * The time step of the context (dt) remains the step of the animation loop: the events, the collision detection and
+ * the visual updates keep the same timing. Inside each dt, the integrator performs as many sub-steps as needed to keep
+ * the local error estimate below the tolerance, and a single one during the quiet phases. The size of the sub-steps
+ * is kept from one animation step to the next. During the integration, the time of the context is set to the
+ * beginning of the current sub-step, and restored at the end.
+ *
+ * A sub-step is rejected, and retried with a smaller size, when its normalized error
+ * \f$ e / (atol + rtol |x|_\infty) \f$ is greater than 1. The next size is
+ * \f$ h_{next} = h \; \min(f_{max}, \max(f_{min}, 0.9 \; e_n^{-1/(p+1)})) \f$, where p is the order of the scheme.
+ */
+class SOFA_COMPONENT_ODESOLVER_BACKWARD_API AdaptiveTimeStepper
+{
+public:
+    struct Parameters
+    {
+        SReal absoluteTolerance { 1e-4 };
+        SReal relativeTolerance { 0 };
+        SReal minDt { 0 };                  ///< sub-steps smaller than this size are always accepted
+        unsigned int maxSubSteps { 1000 };  ///< sub-steps (accepted or rejected) per animation step
+        unsigned int order { 1 };           ///< order of the scheme: the local error is in h^(order+1)
+        SReal minFactor { 0.2 };            ///< maximum shrink of the sub-step size
+        SReal maxFactor { 2 };              ///< maximum growth of the sub-step size
+    };
+
+    struct Statistics
+    {
+        unsigned int nbSubSteps { 0 };
+        unsigned int nbRejectedSubSteps { 0 };
+        SReal lastDt { 0 };
+    };
+
+    /// Performs a sub-step of the given size from the current position and velocity, and returns the
+    /// infinite norm of the estimate of the local error on the positions. The velocity at the beginning
+    /// of the sub-step is given as it is often needed by the estimate.
+    using StepFunction = std::function<SReal(SReal h, core::MultiVecDerivId startVelocity)>;
+
+    /// Called when a sub-step is rejected, after the position and velocity are restored, to restore
+    /// the other states of the integrator
+    using RejectFunction = std::function<void()>;
+
+    /// Only the integration of the position and velocity of the context can be sub-stepped (not the free motion)
+    static bool supports(core::MultiVecCoordId xResult, core::MultiVecDerivId vResult);
+
+    /// Integrates over dt with adaptive sub-steps
+    void integrate(const core::ExecParams* params, core::objectmodel::BaseContext* context, SReal dt,
+                   const Parameters& parameters, const StepFunction& step, const RejectFunction& reject = {});
+
+    /// Statistics of the last call to integrate
+    const Statistics& getStatistics() const { return m_statistics; }
+
+    /// Forget the size of the sub-steps
+    void reset() { m_nextDt = 0; }
+
+private:
+    SReal m_nextDt { 0 };
+    Statistics m_statistics;
+};
+
+} // namespace sofa::component::odesolver::backward
@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/odesolver/backward/EulerImplicitSolver.h>
+#include <sofa/component/odesolver/backward/InexactNewton.h>
 
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/simulation/MechanicalOperations.h>
@@ -27,8 +28,10 @@
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/behavior/MultiMatrix.h>
+#include <sofa/core/behavior/LinearSolver.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
 
+#include <memory>
 
 namespace sofa::component::odesolver::backward
 {
@@ -45,7 +48,36 @@ EulerImplicitSolver::EulerImplicitSolver()
     , d_trapezoidalScheme( initData(&d_trapezoidalScheme,false,"trapezoidalScheme","Optional: use the trapezoidal scheme instead of the implicit Euler scheme and get second order accuracy in time") )
     , f_solveConstraint( initData(&f_solveConstraint,false,"solveConstraint","Apply ConstraintSolver (requires a ConstraintSolver in the same node as this solver, disabled by by default for now)") )
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_newtonIterations(initData(&d_newtonIterations, 1u, "newtonIterations", "Maximum number of linear solves per time step. With 1, the system is linearized once per time step. Newton iterations are only supported by the 2nd order implicit Euler scheme, without solveConstraint."))
+    , d_newtonTolerance(initData(&d_newtonTolerance, (SReal)1e-3, "newtonTolerance", "The Newton iterations stop when the ratio |g|/|b| between the residual of the implicit scheme and the initial right-hand side is smaller than this threshold."))
+    , d_newtonKrylov(initData(&d_newtonKrylov, false, "newtonKrylov", "Inexact Newton: the relative tolerance of each linear solve is adapted to the reduction of the residual (Eisenstat-Walker forcing terms). Requires newtonIterations > 1, and an iterative linear solver or matrixFree."))
+    , d_forcingTermInitial(initData(&d_forcingTermInitial, (SReal)0.5, "forcingTermInitial", "Inexact Newton: relative tolerance of the first linear solve."))
+    , d_forcingTermMax(initData(&d_forcingTermMax, (SReal)0.9, "forcingTermMax", "Inexact Newton: maximum relative tolerance of the linear solves."))
+    , d_forcingTermGamma(initData(&d_forcingTermGamma, (SReal)0.9, "forcingTermGamma", "Inexact Newton: factor gamma of the forcing terms gamma (|g_k|/|g_k-1|)^alpha."))
+    , d_forcingTermAlpha(initData(&d_forcingTermAlpha, (SReal)1.618033988749895, "forcingTermAlpha", "Inexact Newton: exponent alpha of the forcing terms gamma (|g_k|/|g_k-1|)^alpha."))
+    , d_matrixFree(initData(&d_matrixFree, false, "matrixFree", "The linear systems are solved by a conjugate gradient computing the products through addMDx and addDForce, without any linear solver component."))
+    , d_matrixFreeTolerance(initData(&d_matrixFreeTolerance, (SReal)1e-8, "matrixFreeTolerance", "Relative tolerance of the matrix-free conjugate gradient when newtonKrylov is disabled."))
+    , d_matrixFreeMaxIterations(initData(&d_matrixFreeMaxIterations, 1000u, "matrixFreeMaxIterations", "Maximum number of iterations of the matrix-free conjugate gradient."))
+    , d_nbNewtonIterations(initData(&d_nbNewtonIterations, 0u, "nbNewtonIterations", "Output: number of linear solves of the last time step."))
+    , d_nbLinearIterations(initData(&d_nbLinearIterations, 0u, "nbLinearIterations", "Output: total number of iterations of the linear solves of the last time step (0 for direct solvers)."))
+    , d_forcingTerms(initData(&d_forcingTerms, "forcingTerms", "Output: relative tolerances of the linear solves of the last time step (inexact Newton only)."))
+    , d_residualNorms(initData(&d_residualNorms, "residualNorms", "Output: residual norms of the last time step: |b|, then |g| at each Newton iteration."))
+    , d_adaptiveTimeStep(initData(&d_adaptiveTimeStep, false, "adaptiveTimeStep", "Integrate each time step in sub-steps whose size is controlled by an estimate of the local error (difference between the implicit Euler and trapezoidal positions). Not supported in the free motion of constraint-based animation loops."))
+    , d_adaptiveTolerance(initData(&d_adaptiveTolerance, (SReal)1e-4, "adaptiveTolerance", "Adaptive time step: absolute tolerance on the local error of the positions."))
+    , d_adaptiveRelativeTolerance(initData(&d_adaptiveRelativeTolerance, (SReal)0.0, "adaptiveRelativeTolerance", "Adaptive time step: tolerance on the local error of the positions, relative to their infinite norm."))
+    , d_adaptiveMinDt(initData(&d_adaptiveMinDt, (SReal)1e-6, "adaptiveMinDt", "Adaptive time step: sub-steps smaller than this size are accepted whatever their error."))
+    , d_adaptiveMaxSubSteps(initData(&d_adaptiveMaxSubSteps, 100u, "adaptiveMaxSubSteps", "Adaptive time step: maximum number of sub-steps (accepted or rejected) per time step."))
+    , d_nbSubSteps(initData(&d_nbSubSteps, 0u, "nbSubSteps", "Output: number of accepted sub-steps of the last time step."))
+    , d_nbRejectedSubSteps(initData(&d_nbRejectedSubSteps, 0u, "nbRejectedSubSteps", "Output: number of rejected sub-steps of the last time step."))
+    , d_subStepDt(initData(&d_subStepDt, (SReal)0.0, "subStepDt", "Output: size of the last accepted sub-step."))
 {
+    d_nbNewtonIterations.setReadOnly(true);
+    d_nbLinearIterations.setReadOnly(true);
+    d_forcingTerms.setReadOnly(true);
+    d_residualNorms.setReadOnly(true);
+    d_nbSubSteps.setReadOnly(true);
+    d_nbRejectedSubSteps.setReadOnly(true);
+    d_subStepDt.setReadOnly(true);
 }
 
 void EulerImplicitSolver::init()
@@ -58,9 +90,24 @@ void EulerImplicitSolver::init()
         for (const auto* obj : objs)
             msg_info() << "  " << obj->getClassName() << ' ' << obj->getName();
     }
+
+    if (d_newtonIterations.getValue() > 1 && !useNewtonIterations())
+    {
+        msg_warning() << "Newton iterations are only supported by the 2nd order implicit Euler scheme, without "
+                      << "trapezoidalScheme and solveConstraint: the system is linearized once per time step.";
+    }
+
     sofa::core::behavior::OdeSolver::init();
 }
 
+bool EulerImplicitSolver::useNewtonIterations() const
+{
+    return d_newtonIterations.getValue() > 1
+        && !f_firstOrder.getValue()
+        && !d_trapezoidalScheme.getValue()
+        && !f_solveConstraint.getValue();
+}
+
 void EulerImplicitSolver::cleanup()
 {
     // free the locally created vector x (including eventual external mechanical states linked by an InteractionForceField)
@@ -69,6 +116,49 @@ void EulerImplicitSolver::cleanup()
 }
 
 void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    if (!d_adaptiveTimeStep.getValue())
+    {
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    if (!AdaptiveTimeStepper::supports(xResult, vResult))
+    {
+        msg_warning_when(d_nbSubSteps.getValue() == 0) << "The adaptive time step is not supported when integrating the free motion: "
+                                                       << "the time steps are not sub-stepped.";
+        d_nbSubSteps.setValue(1);
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    AdaptiveTimeStepper::Parameters parameters;
+    parameters.absoluteTolerance = d_adaptiveTolerance.getValue();
+    parameters.relativeTolerance = d_adaptiveRelativeTolerance.getValue();
+    parameters.minDt = d_adaptiveMinDt.getValue();
+    parameters.maxSubSteps = d_adaptiveMaxSubSteps.getValue();
+    parameters.order = 1;
+
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    MultiVecDeriv velocityIncrement(&vop);
+
+    m_adaptiveTimeStepper.integrate(params, this->getContext(), dt, parameters,
+        [&](SReal h, core::MultiVecDerivId startVelocity)
+        {
+            solveStep(params, h, xResult, vResult);
+
+            // local error on the positions: difference between the implicit Euler and the trapezoidal positions
+            velocityIncrement.eq(vResult, startVelocity, -1.0);
+            return h / 2 * velocityIncrement.norm(0);
+        });
+
+    const auto& statistics = m_adaptiveTimeStepper.getStatistics();
+    d_nbSubSteps.setValue(statistics.nbSubSteps);
+    d_nbRejectedSubSteps.setValue(statistics.nbRejectedSubSteps);
+    d_subStepDt.setValue(statistics.lastDt);
+}
+
+void EulerImplicitSolver::solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
 {
 #ifdef SOFA_DUMP_VISITOR_INFO
     sofa::simulation::Visitor::printNode("SolverVectorAllocation");
@@ -92,6 +182,19 @@ void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::
 
     x.realloc(&vop, !d_threadSafeVisitor.getValue(), true, core::VecIdProperties{"solution", GetClass()->className});
 
+    // the Newton iterations need the state at the beginning of the time step, as xResult and vResult are
+    // usually the position and velocity vectors
+    const bool newtonIterations = useNewtonIterations();
+    std::unique_ptr<MultiVecCoord> startPos;
+    std::unique_ptr<MultiVecDeriv> startVel;
+    if (newtonIterations)
+    {
+        startPos = std::make_unique<MultiVecCoord>(&vop, true, core::VecIdProperties{"startPosition", GetClass()->className});
+        startVel = std::make_unique<MultiVecDeriv>(&vop, true, core::VecIdProperties{"startVelocity", GetClass()->className});
+        startPos->eq(pos);
+        startVel->eq(vel);
+    }
+
 
 #ifdef SOFA_DUMP_VISITOR_INFO
     sofa::simulation::Visitor::printCloseNode("SolverVectorAllocation");
@@ -151,10 +254,13 @@ void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::
 
     core::behavior::MultiMatrix<simulation::common::MechanicalOperations> matrix(&mop);
 
-    if (firstOrder)
-        matrix.setSystemMBKMatrix(MechanicalMatrix(1,0,-h*tr)); //MechanicalMatrix::K * (-h*tr) + MechanicalMatrix::M;
-    else
-        matrix.setSystemMBKMatrix(MechanicalMatrix(1+tr*h*f_rayleighMass.getValue(),-tr*h,-tr*h*(h+f_rayleighStiffness.getValue()))); // MechanicalMatrix::K * (-tr*h*(h+f_rayleighStiffness.getValue())) + MechanicalMatrix::B * (-tr*h) + MechanicalMatrix::M * (1+tr*h*f_rayleighMass.getValue());
+    const MechanicalMatrix systemMatrix = firstOrder
+        ? MechanicalMatrix(1,0,-h*tr) //MechanicalMatrix::K * (-h*tr) + MechanicalMatrix::M;
+        : MechanicalMatrix(1+tr*h*f_rayleighMass.getValue(),-tr*h,-tr*h*(h+f_rayleighStiffness.getValue())); // MechanicalMatrix::K * (-tr*h*(h+f_rayleighStiffness.getValue())) + MechanicalMatrix::B * (-tr*h) + MechanicalMatrix::M * (1+tr*h*f_rayleighMass.getValue());
+
+    const bool matrixFree = d_matrixFree.getValue();
+    if (!matrixFree)
+        matrix.setSystemMBKMatrix(systemMatrix);
 
     msg_info() << "EulerImplicitSolver, matrix = " << (MechanicalMatrix::K * (-h * (h + f_rayleighStiffness.getValue())) + MechanicalMatrix::M * (1 + h * f_rayleighMass.getValue())) << " = " << matrix;
     msg_info() << "EulerImplicitSolver, Matrix K = " << MechanicalMatrix::K;
@@ -163,10 +269,47 @@ void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::
     simulation::Visitor::printNode("SystemSolution");
 #endif
     sofa::helper::AdvancedTimer::stepEnd ("MBKBuild");
+
+    // Inexact Newton: the forcing term is the relative tolerance of the next linear solve (0 for an exact solve)
+    const bool newtonKrylov = newtonIterations && d_newtonKrylov.getValue();
+    EisenstatWalkerForcingTerm forcing(d_forcingTermInitial.getValue(), d_forcingTermMax.getValue(),
+                                       d_forcingTermGamma.getValue(), d_forcingTermAlpha.getValue());
+    type::vector<SReal> forcingTerms;
+    unsigned int nbLinearIterations = 0;
+
+    // the linear solver is only needed here to adapt its tolerance and to get its number of iterations
+    auto* linearSolver = matrixFree ? nullptr : this->getContext()->get<core::behavior::LinearSolver>(this->getContext()->getTags(), core::objectmodel::BaseContext::SearchDown);
+
+    const auto solveSystem = [&](MultiVecDeriv& rhs, SReal forcingTerm)
     {
         SCOPED_TIMER("MBKSolve");
-        matrix.solve(x, b); //Call to ODE resolution: x is the solution of the system}
-    }
+        if (newtonKrylov)
+            forcingTerms.push_back(forcingTerm);
+
+        if (matrixFree)
+        {
+            nbLinearIterations += matrixFreeConjugateGradient(mop, vop, x, rhs,
+                systemMatrix.getMFact(), systemMatrix.getBFact(), systemMatrix.getKFact(),
+                newtonKrylov ? forcingTerm : d_matrixFreeTolerance.getValue(), d_matrixFreeMaxIterations.getValue());
+            return;
+        }
+
+        if (newtonKrylov && linearSolver && !linearSolver->setNextRelativeTolerance(forcingTerm) && !m_inexactSolveWarningShown)
+        {
+            msg_warning() << "The linear solver " << linearSolver->getPathName()
+                << " does not support inexact solves: the linear systems are solved exactly.";
+            m_inexactSolveWarningShown = true;
+        }
+        matrix.solve(x, rhs); //Call to ODE resolution: x is the solution of the system
+        if (linearSolver)
+            nbLinearIterations += linearSolver->getNbIterations();
+    };
+
+    type::vector<SReal> residualNorms;
+    if (newtonIterations)
+        residualNorms.push_back(b.norm());
+
+    solveSystem(b, newtonKrylov ? forcing.reset() : 0);
 #ifdef SOFA_DUMP_VISITOR_INFO
     simulation::Visitor::printCloseNode("SystemSolution");
 #endif
@@ -276,6 +419,53 @@ void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::
     }
 #endif
 
+    unsigned int nbNewtonIterations = 1;
+    if (newtonIterations)
+    {
+        SCOPED_TIMER("NewtonIterations");
+
+        MultiVecDeriv residual(&vop);
+        MultiVecDeriv velocityIncrement(&vop);
+        const SReal rm = f_rayleighMass.getValue();
+        const SReal rk = f_rayleighStiffness.getValue();
+        const SReal threshold = d_newtonTolerance.getValue() * residualNorms.front();
+
+        for (; nbNewtonIterations < d_newtonIterations.getValue(); ++nbNewtonIterations)
+        {
+            // residual of the implicit scheme: g = h ( f(x, v) - rm M v + rk K v ) - M (v - v_t)
+            mop.computeForce(this->getContext()->getTime() + h, f, newPos, newVel);
+            residual.eq(f, h);
+            mop.addMBKv(residual, -h * rm, 0, h * rk, false);
+            velocityIncrement.eq(newVel, *startVel, -1.0);
+            mop.addMdx(residual, velocityIncrement, -1.0);
+            mop.projectResponse(residual);
+
+            const SReal residualNorm = residual.norm();
+            msg_info() << "Newton iteration " << nbNewtonIterations << ": |g| = " << residualNorm << ", |g|/|b| = " << residualNorm / residualNorms.front();
+
+            const SReal previousResidualNorm = residualNorms.back();
+            residualNorms.push_back(residualNorm);
+            if (residualNorm <= threshold)
+                break;
+
+            if (!matrixFree)
+            {
+                SCOPED_TIMER("MBKBuild");
+                matrix.setSystemMBKMatrix(systemMatrix); // linearization around the current state
+            }
+            solveSystem(residual, newtonKrylov ? forcing.next(residualNorm, previousResidualNorm, threshold) : 0);
+
+            // v = v + dv, x = x_t + h v
+            newVel.peq(x);
+            newPos.eq(*startPos, newVel, h);
+        }
+    }
+
+    d_nbNewtonIterations.setValue(nbNewtonIterations);
+    d_nbLinearIterations.setValue(nbLinearIterations);
+    d_forcingTerms.setValue(forcingTerms);
+    d_residualNorms.setValue(residualNorms);
+
     mop.addSeparateGravity(dt, newVel);	// v += dt*g . Used if mass wants to add G separately from the other forces to v
 
     if (f_velocityDamping.getValue()!=0.0)
@@ -22,7 +22,9 @@
 #pragma once
 #include <sofa/component/odesolver/backward/config.h>
 
+#include <sofa/component/odesolver/backward/AdaptiveTimeStepper.h>
 #include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/type/vector.h>
 
 namespace sofa::component::odesolver::backward
 {
@@ -92,6 +94,25 @@ namespace sofa::component::odesolver::backward
  *
  *   \f$ ( M + h/2 K ) v_{t+h} = f_{ext} \f$
  *
+ *** Newton iterations ***
+ *
+ * By default, the system is linearized once per time step. With newtonIterations > 1 (2nd order implicit Euler
+ * scheme only), the linearized solve is followed by Newton corrections on the residual of the implicit scheme
+ *
+ *   \f$ g(v) = h ( f(x_t + h v, v) - r_M M v + r_K K v ) - M (v - v_t) \f$
+ *
+ * until \f$ |g| / |b| \f$ is smaller than newtonTolerance. With newtonKrylov, the relative tolerance of each linear
+ * solve is adapted to the reduction of the residual (Eisenstat-Walker forcing terms), avoiding to over-solve the
+ * first iterations. With matrixFree, the linear systems are solved by a conjugate gradient computing the products
+ * through addMDx and addDForce, without any linear solver component.
+ *
+ *** Adaptive time step ***
+ *
+ * With adaptiveTimeStep, each time step of the context is integrated in sub-steps whose size is controlled by an
+ * estimate of the local error on the positions: the difference between the implicit Euler and the trapezoidal
+ * positions, \f$ h/2 |v_{t+h} - v_t|_\infty \f$. The time step of the context is then the largest sub-step, and the
+ * step of the events and visual updates.
+ *
  */
 class SOFA_COMPONENT_ODESOLVER_BACKWARD_API EulerImplicitSolver : public sofa::core::behavior::OdeSolver
 {
@@ -106,6 +127,31 @@ public:
     Data<bool> f_solveConstraint; ///< Apply ConstraintSolver (requires a ConstraintSolver in the same node as this solver, disabled by by default for now)
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
 
+    Data<unsigned int> d_newtonIterations; ///< Maximum number of linear solves per time step. With 1, the system is linearized once per time step.
+    Data<SReal> d_newtonTolerance; ///< The Newton iterations stop when the ratio |g|/|b| between the residual of the implicit scheme and the initial right-hand side is smaller than this threshold.
+    Data<bool> d_newtonKrylov; ///< Inexact Newton: the relative tolerance of each linear solve is adapted to the reduction of the residual (Eisenstat-Walker forcing terms).
+    Data<SReal> d_forcingTermInitial; ///< Inexact Newton: relative tolerance of the first linear solve.
+    Data<SReal> d_forcingTermMax; ///< Inexact Newton: maximum relative tolerance of the linear solves.
+    Data<SReal> d_forcingTermGamma; ///< Inexact Newton: factor gamma of the forcing terms gamma (|g_k|/|g_k-1|)^alpha.
+    Data<SReal> d_forcingTermAlpha; ///< Inexact Newton: exponent alpha of the forcing terms gamma (|g_k|/|g_k-1|)^alpha.
+    Data<bool> d_matrixFree; ///< The linear systems are solved by a conjugate gradient computing the products through addMDx and addDForce, without any linear solver component.
+    Data<SReal> d_matrixFreeTolerance; ///< Relative tolerance of the matrix-free conjugate gradient when newtonKrylov is disabled.
+    Data<unsigned int> d_matrixFreeMaxIterations; ///< Maximum number of iterations of the matrix-free conjugate gradient.
+
+    Data<unsigned int> d_nbNewtonIterations; ///< Output: number of linear solves of the last time step.
+    Data<unsigned int> d_nbLinearIterations; ///< Output: total number of iterations of the linear solves of the last time step (0 for direct solvers).
+    Data<type::vector<SReal> > d_forcingTerms; ///< Output: relative tolerances of the linear solves of the last time step (inexact Newton only).
+    Data<type::vector<SReal> > d_residualNorms; ///< Output: residual norms of the last time step: |b|, then |g| at each Newton iteration.
+
+    Data<bool> d_adaptiveTimeStep; ///< Integrate each time step in sub-steps whose size is controlled by an estimate of the local error.
+    Data<SReal> d_adaptiveTolerance; ///< Adaptive time step: absolute tolerance on the local error of the positions.
+    Data<SReal> d_adaptiveRelativeTolerance; ///< Adaptive time step: tolerance on the local error of the positions, relative to their infinite norm.
+    Data<SReal> d_adaptiveMinDt; ///< Adaptive time step: sub-steps smaller than this size are accepted whatever their error.
+    Data<unsigned int> d_adaptiveMaxSubSteps; ///< Adaptive time step: maximum number of sub-steps (accepted or rejected) per time step.
+    Data<unsigned int> d_nbSubSteps; ///< Output: number of accepted sub-steps of the last time step.
+    Data<unsigned int> d_nbRejectedSubSteps; ///< Output: number of rejected sub-steps of the last time step.
+    Data<SReal> d_subStepDt; ///< Output: size of the last accepted sub-step.
+
 protected:
     EulerImplicitSolver();
 public:
@@ -159,6 +205,17 @@ protected:
     /// the solution vector is stored for warm-start
     core::behavior::MultiVecDeriv x;
 
+    /// Returns true if the Newton iterations are enabled and supported by the chosen scheme
+    bool useNewtonIterations() const;
+
+    /// Integrates a single step of size dt
+    void solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult);
+
+    AdaptiveTimeStepper m_adaptiveTimeStepper;
+
+    /// The linear solver does not support inexact solves, and the user has already been warned about it.
+    bool m_inexactSolveWarningShown = false;
+
 };
 
 } // namespace sofa::component::odesolver::backward
@@ -0,0 +1,140 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/backward/InexactNewton.h>
+
+#include <sofa/core/behavior/MultiVec.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/simulation/MechanicalOperations.h>
+#include <sofa/simulation/VectorOperations.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sofa::component::odesolver::backward
+{
+
+EisenstatWalkerForcingTerm::EisenstatWalkerForcingTerm(SReal initial, SReal maximum, SReal gamma, SReal alpha)
+    : m_initial(initial)
+    , m_maximum(maximum)
+    , m_gamma(gamma)
+    , m_alpha(alpha)
+    , m_current(std::min(initial, maximum))
+{}
+
+SReal EisenstatWalkerForcingTerm::reset()
+{
+    m_current = std::min(m_initial, m_maximum);
+    return m_current;
+}
+
+SReal EisenstatWalkerForcingTerm::next(SReal residualNorm, SReal previousResidualNorm, SReal residualThreshold)
+{
+    if (previousResidualNorm <= std::numeric_limits<SReal>::min())
+    {
+        return m_current;
+    }
+
+    SReal eta = m_gamma * std::pow(residualNorm / previousResidualNorm, m_alpha);
+
+    const SReal safeguard = m_gamma * std::pow(m_current, m_alpha);
+    if (safeguard > 0.1)
+    {
+        eta = std::max(eta, safeguard);
+    }
+
+    if (residualThreshold > 0 && residualNorm > 0)
+    {
+        eta = std::max(eta, 0.5 * residualThreshold / residualNorm);
+    }
+
+    m_current = std::min(eta, m_maximum);
+    return m_current;
+}
+
+unsigned int matrixFreeConjugateGradient(simulation::common::MechanicalOperations& mop,
+                                         simulation::common::VectorOperations& vop,
+                                         core::MultiVecDerivId x, core::MultiVecDerivId rhs,
+                                         SReal m, SReal b, SReal k,
+                                         SReal relativeTolerance, unsigned int maxIterations)
+{
+    using core::behavior::MultiVecDeriv;
+
+    SCOPED_TIMER("MatrixFreeCG");
+
+    MultiVecDeriv solution(&vop, x);
+    MultiVecDeriv r(&vop);
+    MultiVecDeriv p(&vop);
+    MultiVecDeriv q(&vop);
+
+    solution.clear();
+    r.eq(rhs);
+
+    const SReal rhsSquaredNorm = r.dot(r);
+    if (rhsSquaredNorm <= 0)
+    {
+        return 0;
+    }
+    const SReal squaredTolerance = relativeTolerance * relativeTolerance * rhsSquaredNorm;
+
+    SReal rho_1 = 0;
+    unsigned int nbIterations = 0;
+    while (nbIterations < maxIterations)
+    {
+        const SReal rho = r.dot(r);
+        if (rho <= squaredTolerance)
+        {
+            break;
+        }
+
+        if (nbIterations == 0)
+        {
+            p.eq(r); // p = r
+        }
+        else
+        {
+            p.eq(r, p, rho / rho_1); // p = r + beta p
+        }
+
+        // q = (m M + b B + k K) p, through the force fields and the mappings
+        mop.propagateDxAndResetDf(p, q);
+        mop.addMBKdx(q, m, b, k, false);
+        mop.projectResponse(q);
+
+        const SReal den = p.dot(q);
+        if (std::abs(den) <= std::numeric_limits<SReal>::min())
+        {
+            break;
+        }
+
+        const SReal alpha = rho / den;
+        solution.peq(p, alpha); // x += alpha p
+        r.peq(q, -alpha);       // r -= alpha q
+        rho_1 = rho;
+
+        ++nbIterations;
+    }
+
+    return nbIterations;
+}
+
+} // namespace sofa::component::odesolver::backward
@@ -0,0 +1,87 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/backward/config.h>
+
+#include <sofa/core/MultiVecId.h>
+#include <sofa/simulation/fwd.h>
+
+namespace sofa::simulation::common
+{
+class MechanicalOperations;
+class VectorOperations;
+}
+
+namespace sofa::component::odesolver::backward
+{
+
+/**
+ * Forcing terms of an inexact Newton method, i.e. the relative tolerance of the linear solve of each Newton iteration.
+ *
+ * It follows the second choice of [Eisenstat and Walker, Choosing the forcing terms in an inexact Newton method,
+ * SIAM J. Sci. Comput. 17(1), 1996]:
+ *
+ *   \f$ \eta_k = \gamma \left( \frac{|F_k|}{|F_{k-1}|} \right)^\alpha \f$
+ *
+ * with the safeguard \f$ \eta_k = \max(\eta_k, \gamma \eta_{k-1}^\alpha) \f$ when \f$ \gamma \eta_{k-1}^\alpha > 0.1 \f$,
+ * preventing the forcing terms to decrease too quickly while the convergence is not yet superlinear, and the safeguard
+ * \f$ \eta_k = \max(\eta_k, 0.5 \frac{\tau}{|F_k|}) \f$, preventing to over-solve the last iteration before
+ * reaching the residual threshold \f$ \tau \f$.
+ */
+class SOFA_COMPONENT_ODESOLVER_BACKWARD_API EisenstatWalkerForcingTerm
+{
+public:
+    EisenstatWalkerForcingTerm(SReal initial, SReal maximum, SReal gamma, SReal alpha);
+
+    /// Forcing term of the first Newton iteration
+    SReal reset();
+
+    /// Forcing term of the next Newton iteration, given the residual norms after and before the last iteration.
+    /// @param residualThreshold absolute residual norm at which the Newton iterations stop (ignored if not positive)
+    SReal next(SReal residualNorm, SReal previousResidualNorm, SReal residualThreshold);
+
+    SReal current() const { return m_current; }
+
+private:
+    SReal m_initial;
+    SReal m_maximum;
+    SReal m_gamma;
+    SReal m_alpha;
+    SReal m_current;
+};
+
+/**
+ * Solve \f$ (m M + b B + k K) x = rhs \f$ using a conjugate gradient where the matrix-vector products are computed
+ * without assembling any matrix, with addMBKdx (i.e. addMDx and addDForce through the mappings), and projected
+ * with the projective constraints. The system matrix must be symmetric positive definite (e.g. m >= 0 and k <= 0,
+ * K being the derivative of the forces).
+ *
+ * @return the number of iterations
+ */
+SOFA_COMPONENT_ODESOLVER_BACKWARD_API
+unsigned int matrixFreeConjugateGradient(simulation::common::MechanicalOperations& mop,
+                                         simulation::common::VectorOperations& vop,
+                                         core::MultiVecDerivId x, core::MultiVecDerivId rhs,
+                                         SReal m, SReal b, SReal k,
+                                         SReal relativeTolerance, unsigned int maxIterations);
+
+} // namespace sofa::component::odesolver::backward
@@ -53,8 +53,19 @@ NewmarkImplicitSolver::NewmarkImplicitSolver()
                        "Newmark scheme gamma coefficient"))
     , d_beta(initData(&d_beta, 0.25_sreal, "beta", "Newmark scheme beta coefficient"))
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_adaptiveTimeStep(initData(&d_adaptiveTimeStep, false, "adaptiveTimeStep", "Integrate each time step in sub-steps whose size is controlled by an estimate of the local error. Not supported in the free motion of constraint-based animation loops."))
+    , d_adaptiveTolerance(initData(&d_adaptiveTolerance, (SReal)1e-4, "adaptiveTolerance", "Adaptive time step: absolute tolerance on the local error of the positions."))
+    , d_adaptiveRelativeTolerance(initData(&d_adaptiveRelativeTolerance, (SReal)0.0, "adaptiveRelativeTolerance", "Adaptive time step: tolerance on the local error of the positions, relative to their infinite norm."))
+    , d_adaptiveMinDt(initData(&d_adaptiveMinDt, (SReal)1e-6, "adaptiveMinDt", "Adaptive time step: sub-steps smaller than this size are accepted whatever their error."))
+    , d_adaptiveMaxSubSteps(initData(&d_adaptiveMaxSubSteps, 100u, "adaptiveMaxSubSteps", "Adaptive time step: maximum number of sub-steps (accepted or rejected) per time step."))
+    , d_nbSubSteps(initData(&d_nbSubSteps, 0u, "nbSubSteps", "Output: number of accepted sub-steps of the last time step."))
+    , d_nbRejectedSubSteps(initData(&d_nbRejectedSubSteps, 0u, "nbRejectedSubSteps", "Output: number of rejected sub-steps of the last time step."))
+    , d_subStepDt(initData(&d_subStepDt, (SReal)0.0, "subStepDt", "Output: size of the last accepted sub-step."))
 {
     cpt=0;
+    d_nbSubSteps.setReadOnly(true);
+    d_nbRejectedSubSteps.setReadOnly(true);
+    d_subStepDt.setReadOnly(true);
 }
 
 
@@ -62,23 +73,6 @@ void NewmarkImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa
 {
     sofa::simulation::common::VectorOperations vop( params, this->getContext() );
     sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
-    MultiVecCoord pos(&vop, core::VecCoordId::position() );
-    MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
-    MultiVecDeriv b(&vop);
-    MultiVecDeriv aResult(&vop);
-    MultiVecCoord newPos(&vop, xResult );
-    MultiVecDeriv newVel(&vop, vResult );
-
-
-    // dx is no longer allocated by default (but it will be deleted automatically by the mechanical objects)
-    MultiVecDeriv dx(&vop, core::VecDerivId::dx()); dx.realloc(&vop, !d_threadSafeVisitor.getValue(), true);
-
-
-    const SReal h = dt;
-    const SReal gamma = d_gamma.getValue();
-    const SReal beta = d_beta.getValue();
-    const SReal rM = d_rayleighMass.getValue();
-    const SReal rK = d_rayleighStiffness.getValue();
 
     // 1. Initialize a_t and to store it as a vecId to be used in the resolution of this solver (using as well old xand v)
     // Once we have a_{t+dt} we can update the new x and v.
@@ -94,11 +88,87 @@ void NewmarkImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa
 
     if(cpt == 0)
     {
+        MultiVecCoord pos(&vop, core::VecCoordId::position() );
+        MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
         a.clear();
         mop.computeAcc(0,a,pos,vel);
     }
     cpt++;
 
+    if (!d_adaptiveTimeStep.getValue())
+    {
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    if (!AdaptiveTimeStepper::supports(xResult, vResult))
+    {
+        msg_warning_when(d_nbSubSteps.getValue() == 0) << "The adaptive time step is not supported when integrating the free motion: "
+                                                       << "the time steps are not sub-stepped.";
+        d_nbSubSteps.setValue(1);
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    AdaptiveTimeStepper::Parameters parameters;
+    parameters.absoluteTolerance = d_adaptiveTolerance.getValue();
+    parameters.relativeTolerance = d_adaptiveRelativeTolerance.getValue();
+    parameters.minDt = d_adaptiveMinDt.getValue();
+    parameters.maxSubSteps = d_adaptiveMaxSubSteps.getValue();
+    parameters.order = 2;
+
+    // The leading term of the local error vanishes for beta = 1/6: use the coefficient of the central
+    // difference scheme instead, so that the estimate remains meaningful.
+    SReal errorCoefficient = std::abs(d_beta.getValue() - 1.0 / 6.0);
+    if (errorCoefficient < 1e-3)
+        errorCoefficient = 1.0 / 12.0;
+
+    MultiVecDeriv startAcceleration(&vop);
+    MultiVecDeriv accelerationIncrement(&vop);
+
+    m_adaptiveTimeStepper.integrate(params, this->getContext(), dt, parameters,
+        [&](SReal h, core::MultiVecDerivId /*startVelocity*/)
+        {
+            startAcceleration.eq(a);
+            solveStep(params, h, xResult, vResult);
+
+            accelerationIncrement.eq(a, startAcceleration, -1.0);
+            return h * h * errorCoefficient * accelerationIncrement.norm(0);
+        },
+        [&]()
+        {
+            a.eq(startAcceleration);
+        });
+
+    const auto& statistics = m_adaptiveTimeStepper.getStatistics();
+    d_nbSubSteps.setValue(statistics.nbSubSteps);
+    d_nbRejectedSubSteps.setValue(statistics.nbRejectedSubSteps);
+    d_subStepDt.setValue(statistics.lastDt);
+}
+
+void NewmarkImplicitSolver::solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+    MultiVecCoord pos(&vop, core::VecCoordId::position() );
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
+    MultiVecDeriv b(&vop);
+    MultiVecDeriv aResult(&vop);
+    MultiVecCoord newPos(&vop, xResult );
+    MultiVecDeriv newVel(&vop, vResult );
+    MultiVecDeriv a(&vop, pID);
+
+
+    // dx is no longer allocated by default (but it will be deleted automatically by the mechanical objects)
+    MultiVecDeriv dx(&vop, core::VecDerivId::dx()); dx.realloc(&vop, !d_threadSafeVisitor.getValue(), true);
+
+
+    const SReal h = dt;
+    const SReal gamma = d_gamma.getValue();
+    const SReal beta = d_beta.getValue();
+    const SReal rM = d_rayleighMass.getValue();
+    const SReal rK = d_rayleighStiffness.getValue();
+
     msg_info() << "aPrevious = " << a;
     msg_info() << "xPrevious = " << pos;
     msg_info() << "vPrevious = " << vel;
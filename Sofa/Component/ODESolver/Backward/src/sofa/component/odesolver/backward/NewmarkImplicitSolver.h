@@ -23,6 +23,7 @@
 
 #include <sofa/component/odesolver/backward/config.h>
 
+#include <sofa/component/odesolver/backward/AdaptiveTimeStepper.h>
 #include <sofa/core/behavior/OdeSolver.h>
 
 namespace sofa::component::odesolver::backward
@@ -45,6 +46,9 @@ namespace sofa::component::odesolver::backward
  *
  * The current implementation first computes $a_t$ directly (as in the explicit solvers), then solves the previous system to compute $a_{t+dt}$, and finally computes the new position and velocity.
  *
+ * With adaptiveTimeStep, each time step of the context is integrated in sub-steps whose size is controlled by the
+ * estimate of the local error on the positions of Zienkiewicz and Xie: $ h^2 |\beta - 1/6| |a_{t+h} - a_t|_\infty $.
+ *
 */
 class SOFA_COMPONENT_ODESOLVER_BACKWARD_API NewmarkImplicitSolver : public sofa::core::behavior::OdeSolver
 {
@@ -65,6 +69,15 @@ public:
 
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
 
+    Data<bool> d_adaptiveTimeStep; ///< Integrate each time step in sub-steps whose size is controlled by an estimate of the local error.
+    Data<SReal> d_adaptiveTolerance; ///< Adaptive time step: absolute tolerance on the local error of the positions.
+    Data<SReal> d_adaptiveRelativeTolerance; ///< Adaptive time step: tolerance on the local error of the positions, relative to their infinite norm.
+    Data<SReal> d_adaptiveMinDt; ///< Adaptive time step: sub-steps smaller than this size are accepted whatever their error.
+    Data<unsigned int> d_adaptiveMaxSubSteps; ///< Adaptive time step: maximum number of sub-steps (accepted or rejected) per time step.
+    Data<unsigned int> d_nbSubSteps; ///< Output: number of accepted sub-steps of the last time step.
+    Data<unsigned int> d_nbRejectedSubSteps; ///< Output: number of rejected sub-steps of the last time step.
+    Data<SReal> d_subStepDt; ///< Output: size of the last accepted sub-step.
+
     void solve (const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult) override;
 
     /// Given a displacement as computed by the linear system inversion, how much will it affect the velocity
@@ -121,6 +134,11 @@ public:
             return vect[outputDerivative];
     }
 
+protected:
+    /// Integrates a single step of size dt, from the acceleration stored in pID
+    void solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult);
+
+    AdaptiveTimeStepper m_adaptiveTimeStepper;
 };
 
 } // namespace sofa::component::odesolver::backward
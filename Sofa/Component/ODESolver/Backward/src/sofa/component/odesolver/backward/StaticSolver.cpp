@@ -20,12 +20,14 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/odesolver/backward/StaticSolver.h>
+#include <sofa/component/odesolver/backward/InexactNewton.h>
 
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
 #include <sofa/simulation/MechanicalOperations.h>
 #include <sofa/simulation/VectorOperations.h>
 #include <sofa/core/behavior/MultiMatrix.h>
+#include <sofa/core/behavior/LinearSolver.h>
 #include <sofa/simulation/Node.h>
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
 
@@ -69,7 +71,68 @@ StaticSolver::StaticSolver()
             false,
             "should_diverge_when_residual_is_growing",
             "Divergence criterion: The newton iterations will stop when the residual is greater than the one from the previous iteration."))
-{}
+    , d_newton_krylov(initData(&d_newton_krylov,
+            false,
+            "newton_krylov",
+            "Inexact Newton: the relative tolerance of each linear solve is adapted to the reduction of the residual "
+            "(Eisenstat-Walker forcing terms). Requires an iterative linear solver, or matrix_free."))
+    , d_forcing_term_initial(initData(&d_forcing_term_initial,
+            0.5_sreal,
+            "forcing_term_initial",
+            "Inexact Newton: relative tolerance of the linear solve of the first Newton iteration."))
+    , d_forcing_term_max(initData(&d_forcing_term_max,
+            0.9_sreal,
+            "forcing_term_max",
+            "Inexact Newton: maximum relative tolerance of the linear solves."))
+    , d_forcing_term_gamma(initData(&d_forcing_term_gamma,
+            0.9_sreal,
+            "forcing_term_gamma",
+            "Inexact Newton: factor gamma of the forcing terms gamma (|R_k|/|R_k-1|)^alpha."))
+    , d_forcing_term_alpha(initData(&d_forcing_term_alpha,
+            static_cast<SReal>(1.618033988749895),
+            "forcing_term_alpha",
+            "Inexact Newton: exponent alpha of the forcing terms gamma (|R_k|/|R_k-1|)^alpha."))
+    , d_matrix_free(initData(&d_matrix_free,
+            false,
+            "matrix_free",
+            "The linear systems are solved by a conjugate gradient computing the products with the stiffness through "
+            "addDForce, without any linear solver component."))
+    , d_matrix_free_tolerance(initData(&d_matrix_free_tolerance,
+            1e-8_sreal,
+            "matrix_free_tolerance",
+            "Relative tolerance of the matrix-free conjugate gradient when newton_krylov is disabled."))
+    , d_matrix_free_max_iterations(initData(&d_matrix_free_max_iterations,
+            (unsigned) 1000,
+            "matrix_free_max_iterations",
+            "Maximum number of iterations of the matrix-free conjugate gradient."))
+    , d_line_search(initData(&d_line_search,
+            false,
+            "line_search",
+            "The Newton increment is halved until the residual decreases sufficiently (requires more than one Newton iteration)."))
+    , d_line_search_max_iterations(initData(&d_line_search_max_iterations,
+            (unsigned) 10,
+            "line_search_max_iterations",
+            "Maximum number of times the Newton increment is halved."))
+    , d_nb_newton_iterations(initData(&d_nb_newton_iterations,
+            (unsigned) 0,
+            "nb_newton_iterations",
+            "Output: number of Newton iterations of the last time step."))
+    , d_nb_linear_iterations(initData(&d_nb_linear_iterations,
+            (unsigned) 0,
+            "nb_linear_iterations",
+            "Output: total number of iterations of the linear solves of the last time step (0 for direct solvers)."))
+    , d_forcing_terms(initData(&d_forcing_terms,
+            "forcing_terms",
+            "Output: relative tolerances of the linear solves of the last time step (inexact Newton only)."))
+    , d_residual_norms(initData(&d_residual_norms,
+            "residual_norms",
+            "Output: residual norms |R| at the end of each Newton iteration of the last time step."))
+{
+    d_nb_newton_iterations.setReadOnly(true);
+    d_nb_linear_iterations.setReadOnly(true);
+    d_forcing_terms.setReadOnly(true);
+    d_residual_norms.setReadOnly(true);
+}
 
 void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
 {
@@ -79,6 +142,8 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     using std::chrono::steady_clock;
     using sofa::helper::ScopedAdvancedTimer;
     using sofa::core::behavior::MultiMatrix;
+    using sofa::core::behavior::LinearSolver;
+    using sofa::core::objectmodel::BaseContext;
     using sofa::simulation::common::VectorOperations;
     using sofa::simulation::common::MechanicalOperations;
 
@@ -121,6 +186,12 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     const auto & absolute_residual_tolerance_threshold = d_absolute_residual_tolerance_threshold.getValue();
     const auto & max_number_of_newton_iterations = d_newton_iterations.getValue();
     const auto & should_diverge_when_residual_is_growing = d_should_diverge_when_residual_is_growing.getValue();
+    const auto & newton_krylov = d_newton_krylov.getValue();
+    const auto & matrix_free = d_matrix_free.getValue();
+    const auto & matrix_free_tolerance = d_matrix_free_tolerance.getValue();
+    const auto & matrix_free_max_iterations = d_matrix_free_max_iterations.getValue();
+    const bool line_search = d_line_search.getValue() && max_number_of_newton_iterations > 1;
+    const auto & line_search_max_iterations = d_line_search_max_iterations.getValue();
     const auto & print_log = f_printLog.getValue();
     auto info = MessageDispatcher::info(Message::Runtime, std::make_shared<ComponentInfo>(this->getClassName()), SOFA_FILE_INFO);
 
@@ -134,6 +205,16 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     bool converged = false, diverged = false;
     steady_clock::time_point t;
 
+    // Inexact Newton: relative tolerance of the next linear solve (0 for an exact solve)
+    EisenstatWalkerForcingTerm forcing(d_forcing_term_initial.getValue(), d_forcing_term_max.getValue(),
+                                       d_forcing_term_gamma.getValue(), d_forcing_term_alpha.getValue());
+    SReal forcing_term = newton_krylov ? forcing.reset() : 0;
+    sofa::type::vector<SReal> forcing_terms;
+    unsigned nb_linear_iterations = 0;
+
+    // The linear solver is only needed here to adapt its tolerance and to get its number of iterations
+    LinearSolver* linear_solver = matrix_free ? nullptr : context->get<LinearSolver>(context->getTags(), BaseContext::SearchDown);
+
     // Reset the list of residual norms for this time step
     p_squared_residual_norms.clear();
     p_squared_residual_norms.reserve(max_number_of_newton_iterations);
@@ -205,8 +286,12 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
         SCOPED_TIMER_VARNAME(step_timer, "NewtonStep");
         t = steady_clock::now();
 
+        // Residual at the beginning of the iteration, used by the forcing terms and the line search
+        const auto R_start_squared_norm = R_squared_norm;
+
         // Part I. Assemble the system matrix.
         MultiMatrix<MechanicalOperations> matrix(&mop);
+        if (! matrix_free)
         {
             SCOPED_TIMER("MBKBuild");
             // 1. The MechanicalMatrix::K is a simple structure that stores three floats called factors: m, b and k.
@@ -229,7 +314,33 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             // Calls methods "setSystemRHVector", "setSystemLHVector" and "solveSystem" of the LinearSolver component
             // for CG: calls iteratively addDForce, mapped:  [applyJ, addDForce, applyJt(vec)]+
             // for Direct: solves the system, everything's already assembled
-            matrix.solve(dx, force);
+            if (newton_krylov)
+            {
+                forcing_terms.push_back(forcing_term);
+            }
+
+            if (matrix_free)
+            {
+                // Same products as a CG on a GraphScatteredMatrix: -K is positive definite for stable materials
+                nb_linear_iterations += matrixFreeConjugateGradient(mop, vop, dx, force, 0, 0, -1,
+                    newton_krylov ? forcing_term : matrix_free_tolerance, matrix_free_max_iterations);
+            }
+            else
+            {
+                if (newton_krylov && linear_solver && !linear_solver->setNextRelativeTolerance(forcing_term) && !p_inexact_solve_warning_shown)
+                {
+                    msg_warning() << "The linear solver " << linear_solver->getPathName() << " does not support inexact solves: "
+                                  << "the linear systems are solved exactly. Use an iterative linear solver, or matrix_free.";
+                    p_inexact_solve_warning_shown = true;
+                }
+
+                matrix.solve(dx, force);
+
+                if (linear_solver)
+                {
+                    nb_linear_iterations += linear_solver->getNbIterations();
+                }
+            }
         }
 
         // Part III. Propagate the solution increment and update geometry.
@@ -269,6 +380,46 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             mop.projectResponse(force);
         }
 
+        // Part IV bis. Line search: the increment is halved until the residual decreases sufficiently, following
+        // the backtracking of [Eisenstat and Walker, Globally convergent inexact Newton methods, 1994]:
+        //     |R(x + s du)| <= (1 - t s (1 - eta)) |R(x)|
+        if (line_search)
+        {
+            SCOPED_TIMER("LineSearch");
+            static constexpr SReal sufficient_decrease = 1e-4;
+            const auto R_start_norm = std::sqrt(R_start_squared_norm);
+            const auto is_sufficient = [&](SReal step, SReal squared_norm)
+            {
+                const auto bound = (1 - sufficient_decrease * step * (1 - forcing_term)) * R_start_norm;
+                return squared_norm <= bound * bound;
+            };
+
+            SReal step = 1;
+            unsigned nb_backtracks = 0;
+            auto trial_squared_norm = force.dot(force);
+            while (! is_sufficient(step, trial_squared_norm) && nb_backtracks < line_search_max_iterations)
+            {
+                step *= 0.5;
+                x.peq(dx, -step); // x := x_start + step * dx
+                mop.solveConstraint(x, sofa::core::ConstraintOrder::POS);
+                MechanicalPropagateOnlyPositionAndVelocityVisitor(&mechanical_parameters).execute(context);
+
+                mop.computeForce(force);
+                mop.projectResponse(force);
+                trial_squared_norm = force.dot(force);
+                ++nb_backtracks;
+            }
+
+            if (nb_backtracks > 0)
+            {
+                dx.teq(step); // the increment actually applied
+                if (print_log)
+                {
+                    info << "Line search: the increment was scaled by " << step << "\n";
+                }
+            }
+        }
+
         // Part V. Compute the updated norms.
         {
             SCOPED_TIMER("ComputeNorms");
@@ -284,6 +435,11 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
 
             p_squared_residual_norms.emplace_back(R_squared_norm);
 
+            if (newton_krylov)
+            {
+                forcing_term = forcing.next(std::sqrt(R_squared_norm), std::sqrt(R_start_squared_norm), absolute_residual_tolerance_threshold);
+            }
+
             // Displacement norm
             U.peq(dx);
             dx_squared_norm = dx.dot(dx);
@@ -390,6 +546,18 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
         R_previous_squared_norm = R_squared_norm;
     }
 
+    d_nb_newton_iterations.setValue(n_it);
+    d_nb_linear_iterations.setValue(nb_linear_iterations);
+    d_forcing_terms.setValue(forcing_terms);
+    {
+        auto residual_norms = sofa::helper::getWriteOnlyAccessor(d_residual_norms);
+        residual_norms.clear();
+        for (const auto & squared_norm : p_squared_residual_norms)
+        {
+            residual_norms.push_back(std::sqrt(squared_norm));
+        }
+    }
+
     n_it--; // Reset to the actual index of the last iteration completed
 
     if (! converged && ! diverged && n_it == (max_number_of_newton_iterations-1))
@@ -403,6 +571,7 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     sofa::helper::AdvancedTimer::valSet("nb_iterations", n_it+1);
     sofa::helper::AdvancedTimer::valSet("residual", std::sqrt(R_squared_norm));
     sofa::helper::AdvancedTimer::valSet("correction", std::sqrt(dx_squared_norm));
+    sofa::helper::AdvancedTimer::valSet("nb_linear_iterations", nb_linear_iterations);
 }
 
 
@@ -24,6 +24,7 @@
 
 #include <sofa/core/behavior/OdeSolver.h>
 #include <sofa/core/behavior/MultiVec.h>
+#include <sofa/type/vector.h>
 
 namespace sofa::component::odesolver::backward
 {
@@ -55,6 +56,12 @@ using sofa::core::objectmodel::Data;
  *     \mat{K}(\vec{x}_{n+1}^i) \left [ \Delta \vec{x}_{n+1}^{i+1} \right ] &= - \vec{F}(\vec{x}_{n+1}^i) \\
  *     \vec{x}_{n+1}^{i+1} &= \vec{x}_{n+1}^{i} + \Delta \vec{x}_{n+1}^{i+1}
  * \f}
+ *
+ * With newton_krylov, the linear systems are solved inexactly: the relative tolerance of the iterative linear solver
+ * (the forcing term) is loose in the first Newton iterations and tightens as the residual decreases, following
+ * Eisenstat and Walker. This avoids over-solving the linear systems far from the solution. With matrix_free, the
+ * linear systems are solved by a conjugate gradient computing the products with the stiffness through addDForce.
+ * With line_search, the increment is halved until the residual decreases sufficiently.
  */
 class SOFA_COMPONENT_ODESOLVER_BACKWARD_API StaticSolver : public sofa::core::behavior::OdeSolver
 {
@@ -153,6 +160,22 @@ protected:
     Data<SReal> d_relative_residual_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the ratio |R|/|R0| is smaller than this threshold. Use a negative value to disable this criterion.
     Data<bool> d_should_diverge_when_residual_is_growing; ///< Divergence criterion: The newton iterations will stop when the residual is greater than the one from the previous iteration.
 
+    Data<bool> d_newton_krylov; ///< Inexact Newton: the relative tolerance of each linear solve is adapted to the reduction of the residual (Eisenstat-Walker forcing terms).
+    Data<SReal> d_forcing_term_initial; ///< Inexact Newton: relative tolerance of the linear solve of the first Newton iteration.
+    Data<SReal> d_forcing_term_max; ///< Inexact Newton: maximum relative tolerance of the linear solves.
+    Data<SReal> d_forcing_term_gamma; ///< Inexact Newton: factor gamma of the forcing terms gamma (|R_k|/|R_k-1|)^alpha.
+    Data<SReal> d_forcing_term_alpha; ///< Inexact Newton: exponent alpha of the forcing terms gamma (|R_k|/|R_k-1|)^alpha.
+    Data<bool> d_matrix_free; ///< The linear systems are solved by a conjugate gradient computing the products with the stiffness through addDForce, without any linear solver component.
+    Data<SReal> d_matrix_free_tolerance; ///< Relative tolerance of the matrix-free conjugate gradient when newton_krylov is disabled.
+    Data<unsigned> d_matrix_free_max_iterations; ///< Maximum number of iterations of the matrix-free conjugate gradient.
+    Data<bool> d_line_search; ///< The Newton increment is halved until the residual decreases sufficiently.
+    Data<unsigned> d_line_search_max_iterations; ///< Maximum number of times the Newton increment is halved.
+
+    Data<unsigned> d_nb_newton_iterations; ///< Output: number of Newton iterations of the last time step.
+    Data<unsigned> d_nb_linear_iterations; ///< Output: total number of iterations of the linear solves of the last time step (0 for direct solvers).
+    Data<sofa::type::vector<SReal> > d_forcing_terms; ///< Output: relative tolerances of the linear solves of the last time step (inexact Newton only).
+    Data<sofa::type::vector<SReal> > d_residual_norms; ///< Output: residual norms |R| at the end of each Newton iteration of the last time step.
+
 private:
     /// Sum of displacement increments since the beginning of the time step
     sofa::core::behavior::MultiVecDeriv U;
@@ -162,6 +185,9 @@ private:
 
     /// List of squared correction increment norms (dx.dot(dx) = ||dx||^2) of every newton iterations of the last solve call.
     std::vector<SReal> p_squared_increment_norms;
+
+    /// The linear solver does not support inexact solves, and the user has already been warned about it.
+    bool p_inexact_solve_warning_shown = false;
 };
 
 } // namespace sofa::component::odesolver::backward
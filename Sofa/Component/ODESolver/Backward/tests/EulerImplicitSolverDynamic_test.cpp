@@ -186,4 +186,132 @@ TYPED_TEST( EulerImplicitDynamic_test , eulerImplicitSolverDynamicTest_small_dt_
    this-> compareSimulatedToTheoreticalPositions(5e-16,0.001);
 }
 
+/// With an adaptive time step, a time step much larger than the period of the oscillations is integrated in sub-steps
+/// so that the numerical damping of the implicit Euler scheme remains small.
+struct EulerImplicitAdaptive_test : public component::odesolver::testing::ODESolverSpringTest
+{
+};
+
+TEST_F(EulerImplicitAdaptive_test, adaptiveTimeStepFollowsTheOscillation)
+{
+    // w = sqrt(K/m), and the equilibrium position is at y = 0: y(t) = cos(wt)
+    const double K = 100, m = 10, dt = 0.1;
+    this->prepareScene(K, m, 1);
+    const auto solver = simpleapi::createObject(m_si.root, "EulerImplicitSolver", {
+        { "adaptiveTimeStep", "true"},
+        { "adaptiveTolerance", simpleapi::str(1e-4)}
+    });
+    m_si.initScene();
+
+    const simulation::Node::SPtr massNode = m_si.root->getChild("MassNode");
+    const auto dofs = massNode->get<MechanicalObject3>(m_si.root->SearchDown);
+    ASSERT_NE(dofs, nullptr);
+
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        m_si.simulate(dt);
+    }
+    EXPECT_NEAR(m_si.root->getTime(), 1.0, 1e-10);
+
+    const auto nbSubSteps = dynamic_cast<core::objectmodel::Data<unsigned int>*>(solver->findData("nbSubSteps"));
+    ASSERT_NE(nbSubSteps, nullptr);
+    EXPECT_GT(nbSubSteps->getValue(), 1u);
+
+    // with a single step per dt, the amplitude would be damped by 40%
+    const double y = dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0][1];
+    EXPECT_NEAR(y, std::cos(std::sqrt(K / m) * 1.0), 0.05);
+}
+
+/// Newton iterations on a mass swinging on a spring, a geometrically non-linear problem: the exact, inexact
+/// (Eisenstat-Walker forcing terms) and matrix-free Newton iterations converge to the same positions.
+struct EulerImplicitNewton_test : public component::odesolver::testing::ODESolverSpringTest
+{
+    core::sptr<core::objectmodel::BaseObject> m_solver;
+
+    /// Position of the mass after 10 time steps
+    type::Vec3 simulate(std::map<std::string, std::string> parameters)
+    {
+        simulation::node::unload(m_si.root);
+        m_si.root = simulation::getSimulation()->createNewGraph("root");
+
+        this->prepareScene(100, 1, 0.5);
+        parameters["rayleighStiffness"] = "0";
+        parameters["rayleighMass"] = "0";
+        m_solver = simpleapi::createObject(m_si.root, "EulerImplicitSolver", parameters);
+
+        const simulation::Node::SPtr massNode = m_si.root->getChild("MassNode");
+        const auto dofs = massNode->get<MechanicalObject3>(m_si.root->SearchDown);
+        EXPECT_NE(dofs, nullptr);
+        if (dofs == nullptr)
+        {
+            return {};
+        }
+
+        // the mass is moved aside, so that the spring force is not linear in the position of the mass
+        dofs->findData("position")->read("1 1 0");
+        m_si.initScene();
+
+        for (unsigned int i = 0; i < 10; ++i)
+        {
+            m_si.simulate(0.05);
+        }
+        return dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0];
+    }
+
+    template<class T>
+    T getOutput(const std::string& name) const
+    {
+        const auto data = dynamic_cast<core::objectmodel::Data<T>*>(m_solver->findData(name));
+        EXPECT_NE(data, nullptr) << name;
+        return data ? data->getValue() : T();
+    }
+
+    /// The Newton iterations of the last time step reduced the residual under the tolerance
+    void checkConvergence(SReal tolerance)
+    {
+        EXPECT_GT(getOutput<unsigned int>("nbNewtonIterations"), 1u);
+        const auto residualNorms = getOutput<type::vector<SReal>>("residualNorms");
+        ASSERT_GE(residualNorms.size(), 2u);
+        EXPECT_LT(residualNorms.back(), tolerance * residualNorms.front());
+    }
+};
+
+TEST_F(EulerImplicitNewton_test, newtonKrylovAndMatrixFree)
+{
+    const std::map<std::string, std::string> newton {
+        { "newtonIterations", "20"},
+        { "newtonTolerance", "1e-8"}
+    };
+
+    const type::Vec3 exact = simulate(newton);
+    checkConvergence(1e-8);
+    EXPECT_TRUE(getOutput<type::vector<SReal>>("forcingTerms").empty());
+
+    // a single linearization per time step gives another result
+    const type::Vec3 linearized = simulate({});
+    EXPECT_GT((linearized - exact).norm(), 1e-6);
+
+    auto newtonKrylov = newton;
+    newtonKrylov["newtonKrylov"] = "true";
+    const type::Vec3 inexact = simulate(newtonKrylov);
+    checkConvergence(1e-8);
+    const auto forcingTerms = getOutput<type::vector<SReal>>("forcingTerms");
+    ASSERT_FALSE(forcingTerms.empty());
+    EXPECT_NEAR(forcingTerms.front(), 0.5, 1e-12);
+    EXPECT_NEAR((inexact - exact).norm(), 0, 1e-6);
+
+    auto matrixFree = newtonKrylov;
+    matrixFree["matrixFree"] = "true";
+    const type::Vec3 inexactMatrixFree = simulate(matrixFree);
+    checkConvergence(1e-8);
+    EXPECT_NEAR((inexactMatrixFree - exact).norm(), 0, 1e-6);
+
+    auto exactMatrixFree = newton;
+    exactMatrixFree["matrixFree"] = "true";
+    exactMatrixFree["matrixFreeTolerance"] = "1e-12";
+    const type::Vec3 matrixFreePosition = simulate(exactMatrixFree);
+    checkConvergence(1e-8);
+    EXPECT_NEAR((matrixFreePosition - exact).norm(), 0, 1e-6);
+}
+
 } // namespace sofa
@@ -37,6 +37,8 @@ using MechanicalObject3 = sofa::component::statecontainer::MechanicalObject<sofa
 
 #include <sofa/defaulttype/VecTypes.h>
 
+#include <cmath>
+
 namespace sofa {
 
 using namespace component;
@@ -202,4 +204,39 @@ TYPED_TEST( NewmarkImplicitDynamic_test , newmarkImplicitSolverDynamicTest_small
    this-> compareSimulatedToTheoreticalPositions(9e-16,0.001);
 }
 
+struct NewmarkImplicitAdaptive_test : public component::odesolver::testing::ODESolverSpringTest
+{
+};
+
+TEST_F(NewmarkImplicitAdaptive_test, adaptiveTimeStepFollowsTheOscillation)
+{
+    // w = sqrt(K/m), and the equilibrium position is at y = 0: y(t) = cos(wt)
+    const double K = 100, m = 10, dt = 0.5;
+    this->prepareScene(K, m, 1);
+    const auto solver = simpleapi::createObject(m_si.root, "NewmarkImplicitSolver", {
+        { "adaptiveTimeStep", "true"},
+        { "adaptiveTolerance", simpleapi::str(1e-4)}
+    });
+    m_si.initScene();
+
+    const simulation::Node::SPtr massNode = m_si.root->getChild("MassNode");
+    const auto dofs = massNode->get<MechanicalObject3>(m_si.root->SearchDown);
+    ASSERT_NE(dofs, nullptr);
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        m_si.simulate(dt);
+    }
+    EXPECT_NEAR(m_si.root->getTime(), 1.0, 1e-10);
+
+    const auto nbSubSteps = dynamic_cast<core::objectmodel::Data<unsigned int>*>(solver->findData("nbSubSteps"));
+    ASSERT_NE(nbSubSteps, nullptr);
+    EXPECT_GT(nbSubSteps->getValue(), 1u);
+
+    // with a single step per dt, the period elongation of the trapezoidal rule would shift the
+    // position by 0.1
+    const double y = dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0][1];
+    EXPECT_NEAR(y, std::cos(std::sqrt(K / m) * 1.0), 0.02);
+}
+
 } // namespace sofa
@@ -235,3 +235,48 @@ TEST_F(StaticSolverTest, AbsoluteIncrements) {
     << "The static ODE solver is supposed to converge after 8 Newton steps when using a relative correction threshold of 1e-5.\n"
     << actual_increment_norms;
 }
+
+TEST_F(StaticSolverTest, NewtonKrylovMatrixFree) {
+    using namespace sofa::core::objectmodel;
+    using sofa::type::vector;
+    using sofa::type::Vec3;
+
+    // Solve until |R|/|R0| < 1e-6, with either exact or inexact (Eisenstat-Walker) matrix-free linear solves
+    const auto solve = [this](bool newton_krylov) -> std::pair<vector<Vec3>, unsigned> {
+        this->solver->findData("newton_iterations")->read("50");
+        this->solver->findData("absolute_correction_tolerance_threshold")->read("-1");
+        this->solver->findData("relative_correction_tolerance_threshold")->read("-1");
+        this->solver->findData("absolute_residual_tolerance_threshold")->read("-1");
+        this->solver->findData("relative_residual_tolerance_threshold")->read("1e-6");
+        this->solver->findData("matrix_free")->read("true");
+        this->solver->findData("matrix_free_tolerance")->read("1e-10");
+        this->solver->findData("newton_krylov")->read(newton_krylov ? "true" : "false");
+
+        const std::vector<SReal> residuals = this->execute().first;
+        EXPECT_LT(residuals.size(), 50)
+        << "The static ODE solver is supposed to converge before the maximum number of Newton iterations.";
+
+        const auto nb_linear_iterations = dynamic_cast< Data<unsigned> * > ( this->solver->findData("nb_linear_iterations") )->getValue();
+        const auto positions = dynamic_cast< Data<vector<Vec3>> * > ( this->root->getObject("mo")->findData("position") )->getValue();
+        return {positions, nb_linear_iterations};
+    };
+
+    const auto [exact_positions, exact_nb_iterations] = solve(false);
+
+    this->onTearDown();
+    this->onSetUp();
+    const auto [inexact_positions, inexact_nb_iterations] = solve(true);
+
+    ASSERT_EQ(exact_positions.size(), inexact_positions.size());
+    for (std::size_t i = 0; i < exact_positions.size(); ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(exact_positions[i][j], inexact_positions[i][j], 1e-3);
+        }
+    }
+
+    EXPECT_LT(inexact_nb_iterations, exact_nb_iterations)
+    << "The inexact Newton method is supposed to require less conjugate gradient iterations.";
+
+    const auto & forcing_terms = dynamic_cast< Data<vector<SReal>> * > ( this->solver->findData("forcing_terms") )->getValue();
+    EXPECT_FALSE(forcing_terms.empty());
+}
@@ -24,6 +24,9 @@
 #include <sofa/simulation/MechanicalOperations.h>
 #include <sofa/simulation/VectorOperations.h>
 #include <sofa/core/ObjectFactory.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+#include <algorithm>
 
 namespace sofa::component::odesolver::forward
 {
@@ -35,7 +38,11 @@ using namespace core::behavior;
 CentralDifferenceSolver::CentralDifferenceSolver()
     : f_rayleighMass( initData(&f_rayleighMass,(SReal)0.0,"rayleighMass","Rayleigh damping coefficient related to mass"))
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_nbSubSteps(initData(&d_nbSubSteps, 1u, "nbSubSteps", "Number of sub-steps per time step. Not supported in the free motion of constraint-based animation loops."))
+    , d_lumpedMassFastPath(initData(&d_lumpedMassFastPath, false, "lumpedMassFastPath", "If true, integrates each mechanical state independently, without visitor, when all the masses are diagonal and no component acts on several or on mapped mechanical states. Otherwise, the regular integration is used."))
+    , d_parallel(initData(&d_parallel, false, "parallel", "If true, the mechanical states are integrated in parallel in the lumped mass fast path."))
 {
+    d_parallel.setGroup("Multithreading");
 }
 
 /**
@@ -75,6 +82,89 @@ CentralDifferenceSolver::CentralDifferenceSolver()
 
 void CentralDifferenceSolver::solve(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
 {
+    const unsigned int nbSubSteps = std::max(1u, d_nbSubSteps.getValue());
+    const bool fastPath = d_lumpedMassFastPath.getValue();
+
+    if (nbSubSteps == 1 && !fastPath)
+    {
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    if (!LumpedMassExplicitIntegrator::isPositionAndVelocity(xResult, vResult))
+    {
+        msg_warning_when(!m_fastPathFallbackWarned) << "The sub-steps and the lumped mass fast path are not supported when integrating the free motion.";
+        m_fastPathFallbackWarned = true;
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    const SReal h = dt / nbSubSteps;
+
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+
+    if (fastPath)
+    {
+        std::string reason;
+        if (m_lumpedMassIntegrator.build(this->getContext(), reason))
+        {
+            SCOPED_TIMER("CentralDifferenceSolve");
+
+            MultiVecDeriv dx(&vop, core::VecDerivId::dx());
+            dx.realloc(&vop, !d_threadSafeVisitor.getValue(), true);
+
+            m_lumpedMassIntegrator.integrate(params, h, nbSubSteps,
+                                             getUpdateOperations(xResult, vResult, dx.id(), h),
+                                             d_parallel.getValue());
+            return;
+        }
+
+        msg_warning_when(!m_fastPathFallbackWarned) << "The lumped mass fast path cannot be used: " << reason
+                                                    << ". The regular integration is used instead.";
+        m_fastPathFallbackWarned = true;
+    }
+
+    MultiVecCoord pos(&vop, core::VecCoordId::position());
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity());
+    for (unsigned int i = 0; i < nbSubSteps; ++i)
+    {
+        if (i > 0)
+        {
+            // the next sub-step starts from the new state, as the animation loop would do
+            mop.projectPositionAndVelocity(pos, vel);
+            mop.propagateXAndV(pos, vel);
+        }
+        solveStep(params, h, xResult, vResult);
+    }
+}
+
+core::behavior::BaseMechanicalState::VMultiOp CentralDifferenceSolver::getUpdateOperations(sofa::core::MultiVecCoordId xResult,
+                                                                                           sofa::core::MultiVecDerivId vResult,
+                                                                                           sofa::core::MultiVecDerivId acc,
+                                                                                           SReal dt) const
+{
+    const SReal r = f_rayleighMass.getValue();
+
+    typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
+    VMultiOp ops;
+    ops.resize(2);
+    // vel = \frac{\frac{1}{dt} - \frac{r}{2}}{\frac{1}{dt} + \frac{r}{2}} vel + \frac{1}{\frac{1}{dt} + \frac{r}{2}} dx
+    // (vel += dx * dt without damping)
+    ops[0].first = vResult;
+    ops[0].second.push_back(std::make_pair(core::MultiVecDerivId(core::VecDerivId::velocity()), (1/dt - r/2)/(1/dt + r/2)));
+    ops[0].second.push_back(std::make_pair(acc, 1/(1/dt + r/2)));
+    // pos += vel * dt
+    ops[1].first = xResult;
+    ops[1].second.push_back(std::make_pair(core::MultiVecCoordId(core::VecCoordId::position()), 1.0));
+    ops[1].second.push_back(std::make_pair(vResult, dt));
+    return ops;
+}
+
+void CentralDifferenceSolver::solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    SCOPED_TIMER("CentralDifferenceSolve");
+
     sofa::simulation::common::VectorOperations vop( params, this->getContext() );
     sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
     mop->setImplicit(false); // this solver is explicit only
@@ -22,6 +22,7 @@
 #pragma once
 #include <sofa/component/odesolver/forward/config.h>
 
+#include <sofa/component/odesolver/forward/LumpedMassExplicitIntegrator.h>
 #include <sofa/core/behavior/OdeSolver.h>
 
 namespace sofa::component::odesolver::forward
@@ -32,6 +33,10 @@ namespace sofa::component::odesolver::forward
  * @see http://www.dynasupport.com/support/tutorial/users.guide/time.integration
  * @see http://en.wikipedia.org/wiki/Leapfrog_method
  *
+ * Each time step can be divided in nbSubSteps sub-steps. With lumpedMassFastPath, if each mechanical state
+ * has a diagonal mass and only depends on itself, the states are integrated independently and without visitor
+ * (see LumpedMassExplicitIntegrator).
+ *
  */
 class SOFA_COMPONENT_ODESOLVER_FORWARD_API CentralDifferenceSolver : public sofa::core::behavior::OdeSolver
 {
@@ -44,6 +49,9 @@ public:
 
     Data<SReal> f_rayleighMass; ///< Rayleigh damping coefficient related to mass
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
+    Data<unsigned int> d_nbSubSteps; ///< Number of sub-steps per time step.
+    Data<bool> d_lumpedMassFastPath; ///< If true, integrates each mechanical state independently, without visitor, when the masses are diagonal and the states independent.
+    Data<bool> d_parallel; ///< If true, the mechanical states are integrated in parallel in the lumped mass fast path.
 
     /// Given an input derivative order (0 for position, 1 for velocity, 2 for acceleration),
     /// how much will it affect the output derivative of the given order.
@@ -74,6 +82,19 @@ public:
         else
             return vect[outputDerivative];
     }
+
+protected:
+    /// Performs a single step of size dt
+    void solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult);
+
+    /// Operations computing the new velocity and position from the acceleration, in a single pass
+    core::behavior::BaseMechanicalState::VMultiOp getUpdateOperations(sofa::core::MultiVecCoordId xResult,
+                                                                      sofa::core::MultiVecDerivId vResult,
+                                                                      sofa::core::MultiVecDerivId acc,
+                                                                      SReal dt) const;
+
+    LumpedMassExplicitIntegrator m_lumpedMassIntegrator;
+    bool m_fastPathFallbackWarned { false };
 };
 
 } // namespace sofa::component::odesolver::forward
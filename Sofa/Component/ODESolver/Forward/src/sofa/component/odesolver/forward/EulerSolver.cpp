@@ -28,6 +28,8 @@
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
 
+#include <algorithm>
+
 #include <sofa/simulation/mechanicalvisitor/MechanicalGetNonDiagonalMassesCountVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalGetNonDiagonalMassesCountVisitor;
 
@@ -47,13 +49,79 @@ int EulerExplicitSolverClass = core::RegisterObject("A simple explicit time inte
 EulerExplicitSolver::EulerExplicitSolver()
     : d_symplectic( initData( &d_symplectic, true, "symplectic", "If true, the velocities are updated before the positions and the method is symplectic (more robust). If false, the positions are updated before the velocities (standard Euler, less robust).") )
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_nbSubSteps(initData(&d_nbSubSteps, 1u, "nbSubSteps", "Number of sub-steps per time step. Not supported in the free motion of constraint-based animation loops."))
+    , d_lumpedMassFastPath(initData(&d_lumpedMassFastPath, false, "lumpedMassFastPath", "If true, integrates each mechanical state independently, without visitor, when all the masses are diagonal and no component acts on several or on mapped mechanical states. Otherwise, the regular integration is used."))
+    , d_parallel(initData(&d_parallel, false, "parallel", "If true, the mechanical states are integrated in parallel in the lumped mass fast path."))
 {
+    d_parallel.setGroup("Multithreading");
 }
 
 void EulerExplicitSolver::solve(const core::ExecParams* params,
                                 SReal dt,
                                 sofa::core::MultiVecCoordId xResult,
                                 sofa::core::MultiVecDerivId vResult)
+{
+    const unsigned int nbSubSteps = std::max(1u, d_nbSubSteps.getValue());
+    const bool fastPath = d_lumpedMassFastPath.getValue();
+
+    if (nbSubSteps == 1 && !fastPath)
+    {
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    if (!LumpedMassExplicitIntegrator::isPositionAndVelocity(xResult, vResult))
+    {
+        msg_warning_when(!m_fastPathFallbackWarned) << "The sub-steps and the lumped mass fast path are not supported when integrating the free motion.";
+        m_fastPathFallbackWarned = true;
+        solveStep(params, dt, xResult, vResult);
+        return;
+    }
+
+    const SReal h = dt / nbSubSteps;
+
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+
+    if (fastPath)
+    {
+        std::string reason;
+        if (m_lumpedMassIntegrator.build(this->getContext(), reason))
+        {
+            SCOPED_TIMER("EulerExplicitSolve");
+
+            MultiVecDeriv acc(&vop, core::VecDerivId::dx());
+            acc.realloc(&vop, !d_threadSafeVisitor.getValue(), true);
+
+            m_lumpedMassIntegrator.integrate(params, h, nbSubSteps,
+                                             getUpdateOperations(xResult, vResult, acc.id(), h),
+                                             d_parallel.getValue());
+            return;
+        }
+
+        msg_warning_when(!m_fastPathFallbackWarned) << "The lumped mass fast path cannot be used: " << reason
+                                                    << ". The regular integration is used instead.";
+        m_fastPathFallbackWarned = true;
+    }
+
+    MultiVecCoord pos(&vop, core::VecCoordId::position());
+    MultiVecDeriv vel(&vop, core::VecDerivId::velocity());
+    for (unsigned int i = 0; i < nbSubSteps; ++i)
+    {
+        if (i > 0)
+        {
+            // the next sub-step starts from the new state, as the animation loop would do
+            mop.projectPositionAndVelocity(pos, vel);
+            mop.propagateXAndV(pos, vel);
+        }
+        solveStep(params, h, xResult, vResult);
+    }
+}
+
+void EulerExplicitSolver::solveStep(const core::ExecParams* params,
+                                    SReal dt,
+                                    sofa::core::MultiVecCoordId xResult,
+                                    sofa::core::MultiVecDerivId vResult)
 {
     SCOPED_TIMER("EulerExplicitSolve");
 
@@ -153,55 +221,13 @@ void EulerExplicitSolver::updateState(sofa::simulation::common::VectorOperations
     }
 #else // single-operation optimization
     {
-        typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
-
-        // Create a set of linear operations that will be executed on two vectors
-        // In our case, the operations will be executed to compute the new velocity vector,
-        // and the new position vector. The order of execution is defined by
-        // the symplectic property of the solver.
-        VMultiOp ops(2);
-
-        // Change order of operations depending on the symplectic flag
-        const VMultiOp::size_type posId = d_symplectic.getValue(); // 1 if symplectic, 0 otherwise
-        const VMultiOp::size_type velId = 1 - posId; // 0 if symplectic, 1 otherwise
-
-        // Access the set of operations corresponding to the velocity vector
-        // In case of symplectic solver, these operations are executed first.
-        auto& ops_vel = ops[velId];
-
-        // Associate the new velocity vector as the result to this set of operations
-        ops_vel.first = newVel;
-
-        // The two following operations are actually a unique operation: newVel = vel + dt * acc
-        // The value 1.0 indicates that the first operation is based on the values
-        // in the second pair and, therefore, the second operation is discarded.
-        ops_vel.second.emplace_back(vel.id(), 1.0);
-        ops_vel.second.emplace_back(acc.id(), dt);
-
-        // Access the set of operations corresponding to the position vector
-        // In case of symplectic solver, these operations are executed second.
-        auto& ops_pos = ops[posId];
-
-        // Associate the new position vector as the result to this set of operations
-        ops_pos.first = newPos;
-
-        // The two following operations are actually a unique operation: newPos = pos + dt * v
-        // where v is "newVel" in case of a symplectic solver, and "vel" otherwise.
-        // If symplectic: newPos = pos + dt * newVel, executed after newVel has been computed
-        // If not symplectic: newPos = pos + dt * vel
-        // The value 1.0 indicates that the first operation is based on the values
-        // in the second pair and, therefore, the second operation is discarded.
-        ops_pos.second.emplace_back(pos.id(), 1.0);
-        ops_pos.second.emplace_back(d_symplectic.getValue() ? newVel.id() : vel.id(), dt);
-
-        // Execute the defined operations to compute the new velocity vector and
-        // the new position vector.
+        // Execute the operations computing the new velocity vector and the new position vector.
         // 1. Calls the "vMultiOp" method of every mapped BaseMechanicalState objects found in the
         // current context tree. This method may be called with different parameters than for the non-mapped
         // BaseMechanicalState objects.
         // 2. Calls the "vMultiOp" method of every BaseMechanicalState objects found in the
         // current context tree.
-        vop->v_multiop(ops);
+        vop->v_multiop(getUpdateOperations(newPos, newVel, acc.id(), dt));
 
         // Calls "solveConstraint" on every ConstraintSolver objects found in the current context tree.
         mop->solveConstraint(newVel,core::ConstraintOrder::VEL);
@@ -210,6 +236,58 @@ void EulerExplicitSolver::updateState(sofa::simulation::common::VectorOperations
 #endif
 }
 
+core::behavior::BaseMechanicalState::VMultiOp EulerExplicitSolver::getUpdateOperations(sofa::core::MultiVecCoordId newPos,
+                                                                                       sofa::core::MultiVecDerivId newVel,
+                                                                                       sofa::core::MultiVecDerivId acc,
+                                                                                       SReal dt) const
+{
+    typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
+
+    const core::MultiVecCoordId pos = core::VecCoordId::position();
+    const core::MultiVecDerivId vel = core::VecDerivId::velocity();
+
+    // Create a set of linear operations that will be executed on two vectors
+    // In our case, the operations will be executed to compute the new velocity vector,
+    // and the new position vector. The order of execution is defined by
+    // the symplectic property of the solver.
+    VMultiOp ops(2);
+
+    // Change order of operations depending on the symplectic flag
+    const VMultiOp::size_type posId = d_symplectic.getValue(); // 1 if symplectic, 0 otherwise
+    const VMultiOp::size_type velId = 1 - posId; // 0 if symplectic, 1 otherwise
+
+    // Access the set of operations corresponding to the velocity vector
+    // In case of symplectic solver, these operations are executed first.
+    auto& ops_vel = ops[velId];
+
+    // Associate the new velocity vector as the result to this set of operations
+    ops_vel.first = newVel;
+
+    // The two following operations are actually a unique operation: newVel = vel + dt * acc
+    // The value 1.0 indicates that the first operation is based on the values
+    // in the second pair and, therefore, the second operation is discarded.
+    ops_vel.second.emplace_back(vel, 1.0);
+    ops_vel.second.emplace_back(acc, dt);
+
+    // Access the set of operations corresponding to the position vector
+    // In case of symplectic solver, these operations are executed second.
+    auto& ops_pos = ops[posId];
+
+    // Associate the new position vector as the result to this set of operations
+    ops_pos.first = newPos;
+
+    // The two following operations are actually a unique operation: newPos = pos + dt * v
+    // where v is "newVel" in case of a symplectic solver, and "vel" otherwise.
+    // If symplectic: newPos = pos + dt * newVel, executed after newVel has been computed
+    // If not symplectic: newPos = pos + dt * vel
+    // The value 1.0 indicates that the first operation is based on the values
+    // in the second pair and, therefore, the second operation is discarded.
+    ops_pos.second.emplace_back(pos, 1.0);
+    ops_pos.second.emplace_back(d_symplectic.getValue() ? newVel : vel, dt);
+
+    return ops;
+}
+
 SReal EulerExplicitSolver::getIntegrationFactor(int inputDerivative, int outputDerivative) const
 {
     if (inputDerivative >= 3 || outputDerivative >= 3)
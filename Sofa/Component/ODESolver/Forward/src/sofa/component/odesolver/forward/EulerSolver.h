@@ -22,6 +22,7 @@
 #pragma once
 #include <sofa/component/odesolver/forward/config.h>
 
+#include <sofa/component/odesolver/forward/LumpedMassExplicitIntegrator.h>
 #include <sofa/core/behavior/OdeSolver.h>
 #include <sofa/core/behavior/MultiVec.h>
 
@@ -68,6 +69,10 @@ namespace sofa::component::odesolver::forward
  * x_{n+1} = x_n + v_{n+1} * dt
  *
  * The semi-implicit Euler method is more robust than the standard Euler method.
+ *
+ * Each time step can be divided in nbSubSteps sub-steps. With lumpedMassFastPath, if each mechanical state
+ * has a diagonal mass and only depends on itself, the states are integrated independently and without visitor
+ * (see LumpedMassExplicitIntegrator).
  */
 class SOFA_COMPONENT_ODESOLVER_FORWARD_API EulerExplicitSolver : public sofa::core::behavior::OdeSolver
 {
@@ -82,6 +87,9 @@ public:
 
     Data<bool> d_symplectic; ///< If true, the velocities are updated before the positions and the method is symplectic (more robust). If false, the positions are updated before the velocities (standard Euler, less robust).
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
+    Data<unsigned int> d_nbSubSteps; ///< Number of sub-steps per time step.
+    Data<bool> d_lumpedMassFastPath; ///< If true, integrates each mechanical state independently, without visitor, when the masses are diagonal and the states independent.
+    Data<bool> d_parallel; ///< If true, the mechanical states are integrated in parallel in the lumped mass fast path.
 
     /// Given an input derivative order (0 for position, 1 for velocity, 2 for acceleration),
     /// how much will it affect the output derivative of the given order.
@@ -98,6 +106,15 @@ public:
 
 protected:
 
+    /// Performs a single step of size dt
+    void solveStep(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult);
+
+    /// Operations computing the new position and velocity from the acceleration
+    core::behavior::BaseMechanicalState::VMultiOp getUpdateOperations(sofa::core::MultiVecCoordId xResult,
+                                                                      sofa::core::MultiVecDerivId vResult,
+                                                                      sofa::core::MultiVecDerivId acc,
+                                                                      SReal dt) const;
+
     /// Update state variable (new position and velocity) based on the computed acceleration
     /// The update takes constraints into account
     void updateState(sofa::simulation::common::VectorOperations* vop,
@@ -129,6 +146,9 @@ protected:
 
     static void solveSystem(core::behavior::MultiMatrix<simulation::common::MechanicalOperations>* matrix,
                             core::MultiVecDerivId solution, core::MultiVecDerivId rhs);
+
+    LumpedMassExplicitIntegrator m_lumpedMassIntegrator;
+    bool m_fastPathFallbackWarned { false };
 };
 
 } // namespace sofa::component::odesolver::forward
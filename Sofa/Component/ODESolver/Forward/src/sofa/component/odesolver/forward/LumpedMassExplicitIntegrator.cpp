@@ -0,0 +1,229 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/forward/LumpedMassExplicitIntegrator.h>
+
+#include <sofa/core/BaseMapping.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/core/behavior/BaseConstraintSet.h>
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/behavior/BaseProjectiveConstraintSet.h>
+#include <sofa/core/behavior/ConstraintSolver.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <map>
+#include <set>
+
+namespace sofa::component::odesolver::forward
+{
+
+using core::behavior::BaseMechanicalState;
+
+namespace
+{
+
+/// Returns the single mechanical state the component acts on, or nullptr if it acts on several of them
+BaseMechanicalState* getSingleMechanicalState(const core::behavior::StateAccessor* component)
+{
+    const auto& states = component->getMechanicalStates();
+    return states.size() == 1 ? states[0] : nullptr;
+}
+
+}
+
+bool LumpedMassExplicitIntegrator::isPositionAndVelocity(core::MultiVecCoordId xResult, core::MultiVecDerivId vResult)
+{
+    return !xResult.hasIdMap() && xResult.getDefaultId() == core::VecCoordId::position()
+        && !vResult.hasIdMap() && vResult.getDefaultId() == core::VecDerivId::velocity();
+}
+
+bool LumpedMassExplicitIntegrator::build(core::objectmodel::BaseContext* context, std::string& reason)
+{
+    SCOPED_TIMER("LumpedMassExplicitIntegrator::build");
+
+    m_states.clear();
+    reason.clear();
+
+    if (!context->getObjects<core::behavior::BaseConstraintSet>(core::objectmodel::BaseContext::SearchDown).empty()
+        || !context->getObjects<core::behavior::ConstraintSolver>(core::objectmodel::BaseContext::SearchDown).empty())
+    {
+        reason = "the scene contains constraints solved by a constraint solver";
+        return false;
+    }
+
+    std::set<BaseMechanicalState*> mappedStates;
+    for (auto* mapping : context->getObjects<core::BaseMapping>(core::objectmodel::BaseContext::SearchDown))
+    {
+        if (mapping->isMechanical())
+        {
+            for (auto* state : mapping->getMechTo())
+            {
+                mappedStates.insert(state);
+            }
+        }
+    }
+
+    std::map<BaseMechanicalState*, std::size_t> stateIndices;
+    for (auto* state : context->getObjects<BaseMechanicalState>(core::objectmodel::BaseContext::SearchDown))
+    {
+        if (mappedStates.count(state) == 0)
+        {
+            stateIndices.emplace(state, m_states.size());
+            m_states.push_back({state, nullptr, {}, {}});
+        }
+    }
+
+    // returns the independent state the component acts on, or nullptr if it is not the case
+    const auto findIndependentState = [&](const core::behavior::StateAccessor* component) -> IndependentState*
+    {
+        const auto it = stateIndices.find(getSingleMechanicalState(component));
+        return it != stateIndices.end() ? &m_states[it->second] : nullptr;
+    };
+
+    for (auto* mass : context->getObjects<core::behavior::BaseMass>(core::objectmodel::BaseContext::SearchDown))
+    {
+        IndependentState* independentState = findIndependentState(mass);
+        if (!independentState || independentState->mass)
+        {
+            reason = "the mass '" + mass->getName() + "' is not the only mass of a non-mapped mechanical state";
+            return false;
+        }
+        if (!mass->isDiagonal())
+        {
+            reason = "the mass '" + mass->getName() + "' is not diagonal";
+            return false;
+        }
+        independentState->mass = mass;
+    }
+
+    for (auto* forceField : context->getObjects<core::behavior::BaseForceField>(core::objectmodel::BaseContext::SearchDown))
+    {
+        IndependentState* independentState = findIndependentState(forceField);
+        if (!independentState)
+        {
+            reason = "the force field '" + forceField->getName() + "' acts on several or on mapped mechanical states";
+            return false;
+        }
+        independentState->forceFields.push_back(forceField);
+    }
+
+    for (auto* constraint : context->getObjects<core::behavior::BaseProjectiveConstraintSet>(core::objectmodel::BaseContext::SearchDown))
+    {
+        IndependentState* independentState = findIndependentState(constraint);
+        if (!independentState)
+        {
+            reason = "the projective constraint '" + constraint->getName() + "' acts on several or on mapped mechanical states";
+            return false;
+        }
+        independentState->projectiveConstraints.push_back(constraint);
+    }
+
+    for (const auto& independentState : m_states)
+    {
+        if (!independentState.mass)
+        {
+            reason = "the mechanical state '" + independentState.state->getName() + "' has no mass";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void LumpedMassExplicitIntegrator::integrate(const core::ExecParams* params, SReal dt, unsigned int nbSteps,
+                                             const VMultiOp& update, bool parallel) const
+{
+    SCOPED_TIMER("LumpedMassExplicitIntegrator::integrate");
+
+    core::MechanicalParams mparams(*params);
+    mparams.setDt(dt);
+    mparams.setImplicit(false);
+
+    if (!parallel || m_states.size() < 2)
+    {
+        for (const auto& independentState : m_states)
+        {
+            integrate(independentState, mparams, nbSteps, update);
+        }
+        return;
+    }
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    // the states are independent: each task performs all the sub-steps of its states
+    simulation::parallelForEach(*taskScheduler, m_states.begin(), m_states.end(),
+        [this, &mparams, nbSteps, &update](const IndependentState& independentState)
+        {
+            integrate(independentState, mparams, nbSteps, update);
+        });
+}
+
+void LumpedMassExplicitIntegrator::integrate(const IndependentState& independentState, const core::MechanicalParams& mparams,
+                                             unsigned int nbSteps, const VMultiOp& update) const
+{
+    const core::MultiVecCoordId x(core::VecCoordId::position());
+    const core::MultiVecDerivId v(core::VecDerivId::velocity());
+    const core::MultiVecDerivId f(core::VecDerivId::force());
+    const core::MultiVecDerivId a(core::VecDerivId::dx());
+
+    for (unsigned int step = 0; step < nbSteps; ++step)
+    {
+        if (step > 0)
+        {
+            // the animation loop projects the state at the end of the time step, but not between the sub-steps
+            for (auto* constraint : independentState.projectiveConstraints)
+            {
+                constraint->projectPosition(&mparams, x);
+                constraint->projectVelocity(&mparams, v);
+            }
+        }
+
+        if (independentState.mass->m_separateGravity.getValue())
+        {
+            independentState.mass->addGravityToV(&mparams, v);
+        }
+
+        independentState.state->resetForce(&mparams, core::VecDerivId::force());
+        independentState.state->accumulateForce(&mparams, core::VecDerivId::force());
+        for (auto* forceField : independentState.forceFields)
+        {
+            forceField->addForce(&mparams, f);
+        }
+
+        independentState.mass->accFromF(&mparams, a);
+        for (auto* constraint : independentState.projectiveConstraints)
+        {
+            constraint->projectResponse(&mparams, a);
+        }
+
+        independentState.state->vMultiOp(&mparams, update);
+    }
+}
+
+} // namespace sofa::component::odesolver::forward
@@ -0,0 +1,90 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/forward/config.h>
+
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/type/vector.h>
+
+#include <string>
+
+namespace sofa::core::behavior
+{
+class BaseMass;
+class BaseForceField;
+class BaseProjectiveConstraintSet;
+}
+
+namespace sofa::component::odesolver::forward
+{
+
+/**
+ * Fast path of the explicit integrators for the scenes where each mechanical state has a diagonal mass and
+ * only depends on itself: no interaction force field, no Lagrangian constraint and no component acting on a
+ * mapped state.
+ *
+ * The states and the components acting on them are collected once per time step. Then each state is
+ * integrated on its own, without visitor: forces, a = M^-1 f, projection of a, and update of v and x in a
+ * single vMultiOp (fused in a single loop by MechanicalObject for the usual v += a*dt, x += v*dt). The
+ * sub-steps of a time step are all performed for one state before the next one, and the states can be
+ * integrated in parallel.
+ *
+ * The mapped states are not updated between the sub-steps: it is up to the animation loop to propagate the
+ * positions at the end of the time step, as for a single step.
+ */
+class SOFA_COMPONENT_ODESOLVER_FORWARD_API LumpedMassExplicitIntegrator
+{
+public:
+    using VMultiOp = core::behavior::BaseMechanicalState::VMultiOp;
+
+    /// The sub-steps and the fast path only apply to the integration of the position and velocity of the
+    /// context, not to the free motion
+    static bool isPositionAndVelocity(core::MultiVecCoordId xResult, core::MultiVecDerivId vResult);
+
+    /// Collects the mechanical states of the subtree of the context, and the components acting on each of them.
+    /// Returns false, and the reason why, if the fast path cannot be used in this subtree.
+    bool build(core::objectmodel::BaseContext* context, std::string& reason);
+
+    /// Performs nbSteps steps of size dt on each state:
+    /// v += dt*g (separate gravity), f = sum of the forces, dx = M^-1 f, projection of dx, then the
+    /// update of the velocity and position given as a vMultiOp on position(), velocity() and dx().
+    void integrate(const core::ExecParams* params, SReal dt, unsigned int nbSteps, const VMultiOp& update, bool parallel) const;
+
+    std::size_t getNbStates() const { return m_states.size(); }
+
+private:
+    struct IndependentState
+    {
+        core::behavior::BaseMechanicalState* state { nullptr };
+        core::behavior::BaseMass* mass { nullptr };
+        sofa::type::vector<core::behavior::BaseForceField*> forceFields; ///< including the mass
+        sofa::type::vector<core::behavior::BaseProjectiveConstraintSet*> projectiveConstraints;
+    };
+
+    void integrate(const IndependentState& independentState, const core::MechanicalParams& mparams,
+                   unsigned int nbSteps, const VMultiOp& update) const;
+
+    sofa::type::vector<IndependentState> m_states;
+};
+
+} // namespace sofa::component::odesolver::forward
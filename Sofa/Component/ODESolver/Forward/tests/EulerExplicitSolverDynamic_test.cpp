@@ -178,4 +178,110 @@ TYPED_TEST( EulerExplicitDynamic_test , eulerExplicitSolverDynamicTest_high_dt)
    this-> compareSimulatedToTheoreticalPositions(5e-16,0.1);
 }
 
+/// Free fall of particles integrated with sub-steps by the lumped mass fast path: the positions follow
+/// the symplectic Euler scheme with the sub-step size, and the fixed particle does not move.
+struct EulerExplicitLumpedMass_test : public BaseSimulationTest
+{
+    SceneInstance m_si{};
+};
+
+TEST_F(EulerExplicitLumpedMass_test, fastPathWithSubSteps)
+{
+    sofa::simpleapi::importPlugin("Sofa.Component.ODESolver.Forward");
+    sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+    sofa::simpleapi::importPlugin("Sofa.Component.Mass");
+    sofa::simpleapi::importPlugin("Sofa.Component.Constraint.Projective");
+
+    m_si.root->setGravity({ 0, -10, 0 });
+    simpleapi::createObject(m_si.root, "DefaultAnimationLoop", {});
+    simpleapi::createObject(m_si.root, "EulerExplicitSolver", {
+        { "lumpedMassFastPath", "true"},
+        { "nbSubSteps", "10"},
+        { "parallel", "true"}
+    });
+
+    for (const auto* name : { "Particles1", "Particles2" })
+    {
+        const auto node = simpleapi::createChild(m_si.root, name);
+        simpleapi::createObject(node, "MechanicalObject", {
+            { "name", "dofs"},
+            { "template", "Vec3"},
+            { "position", "0 0 0  1 0 0  2 0 0"}
+        });
+        simpleapi::createObject(node, "UniformMass", { { "totalMass", "3"} });
+        simpleapi::createObject(node, "FixedProjectiveConstraint", { { "indices", "2"} });
+    }
+
+    m_si.initScene();
+
+    const double dt = 0.01;
+    const unsigned int nbSteps = 10;
+    for (unsigned int i = 0; i < nbSteps; ++i)
+    {
+        m_si.simulate(dt);
+    }
+
+    // symplectic Euler with n sub-steps of size h: y_n = -g h^2 n (n+1) / 2
+    const double h = dt / 10;
+    const double n = nbSteps * 10;
+    const double expected = -10 * h * h * n * (n + 1) / 2;
+
+    for (const auto* name : { "Particles1", "Particles2" })
+    {
+        const auto dofs = m_si.root->getChild(name)->get<MechanicalObject3>();
+        ASSERT_NE(dofs, nullptr);
+        const auto& x = dofs->read(sofa::core::ConstVecCoordId::position())->getValue();
+        EXPECT_NEAR(x[0][1], expected, 1e-10);
+        EXPECT_NEAR(x[1][1], expected, 1e-10);
+        EXPECT_NEAR(x[2][1], 0, 1e-10);
+    }
+}
+
+/// The external forces of the state are applied by the lumped mass fast path, as by the generic path
+TEST_F(EulerExplicitLumpedMass_test, fastPathWithExternalForce)
+{
+    sofa::simpleapi::importPlugin("Sofa.Component.ODESolver.Forward");
+    sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+    sofa::simpleapi::importPlugin("Sofa.Component.Mass");
+
+    m_si.root->setGravity({ 0, 0, 0 });
+    simpleapi::createObject(m_si.root, "DefaultAnimationLoop", {});
+    simpleapi::createObject(m_si.root, "EulerExplicitSolver", {
+        { "lumpedMassFastPath", "true"},
+        { "nbSubSteps", "10"}
+    });
+
+    const auto node = simpleapi::createChild(m_si.root, "Particles");
+    simpleapi::createObject(node, "MechanicalObject", {
+        { "name", "dofs"},
+        { "template", "Vec3"},
+        { "position", "0 0 0  1 0 0"}
+    });
+    simpleapi::createObject(node, "UniformMass", { { "totalMass", "2"} });
+
+    m_si.initScene();
+
+    const auto dofs = node->get<MechanicalObject3>();
+    ASSERT_NE(dofs, nullptr);
+    {
+        // the external forces are cleared at the end of the time step
+        auto externalForce = sofa::helper::getWriteOnlyAccessor(*dofs->write(sofa::core::VecDerivId::externalForce()));
+        externalForce.resize(2);
+        externalForce[0] = { 0, 5, 0 };
+        externalForce[1] = { 0, 0, 0 };
+    }
+
+    const double dt = 0.01;
+    m_si.simulate(dt);
+
+    // symplectic Euler with n sub-steps of size h, unit mass: y_n = f h^2 n (n+1) / 2
+    const double h = dt / 10;
+    const double n = 10;
+    const double expected = 5 * h * h * n * (n + 1) / 2;
+
+    const auto& x = dofs->read(sofa::core::ConstVecCoordId::position())->getValue();
+    EXPECT_NEAR(x[0][1], expected, 1e-10);
+    EXPECT_NEAR(x[1][1], 0, 1e-10);
+}
+
 } // namespace sofa
@@ -0,0 +1,167 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/playback/Checkpoint.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+#include <sofa/simulation/events/SimulationInitDoneEvent.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/helper/system/FileSystem.h>
+
+#include <algorithm>
+#include <filesystem>
+
+namespace sofa::component::playback
+{
+
+int CheckpointClass = core::RegisterObject("Periodically save the state of the whole simulation in a checkpoint file, and restart from it")
+        .add< Checkpoint >();
+
+Checkpoint::Checkpoint()
+    : d_filename(initData(&d_filename, std::string("checkpoint.snapshot"), "filename", "checkpoint file"))
+    , d_period(initData(&d_period, 1.0, "period", "simulated time between checkpoints (0 to disable the checkpoints)"))
+    , d_asynchronous(initData(&d_asynchronous, true, "asynchronous", "write the checkpoints in a background thread"))
+    , d_restart(initData(&d_restart, false, "restart", "restore the checkpoint file, if it exists, at the end of the initialization"))
+    , d_lastCheckpoint(initData(&d_lastCheckpoint, -1.0, "lastCheckpoint", "time of the last checkpoint (-1 if none)"))
+{
+    d_lastCheckpoint.setReadOnly(true);
+    this->f_listening.setValue(true);
+}
+
+Checkpoint::~Checkpoint()
+{
+    waitForWriting();
+}
+
+void Checkpoint::cleanup()
+{
+    waitForWriting();
+    Inherit1::cleanup();
+}
+
+simulation::Node* Checkpoint::getRootNode() const
+{
+    return dynamic_cast<simulation::Node*>(this->getContext()->getRootContext());
+}
+
+void Checkpoint::handleEvent(sofa::core::objectmodel::Event* event)
+{
+    if (simulation::SimulationInitDoneEvent::checkEventType(event))
+    {
+        if (d_restart.getValue() && sofa::helper::system::FileSystem::exists(d_filename.getFullPath()))
+        {
+            restoreCheckpoint();
+        }
+    }
+    else if (simulation::AnimateEndEvent::checkEventType(event))
+    {
+        const double period = d_period.getValue();
+        if (period <= 0)
+        {
+            return;
+        }
+
+        // the time is accumulated: a tolerance avoids missing a checkpoint because of rounding errors
+        const double time = this->getContext()->getTime();
+        const double lastCheckpoint = std::max(d_lastCheckpoint.getValue(), 0.0);
+        if (time + 1e-3 * this->getContext()->getDt() >= lastCheckpoint + period)
+        {
+            saveCheckpoint();
+        }
+    }
+}
+
+void Checkpoint::saveCheckpoint()
+{
+    simulation::Node* root = getRootNode();
+    if (root == nullptr)
+    {
+        return;
+    }
+
+    // the time of the checkpoint is part of the checkpoint
+    d_lastCheckpoint.setValue(this->getContext()->getTime());
+
+    auto snapshot = std::make_shared<simulation::SceneSnapshot>();
+    snapshot->capture(root);
+
+    const std::string filename = d_filename.getFullPath();
+
+    // a single checkpoint is written at a time
+    waitForWriting();
+    if (d_asynchronous.getValue())
+    {
+        m_writer = std::thread([snapshot, filename]()
+        {
+            write(*snapshot, filename);
+        });
+    }
+    else
+    {
+        write(*snapshot, filename);
+    }
+}
+
+bool Checkpoint::write(const simulation::SceneSnapshot& snapshot, const std::string& filename)
+{
+    const std::string temporaryFilename = filename + ".tmp";
+    if (!snapshot.save(temporaryFilename))
+    {
+        return false;
+    }
+
+    // the previous checkpoint is replaced in a single operation (rename on POSIX, MoveFileEx with
+    // MOVEFILE_REPLACE_EXISTING on Windows), so that a valid checkpoint exists at any time
+    std::error_code error;
+    std::filesystem::rename(temporaryFilename, filename, error);
+    if (error)
+    {
+        msg_error("Checkpoint") << "Cannot rename '" << temporaryFilename << "' to '" << filename << "': " << error.message();
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::restoreCheckpoint()
+{
+    simulation::Node* root = getRootNode();
+    waitForWriting();
+
+    simulation::SceneSnapshot snapshot;
+    if (root == nullptr || !snapshot.load(d_filename.getFullPath()) || !snapshot.restore(root))
+    {
+        msg_error() << "Cannot restart from the checkpoint '" << d_filename.getFullPath() << "'";
+        return false;
+    }
+
+    msg_info() << "Restarted from the checkpoint '" << d_filename.getFullPath() << "' at time " << root->getTime();
+    return true;
+}
+
+void Checkpoint::waitForWriting()
+{
+    if (m_writer.joinable())
+    {
+        m_writer.join();
+    }
+}
+
+} // namespace sofa::component::playback
@@ -0,0 +1,81 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/playback/config.h>
+
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/simulation/SceneSnapshot.h>
+
+#include <memory>
+#include <thread>
+
+namespace sofa::component::playback
+{
+
+/** Periodically save the state of the whole simulation in a checkpoint file, and restart from it.
+ *
+ * At the end of the time steps separated by the given period, the values of all the Data of the scene graph
+ * (state vectors, topologies, solver parameters, simulation time, ...) are captured in a SceneSnapshot.
+ * The snapshot is written in a binary file, in a background thread when asynchronous is set, so that the
+ * simulation does not wait for the disk. The file is replaced atomically: a preempted run always leaves a
+ * complete checkpoint.
+ *
+ * When restart is set, the checkpoint file is restored at the end of the initialization, if it exists, and
+ * the simulation continues from the time it was saved.
+ */
+class SOFA_COMPONENT_PLAYBACK_API Checkpoint : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(Checkpoint, core::objectmodel::BaseObject);
+
+    sofa::core::objectmodel::DataFileName d_filename; ///< checkpoint file
+    Data<double> d_period; ///< simulated time between checkpoints (0 to disable the checkpoints)
+    Data<bool> d_asynchronous; ///< write the checkpoints in a background thread
+    Data<bool> d_restart; ///< restore the checkpoint file, if it exists, at the end of the initialization
+    Data<double> d_lastCheckpoint; ///< time of the last checkpoint (-1 if none)
+
+    void handleEvent(sofa::core::objectmodel::Event* event) override;
+    void cleanup() override;
+
+    /// Capture the state of the simulation and write it in the checkpoint file
+    void saveCheckpoint();
+
+    /// Restore the state of the simulation from the checkpoint file. Returns false if it cannot be restored.
+    bool restoreCheckpoint();
+
+    /// Wait for the checkpoint being written, if any
+    void waitForWriting();
+
+protected:
+    Checkpoint();
+    ~Checkpoint() override;
+
+    simulation::Node* getRootNode() const;
+
+    /// Write the snapshot in a temporary file, renamed once complete
+    static bool write(const simulation::SceneSnapshot& snapshot, const std::string& filename);
+
+    std::thread m_writer;
+};
+
+} // namespace sofa::component::playback
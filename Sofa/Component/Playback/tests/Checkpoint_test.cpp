@@ -0,0 +1,150 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/component/odesolver/backward/EulerImplicitSolver.h>
+#include <sofa/component/linearsolver/iterative/CGLinearSolver.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/component/mass/UniformMass.h>
+#include <sofa/component/playback/Checkpoint.h>
+#include <sofa/simulation/Node.h>
+
+#include <cstdio>
+
+namespace sofa
+{
+
+using namespace component;
+using sofa::core::objectmodel::New;
+using defaulttype::Vec3Types;
+
+struct Checkpoint_test : public BaseSimulationTest
+{
+    typedef statecontainer::MechanicalObject<Vec3Types> MechanicalObject;
+    typedef linearsolver::iterative::CGLinearSolver<linearsolver::GraphScatteredMatrix, linearsolver::GraphScatteredVector> CGLinearSolver;
+
+    const double timeStep = 0.01;
+    const std::string filename = std::string(SOFA_COMPONENT_PLAYBACK_TEST_BUILD_DIR) + "Checkpoint_test.snapshot";
+
+    simulation::Node::SPtr root;
+    MechanicalObject::SPtr dofs;
+    playback::Checkpoint::SPtr checkpoint;
+
+    void onTearDown() override
+    {
+        if (root)
+        {
+            simulation::node::unload(root);
+        }
+        std::remove(filename.c_str());
+    }
+
+    void createScene(bool restart)
+    {
+        if (root)
+        {
+            simulation::node::unload(root);
+        }
+
+        root = simulation::getSimulation()->createNewGraph("root");
+        root->setGravity(type::Vec3(0, 0, -9.81));
+        root->setDt(timeStep);
+
+        root->addObject(New<odesolver::backward::EulerImplicitSolver>());
+        root->addObject(New<CGLinearSolver>());
+
+        const simulation::Node::SPtr child = root->createChild("Particles");
+        dofs = New<MechanicalObject>();
+        dofs->resize(2);
+        dofs->writePositions()[1] = type::Vec3(1, 0, 0);
+        child->addObject(dofs);
+
+        const auto mass = New<mass::UniformMass<Vec3Types> >();
+        mass->setTotalMass(1.0);
+        child->addObject(mass);
+
+        checkpoint = New<playback::Checkpoint>();
+        checkpoint->d_filename.setValue(filename);
+        checkpoint->d_period.setValue(3 * timeStep);
+        checkpoint->d_asynchronous.setValue(false);
+        checkpoint->d_restart.setValue(restart);
+        root->addObject(checkpoint);
+
+        simulation::node::initRoot(root.get());
+    }
+
+    void run(int nbSteps)
+    {
+        for (int i = 0; i < nbSteps; ++i)
+        {
+            simulation::node::animate(root.get(), timeStep);
+        }
+    }
+};
+
+TEST_F(Checkpoint_test, periodicCheckpoints)
+{
+    createScene(false);
+    run(2);
+    EXPECT_EQ(checkpoint->d_lastCheckpoint.getValue(), -1.0);
+    run(1);
+    EXPECT_NEAR(checkpoint->d_lastCheckpoint.getValue(), 3 * timeStep, 1e-12);
+    run(3);
+    EXPECT_NEAR(checkpoint->d_lastCheckpoint.getValue(), 6 * timeStep, 1e-12);
+}
+
+TEST_F(Checkpoint_test, restartIsIdentical)
+{
+    createScene(false);
+    run(3);
+    const auto checkpointPositions = dofs->readPositions().ref();
+    run(4);
+    const auto expectedPositions = dofs->readPositions().ref();
+    const auto expectedVelocities = dofs->readVelocities().ref();
+    const double expectedTime = root->getTime();
+
+    // the last checkpoint is at step 6: replace it by the one at step 3
+    createScene(false);
+    run(3);
+    checkpoint->d_period.setValue(0);
+
+    createScene(true);
+    EXPECT_NEAR(root->getTime(), 3 * timeStep, 1e-12);
+    EXPECT_EQ(dofs->readPositions().ref(), checkpointPositions);
+
+    checkpoint->d_period.setValue(0);
+    run(4);
+    EXPECT_EQ(root->getTime(), expectedTime);
+    EXPECT_EQ(dofs->readPositions().ref(), expectedPositions);
+    EXPECT_EQ(dofs->readVelocities().ref(), expectedVelocities);
+}
+
+TEST_F(Checkpoint_test, restartWithoutCheckpoint)
+{
+    std::remove(filename.c_str());
+    createScene(true);
+    EXPECT_EQ(root->getTime(), 0);
+}
+
+}
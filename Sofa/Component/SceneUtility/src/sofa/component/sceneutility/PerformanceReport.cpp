@@ -0,0 +1,278 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/sceneutility/PerformanceReport.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/BaseMapping.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+
+#include <iomanip>
+#include <sstream>
+
+namespace sofa::component::sceneutility
+{
+
+using core::objectmodel::BaseObject;
+using core::objectmodel::PerformanceCounter;
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
+namespace
+{
+
+constexpr auto NbCounterTypes = static_cast<std::size_t>(PerformanceCounterType::NbTypes);
+
+void writeJSONString(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+} // anonymous namespace
+
+PerformanceReport::PerformanceReport()
+    : d_filename(initData(&d_filename, "filename", "Output file. If empty, the report is written in the log"))
+    , d_format(initData(&d_format, helper::OptionsGroup{"csv", "json"}, "format", "Format of the report: csv (one line per component and per call) or json (one object per report and per line)"))
+    , d_period(initData(&d_period, 100u, "period", "Number of time steps between two reports (0 to only report at the end of the simulation)"))
+    , d_countBytes(initData(&d_countBytes, false, "countBytes", "If true, estimate the bytes of the state vectors accessed by the calls"))
+    , d_resetCounters(initData(&d_resetCounters, false, "resetCounters", "If true, the counters are reset after each report"))
+{
+    this->f_listening.setValue(true);
+}
+
+void PerformanceReport::init()
+{
+    BaseObject::init();
+
+    if (!m_countersEnabled)
+    {
+        PerformanceCounters::enable();
+        m_countersEnabled = true;
+    }
+    PerformanceCounters::setCountingBytes(d_countBytes.getValue());
+
+    // the Data of the counters are registered before the simulation, which may measure the calls in parallel
+    for (BaseObject* object : getMeasurableObjects())
+    {
+        object->getPerformanceCounters().registerData();
+    }
+
+    m_nbSteps = 0;
+    m_lastReportStep = 0;
+
+    const std::string& filename = d_filename.getFullPath();
+    if (!filename.empty())
+    {
+        m_file.open(filename, std::ios::out | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            msg_error() << "Cannot open file '" << filename << "'";
+            d_componentState.setValue(core::objectmodel::ComponentState::Invalid);
+            return;
+        }
+    }
+
+    d_componentState.setValue(core::objectmodel::ComponentState::Valid);
+}
+
+void PerformanceReport::cleanup()
+{
+    if (d_componentState.getValue() == core::objectmodel::ComponentState::Valid && m_nbSteps > m_lastReportStep)
+    {
+        writeReport();
+    }
+    m_file.close();
+    if (m_countersEnabled)
+    {
+        PerformanceCounters::disable();
+        m_countersEnabled = false;
+    }
+
+    BaseObject::cleanup();
+}
+
+void PerformanceReport::handleEvent(core::objectmodel::Event* event)
+{
+    if (simulation::AnimateEndEvent::checkEventType(event))
+    {
+        ++m_nbSteps;
+
+        const unsigned int period = d_period.getValue();
+        if (period != 0 && m_nbSteps % period == 0
+            && d_componentState.getValue() == core::objectmodel::ComponentState::Valid)
+        {
+            writeReport();
+        }
+    }
+}
+
+type::vector<BaseObject*> PerformanceReport::getMeasurableObjects() const
+{
+    type::vector<BaseObject*> objects;
+    for (BaseObject* object : this->getContext()->getRootContext()->getObjects<BaseObject>(core::objectmodel::BaseContext::SearchDown))
+    {
+        if (dynamic_cast<core::behavior::BaseForceField*>(object) || dynamic_cast<core::BaseMapping*>(object))
+        {
+            objects.push_back(object);
+        }
+    }
+    return objects;
+}
+
+type::vector<BaseObject*> PerformanceReport::getMeasuredObjects() const
+{
+    type::vector<BaseObject*> measuredObjects;
+    for (BaseObject* object : this->getContext()->getRootContext()->getObjects<BaseObject>(core::objectmodel::BaseContext::SearchDown))
+    {
+        const PerformanceCounters* counters = object->findPerformanceCounters();
+        if (counters == nullptr)
+        {
+            continue;
+        }
+        for (std::size_t i = 0; i < NbCounterTypes; ++i)
+        {
+            if (counters->isMeasured(static_cast<PerformanceCounterType>(i)))
+            {
+                measuredObjects.push_back(object);
+                break;
+            }
+        }
+    }
+    return measuredObjects;
+}
+
+void PerformanceReport::writeReport()
+{
+    const auto objects = getMeasuredObjects();
+
+    // the report is written between two time steps: the counters can be published in their Data
+    for (BaseObject* object : objects)
+    {
+        object->getPerformanceCounters().registerData();
+    }
+
+    std::ostringstream report;
+    report << std::setprecision(9);
+    if (d_format.getValue().getSelectedId() == 1)
+    {
+        writeJSON(report, objects);
+    }
+    else
+    {
+        writeCSV(report, objects);
+    }
+
+    if (m_file.is_open())
+    {
+        m_file << report.str();
+        m_file.flush();
+    }
+    else
+    {
+        msg_info() << report.str();
+    }
+
+    if (d_resetCounters.getValue())
+    {
+        for (BaseObject* object : objects)
+        {
+            object->getPerformanceCounters().reset();
+        }
+    }
+    m_lastReportStep = m_nbSteps;
+}
+
+void PerformanceReport::writeCSV(std::ostream& out, const type::vector<BaseObject*>& objects) const
+{
+    // the header is written once, at the beginning of the file
+    if (!m_file.is_open() || m_lastReportStep == 0)
+    {
+        out << "step,time,component,class,call,nbCalls,totalTime,lastTime,bytes\n";
+    }
+
+    const SReal time = this->getContext()->getTime();
+    for (const BaseObject* object : objects)
+    {
+        const PerformanceCounters& counters = *object->findPerformanceCounters();
+        for (std::size_t i = 0; i < NbCounterTypes; ++i)
+        {
+            const auto type = static_cast<PerformanceCounterType>(i);
+            if (counters.isMeasured(type))
+            {
+                const PerformanceCounter counter = counters.get(type);
+                out << m_nbSteps << ',' << time << ',' << object->getPathName() << ','
+                    << object->getClassName() << ',' << PerformanceCounters::getName(type) << ','
+                    << counter[0] << ',' << counter[1] << ',' << counter[2] << ',' << counter[3] << '\n';
+            }
+        }
+    }
+}
+
+void PerformanceReport::writeJSON(std::ostream& out, const type::vector<BaseObject*>& objects) const
+{
+    out << "{\"step\":" << m_nbSteps << ",\"time\":" << this->getContext()->getTime() << ",\"components\":[";
+    for (std::size_t o = 0; o < objects.size(); ++o)
+    {
+        const BaseObject* object = objects[o];
+        const PerformanceCounters& counters = *object->findPerformanceCounters();
+
+        out << (o == 0 ? "" : ",") << "{\"path\":";
+        writeJSONString(out, object->getPathName());
+        out << ",\"class\":";
+        writeJSONString(out, object->getClassName());
+        out << ",\"counters\":{";
+
+        bool first = true;
+        for (std::size_t i = 0; i < NbCounterTypes; ++i)
+        {
+            const auto type = static_cast<PerformanceCounterType>(i);
+            if (counters.isMeasured(type))
+            {
+                const PerformanceCounter counter = counters.get(type);
+                out << (first ? "" : ",") << '"' << PerformanceCounters::getName(type) << "\":{"
+                    << "\"nbCalls\":" << counter[0]
+                    << ",\"totalTime\":" << counter[1]
+                    << ",\"lastTime\":" << counter[2]
+                    << ",\"bytes\":" << counter[3] << '}';
+                first = false;
+            }
+        }
+        out << "}}";
+    }
+    out << "]}\n";
+}
+
+int PerformanceReportClass = core::RegisterObject("Periodically writes the performance counters (calls and wall time of addForce, addDForce, apply, applyJ, applyJT and buildStiffnessMatrix) of all the components of the scene")
+        .add< PerformanceReport >();
+
+} // namespace sofa::component::sceneutility
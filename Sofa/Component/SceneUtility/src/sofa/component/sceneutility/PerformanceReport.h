@@ -0,0 +1,82 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/sceneutility/config.h>
+
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/helper/OptionsGroup.h>
+
+#include <fstream>
+
+namespace sofa::component::sceneutility
+{
+
+/**
+ * Scene-wide report of the performance counters of the components.
+ *
+ * This component enables the performance counters (see core::objectmodel::PerformanceCounters)
+ * recorded by the mechanical visitors, until its cleanup, and periodically writes the counters of
+ * all the components of the scene in a CSV or JSON file:
+ * - csv: one line per component and per measured call, for each report
+ * - json: one JSON object per report, written on a single line
+ */
+class SOFA_COMPONENT_SCENEUTILITY_API PerformanceReport : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(PerformanceReport, core::objectmodel::BaseObject);
+
+    core::objectmodel::DataFileName d_filename; ///< Output file. If empty, the report is written in the log
+    Data<helper::OptionsGroup> d_format; ///< Format of the report
+    Data<unsigned int> d_period; ///< Number of time steps between two reports (0 to only report at the end of the simulation)
+    Data<bool> d_countBytes; ///< If true, estimate the bytes of the state vectors accessed by the calls
+    Data<bool> d_resetCounters; ///< If true, the counters are reset after each report
+
+    void init() override;
+    void cleanup() override;
+    void handleEvent(core::objectmodel::Event* event) override;
+
+    /// Writes the report of the current counters
+    void writeReport();
+
+protected:
+    PerformanceReport();
+
+    void writeCSV(std::ostream& out, const type::vector<core::objectmodel::BaseObject*>& objects) const;
+    void writeJSON(std::ostream& out, const type::vector<core::objectmodel::BaseObject*>& objects) const;
+
+    /// Components of the scene whose calls can be measured: the force fields and the mappings
+    type::vector<core::objectmodel::BaseObject*> getMeasurableObjects() const;
+
+    /// Components of the scene with measured calls
+    type::vector<core::objectmodel::BaseObject*> getMeasuredObjects() const;
+
+    std::ofstream m_file;
+    unsigned int m_nbSteps { 0 };
+    unsigned int m_lastReportStep { 0 };
+
+    /// true if this component holds a reference on the activation of the counters
+    bool m_countersEnabled { false };
+};
+
+} // namespace sofa::component::sceneutility
@@ -0,0 +1,146 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/sceneutility/PerformanceReport.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+using sofa::component::sceneutility::PerformanceReport;
+using sofa::core::objectmodel::BaseObject;
+using sofa::core::objectmodel::PerformanceCounters;
+using sofa::core::objectmodel::PerformanceCounterType;
+
+class MeasuredObject : public BaseObject
+{
+public:
+    SOFA_CLASS(MeasuredObject, BaseObject);
+};
+
+struct PerformanceReport_test : public sofa::testing::BaseTest
+{
+    sofa::simulation::Node::SPtr m_root;
+    PerformanceReport::SPtr m_report;
+    MeasuredObject::SPtr m_object;
+
+    std::string createScene(const std::string& format)
+    {
+        const std::string filename = (std::filesystem::temp_directory_path() / ("PerformanceReport_test." + format)).string();
+
+        m_root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+        m_object = sofa::core::objectmodel::New<MeasuredObject>();
+        m_object->setName("measured");
+        m_root->addObject(m_object);
+        m_root->addObject(sofa::core::objectmodel::New<MeasuredObject>());
+
+        m_report = sofa::core::objectmodel::New<PerformanceReport>();
+        m_report->d_filename.setValue(filename);
+        m_report->d_format.setValue(sofa::helper::OptionsGroup{"csv", "json"}.setSelectedItem(format));
+        m_root->addObject(m_report);
+
+        sofa::simulation::node::initRoot(m_root.get());
+        return filename;
+    }
+
+    void onTearDown() override
+    {
+        if (m_root)
+        {
+            sofa::simulation::node::unload(m_root);
+        }
+    }
+
+    static std::string readFile(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+};
+
+TEST_F(PerformanceReport_test, csv)
+{
+    const std::string filename = createScene("csv");
+    EXPECT_TRUE(PerformanceCounters::isEnabled());
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        PerformanceCounters::Scope scope(m_object.get(), PerformanceCounterType::ApplyJ);
+    }
+    m_report->writeReport();
+
+    const std::string report = readFile(filename);
+    EXPECT_EQ(report.find("step,time,component,class,call,nbCalls,totalTime,lastTime,bytes\n"), 0u);
+    EXPECT_NE(report.find("/measured,MeasuredObject,applyJ,2,"), std::string::npos);
+
+    // only the measured components are reported
+    EXPECT_EQ(report.find("addForce"), std::string::npos);
+    EXPECT_EQ(std::count(report.begin(), report.end(), '\n'), 2);
+
+    // the counters are published in the Data of the components
+    const auto* data = m_object->findData("perf_applyJ");
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(data->getValueString().substr(0, 2), "2 ");
+
+    // the components which are neither measured nor measurable have no counters
+    EXPECT_EQ(m_report->findPerformanceCounters(), nullptr);
+    EXPECT_EQ(m_report->findData("perf_applyJ"), nullptr);
+}
+
+TEST_F(PerformanceReport_test, sharedActivation)
+{
+    PerformanceCounters::enable();
+    createScene("csv");
+
+    // the counters stay enabled for the other client
+    sofa::simulation::node::unload(m_root);
+    m_root.reset();
+    EXPECT_TRUE(PerformanceCounters::isEnabled());
+
+    PerformanceCounters::disable();
+    EXPECT_FALSE(PerformanceCounters::isEnabled());
+}
+
+TEST_F(PerformanceReport_test, json)
+{
+    const std::string filename = createScene("json");
+
+    {
+        PerformanceCounters::Scope scope(m_object.get(), PerformanceCounterType::AddForce);
+    }
+    m_report->writeReport();
+
+    const std::string report = readFile(filename);
+    EXPECT_EQ(report.find("{\"step\":0,\"time\":0,\"components\":[{\"path\":\"/measured\",\"class\":\"MeasuredObject\",\"counters\":{\"addForce\":{\"nbCalls\":1,"), 0u);
+}
+
+} // namespace
@@ -121,6 +121,9 @@ public:
     Data< sofa::helper::OptionsGroup > _gatherBsize; ///< use in GPU version
     Data<bool> f_drawing; ///<  draw the forcefield if true
     Data<Real> f_drawPercentageOffset; ///< size of the hexa
+    Data<bool> d_shareStiffnessMatrices; ///< Share a single stiffness matrix between congruent elements, and apply it to batches of elements
+    Data<bool> d_parallel; ///< Process the batches of elements sharing a stiffness matrix in parallel
+    Data<sofa::Size> d_nbStiffnessMatrices; ///< Number of distinct stiffness matrices stored
     bool needUpdateTopology;
 
     /// Link to be set to the topology container in the component graph. 
@@ -204,6 +207,36 @@ protected:
 
     static void computeForce( Displacement &F, const Displacement &Depl, const ElementStiffness &K );
 
+    /// stiffness matrix of an element, possibly shared with the congruent elements
+    const ElementStiffness& getElementStiffness(sofa::Index elementIndex) const;
+
+
+    ////////////// shared stiffness matrices
+    /// elements sharing the same stiffness matrix, and without common vertices with the other
+    /// elements of the same color, so that all the batches of a color can be processed concurrently
+    struct ElementBatch
+    {
+        static constexpr sofa::Size MaxSize = 8;
+
+        sofa::Index stiffnessClass {};
+        sofa::Index begin {}; ///< first element of the batch in m_batchedElements
+        sofa::Index end {};
+        SReal potentialEnergy {};
+    };
+    typedef type::Mat<24, ElementBatch::MaxSize, Real> BatchDisplacement; ///< one column per element of a batch
+
+    type::vector<sofa::Index> m_stiffnessClasses; ///< index of the stiffness matrix of each element, empty if the matrices are not shared
+    type::vector<sofa::Index> m_batchedElements; ///< elements sorted by color, then by stiffness matrix
+    type::vector<type::vector<ElementBatch> > m_colorBatches; ///< batches of each color
+
+    void computeStiffnessClasses();
+    void computeElementBatches();
+    template<class BatchFunction>
+    void forEachElementBatch(BatchFunction f);
+    static void computeForceBatch( BatchDisplacement &F, const BatchDisplacement &Depl, const ElementStiffness &K );
+    void accumulateForceBatch( VecDeriv &f, const VecCoord &p, const ElementStiffness &K, ElementBatch &batch );
+    void applyStiffnessBatch( VecDeriv &df, const VecDeriv &dx, Real kFactor, const ElementStiffness &K, const ElementBatch &batch );
+
 
     ////////////// large displacements method
     type::vector<type::fixed_array<Coord,8> > _rotatedInitialElements;   ///< The initials positions in its frame
@@ -28,6 +28,9 @@
 #include <sofa/core/MechanicalParams.h>
 #include <sofa/helper/decompose.h>
 #include <sofa/core/behavior/BaseLocalForceFieldMatrix.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <map>
 
 // WARNING: indices ordering is different than in topology node
 //
@@ -58,6 +61,9 @@ HexahedronFEMForceField<DataTypes>::HexahedronFEMForceField()
     , _gatherBsize(initData(&_gatherBsize,"gatherBsize","number of dof accumulated per threads during the gather operation (Only use in GPU version)"))
     , f_drawing(initData(&f_drawing,true,"drawing","draw the forcefield if true"))
     , f_drawPercentageOffset(initData(&f_drawPercentageOffset,(Real)0.15,"drawPercentageOffset","size of the hexa"))
+    , d_shareStiffnessMatrices(initData(&d_shareStiffnessMatrices, false, "shareStiffnessMatrices", "Share a single stiffness matrix between congruent elements (same rest shape up to a translation, same material), and apply it to batches of elements. Not compatible with updateStiffnessMatrix"))
+    , d_parallel(initData(&d_parallel, false, "parallel", "Process the batches of elements sharing a stiffness matrix in parallel (requires shareStiffnessMatrices)"))
+    , d_nbStiffnessMatrices(initData(&d_nbStiffnessMatrices, sofa::Size(0), "nbStiffnessMatrices", "Number of distinct stiffness matrices stored"))
     , needUpdateTopology(false)
     , l_topology(initLink("topology", "link to the topology container"))
     , _elementStiffnesses(initData(&_elementStiffnesses,"stiffnessMatrices", "Stiffness matrices per element (K_i)"))
@@ -96,6 +102,7 @@ HexahedronFEMForceField<DataTypes>::HexahedronFEMForceField()
 
     f_poissonRatio.setRequired(true);
     f_youngModulus.setRequired(true);
+    d_nbStiffnessMatrices.setReadOnly(true);
 }
 
 
@@ -199,6 +206,8 @@ void HexahedronFEMForceField<DataTypes>::reinit()
         break;
     }
     }
+
+    computeStiffnessClasses();
 }
 
 
@@ -224,6 +233,29 @@ void HexahedronFEMForceField<DataTypes>::addForce (const core::MechanicalParams*
         needUpdateTopology = false;
     }
 
+    if (!m_stiffnessClasses.empty())
+    {
+        VecDeriv& force = _f.wref();
+        const VecCoord& position = _p.ref();
+        const auto& stiffnesses = _elementStiffnesses.getValue();
+
+        forEachElementBatch([&](ElementBatch& batch)
+        {
+            accumulateForceBatch(force, position, stiffnesses[batch.stiffnessClass], batch);
+        });
+
+        m_potentialEnergy = 0;
+        for (const auto& batches : m_colorBatches)
+        {
+            for (const auto& batch : batches)
+            {
+                m_potentialEnergy += batch.potentialEnergy;
+            }
+        }
+        m_potentialEnergy/=-2.0;
+        return;
+    }
+
     unsigned int i=0;
     typename VecElement::const_iterator it;
 
@@ -274,6 +306,19 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
     if (_df.size() != _dx.size())
         _df.resize(_dx.size());
 
+    if (!m_stiffnessClasses.empty())
+    {
+        VecDeriv& df = _df.wref();
+        const VecDeriv& dx = _dx.ref();
+        const auto& stiffnesses = _elementStiffnesses.getValue();
+
+        forEachElementBatch([&](const ElementBatch& batch)
+        {
+            applyStiffnessBatch(df, dx, kFactor, stiffnesses[batch.stiffnessClass], batch);
+        });
+        return;
+    }
+
     unsigned int i = 0;
     typename VecElement::const_iterator it;
 
@@ -734,6 +779,303 @@ void HexahedronFEMForceField<DataTypes>::computeForce( Displacement &F, const Di
     F = K*Depl;
 }
 
+template<class DataTypes>
+const typename HexahedronFEMForceField<DataTypes>::ElementStiffness& HexahedronFEMForceField<DataTypes>::getElementStiffness(sofa::Index elementIndex) const
+{
+    const auto& stiffnesses = _elementStiffnesses.getValue();
+    return m_stiffnessClasses.empty() ? stiffnesses[elementIndex] : stiffnesses[m_stiffnessClasses[elementIndex]];
+}
+
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+////////////// shared stiffness matrices
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::computeStiffnessClasses()
+{
+    m_stiffnessClasses.clear();
+    m_batchedElements.clear();
+    m_colorBatches.clear();
+
+    auto stiffnesses = sofa::helper::getWriteAccessor(_elementStiffnesses);
+    const std::size_t nbElements = this->getIndexedElements()->size();
+
+    if (!d_shareStiffnessMatrices.getValue() || nbElements == 0)
+    {
+        d_nbStiffnessMatrices.setValue(static_cast<sofa::Size>(stiffnesses.size()));
+        return;
+    }
+
+    if (f_updateStiffnessMatrix.getValue())
+    {
+        msg_warning() << "Stiffness matrices cannot be shared when they are updated at each time step (updateStiffnessMatrix=true): one matrix per element is used.";
+        d_nbStiffnessMatrices.setValue(static_cast<sofa::Size>(stiffnesses.size()));
+        return;
+    }
+
+    // Elements are congruent if their rest shapes, expressed in their initial frame, are the
+    // same up to a translation. The coordinates are compared up to a tolerance relative to the
+    // mean size of the elements, so that the cells of a grid are identified despite round-off.
+    Real meanDiagonal = 0;
+    for (std::size_t i = 0; i < nbElements; ++i)
+    {
+        meanDiagonal += (_rotatedInitialElements[i][6] - _rotatedInitialElements[i][0]).norm();
+    }
+    meanDiagonal /= static_cast<Real>(nbElements);
+    const Real tolerance = meanDiagonal * static_cast<Real>(1e-6);
+
+    if (tolerance <= 0)
+    {
+        d_nbStiffnessMatrices.setValue(static_cast<sofa::Size>(stiffnesses.size()));
+        return;
+    }
+
+    std::map<type::vector<Real>, sofa::Index> classes;
+    type::vector<Real> key(7 * 3 + 4);
+    VecElementStiffness sharedStiffnesses;
+
+    m_stiffnessClasses.resize(nbElements);
+    for (sofa::Index i = 0; i < nbElements; ++i)
+    {
+        const auto& nodes = _rotatedInitialElements[i];
+        std::size_t k = 0;
+        for (int w = 1; w < 8; ++w)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                key[k++] = std::round((nodes[w][c] - nodes[0][c]) / tolerance);
+            }
+        }
+        // coefficients of the material stiffness used by computeElementStiffness
+        key[k++] = _materialsStiffnesses[i][0][0];
+        key[k++] = _materialsStiffnesses[i][0][1];
+        key[k++] = _materialsStiffnesses[i][3][3];
+        key[k++] = static_cast<Real>(_sparseGrid ? _sparseGrid->getStiffnessCoef(i) : 1.0);
+
+        const auto [it, inserted] = classes.emplace(key, static_cast<sofa::Index>(sharedStiffnesses.size()));
+        if (inserted)
+        {
+            sharedStiffnesses.push_back(stiffnesses[i]);
+        }
+        m_stiffnessClasses[i] = it->second;
+    }
+
+    stiffnesses.wref().swap(sharedStiffnesses);
+    d_nbStiffnessMatrices.setValue(static_cast<sofa::Size>(stiffnesses.size()));
+
+    msg_info() << nbElements << " elements share " << stiffnesses.size() << " stiffness matrices";
+
+    computeElementBatches();
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::computeElementBatches()
+{
+    const VecElement& elements = *this->getIndexedElements();
+    const std::size_t nbElements = elements.size();
+
+    // greedy coloring: two elements sharing a vertex get different colors
+    type::vector<type::vector<unsigned int> > colorsAroundVertex(this->mstate->getSize());
+    type::vector<unsigned int> elementColors(nbElements);
+    unsigned int nbColors = 0;
+    type::vector<bool> isColorUsed;
+    for (sofa::Index i = 0; i < nbElements; ++i)
+    {
+        isColorUsed.assign(nbColors + 1, false);
+        for (const auto v : elements[i])
+        {
+            for (const auto c : colorsAroundVertex[v])
+            {
+                isColorUsed[c] = true;
+            }
+        }
+
+        const unsigned int color = static_cast<unsigned int>(std::find(isColorUsed.begin(), isColorUsed.end(), false) - isColorUsed.begin());
+        elementColors[i] = color;
+        nbColors = std::max(nbColors, color + 1);
+        for (const auto v : elements[i])
+        {
+            colorsAroundVertex[v].push_back(color);
+        }
+    }
+
+    m_batchedElements.resize(nbElements);
+    for (sofa::Index i = 0; i < nbElements; ++i)
+    {
+        m_batchedElements[i] = i;
+    }
+    std::stable_sort(m_batchedElements.begin(), m_batchedElements.end(), [&](sofa::Index a, sofa::Index b)
+    {
+        return std::make_pair(elementColors[a], m_stiffnessClasses[a]) < std::make_pair(elementColors[b], m_stiffnessClasses[b]);
+    });
+
+    m_colorBatches.resize(nbColors);
+    for (sofa::Index begin = 0; begin < nbElements;)
+    {
+        const sofa::Index first = m_batchedElements[begin];
+
+        ElementBatch batch;
+        batch.stiffnessClass = m_stiffnessClasses[first];
+        batch.begin = begin;
+        batch.end = begin + 1;
+        while (batch.end < nbElements && batch.end - batch.begin < ElementBatch::MaxSize
+               && elementColors[m_batchedElements[batch.end]] == elementColors[first]
+               && m_stiffnessClasses[m_batchedElements[batch.end]] == batch.stiffnessClass)
+        {
+            ++batch.end;
+        }
+
+        m_colorBatches[elementColors[first]].push_back(batch);
+        begin = batch.end;
+    }
+
+    msg_info() << "Elements grouped in " << nbColors << " colors";
+}
+
+template<class DataTypes>
+template<class BatchFunction>
+void HexahedronFEMForceField<DataTypes>::forEachElementBatch(BatchFunction f)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    if (d_parallel.getValue() && taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    const simulation::ForEachExecutionPolicy execution = d_parallel.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    // the elements of a color have no common vertex: their batches write to distinct vertices
+    for (auto& batches : m_colorBatches)
+    {
+        simulation::forEach(execution, *taskScheduler, batches.begin(), batches.end(), f);
+    }
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::computeForceBatch( BatchDisplacement &F, const BatchDisplacement &Depl, const ElementStiffness &K )
+{
+    // F = K * Depl for all the elements of the batch at once: the innermost loop runs over the
+    // elements, with contiguous and independent operations that the compiler vectorizes
+    for (int r = 0; r < 24; ++r)
+    {
+        auto& Fr = F[r];
+        Fr.clear();
+        for (int c = 0; c < 24; ++c)
+        {
+            const Real k = K[r][c];
+            const auto& Dc = Depl[c];
+            for (sofa::Size b = 0; b < ElementBatch::MaxSize; ++b)
+            {
+                Fr[b] += k * Dc[b];
+            }
+        }
+    }
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::accumulateForceBatch( VecDeriv &f, const VecCoord &p, const ElementStiffness &K, ElementBatch &batch )
+{
+    const VecElement& elements = *this->getIndexedElements();
+    const sofa::Size nbElementsInBatch = batch.end - batch.begin;
+
+    // displacements of the elements in their frame
+    BatchDisplacement D;
+    D.clear();
+    for (sofa::Size b = 0; b < nbElementsInBatch; ++b)
+    {
+        const sofa::Index i = m_batchedElements[batch.begin + b];
+        const Element& elem = elements[i];
+
+        type::Vec<8,Coord> nodes;
+        for(int w=0; w<8; ++w)
+            nodes[w] = p[elem[w]];
+
+        switch(method)
+        {
+        case LARGE :
+        {
+            Coord horizontal = (nodes[1]-nodes[0] + nodes[2]-nodes[3] + nodes[5]-nodes[4] + nodes[6]-nodes[7])*.25;
+            Coord vertical = (nodes[3]-nodes[0] + nodes[2]-nodes[1] + nodes[7]-nodes[4] + nodes[6]-nodes[5])*.25;
+            computeRotationLarge( _rotations[i], horizontal, vertical);
+            break;
+        }
+        case POLAR :
+            computeRotationPolar( _rotations[i], nodes );
+            break;
+        default :
+            // small displacements: the rotation is the identity set in initSmall
+            break;
+        }
+
+        for(int k=0 ; k<8 ; ++k )
+        {
+            const Coord deformed = _rotations[i] * nodes[k];
+            for(int j=0 ; j<3 ; ++j )
+                D[k*3+j][b] = _rotatedInitialElements[i][k][j] - deformed[j];
+        }
+    }
+
+    BatchDisplacement F;
+    computeForceBatch( F, D, K );
+
+    batch.potentialEnergy = 0;
+    for (sofa::Size b = 0; b < nbElementsInBatch; ++b)
+    {
+        const sofa::Index i = m_batchedElements[batch.begin + b];
+        const Element& elem = elements[i];
+
+        for(int w=0; w<8; ++w)
+        {
+            const Deriv Fw( F[w*3][b], F[w*3+1][b], F[w*3+2][b] );
+            f[elem[w]] += _rotations[i].multTranspose( Fw );
+            batch.potentialEnergy += dot( Fw, -Deriv( D[w*3][b], D[w*3+1][b], D[w*3+2][b] ) );
+        }
+    }
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::applyStiffnessBatch( VecDeriv &df, const VecDeriv &dx, Real kFactor, const ElementStiffness &K, const ElementBatch &batch )
+{
+    const VecElement& elements = *this->getIndexedElements();
+    const sofa::Size nbElementsInBatch = batch.end - batch.begin;
+
+    BatchDisplacement X;
+    X.clear();
+    for (sofa::Size b = 0; b < nbElementsInBatch; ++b)
+    {
+        const sofa::Index i = m_batchedElements[batch.begin + b];
+        const Element& elem = elements[i];
+
+        for(int w=0; w<8; ++w)
+        {
+            const Coord x_2 = _rotations[i] * dx[elem[w]];
+            X[w*3][b] = x_2[0];
+            X[w*3+1][b] = x_2[1];
+            X[w*3+2][b] = x_2[2];
+        }
+    }
+
+    BatchDisplacement F;
+    computeForceBatch( F, X, K );
+
+    for (sofa::Size b = 0; b < nbElementsInBatch; ++b)
+    {
+        const sofa::Index i = m_batchedElements[batch.begin + b];
+        const Element& elem = elements[i];
+
+        for(int w=0; w<8; ++w)
+        {
+            df[elem[w]] -= _rotations[i].multTranspose( Deriv( F[w*3][b], F[w*3+1][b], F[w*3+2][b] ) ) * kFactor;
+        }
+    }
+}
+
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
@@ -785,7 +1127,7 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceSmall ( WDataRefVecDeriv
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
 
     Displacement F; //forces
-    computeForce( F, D, stiffnesses[i] ); // compute force on element
+    computeForce( F, D, getElementStiffness(i) ); // compute force on element
 
     for(int w=0; w<8; ++w)
         f[elem[w]] += Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) ;
@@ -888,7 +1230,7 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceLarge( WDataRefVecDeriv
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
 
     Displacement F; //forces
-    computeForce( F, D, _elementStiffnesses.getValue()[i] ); // compute force on element
+    computeForce( F, D, getElementStiffness(i) ); // compute force on element
 
     for(int w=0; w<8; ++w)
         f[elem[w]] += _rotations[i].multTranspose( Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) );
@@ -1087,7 +1429,7 @@ void HexahedronFEMForceField<DataTypes>::accumulateForcePolar( WDataRefVecDeriv
 
 
     // compute force on element
-    computeForce( F, D, _elementStiffnesses.getValue()[i] );
+    computeForce( F, D, getElementStiffness(i) );
 
 
     for(int j=0; j<8; ++j)
@@ -1142,12 +1484,11 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalPara
 
     sofa::Index e { 0 }; //index of the element in the topology
 
-    const auto& stiffnesses = _elementStiffnesses.getValue();
     const auto* indexedElements = this->getIndexedElements();
 
     for (const auto& element : *indexedElements)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
+        const ElementStiffness &Ke = getElementStiffness(e);
         const Transformation Rot = getElementRotation(e);
         e++;
 
@@ -1176,7 +1517,6 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
 {
     sofa::Index e { 0 }; //index of the element in the topology
 
-    const auto& stiffnesses = _elementStiffnesses.getValue();
     const auto* indexedElements = this->getIndexedElements();
 
     auto dfdx = matrix->getForceDerivativeIn(this->mstate)
@@ -1184,7 +1524,7 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
 
     for (const auto& element : *indexedElements)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
+        const ElementStiffness &Ke = getElementStiffness(e);
         const Transformation& Rot = getElementRotation(e);
         e++;
 
@@ -235,6 +235,31 @@ public:
     type::Vec3 getStrainDisplacementFactors(Index elemId);
     Real getTriangleFactor(Index elemId);
 
+    /// triangles without common vertices with the other triangles of the same color, so that
+    /// all the batches of a color can be processed concurrently
+    struct TriangleBatch
+    {
+        static constexpr sofa::Size MaxSize = 32;
+
+        sofa::Index begin {}; ///< first triangle of the batch in m_batchedTriangles
+        sofa::Index end {};
+    };
+
+    type::vector<Index> m_batchedTriangles; ///< triangles sorted by color
+    type::vector<type::vector<TriangleBatch> > m_colorBatches; ///< batches of each color
+    int m_batchesTopologyRevision { -1 }; ///< topology revision for which the batches were computed
+
+    /// Recompute the batches if the triangles changed
+    void updateTriangleBatches();
+    void computeTriangleBatches();
+    template<class BatchFunction>
+    void forEachTriangleBatch(BatchFunction f);
+
+    /// addForce and addDForce on a batch of triangles: the computations are done on arrays of
+    /// per-triangle values (one array per component), in loops over the triangles of the batch
+    void accumulateForceBatch(VecDeriv& f, const VecCoord& x, VecTriangleState& triState, const VecTriangleInfo& triInfo, const TriangleBatch& batch);
+    void applyStiffnessBatch(VecDeriv& df, const VecDeriv& dx, Real kFactor, const VecTriangleState& triState, const VecTriangleInfo& triInfo, const TriangleBatch& batch);
+
 public:
 
     /// Forcefield intern paramaters
@@ -242,6 +267,7 @@ public:
     Data<Real> d_young; ///< Young modulus in Hooke's law
     Data<Real> d_damping; ///< Ratio damping/stiffness
     Data<Real> d_restScale; ///< Scale factor applied to rest positions (to simulate pre-stretched materials)
+    Data<bool> d_parallel; ///< Process the batches of triangles of a same color in parallel
 
     Data<bool> d_computePrincipalStress; ///< Compute principal stress for each triangle
     Data<Real> d_stressMaxValue; ///< Max stress value computed over the triangulation
@@ -25,6 +25,10 @@
 #include <sofa/core/behavior/BlocMatrixWriter.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/core/topology/TopologyData.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 
@@ -42,6 +46,7 @@ TriangularFEMForceFieldOptim<DataTypes>::TriangularFEMForceFieldOptim()
     , d_young(initData(&d_young,(Real)(1000.0),"youngModulus","Young modulus in Hooke's law"))
     , d_damping(initData(&d_damping,(Real)0.,"damping","Ratio damping/stiffness"))
     , d_restScale(initData(&d_restScale,(Real)1.,"restScale","Scale factor applied to rest positions (to simulate pre-stretched materials)"))
+    , d_parallel(initData(&d_parallel, false, "parallel", "Process the batches of triangles of a same color in parallel"))
     , d_computePrincipalStress(initData(&d_computePrincipalStress, false, "computePrincipalStress", "Compute principal stress for each triangle"))
     , d_stressMaxValue(initData(&d_stressMaxValue, (Real)0., "stressMaxValue", "Max stress value computed over the triangulation"))
     , d_showStressVector(initData(&d_showStressVector,false,"showStressVector","Flag activating rendering of stress directions within each triangle"))
@@ -237,9 +242,112 @@ void TriangularFEMForceFieldOptim<DataTypes>::reinit()
     d_triangleInfo.endEdit();
     d_triangleState.endEdit();
 
+    computeTriangleBatches();
+
     data.reinit(this);
 }
 
+template <class DataTypes>
+void TriangularFEMForceFieldOptim<DataTypes>::updateTriangleBatches()
+{
+    if (m_batchesTopologyRevision != m_topology->getRevision() || m_batchedTriangles.size() != m_topology->getNbTriangles())
+    {
+        computeTriangleBatches();
+    }
+}
+
+template <class DataTypes>
+void TriangularFEMForceFieldOptim<DataTypes>::computeTriangleBatches()
+{
+    const VecElement& triangles = m_topology->getTriangles();
+    const std::size_t nbTriangles = triangles.size();
+    m_batchesTopologyRevision = m_topology->getRevision();
+
+    // greedy coloring: two triangles sharing a vertex get different colors
+    std::size_t nbVertices = this->mstate ? this->mstate->getSize() : 0;
+    for (const auto& t : triangles)
+    {
+        nbVertices = std::max<std::size_t>(nbVertices, *std::max_element(t.begin(), t.end()) + 1);
+    }
+    type::vector<type::vector<unsigned int> > colorsAroundVertex(nbVertices);
+    type::vector<unsigned int> triangleColors(nbTriangles);
+    unsigned int nbColors = 0;
+    type::vector<bool> isColorUsed;
+    for (Index i = 0; i < nbTriangles; ++i)
+    {
+        isColorUsed.assign(nbColors + 1, false);
+        for (const auto v : triangles[i])
+        {
+            for (const auto c : colorsAroundVertex[v])
+            {
+                isColorUsed[c] = true;
+            }
+        }
+
+        const unsigned int color = static_cast<unsigned int>(std::find(isColorUsed.begin(), isColorUsed.end(), false) - isColorUsed.begin());
+        triangleColors[i] = color;
+        nbColors = std::max(nbColors, color + 1);
+        for (const auto v : triangles[i])
+        {
+            colorsAroundVertex[v].push_back(color);
+        }
+    }
+
+    m_batchedTriangles.resize(nbTriangles);
+    for (Index i = 0; i < nbTriangles; ++i)
+    {
+        m_batchedTriangles[i] = i;
+    }
+    std::stable_sort(m_batchedTriangles.begin(), m_batchedTriangles.end(), [&](Index a, Index b)
+    {
+        return triangleColors[a] < triangleColors[b];
+    });
+
+    m_colorBatches.clear();
+    m_colorBatches.resize(nbColors);
+    for (Index begin = 0; begin < nbTriangles;)
+    {
+        const unsigned int color = triangleColors[m_batchedTriangles[begin]];
+
+        TriangleBatch batch;
+        batch.begin = begin;
+        batch.end = begin + 1;
+        while (batch.end < nbTriangles && batch.end - batch.begin < TriangleBatch::MaxSize
+               && triangleColors[m_batchedTriangles[batch.end]] == color)
+        {
+            ++batch.end;
+        }
+
+        m_colorBatches[color].push_back(batch);
+        begin = batch.end;
+    }
+
+    msg_info() << "Triangles grouped in " << nbColors << " colors";
+}
+
+template<class DataTypes>
+template<class BatchFunction>
+void TriangularFEMForceFieldOptim<DataTypes>::forEachTriangleBatch(BatchFunction f)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    if (d_parallel.getValue() && taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    const simulation::ForEachExecutionPolicy execution = d_parallel.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    // the triangles of a color have no common vertex: their batches write to distinct vertices
+    for (auto& batches : m_colorBatches)
+    {
+        simulation::forEach(execution, *taskScheduler, batches.begin(), batches.end(), f);
+    }
+}
+
 
 
 template <class DataTypes>
@@ -261,29 +369,85 @@ void TriangularFEMForceFieldOptim<DataTypes>::addForce(const core::MechanicalPar
     sofa::helper::WriteAccessor< core::objectmodel::Data< VecTriangleState > > triState = d_triangleState;
     sofa::helper::ReadAccessor< core::objectmodel::Data< VecTriangleInfo > > triInfo = d_triangleInfo;
 
-    const unsigned int nbTriangles = m_topology->getNbTriangles();
+    f.resize(x.size());
+    updateTriangleBatches();
+
+    VecDeriv& forces = f.wref();
+    const VecCoord& positions = x.ref();
+    VecTriangleState& states = triState.wref();
+    const VecTriangleInfo& infos = triInfo.ref();
+    forEachTriangleBatch([&](const TriangleBatch& batch)
+    {
+        accumulateForceBatch(forces, positions, states, infos, batch);
+    });
+
+    // compute principal stress if requested or for rendering
+    if (this->d_computePrincipalStress.getValue() || this->d_showStressVector.getValue())
+    {
+        computePrincipalStress();
+    }
+}
+
+template <class DataTypes>
+void TriangularFEMForceFieldOptim<DataTypes>::accumulateForceBatch(VecDeriv& f, const VecCoord& x, VecTriangleState& triState, const VecTriangleInfo& triInfo, const TriangleBatch& batch)
+{
+    static constexpr sofa::Size MaxSize = TriangleBatch::MaxSize;
     const VecElement& triangles = m_topology->getTriangles();
+    const sofa::Size n = batch.end - batch.begin;
     const Real gamma = this->gamma;
     const Real mu = this->mu;
+    const Real epsilon = std::numeric_limits<Real>::epsilon();
 
-    f.resize(x.size());
-
-    for ( Index i=0; i<nbTriangles; i+=1)
+    // gather the edges AB, AC and the rest shape of the triangles, one array per component
+    Real ab[3][MaxSize], ac[3][MaxSize];
+    Real bx[MaxSize], cx[MaxSize], cy[MaxSize], ssFactor[MaxSize];
+    for (sofa::Size b = 0; b < n; ++b)
     {
-        Triangle t = triangles[i];
+        const Index i = m_batchedTriangles[batch.begin + b];
+        const Triangle& t = triangles[i];
+        const Coord& a = x[t[0]];
+        for (int c = 0; c < 3; ++c)
+        {
+            ab[c][b] = x[t[1]][c] - a[c];
+            ac[c][b] = x[t[2]][c] - a[c];
+        }
         const TriangleInfo& ti = triInfo[i];
-        TriangleState& ts = triState[i];
-        Coord a = x[t[0]];
-        Coord ab = x[t[1]] -a;
-        Coord ac = x[t[2]] -a;
+        bx[b] = ti.bx;
+        cx[b] = ti.cx;
+        cy[b] = ti.cy;
+        ssFactor[b] = ti.ss_factor;
+    }
 
-        computeTriangleRotation(ts.frame, ab, ac);
+    // The following loops run over the triangles of the batch: the compiler vectorizes them
+    Real frameX[3][MaxSize], frameY[3][MaxSize];
+    for (sofa::Size b = 0; b < n; ++b)
+    {
+        // same operations as computeTriangleRotation: frame X along AB, frame Y = (AB x AC) x AB
+        const Real nx = ab[1][b] * ac[2][b] - ab[2][b] * ac[1][b];
+        const Real ny = ab[2][b] * ac[0][b] - ab[0][b] * ac[2][b];
+        const Real nz = ab[0][b] * ac[1][b] - ab[1][b] * ac[0][b];
+        Real y0 = ny * ab[2][b] - nz * ab[1][b];
+        Real y1 = nz * ab[0][b] - nx * ab[2][b];
+        Real y2 = nx * ab[1][b] - ny * ab[0][b];
+
+        const Real normX = std::sqrt(ab[0][b] * ab[0][b] + ab[1][b] * ab[1][b] + ab[2][b] * ab[2][b]);
+        const Real normY = std::sqrt(y0 * y0 + y1 * y1 + y2 * y2);
+        // as Vec::normalize, vectors of null norm are left unchanged
+        const Real divX = normX > epsilon ? normX : Real(1);
+        const Real divY = normY > epsilon ? normY : Real(1);
+        frameX[0][b] = ab[0][b] / divX;
+        frameX[1][b] = ab[1][b] / divX;
+        frameX[2][b] = ab[2][b] / divX;
+        frameY[0][b] = y0 / divY;
+        frameY[1][b] = y1 / divY;
+        frameY[2][b] = y2 / divY;
+    }
 
+    Real stress[3][MaxSize], fb[3][MaxSize], fc[3][MaxSize];
+    for (sofa::Size b = 0; b < n; ++b)
+    {
         // Displacement in local space (rest pos - current pos), dby == 0
-        Real dbx = ti.bx - ts.frame[0] * ab;
-        Real dcx = ti.cx - ts.frame[0] * ac;
-        Real dcy = ti.cy - ts.frame[1] * ac;
-
+        //
         /// Full StrainDisplacement matrix.
         // | beta1  0       beta2  0        beta3  0      |
         // | 0      gamma1  0      gamma2   0      gamma3 | / (2 * A)
@@ -307,40 +471,49 @@ void TriangularFEMForceFieldOptim<DataTypes>::addForce(const core::MechanicalPar
         // beta2 = ti.cy;
         // gamma2 = -ti.cx;
         // gamma3 = ti.bx;
+        const Real dbx = bx[b] - (frameX[0][b] * ab[0][b] + frameX[1][b] * ab[1][b] + frameX[2][b] * ab[2][b]);
+        const Real dcx = cx[b] - (frameX[0][b] * ac[0][b] + frameX[1][b] * ac[1][b] + frameX[2][b] * ac[2][b]);
+        const Real dcy = cy[b] - (frameY[0][b] * ac[0][b] + frameY[1][b] * ac[1][b] + frameY[2][b] * ac[2][b]);
 
         // Strain = StrainDisplacement * Displacement
-        type::Vec<3,Real> strain (
-            ti.cy * dbx,                   // ( cy,   0,  0,  0) * (dbx, dby(0), dcx, dcy)
-            ti.bx * dcy,                   // (  0, -cx,  0, bx) * (dbx, dby(0), dcx, dcy)
-            ti.bx * dcx - ti.cx * dbx);    // ( -cx, cy, bx,  0) * (dbx, dby(0), dcx, dcy)
+        const Real strain0 = cy[b] * dbx;                   // ( cy,   0,  0,  0) * (dbx, dby(0), dcx, dcy)
+        const Real strain1 = bx[b] * dcy;                   // (  0, -cx,  0, bx) * (dbx, dby(0), dcx, dcy)
+        const Real strain2 = bx[b] * dcx - cx[b] * dbx;     // ( -cx, cy, bx,  0) * (dbx, dby(0), dcx, dcy)
 
         // Stress = K * Strain
-        Real gammaXY = gamma * (strain[0] + strain[1]);
-        type::Vec<3,Real> stress (
-            mu*strain[0] + gammaXY,      // (gamma+mu, gamma   ,    0) * strain
-            mu*strain[1] + gammaXY,      // (gamma   , gamma+mu,    0) * strain
-            (Real)(0.5)*mu*strain[2]);   // (       0,        0, mu/2) * strain
-
-        stress *= ti.ss_factor;
+        const Real gammaXY = gamma * (strain0 + strain1);
+        stress[0][b] = (mu * strain0 + gammaXY) * ssFactor[b];              // (gamma+mu, gamma   ,    0) * strain
+        stress[1][b] = (mu * strain1 + gammaXY) * ssFactor[b];              // (gamma   , gamma+mu,    0) * strain
+        stress[2][b] = ((Real)(0.5) * mu * strain2) * ssFactor[b];          // (       0,        0, mu/2) * strain
+
+        const Real fbX = cy[b] * stress[0][b] - cx[b] * stress[2][b];    // (cy,   0, -cx) * stress
+        const Real fbY = cy[b] * stress[2][b] - cx[b] * stress[1][b];    // ( 0, -cx,  cy) * stress
+        const Real fcX = bx[b] * stress[2][b];                           // ( 0,   0,  bx) * stress
+        const Real fcY = bx[b] * stress[1][b];                           // ( 0,  bx,   0) * stress
+        for (int c = 0; c < 3; ++c)
+        {
+            fb[c][b] = frameX[c][b] * fbX + frameY[c][b] * fbY;
+            fc[c][b] = frameX[c][b] * fcX + frameY[c][b] * fcY;
+        }
+    }
 
-        Deriv fb = ts.frame[0] * (ti.cy * stress[0] - ti.cx * stress[2])  // (cy,   0, -cx) * stress
-                + ts.frame[1] * (ti.cy * stress[2] - ti.cx * stress[1]);  // ( 0, -cx,  cy) * stress
-        Deriv fc = ts.frame[0] * (ti.bx * stress[2])                      // ( 0,   0,  bx) * stress
-                + ts.frame[1] * (ti.bx * stress[1]);                      // ( 0,  bx,   0) * stress
-        Deriv fa = -fb-fc;
+    // scatter: the triangles of a batch have no common vertex
+    for (sofa::Size b = 0; b < n; ++b)
+    {
+        const Index i = m_batchedTriangles[batch.begin + b];
+        const Triangle& t = triangles[i];
 
-        f[t[0]] += fa;
-        f[t[1]] += fb;
-        f[t[2]] += fc;
+        const Deriv forceB(fb[0][b], fb[1][b], fb[2][b]);
+        const Deriv forceC(fc[0][b], fc[1][b], fc[2][b]);
+        f[t[0]] += -forceB - forceC;
+        f[t[1]] += forceB;
+        f[t[2]] += forceC;
 
         // store data for re-use
-        ts.stress = stress;
-    }
-
-    // compute principal stress if requested or for rendering
-    if (this->d_computePrincipalStress.getValue() || this->d_showStressVector.getValue())
-    {
-        computePrincipalStress();
+        TriangleState& ts = triState[i];
+        ts.frame[0] = Coord(frameX[0][b], frameX[1][b], frameX[2][b]);
+        ts.frame[1] = Coord(frameY[0][b], frameY[1][b], frameY[2][b]);
+        ts.stress = Deriv(stress[0][b], stress[1][b], stress[2][b]);
     }
 }
 
@@ -355,52 +528,94 @@ void TriangularFEMForceFieldOptim<DataTypes>::addDForce(const core::MechanicalPa
     sofa::helper::ReadAccessor< core::objectmodel::Data< VecTriangleState > > triState = d_triangleState;
     sofa::helper::ReadAccessor< core::objectmodel::Data< VecTriangleInfo > > triInfo = d_triangleInfo;
 
-    const unsigned int nbTriangles = m_topology->getNbTriangles();
-    const VecElement& triangles = m_topology->getTriangles();
-    const Real gamma = this->gamma;
-    const Real mu = this->mu;
     const Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams, this->rayleighStiffness.getValue());
 
     df.resize(dx.size());
+    updateTriangleBatches();
 
-    for ( Index i=0; i<nbTriangles; i+=1)
+    VecDeriv& dforces = df.wref();
+    const VecDeriv& displacements = dx.ref();
+    const VecTriangleState& states = triState.ref();
+    const VecTriangleInfo& infos = triInfo.ref();
+    forEachTriangleBatch([&](const TriangleBatch& batch)
     {
-        Triangle t = triangles[i];
-        const TriangleInfo& ti = triInfo[i];
+        applyStiffnessBatch(dforces, displacements, kFactor, states, infos, batch);
+    });
+}
+
+template <class DataTypes>
+void TriangularFEMForceFieldOptim<DataTypes>::applyStiffnessBatch(VecDeriv& df, const VecDeriv& dx, Real kFactor, const VecTriangleState& triState, const VecTriangleInfo& triInfo, const TriangleBatch& batch)
+{
+    static constexpr sofa::Size MaxSize = TriangleBatch::MaxSize;
+    const VecElement& triangles = m_topology->getTriangles();
+    const sofa::Size n = batch.end - batch.begin;
+    const Real gamma = this->gamma;
+    const Real mu = this->mu;
+
+    // gather, one array per component
+    Real dab[3][MaxSize], dac[3][MaxSize], frameX[3][MaxSize], frameY[3][MaxSize];
+    Real bx[MaxSize], cx[MaxSize], cy[MaxSize], ssFactor[MaxSize];
+    for (sofa::Size b = 0; b < n; ++b)
+    {
+        const Index i = m_batchedTriangles[batch.begin + b];
+        const Triangle& t = triangles[i];
+        const Deriv& da = dx[t[0]];
         const TriangleState& ts = triState[i];
-        Deriv da  = dx[t[0]];
-        Deriv dab = dx[t[1]]-da;
-        Deriv dac = dx[t[2]]-da;
+        for (int c = 0; c < 3; ++c)
+        {
+            dab[c][b] = dx[t[1]][c] - da[c];
+            dac[c][b] = dx[t[2]][c] - da[c];
+            frameX[c][b] = ts.frame[0][c];
+            frameY[c][b] = ts.frame[1][c];
+        }
+        const TriangleInfo& ti = triInfo[i];
+        bx[b] = ti.bx;
+        cx[b] = ti.cx;
+        cy[b] = ti.cy;
+        ssFactor[b] = ti.ss_factor;
+    }
 
-        Real dbx = ts.frame[0]*dab;
-        Real dby = ts.frame[1]*dab;
-        Real dcx = ts.frame[0]*dac;
-        Real dcy = ts.frame[1]*dac;
+    Real dfb[3][MaxSize], dfc[3][MaxSize];
+    for (sofa::Size b = 0; b < n; ++b)
+    {
+        const Real dbx = frameX[0][b] * dab[0][b] + frameX[1][b] * dab[1][b] + frameX[2][b] * dab[2][b];
+        const Real dby = frameY[0][b] * dab[0][b] + frameY[1][b] * dab[1][b] + frameY[2][b] * dab[2][b];
+        const Real dcx = frameX[0][b] * dac[0][b] + frameX[1][b] * dac[1][b] + frameX[2][b] * dac[2][b];
+        const Real dcy = frameY[0][b] * dac[0][b] + frameY[1][b] * dac[1][b] + frameY[2][b] * dac[2][b];
 
         // Strain = StrainDisplacement * Displacement
-        type::Vec<3, Real> dstrain(
-            ti.cy * dbx,                                // ( cy,   0,  0,  0) * (dbx, dby, dcx, dcy)
-            ti.bx * dcy - ti.cx * dby,                  // (  0, -cx,  0, bx) * (dbx, dby, dcx, dcy)
-            ti.bx * dcx - ti.cx * dbx + ti.cy * dby);   // ( -cx, cy, bx,  0) * (dbx, dby, dcx, dcy)
-
+        const Real dstrain0 = cy[b] * dbx;                                  // ( cy,   0,  0,  0) * (dbx, dby, dcx, dcy)
+        const Real dstrain1 = bx[b] * dcy - cx[b] * dby;                    // (  0, -cx,  0, bx) * (dbx, dby, dcx, dcy)
+        const Real dstrain2 = bx[b] * dcx - cx[b] * dbx + cy[b] * dby;      // ( -cx, cy, bx,  0) * (dbx, dby, dcx, dcy)
 
         // Stress = K * Strain
-        Real gammaXY = gamma*(dstrain[0]+dstrain[1]);
-        type::Vec<3,Real> dstress (
-            mu*dstrain[0] + gammaXY,        // (gamma+mu, gamma   ,    0) * dstrain
-            mu*dstrain[1] + gammaXY,        // (gamma   , gamma+mu,    0) * dstrain
-            (Real)(0.5)*mu*dstrain[2]);     // (       0,        0, mu/2) * dstrain
-
-        dstress *= ti.ss_factor * kFactor;
-        Deriv dfb = ts.frame[0] * (ti.cy * dstress[0] - ti.cx * dstress[2])  // (cy,   0, -cx) * stress
-            + ts.frame[1] * (ti.cy * dstress[2] - ti.cx * dstress[1]);       // ( 0, -cx,  cy) * stress
-        Deriv dfc = ts.frame[0] * (ti.bx * dstress[2])                       // ( 0,   0,  bx) * stress
-            + ts.frame[1] * (ti.bx * dstress[1]);                            // ( 0,  bx,   0) * stress
-        Deriv dfa = -dfb - dfc;
-
-        df[t[0]] -= dfa;
-        df[t[1]] -= dfb;
-        df[t[2]] -= dfc;
+        const Real gammaXY = gamma * (dstrain0 + dstrain1);
+        const Real factor = ssFactor[b] * kFactor;
+        const Real dstress0 = (mu * dstrain0 + gammaXY) * factor;
+        const Real dstress1 = (mu * dstrain1 + gammaXY) * factor;
+        const Real dstress2 = ((Real)(0.5) * mu * dstrain2) * factor;
+
+        const Real dfbX = cy[b] * dstress0 - cx[b] * dstress2;
+        const Real dfbY = cy[b] * dstress2 - cx[b] * dstress1;
+        const Real dfcX = bx[b] * dstress2;
+        const Real dfcY = bx[b] * dstress1;
+        for (int c = 0; c < 3; ++c)
+        {
+            dfb[c][b] = frameX[c][b] * dfbX + frameY[c][b] * dfbY;
+            dfc[c][b] = frameX[c][b] * dfcX + frameY[c][b] * dfcY;
+        }
+    }
+
+    // scatter: the triangles of a batch have no common vertex
+    for (sofa::Size b = 0; b < n; ++b)
+    {
+        const Triangle& t = triangles[m_batchedTriangles[batch.begin + b]];
+
+        const Deriv dforceB(dfb[0][b], dfb[1][b], dfb[2][b]);
+        const Deriv dforceC(dfc[0][b], dfc[1][b], dfc[2][b]);
+        df[t[0]] -= -dforceB - dforceC;
+        df[t[1]] -= dforceB;
+        df[t[2]] -= dforceC;
     }
 }
 
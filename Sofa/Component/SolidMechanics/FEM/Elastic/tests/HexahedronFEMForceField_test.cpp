@@ -22,6 +22,9 @@
 #include <sofa/component/solidmechanics/fem/elastic/HexahedronFEMForceField.h>
 
 #include <sofa/component/solidmechanics/testing/ForceFieldTestCreation.h>
+#include <sofa/component/topology/container/grid/RegularGridTopology.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/simulation/Node.h>
 
 namespace sofa 
 {
@@ -150,4 +153,85 @@ TYPED_TEST( HexahedronFEMForceField_test, test_computeBBox )
     ASSERT_NO_THROW(this->test_computeBBox()) ;
 }
 
+/// The shared stiffness matrices, applied to batches of elements sequentially or in parallel,
+/// must give the same forces as one stiffness matrix per element
+TEST( HexahedronFEMForceField_sharedStiffness, sameForcesAsPerElementStiffness )
+{
+    using DataTypes = defaulttype::Vec3Types;
+    using HexahedronFEMForceField = component::solidmechanics::fem::elastic::HexahedronFEMForceField<DataTypes>;
+    using VecCoord = DataTypes::VecCoord;
+    using VecDeriv = DataTypes::VecDeriv;
+
+    const simulation::Node::SPtr root = simulation::getSimulation()->createNewGraph("root");
+
+    const auto grid = core::objectmodel::New<component::topology::container::grid::RegularGridTopology>(5, 4, 4);
+    grid->setPos(0, 4, 0, 3, 0, 3);
+    root->addObject(grid);
+    root->addObject(core::objectmodel::New<component::statecontainer::MechanicalObject<DataTypes> >());
+
+    const auto fem = core::objectmodel::New<HexahedronFEMForceField>();
+    fem->setYoungModulus(1000);
+    fem->setPoissonRatio(0.3);
+    root->addObject(fem);
+
+    sofa::simulation::node::initRoot(root.get());
+
+    // deform the grid
+    VecCoord x = fem->getMState()->readRestPositions().ref();
+    VecDeriv dx(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = x[i] * 1.1 + DataTypes::Coord(0.05 * std::sin(i), 0.1 * x[i][0] * x[i][0], 0.05 * std::cos(i));
+        dx[i] = DataTypes::Deriv(std::cos(i), std::sin(2. * i), 0.5);
+    }
+
+    core::objectmodel::Data<VecCoord> d_x;
+    core::objectmodel::Data<VecDeriv> d_v, d_dx;
+    d_x.setValue(x);
+    d_v.setValue(VecDeriv(x.size()));
+    d_dx.setValue(dx);
+
+    const auto computeForces = [&](VecDeriv& f, VecDeriv& df)
+    {
+        core::objectmodel::Data<VecDeriv> d_f, d_df;
+        d_f.setValue(VecDeriv(x.size()));
+        d_df.setValue(VecDeriv(x.size()));
+
+        fem->addForce(core::mechanicalparams::defaultInstance(), d_f, d_x, d_v);
+        fem->addDForce(core::mechanicalparams::defaultInstance(), d_df, d_dx);
+
+        f = d_f.getValue();
+        df = d_df.getValue();
+    };
+
+    const auto expectSameForces = [](const VecDeriv& expected, const VecDeriv& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_LE((expected[i] - actual[i]).norm(), 1e-8 * (1 + expected[i].norm())) << "vertex " << i;
+        }
+    };
+
+    VecDeriv f, df;
+    computeForces(f, df);
+    EXPECT_EQ(fem->d_nbStiffnessMatrices.getValue(), 4 * 3 * 3);
+
+    fem->d_shareStiffnessMatrices.setValue(true);
+    fem->reinit();
+    EXPECT_EQ(fem->d_nbStiffnessMatrices.getValue(), 1);
+
+    VecDeriv sharedF, sharedDf;
+    computeForces(sharedF, sharedDf);
+    expectSameForces(f, sharedF);
+    expectSameForces(df, sharedDf);
+
+    fem->d_parallel.setValue(true);
+
+    VecDeriv parallelF, parallelDf;
+    computeForces(parallelF, parallelDf);
+    expectSameForces(f, parallelF);
+    expectSameForces(df, parallelDf);
+}
+
 } // namespace sofa
@@ -644,6 +644,51 @@ public:
     }
 
 
+    /// Simulate the grid with the triangle batches of TriangularFEMForceFieldOptim processed sequentially, then in parallel
+    void checkParallelOptimValues()
+    {
+        const int nbrGrid = 40;
+        const int nbrStep = 20;
+
+        const auto simulate = [&](bool parallel)
+        {
+            createGridFEMScene(2, nbrGrid);
+            typename TriangularFEMOptim::SPtr triFEM = m_root->getTreeObject<TriangularFEMOptim>();
+            EXPECT_NE(triFEM.get(), nullptr);
+            if (triFEM)
+            {
+                triFEM->d_parallel.setValue(parallel);
+            }
+
+            for (int i = 0; i < nbrStep; i++)
+            {
+                sofa::simulation::node::animate(m_root.get(), 0.01_sreal);
+            }
+
+            typename MState::SPtr dofs = m_root->getTreeObject<MState>();
+            VecCoord positions = dofs->x.getValue();
+            sofa::simulation::node::unload(m_root);
+            m_root = nullptr;
+            return positions;
+        };
+
+        const VecCoord sequential = simulate(false);
+        const VecCoord parallel = simulate(true);
+
+        ASSERT_EQ(sequential.size(), nbrGrid * nbrGrid);
+        ASSERT_EQ(parallel.size(), sequential.size());
+        EXPECT_GT(sequential[1515][1], 9.48718); // the grid moved
+        for (std::size_t i = 0; i < sequential.size(); ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                // the vertices receive the contributions of the triangles in the same order
+                EXPECT_NEAR(sequential[i][c], parallel[i][c], 1e-12);
+            }
+        }
+    }
+
+
     void testFEMPerformance(int FEMType)
     {
         // init
@@ -820,6 +865,11 @@ TEST_F(TriangleFEMForceField3_test, checkTriangularFEMForceFieldOptim_values)
     this->checkFEMValues(2);
 }
 
+TEST_F(TriangleFEMForceField3_test, checkTriangularFEMForceFieldOptim_parallel)
+{
+    this->checkParallelOptimValues();
+}
+
 
 
 /// Those tests should not be removed but can't be run on the CI
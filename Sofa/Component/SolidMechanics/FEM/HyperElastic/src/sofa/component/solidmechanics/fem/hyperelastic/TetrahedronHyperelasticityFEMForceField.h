@@ -28,6 +28,7 @@
 #include <sofa/core/behavior/ForceField.h>
 #include <sofa/type/Mat.h>
 #include <sofa/type/MatSym.h>
+#include <sofa/type/fixed_array.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/core/topology/TopologyData.h>
 
@@ -136,6 +137,7 @@ public:
     Data<std::string> d_materialName; ///< the name of the material
     Data<SetParameterArray> d_parameterSet; ///< The global parameters specifying the material
     Data<SetAnisotropyDirectionArray> d_anisotropySet; ///< The global directions of anisotropy of the material
+    Data<bool> d_parallel; ///< Compute the element forces and stiffnesses in parallel using the task scheduler
 
     TetrahedronData<sofa::type::vector<TetrahedronRestInformation> > m_tetrahedronInfo; ///< Internal tetrahedron data
     EdgeData<sofa::type::vector<EdgeInformation> > m_edgeInfo; ///< Internal edge data
@@ -186,11 +188,56 @@ protected:
 
     std::unique_ptr<material::HyperelasticMaterial<DataTypes> > m_myMaterial;
 
+    /// concrete type of m_myMaterial, used to select the element kernels once per call instead of once per element
+    enum class MaterialType
+    {
+        Generic,
+        ArrudaBoyce,
+        StVenantKirchhoff,
+        NeoHookean,
+        MooneyRivlin,
+        VerondaWestman,
+        Costa,
+        Ogden,
+        StableNeoHookean
+    };
+    MaterialType m_materialType { MaterialType::Generic };
+
+    /// element contributions, computed independently in parallel mode and gathered afterwards
+    type::vector<type::fixed_array<Deriv, 4> > m_elementForces;
+    type::vector<type::fixed_array<Matrix3, 6> > m_elementEdgeStiffness;
+
+    /// for each vertex (resp. edge), the contributions of m_elementForces (resp. m_elementEdgeStiffness)
+    /// to sum, in increasing element order. Stored in compressed row format.
+    type::vector<Index> m_vertexContributionBegin;
+    type::vector<Index> m_vertexContributions;
+    type::vector<Index> m_edgeContributionBegin;
+    type::vector<Index> m_edgeContributions;
+    int m_contributionsRevision { -1 };
+
     void testDerivatives();
 
     void updateTangentMatrix();
 
     void instantiateMaterial();
+
+    void initTaskScheduler();
+
+    /// call kernel with m_myMaterial cast to its concrete type
+    template<class Kernel>
+    void dispatchMaterial(Kernel&& kernel);
+
+    /// compute the deformation gradient and the stress of a tetrahedron, and its contribution to the force of its 4 vertices
+    template<class Material>
+    void computeElementForce(Material& material, TetrahedronRestInformation& tetInfo, const Tetrahedron& ta,
+                             const VecCoord& x, Deriv* elementForce);
+
+    /// compute the contribution of a tetrahedron to the stiffness of its 6 edges
+    template<class Material>
+    void computeElementEdgeStiffness(Material& material, TetrahedronRestInformation& tetInfo, Index tetrahedronIndex,
+                                     Matrix3* edgeDfDx);
+
+    void updateContributions();
 };
 
 #if !defined(SOFA_COMPONENT_FORCEFIELD_TETRAHEDRONHYPERELASTICITYFEMFORCEFIELD_CPP)
@@ -37,6 +37,8 @@
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/behavior/ForceField.inl>
 #include <sofa/core/topology/TopologyData.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::solidmechanics::fem::hyperelastic
 {
@@ -54,6 +56,7 @@ template <class DataTypes> TetrahedronHyperelasticityFEMForceField<DataTypes>::T
     , d_materialName(initData(&d_materialName,std::string("ArrudaBoyce"),"materialName","the name of the material to be used"))
     , d_parameterSet(initData(&d_parameterSet,"ParameterSet","The global parameters specifying the material"))
     , d_anisotropySet(initData(&d_anisotropySet,"AnisotropyDirections","The global directions of anisotropy of the material"))
+    , d_parallel(initData(&d_parallel, false, "parallel", "Compute the element forces and stiffnesses in parallel using the task scheduler"))
     , m_tetrahedronInfo(initData(&m_tetrahedronInfo, "tetrahedronInfo", "Internal tetrahedron data"))
     , m_edgeInfo(initData(&m_edgeInfo, "edgeInfo", "Internal edge data"))
     , l_topology(initLink("topology", "link to the topology container"))
@@ -69,37 +72,47 @@ void TetrahedronHyperelasticityFEMForceField<DataTypes>::instantiateMaterial()
 {
     const std::string& material = d_materialName.getValue();
 
+    m_materialType = MaterialType::Generic;
+
     if (material == "ArrudaBoyce")
     {
         m_myMaterial = std::make_unique<BoyceAndArruda<DataTypes>>();
+        m_materialType = MaterialType::ArrudaBoyce;
     }
     else if (material == "StVenantKirchhoff")
     {
         m_myMaterial = std::make_unique<STVenantKirchhoff<DataTypes>>();
+        m_materialType = MaterialType::StVenantKirchhoff;
     }
     else if (material == "NeoHookean")
     {
         m_myMaterial = std::make_unique<NeoHookean<DataTypes>>();
+        m_materialType = MaterialType::NeoHookean;
     }
     else if (material == "MooneyRivlin")
     {
         m_myMaterial = std::make_unique<MooneyRivlin<DataTypes>>();
+        m_materialType = MaterialType::MooneyRivlin;
     }
     else if (material == "VerondaWestman")
     {
         m_myMaterial = std::make_unique<VerondaWestman<DataTypes>>();
+        m_materialType = MaterialType::VerondaWestman;
     }
     else if (material == "Costa")
     {
         m_myMaterial = std::make_unique<Costa<DataTypes>>();
+        m_materialType = MaterialType::Costa;
     }
     else if (material == "Ogden")
     {
         m_myMaterial = std::make_unique<Ogden<DataTypes>>();
+        m_materialType = MaterialType::Ogden;
     }
     else if (material == "StableNeoHookean")
     {
         m_myMaterial = std::make_unique<StableNeoHookean<DataTypes>>();
+        m_materialType = MaterialType::StableNeoHookean;
     }
     else
     {
@@ -113,6 +126,57 @@ void TetrahedronHyperelasticityFEMForceField<DataTypes>::instantiateMaterial()
     }
 }
 
+template <class DataTypes>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::initTaskScheduler()
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+        msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+    }
+}
+
+template <class DataTypes>
+template <class Kernel>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::dispatchMaterial(Kernel&& kernel)
+{
+    // The kernels are instantiated for each concrete material, so that the material laws are
+    // called without virtual dispatch and can be inlined in the element loops.
+    switch (m_materialType)
+    {
+    case MaterialType::ArrudaBoyce:
+        kernel(static_cast<BoyceAndArruda<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::StVenantKirchhoff:
+        kernel(static_cast<STVenantKirchhoff<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::NeoHookean:
+        kernel(static_cast<NeoHookean<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::MooneyRivlin:
+        kernel(static_cast<MooneyRivlin<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::VerondaWestman:
+        kernel(static_cast<VerondaWestman<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::Costa:
+        kernel(static_cast<Costa<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::Ogden:
+        kernel(static_cast<Ogden<DataTypes>&>(*m_myMaterial));
+        break;
+    case MaterialType::StableNeoHookean:
+        kernel(static_cast<StableNeoHookean<DataTypes>&>(*m_myMaterial));
+        break;
+    default:
+        kernel(*m_myMaterial);
+        break;
+    }
+}
+
 template <class DataTypes> void TetrahedronHyperelasticityFEMForceField<DataTypes>::init()
 {
     using namespace material;
@@ -155,6 +219,11 @@ template <class DataTypes> void TetrahedronHyperelasticityFEMForceField<DataType
     /** parse the input material name */
     instantiateMaterial();
 
+    if (d_parallel.getValue())
+    {
+        initTaskScheduler();
+    }
+
     if (!m_topology->getNbTetrahedra())
     {
         msg_error() << "object must have a Tetrahedral Set Topology.";
@@ -269,179 +338,350 @@ void TetrahedronHyperelasticityFEMForceField<DataTypes>::createTetrahedronRestIn
     }
 }
 
+template <class DataTypes>
+template <class Material>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::computeElementForce(Material& material,
+    TetrahedronRestInformation& tetInfo, const Tetrahedron& ta, const VecCoord& x, Deriv* elementForce)
+{
+    unsigned int j = 0, k = 0, l = 0;
+    Coord dp[3], sv;
+
+    const Coord x0 = x[ta[0]];
+
+    // compute the deformation gradient
+    // deformation gradient = sum of tensor product between vertex position and shape vector
+    // optimize by using displacement with first vertex
+    dp[0] = x[ta[1]] - x0;
+    sv = tetInfo.m_shapeVector[1];
+    for (k = 0; k < 3; ++k)
+    {
+        for (l = 0; l < 3; ++l)
+        {
+            tetInfo.m_deformationGradient[k][l] = dp[0][k] * sv[l];
+        }
+    }
+    for (j = 1; j < 3; ++j)
+    {
+        dp[j] = x[ta[j + 1]] - x0;
+        sv = tetInfo.m_shapeVector[j + 1];
+        for (k = 0; k < 3; ++k)
+        {
+            for (l = 0; l < 3; ++l)
+            {
+                tetInfo.m_deformationGradient[k][l] += dp[j][k] * sv[l];
+            }
+        }
+    }
+
+    /// compute the right Cauchy-Green deformation matrix
+    for (k = 0; k < 3; ++k)
+    {
+        for (l = k; l < 3; ++l)
+        {
+            tetInfo.deformationTensor(k, l) =
+                tetInfo.m_deformationGradient(0, k) * tetInfo.m_deformationGradient(0, l) +
+                tetInfo.m_deformationGradient(1, k) * tetInfo.m_deformationGradient(1, l) +
+                tetInfo.m_deformationGradient(2, k) * tetInfo.m_deformationGradient(2, l);
+        }
+    }
+
+    if (globalParameters.anisotropyDirection.size() > 0)
+    {
+        tetInfo.m_fiberDirection = globalParameters.anisotropyDirection[0];
+        Coord vectCa = tetInfo.deformationTensor * tetInfo.m_fiberDirection;
+        Real aDotCDota = dot(tetInfo.m_fiberDirection, vectCa);
+        tetInfo.lambda = (Real)sqrt(aDotCDota);
+    }
+    const Coord areaVec = cross( dp[1], dp[2] );
+
+    tetInfo.J = dot(areaVec, dp[0]) * tetInfo.m_volScale;
+    tetInfo.trC = (Real)(tetInfo.deformationTensor(0, 0) + tetInfo.deformationTensor(1, 1) +
+                         tetInfo.deformationTensor(2, 2));
+    tetInfo.m_SPKTensorGeneral.clear();
+
+    if constexpr (std::is_same_v<Material, HyperelasticMaterial<DataTypes> >)
+    {
+        material.deriveSPKTensor(&tetInfo, globalParameters, tetInfo.m_SPKTensorGeneral);
+    }
+    else
+    {
+        material.Material::deriveSPKTensor(&tetInfo, globalParameters, tetInfo.m_SPKTensorGeneral);
+    }
+
+    for (l = 0; l < 4; ++l)
+    {
+        elementForce[l] = -(tetInfo.m_deformationGradient * (
+            tetInfo.m_SPKTensorGeneral * tetInfo.m_shapeVector[l]) * tetInfo.m_restVolume);
+    }
+}
+
+template <class DataTypes>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::updateContributions()
+{
+    const int revision = m_topology->getRevision();
+    const std::size_t nbVertices = this->mstate->getSize();
+    const unsigned int nbEdges = m_topology->getNbEdges();
+    const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
+
+    if (revision == m_contributionsRevision
+        && m_vertexContributionBegin.size() == nbVertices + 1
+        && m_edgeContributionBegin.size() == nbEdges + 1
+        && m_elementForces.size() == nbTetrahedra)
+    {
+        return;
+    }
+
+    m_elementForces.resize(nbTetrahedra);
+    m_elementEdgeStiffness.resize(nbTetrahedra);
+
+    // counting sort of the element contributions by vertex and by edge: since the elements are
+    // visited in increasing order, the contributions are summed in the same order as in the
+    // sequential loop, and both modes give identical results
+    m_vertexContributionBegin.assign(nbVertices + 1, 0);
+    m_edgeContributionBegin.assign(nbEdges + 1, 0);
+    for (unsigned int i = 0; i < nbTetrahedra; ++i)
+    {
+        const Tetrahedron& ta = m_topology->getTetrahedron(i);
+        const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            ++m_vertexContributionBegin[ta[j] + 1];
+        }
+        for (unsigned int j = 0; j < 6; ++j)
+        {
+            ++m_edgeContributionBegin[te[j] + 1];
+        }
+    }
+    for (std::size_t v = 0; v < nbVertices; ++v)
+    {
+        m_vertexContributionBegin[v + 1] += m_vertexContributionBegin[v];
+    }
+    for (unsigned int e = 0; e < nbEdges; ++e)
+    {
+        m_edgeContributionBegin[e + 1] += m_edgeContributionBegin[e];
+    }
+
+    m_vertexContributions.resize(4 * nbTetrahedra);
+    m_edgeContributions.resize(6 * nbTetrahedra);
+    type::vector<Index> vertexCursor(m_vertexContributionBegin.begin(), m_vertexContributionBegin.end() - 1);
+    type::vector<Index> edgeCursor(m_edgeContributionBegin.begin(), m_edgeContributionBegin.end() - 1);
+    for (unsigned int i = 0; i < nbTetrahedra; ++i)
+    {
+        const Tetrahedron& ta = m_topology->getTetrahedron(i);
+        const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            m_vertexContributions[vertexCursor[ta[j]]++] = 4 * i + j;
+        }
+        for (unsigned int j = 0; j < 6; ++j)
+        {
+            m_edgeContributions[edgeCursor[te[j]]++] = 6 * i + j;
+        }
+    }
+
+    m_contributionsRevision = revision;
+}
+
 template <class DataTypes>
 void TetrahedronHyperelasticityFEMForceField<DataTypes>::addForce(const core::MechanicalParams* /* mparams */ /* PARAMS FIRST */, DataVecDeriv& d_f, const DataVecCoord& d_x, const DataVecDeriv& /* d_v */)
 {
     auto f = sofa::helper::getWriteAccessor(d_f);
     const VecCoord& x = d_x.getValue();
 
-    unsigned int j = 0, k = 0, l = 0;
     const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
 
     auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
 
     assert(this->mstate);
 
-    Coord dp[3], x0, sv;
-
-    for (unsigned int i = 0; i < nbTetrahedra; i++)
+    if (!d_parallel.getValue())
     {
-        TetrahedronRestInformation* tetInfo = &tetrahedronInf[i];
-        const Tetrahedron& ta = m_topology->getTetrahedron(i);
-
-        x0 = x[ta[0]];
-
-        // compute the deformation gradient
-        // deformation gradient = sum of tensor product between vertex position and shape vector
-        // optimize by using displacement with first vertex
-        dp[0] = x[ta[1]] - x0;
-        sv = tetInfo->m_shapeVector[1];
-        for (k = 0; k < 3; ++k)
+        dispatchMaterial([&](auto& material)
         {
-            for (l = 0; l < 3; ++l)
+            Deriv elementForce[4];
+            for (unsigned int i = 0; i < nbTetrahedra; i++)
             {
-                tetInfo->m_deformationGradient[k][l] = dp[0][k] * sv[l];
+                const Tetrahedron& ta = m_topology->getTetrahedron(i);
+                computeElementForce(material, tetrahedronInf[i], ta, x, elementForce);
+                for (unsigned int l = 0; l < 4; ++l)
+                {
+                    f[ta[l]] += elementForce[l];
+                }
             }
-        }
-        for (j = 1; j < 3; ++j)
+        });
+    }
+    else
+    {
+        initTaskScheduler();
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+
+        updateContributions();
+
+        VecDeriv& force = f.wref();
+        type::vector<TetrahedronRestInformation>& tetInfos = tetrahedronInf.wref();
+        const VecElement& tetrahedra = m_topology->getTetrahedra();
+
+        // each element writes its own contributions...
+        dispatchMaterial([&](auto& material)
         {
-            dp[j] = x[ta[j + 1]] - x0;
-            sv = tetInfo->m_shapeVector[j + 1];
-            for (k = 0; k < 3; ++k)
+            simulation::parallelForEach(*taskScheduler, 0u, nbTetrahedra,
+                [&](const unsigned int i)
+                {
+                    computeElementForce(material, tetInfos[i], tetrahedra[i], x, &m_elementForces[i][0]);
+                });
+        });
+
+        // ... which are then gathered by vertex, without write conflicts
+        simulation::parallelForEach(*taskScheduler, std::size_t(0), m_vertexContributionBegin.size() - 1,
+            [&](const std::size_t v)
             {
-                for (l = 0; l < 3; ++l)
+                for (Index c = m_vertexContributionBegin[v]; c < m_vertexContributionBegin[v + 1]; ++c)
                 {
-                    tetInfo->m_deformationGradient[k][l] += dp[j][k] * sv[l];
+                    const Index contribution = m_vertexContributions[c];
+                    force[v] += m_elementForces[contribution / 4][contribution % 4];
                 }
-            }
+            });
+    }
+
+    /// indicates that the next call to addDForce will need to update the stiffness matrix
+    m_updateMatrix = true;
+}
+
+template <class DataTypes>
+template <class Material>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::computeElementEdgeStiffness(Material& material,
+    TetrahedronRestInformation& tetInfo, Index tetrahedronIndex, Matrix3* edgeDfDx)
+{
+    unsigned int k = 0, l = 0;
+    const type::vector<Edge>& edgeArray = m_topology->getEdges();
+    const Matrix3& df = tetInfo.m_deformationGradient;
+    const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(tetrahedronIndex);
+
+    /// describe the jth vertex index of triangle no i
+    const Tetrahedron& ta = m_topology->getTetrahedron(tetrahedronIndex);
+    for (unsigned int j = 0; j < 6; j++)
+    {
+        Edge e = m_topology->getLocalEdgesInTetrahedron(j);
+
+        k = e[0];
+        l = e[1];
+        if (edgeArray[te[j]][0] != ta[k])
+        {
+            k = e[1];
+            l = e[0];
         }
 
-        /// compute the right Cauchy-Green deformation matrix
-        for (k = 0; k < 3; ++k)
+        const Coord& svl = tetInfo.m_shapeVector[l];
+        const Coord& svk = tetInfo.m_shapeVector[k];
+
+        Matrix3  M, N;
+        MatrixSym outputTensor;
+        N.clear();
+        MatrixSym inputTensor[3];
+        for (int m = 0; m < 3; m++)
         {
-            for (l = k; l < 3; ++l)
+            for (int n = m; n < 3; n++)
             {
-                tetInfo->deformationTensor(k, l) =
-                    tetInfo->m_deformationGradient(0, k) * tetInfo->m_deformationGradient(0, l) +
-                    tetInfo->m_deformationGradient(1, k) * tetInfo->m_deformationGradient(1, l) +
-                    tetInfo->m_deformationGradient(2, k) * tetInfo->m_deformationGradient(2, l);
+                inputTensor[0](m, n) = svl[m] * df[0][n] + df[0][m] * svl[n];
+                inputTensor[1](m, n) = svl[m] * df[1][n] + df[1][m] * svl[n];
+                inputTensor[2](m, n) = svl[m] * df[2][n] + df[2][m] * svl[n];
             }
         }
 
-        if (globalParameters.anisotropyDirection.size() > 0)
-        {
-            tetInfo->m_fiberDirection = globalParameters.anisotropyDirection[0];
-            Coord vectCa = tetInfo->deformationTensor * tetInfo->m_fiberDirection;
-            Real aDotCDota = dot(tetInfo->m_fiberDirection, vectCa);
-            tetInfo->lambda = (Real)sqrt(aDotCDota);
-        }
-        const Coord areaVec = cross( dp[1], dp[2] );
-
-        tetInfo->J = dot(areaVec, dp[0]) * tetInfo->m_volScale;
-        tetInfo->trC = (Real)(tetInfo->deformationTensor(0, 0) + tetInfo->deformationTensor(1, 1) +
-                              tetInfo->deformationTensor(2, 2));
-        tetInfo->m_SPKTensorGeneral.clear();
-        m_myMaterial->deriveSPKTensor(tetInfo, globalParameters, tetInfo->m_SPKTensorGeneral);
-        for (l = 0; l < 4; ++l)
+        for (int m = 0; m < 3; m++)
         {
-            f[ta[l]] -= tetInfo->m_deformationGradient * (
-                tetInfo->m_SPKTensorGeneral * tetInfo->m_shapeVector[l]) * tetInfo->m_restVolume;
+            if constexpr (std::is_same_v<Material, HyperelasticMaterial<DataTypes> >)
+            {
+                material.applyElasticityTensor(&tetInfo, globalParameters, inputTensor[m], outputTensor);
+            }
+            else
+            {
+                material.Material::applyElasticityTensor(&tetInfo, globalParameters, inputTensor[m], outputTensor);
+            }
+            Coord vectortemp = df * (outputTensor * svk);
+            Matrix3 Nv;
+            for (int u = 0; u < 3; u++)
+            {
+                Nv[u][m] = vectortemp[u];
+            }
+            N += Nv.transposed();
         }
-    }
 
 
-    /// indicates that the next call to addDForce will need to update the stiffness matrix
-    m_updateMatrix = true;
+        //Now M
+        Real productSD = 0;
+
+        const Coord vectSD = tetInfo.m_SPKTensorGeneral * svk;
+        productSD = dot(vectSD, svl);
+        M[0][1] = M[0][2] = M[1][0] = M[1][2] = M[2][0] = M[2][1] = 0;
+        M[0][0] = M[1][1] = M[2][2] = (Real)productSD;
+
+        edgeDfDx[j] = (M+N)*tetInfo.m_restVolume;
+    }
 }
 
 template <class DataTypes>
 void TetrahedronHyperelasticityFEMForceField<DataTypes>::updateTangentMatrix()
 {
-    unsigned int k = 0, l;
     const unsigned int nbEdges = m_topology->getNbEdges();
-    const type::vector<Edge>& edgeArray = m_topology->getEdges();
 
     auto edgeInf = sofa::helper::getWriteAccessor(m_edgeInfo);
     auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
 
     const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
-    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
 
-    for (l = 0; l < nbEdges; l++)
+    for (unsigned int l = 0; l < nbEdges; l++)
     {
         edgeInf[l].DfDx.clear();
     }
-    for (unsigned int i = 0; i < nbTetrahedra; i++)
-    {
-        TetrahedronRestInformation* tetInfo = &tetrahedronInf[i];
-        Matrix3& df = tetInfo->m_deformationGradient;
-//			Matrix3 Tdf=df.transposed();
-        const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
 
-        /// describe the jth vertex index of triangle no i
-        const Tetrahedron& ta = tetrahedronArray[i];
-        for (unsigned int j = 0; j < 6; j++)
+    if (!d_parallel.getValue())
+    {
+        dispatchMaterial([&](auto& material)
         {
-            EdgeInformation* einfo = &edgeInf[te[j]];
-            Edge e = m_topology->getLocalEdgesInTetrahedron(j);
-
-            k = e[0];
-            l = e[1];
-            if (edgeArray[te[j]][0] != ta[k])
+            Matrix3 edgeDfDx[6];
+            for (unsigned int i = 0; i < nbTetrahedra; i++)
             {
-                k = e[1];
-                l = e[0];
+                computeElementEdgeStiffness(material, tetrahedronInf[i], i, edgeDfDx);
+
+                const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+                for (unsigned int j = 0; j < 6; j++)
+                {
+                    edgeInf[te[j]].DfDx += edgeDfDx[j];
+                }
             }
-            Matrix3 &edgeDfDx = einfo->DfDx;
+        });
+    }
+    else
+    {
+        initTaskScheduler();
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
 
+        updateContributions();
 
-            const Coord& svl = tetInfo->m_shapeVector[l];
-            const Coord& svk = tetInfo->m_shapeVector[k];
+        type::vector<EdgeInformation>& edgeInfos = edgeInf.wref();
+        type::vector<TetrahedronRestInformation>& tetInfos = tetrahedronInf.wref();
 
-            Matrix3  M, N;
-            MatrixSym outputTensor;
-            N.clear();
-            type::vector<MatrixSym> inputTensor;
-            inputTensor.resize(3);
-            //	MatrixSym input1,input2,input3,outputTensor;
-            for (int m = 0; m < 3; m++)
-            {
-                for (int n = m; n < 3; n++)
+        dispatchMaterial([&](auto& material)
+        {
+            simulation::parallelForEach(*taskScheduler, 0u, nbTetrahedra,
+                [&](const unsigned int i)
                 {
-                    inputTensor[0](m, n) = svl[m] * df[0][n] + df[0][m] * svl[n];
-                    inputTensor[1](m, n) = svl[m] * df[1][n] + df[1][m] * svl[n];
-                    inputTensor[2](m, n) = svl[m] * df[2][n] + df[2][m] * svl[n];
-                }
-            }
+                    computeElementEdgeStiffness(material, tetInfos[i], i, &m_elementEdgeStiffness[i][0]);
+                });
+        });
 
-            for (int m = 0; m < 3; m++)
+        simulation::parallelForEach(*taskScheduler, 0u, nbEdges,
+            [&](const unsigned int e)
             {
-                m_myMaterial->applyElasticityTensor(tetInfo, globalParameters, inputTensor[m],
-                                                    outputTensor);
-                Coord vectortemp = df * (outputTensor * svk);
-                Matrix3 Nv;
-                //Nv.clear();
-                for (int u = 0; u < 3; u++)
+                for (Index c = m_edgeContributionBegin[e]; c < m_edgeContributionBegin[e + 1]; ++c)
                 {
-                    Nv[u][m] = vectortemp[u];
+                    const Index contribution = m_edgeContributions[c];
+                    edgeInfos[e].DfDx += m_elementEdgeStiffness[contribution / 6][contribution % 6];
                 }
-                N += Nv.transposed();
-            }
-
-
-            //Now M
-            Real productSD = 0;
-
-            const Coord vectSD = tetInfo->m_SPKTensorGeneral * svk;
-            productSD = dot(vectSD, svl);
-            M[0][1] = M[0][2] = M[1][0] = M[1][2] = M[2][0] = M[2][1] = 0;
-            M[0][0] = M[1][1] = M[2][2] = (Real)productSD;
-
-            edgeDfDx += (M+N)*tetInfo->m_restVolume;
-
+            });
+    }
 
-        }// end of for j
-    }//end of for i
     m_updateMatrix=false;
 }
 
@@ -128,6 +128,60 @@ struct TetrahedronHyperelasticityFEMForceField_params_test : public BaseSimulati
         sofa::core::objectmodel::BaseObject* hefem = root->getTreeNode("Hyperelastic-Liver")->getObject("FEM") ;
         EXPECT_NE(hefem, nullptr) ;
     }
+
+    void run_test_parallel_case()
+    {
+        this->scene_load();
+
+        typename TetrahedronHyperelasticityFEMForceField::SPtr FF = sofa::core::objectmodel::New< TetrahedronHyperelasticityFEMForceField >();
+        hyperelasticNode->addObject(FF);
+        FF->setName("FEM");
+        FF->setMaterialName("NeoHookean");
+        FF->setparameter({ 3000, 10000 }); // Lame coefficients mu and lambda
+
+        sofa::simulation::node::initRoot(this->root.get());
+
+        // deform the rest shape
+        VecCoord x = FF->getMState()->readPositions().ref();
+        VecDeriv dx(x.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            x[i] = x[i] * Real(1.05) + Coord(Real(0.01) * std::sin(Real(i)), 0, Real(0.01) * std::cos(Real(i)));
+            dx[i] = Deriv(std::cos(Real(i)), std::sin(Real(2 * i)), Real(0.5));
+        }
+
+        core::objectmodel::Data<VecCoord> d_x;
+        core::objectmodel::Data<VecDeriv> d_v, d_dx;
+        d_x.setValue(x);
+        d_v.setValue(VecDeriv(x.size()));
+        d_dx.setValue(dx);
+
+        const auto computeForces = [&](bool parallel, VecDeriv& f, VecDeriv& df)
+        {
+            FF->d_parallel.setValue(parallel);
+
+            core::objectmodel::Data<VecDeriv> d_f, d_df;
+            d_f.setValue(VecDeriv(x.size()));
+            d_df.setValue(VecDeriv(x.size()));
+
+            FF->addForce(core::mechanicalparams::defaultInstance(), d_f, d_x, d_v);
+            FF->addDForce(core::mechanicalparams::defaultInstance(), d_df, d_dx);
+
+            f = d_f.getValue();
+            df = d_df.getValue();
+        };
+
+        VecDeriv sequentialForce, sequentialDForce, parallelForce, parallelDForce;
+        computeForces(false, sequentialForce, sequentialDForce);
+        computeForces(true, parallelForce, parallelDForce);
+
+        ASSERT_EQ(sequentialForce.size(), parallelForce.size());
+        for (std::size_t i = 0; i < sequentialForce.size(); ++i)
+        {
+            EXPECT_LE((sequentialForce[i] - parallelForce[i]).norm(), 1e-10 * (1 + sequentialForce[i].norm()));
+            EXPECT_LE((sequentialDForce[i] - parallelDForce[i]).norm(), 1e-10 * (1 + sequentialDForce[i].norm()));
+        }
+    }
 };
 
 
@@ -149,5 +203,12 @@ TYPED_TEST( TetrahedronHyperelasticityFEMForceField_params_test , extension )
     this->run_test_params_mooney_case();
 }
 
+TYPED_TEST( TetrahedronHyperelasticityFEMForceField_params_test , parallelMatchesSequential )
+{
+    EXPECT_MSG_NOEMIT(Error) ;
+
+    this->run_test_parallel_case();
+}
+
 
 } // namespace sofa
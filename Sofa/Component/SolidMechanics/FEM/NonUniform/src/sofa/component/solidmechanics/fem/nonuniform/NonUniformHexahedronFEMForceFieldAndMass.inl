@@ -47,6 +47,13 @@ void NonUniformHexahedronFEMForceFieldAndMass<DataTypes>::init()
 
     this->core::behavior::ForceField<DataTypes>::init();
 
+    // the stiffness matrices are computed by condensation of the finer levels: they are not shared
+    if (this->d_shareStiffnessMatrices.getValue() || this->d_parallel.getValue())
+    {
+        msg_warning() << "The options " << this->d_shareStiffnessMatrices.getName() << " and " << this->d_parallel.getName()
+                      << " are not supported by " << this->getClassName() << ": they are ignored.";
+    }
+
     if (l_topology.empty())
     {
         msg_info() << "link to Topology container should be set to ensure right behavior. First Topology found in current context will be used.";
@@ -2032,7 +2032,7 @@ void MechanicalObject<DataTypes>::vMultiOp(const core::ExecParams* params, const
             for (unsigned int i=0; i<n; ++i)
             {
                 vv[i] *= f_v_v;
-                vv[i] += va[i];
+                vv[i] += va[i]*f_v_a;
                 vx[i] += vv[i]*f_x_v;
             }
         }
@@ -36,10 +36,13 @@
 #include <sofa/core/ObjectFactory.h>
 
 #include <sofa/component/topology/container/grid/SparseGridTopology.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 #include <sstream>
 #include <map>
 #include <memory>
+#include <numeric>
 
 namespace sofa::component::visual
 {
@@ -118,6 +121,7 @@ VisualModelImpl::VisualModelImpl() //const std::string &name, std::string filena
     , m_handleDynamicTopology (initData   (&m_handleDynamicTopology, true, "handleDynamicTopology", "True if topological changes should be handled"))
     , m_fixMergedUVSeams (initData   (&m_fixMergedUVSeams, true, "fixMergedUVSeams", "True if UV seams should be handled even when duplicate UVs are merged"))
     , m_keepLines (initData   (&m_keepLines, false, "keepLines", "keep and draw lines (false by default)"))
+    , d_parallel (initData   (&d_parallel, false, "parallel", "Compute the normals and tangents in parallel"))
     , m_vertices2       (initData   (&m_vertices2, "vertices", "vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)"))
     , m_vtexcoords      (initData   (&m_vtexcoords, "texcoords", "coordinates of the texture"))
     , m_vtangents       (initData   (&m_vtangents, "tangents", "tangents for normal mapping"))
@@ -951,104 +955,234 @@ void VisualModelImpl::initFromTopology()
 
 
 
-void VisualModelImpl::computeNormals()
+template<class Function>
+void VisualModelImpl::forEachIndexRange(std::size_t size, const Function& f)
 {
-    const VecCoord& vertices = getVertices();
+    if (!d_parallel.getValue())
+    {
+        f(std::size_t(0), size);
+        return;
+    }
 
-    if (vertices.empty() || (!m_updateNormals.getValue() && (m_vnormals.getValue()).size() == (vertices).size())) return;
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
 
-    const VecVisualTriangle& triangles = m_triangles.getValue();
-    const VecVisualQuad& quads = m_quads.getValue();
-    const type::vector<visual_index_type> &vertNormIdx = m_vertNormIdx.getValue();
+    simulation::parallelForEachRange(*taskScheduler, std::size_t(0), size,
+        [&f](const simulation::Range<std::size_t>& range)
+        {
+            f(range.start, range.end);
+        });
+}
 
-    if (vertNormIdx.empty())
+void VisualModelImpl::FaceContributions::build(const VecVisualTriangle& triangles, const VecVisualQuad& quads,
+                                               const type::vector<visual_index_type>& vertexTarget, std::size_t nbTargets)
+{
+    const auto target = [&vertexTarget](const visual_index_type vertex)
     {
-        const std::size_t nbn = vertices.size();
-        auto normals = sofa::helper::getWriteOnlyAccessor(m_vnormals);
+        return vertexTarget.empty() ? vertex : vertexTarget[vertex];
+    };
 
-        normals.resize(nbn);
-        std::memset(&normals[0], 0, sizeof(normals[0]) * nbn); // bulk reset with zeros
-
-        for (const auto& triangle : triangles)
+    // count the contributions to each target, then sort them by target (counting sort)
+    begin.assign(nbTargets + 1, 0);
+    for (const auto& triangle : triangles)
+    {
+        for (const auto vertex : triangle)
         {
-            const Coord& v1 = vertices[ triangle[0] ];
-            const Coord& v2 = vertices[ triangle[1] ];
-            const Coord& v3 = vertices[ triangle[2] ];
-            const Coord n = cross(v2-v1, v3-v1);
-
-            normals[ triangle[0] ] += n;
-            normals[ triangle[1] ] += n;
-            normals[ triangle[2] ] += n;
+            ++begin[target(vertex) + 1];
         }
-
-        for (const auto& quad : quads)
+    }
+    for (const auto& quad : quads)
+    {
+        for (const auto vertex : quad)
         {
-            const Coord & v1 = vertices[ quad[0] ];
-            const Coord & v2 = vertices[ quad[1] ];
-            const Coord & v3 = vertices[ quad[2] ];
-            const Coord & v4 = vertices[ quad[3] ];
-            const Coord n1 = cross(v2-v1, v4-v1);
-            const Coord n2 = cross(v3-v2, v1-v2);
-            const Coord n3 = cross(v4-v3, v2-v3);
-            const Coord n4 = cross(v1-v4, v3-v4);
-
-            normals[ quad[0] ] += n1;
-            normals[ quad[1] ] += n2;
-            normals[ quad[2] ] += n3;
-            normals[ quad[3] ] += n4;
+            ++begin[target(vertex) + 1];
         }
+    }
+    std::partial_sum(begin.begin(), begin.end(), begin.begin());
 
-        for (auto& normal : normals)
+    slots.resize(begin.back());
+    type::vector<visual_index_type> next(begin.begin(), begin.end() - 1);
+    const auto nbTriangles = static_cast<visual_index_type>(triangles.size());
+    for (visual_index_type t = 0; t < nbTriangles; ++t)
+    {
+        for (const auto vertex : triangles[t])
         {
-            normal.normalize();
+            slots[next[target(vertex)]++] = t;
         }
     }
+    const auto nbQuads = static_cast<visual_index_type>(quads.size());
+    for (visual_index_type q = 0; q < nbQuads; ++q)
+    {
+        for (visual_index_type c = 0; c < 4; ++c)
+        {
+            slots[next[target(quads[q][c])]++] = nbTriangles + 4 * q + c;
+        }
+    }
+}
+
+bool VisualModelImpl::updateFaceContributions()
+{
+    const std::size_t nbVertices = getVertices().size();
+    const int counters[3] = { m_triangles.getCounter(), m_quads.getCounter(), m_vertNormIdx.getCounter() };
+    if (nbVertices == m_contributionsNbVertices && std::equal(counters, counters + 3, m_facesCounter))
+    {
+        return false;
+    }
+
+    const VecVisualTriangle& triangles = m_triangles.getValue();
+    const VecVisualQuad& quads = m_quads.getValue();
+    const type::vector<visual_index_type>& vertNormIdx = m_vertNormIdx.getValue();
+
+    m_vertexContributions.build(triangles, quads, {}, nbVertices);
+    if (vertNormIdx.empty())
+    {
+        m_normalContributions.begin.clear();
+        m_normalContributions.slots.clear();
+    }
+    else
+    {
+        const std::size_t nbNormals = static_cast<std::size_t>(*std::max_element(vertNormIdx.begin(), vertNormIdx.end())) + 1;
+        m_normalContributions.build(triangles, quads, vertNormIdx, nbNormals);
+    }
+
+    std::copy(counters, counters + 3, m_facesCounter);
+    m_contributionsNbVertices = nbVertices;
+    return true;
+}
+
+void VisualModelImpl::computeNormals()
+{
+    const VecCoord& vertices = getVertices();
+
+    if (vertices.empty() || (!m_updateNormals.getValue() && (m_vnormals.getValue()).size() == (vertices).size())) return;
+
+    const VecVisualTriangle& triangles = m_triangles.getValue();
+    const VecVisualQuad& quads = m_quads.getValue();
+    const type::vector<visual_index_type> &vertNormIdx = m_vertNormIdx.getValue();
+    const std::size_t nbVertices = vertices.size();
+    const std::size_t nbTriangles = triangles.size();
+    const std::size_t nbSlots = nbTriangles + 4 * quads.size();
+
+    // Everything is recomputed if the mesh changed, or if the normals were modified elsewhere. Otherwise, only the
+    // normals around the vertices which moved since the last computation are updated.
+    const bool all = updateFaceContributions()
+                     || m_normalsCounter != m_vnormals.getCounter()
+                     || m_normalsPositions.size() != nbVertices
+                     || m_slotNormals.size() != nbSlots;
+
+    m_slotNormals.resize(nbSlots);
+    m_dirtySlots.resize(nbSlots);
+    m_movedVertices.resize(nbVertices);
+    if (all)
+    {
+        m_normalsPositions = vertices;
+    }
     else
     {
-        const std::size_t nbn = static_cast<std::size_t>(*std::max_element(vertNormIdx.begin(), vertNormIdx.end())) + 1;
-        sofa::type::vector<Coord> normals(nbn); // will call the default ctor, which initializes with zeros
+        forEachIndexRange(nbVertices, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const bool moved = vertices[i] != m_normalsPositions[i];
+                m_movedVertices[i] = moved;
+                if (moved)
+                {
+                    m_normalsPositions[i] = vertices[i];
+                }
+            }
+        });
+    }
 
-        for (const auto& triangle : triangles)
+    // normals of the faces around the moved vertices
+    forEachIndexRange(nbTriangles, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t t = begin; t < end; ++t)
         {
-            const Coord & v1 = vertices[ triangle[0] ];
-            const Coord & v2 = vertices[ triangle[1] ];
-            const Coord & v3 = vertices[ triangle[2] ];
-            const Coord n = cross(v2-v1, v3-v1);
-
-            normals[vertNormIdx[ triangle[0] ]] += n;
-            normals[vertNormIdx[ triangle[1] ]] += n;
-            normals[vertNormIdx[ triangle[2] ]] += n;
+            const auto& triangle = triangles[t];
+            const bool dirty = all || m_movedVertices[triangle[0]] || m_movedVertices[triangle[1]] || m_movedVertices[triangle[2]];
+            m_dirtySlots[t] = dirty;
+            if (dirty)
+            {
+                const Coord& v1 = vertices[ triangle[0] ];
+                const Coord& v2 = vertices[ triangle[1] ];
+                const Coord& v3 = vertices[ triangle[2] ];
+                m_slotNormals[t] = cross(v2-v1, v3-v1);
+            }
         }
-
-        for (const auto& quad : quads)
+    });
+    forEachIndexRange(quads.size(), [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t q = begin; q < end; ++q)
         {
-            const Coord & v1 = vertices[ quad[0] ];
-            const Coord & v2 = vertices[ quad[1] ];
-            const Coord & v3 = vertices[ quad[2] ];
-            const Coord & v4 = vertices[ quad[3] ];
-            const Coord n1 = cross(v2-v1, v4-v1);
-            const Coord n2 = cross(v3-v2, v1-v2);
-            const Coord n3 = cross(v4-v3, v2-v3);
-            const Coord n4 = cross(v1-v4, v3-v4);
-
-            normals[vertNormIdx[ quad[0] ]] += n1;
-            normals[vertNormIdx[ quad[1] ]] += n2;
-            normals[vertNormIdx[ quad[2] ]] += n3;
-            normals[vertNormIdx[ quad[3] ]] += n4;
+            const auto& quad = quads[q];
+            const std::size_t slot = nbTriangles + 4 * q;
+            const bool dirty = all || m_movedVertices[quad[0]] || m_movedVertices[quad[1]] || m_movedVertices[quad[2]] || m_movedVertices[quad[3]];
+            std::fill(m_dirtySlots.begin() + slot, m_dirtySlots.begin() + slot + 4, dirty);
+            if (dirty)
+            {
+                const Coord & v1 = vertices[ quad[0] ];
+                const Coord & v2 = vertices[ quad[1] ];
+                const Coord & v3 = vertices[ quad[2] ];
+                const Coord & v4 = vertices[ quad[3] ];
+                m_slotNormals[slot    ] = cross(v2-v1, v4-v1);
+                m_slotNormals[slot + 1] = cross(v3-v2, v1-v2);
+                m_slotNormals[slot + 2] = cross(v4-v3, v2-v3);
+                m_slotNormals[slot + 3] = cross(v1-v4, v3-v4);
+            }
         }
+    });
 
-        for (auto& normal : normals)
+    // each normal gathers the contributions of its faces, in the order of the faces
+    const auto gatherNormals = [&](const FaceContributions& contributions, VecDeriv& normals)
+    {
+        forEachIndexRange(normals.size(), [&](const std::size_t begin, const std::size_t end)
         {
-            normal.normalize();
-        }
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const auto first = contributions.slots.begin() + contributions.begin[i];
+                const auto last = contributions.slots.begin() + contributions.begin[i + 1];
+                if (!all && std::none_of(first, last, [this](const visual_index_type slot) { return m_dirtySlots[slot] != 0; }))
+                {
+                    continue;
+                }
+
+                Deriv normal;
+                for (auto slot = first; slot != last; ++slot)
+                {
+                    normal += m_slotNormals[*slot];
+                }
+                normal.normalize();
+                normals[i] = normal;
+            }
+        });
+    };
 
+    {
         auto vnormals = sofa::helper::getWriteOnlyAccessor(m_vnormals);
-        vnormals.resize(vertices.size());
-        for (std::size_t i = 0; i < vertices.size(); i++)
+        vnormals.resize(nbVertices);
+
+        if (vertNormIdx.empty())
+        {
+            gatherNormals(m_vertexContributions, vnormals.wref());
+        }
+        else
         {
-            vnormals[i] = normals[vertNormIdx[i]];
+            m_indexedNormals.resize(m_normalContributions.begin.size() - 1);
+            gatherNormals(m_normalContributions, m_indexedNormals);
+            forEachIndexRange(nbVertices, [&](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    vnormals[i] = m_indexedNormals[vertNormIdx[i]];
+                }
+            });
         }
     }
+    m_normalsCounter = m_vnormals.getCounter();
 }
 
 VisualModelImpl::Coord VisualModelImpl::computeTangent(const Coord &v1, const Coord &v2, const Coord &v3,
@@ -1071,94 +1205,89 @@ void VisualModelImpl::computeTangents()
 {
     if (!m_computeTangents.getValue() || !m_vtexcoords.getValue().size()) return;
 
+    updateFaceContributions();
+
     const VecVisualTriangle& triangles = m_triangles.getValue();
     const VecVisualQuad& quads = m_quads.getValue();
     const VecCoord& vertices = getVertices();
     const VecTexCoord& texcoords = m_vtexcoords.getValue();
     const auto& normals = m_vnormals.getValue();
+    const std::size_t nbTriangles = triangles.size();
 
     auto tangents = sofa::helper::getWriteOnlyAccessor(m_vtangents);
     auto bitangents = sofa::helper::getWriteOnlyAccessor(m_vbitangents);
 
     tangents.resize(vertices.size());
     bitangents.resize(vertices.size());
+    m_slotTangents.resize(nbTriangles + 4 * quads.size());
 
-    for (unsigned i = 0; i < vertices.size(); i++)
-    {
-        tangents[i].clear();
-        bitangents[i].clear();
-    }
+    // The bitangents are deduced from the normals and the tangents: only the tangents of the faces are needed
     const bool fixMergedUVSeams = m_fixMergedUVSeams.getValue();
-    for (std::size_t i = 0; i < triangles.size() ; i++)
+    forEachIndexRange(nbTriangles, [&](const std::size_t begin, const std::size_t end)
     {
-        const Coord& v1 = vertices[triangles[i][0]];
-        const Coord& v2 = vertices[triangles[i][1]];
-        const Coord& v3 = vertices[triangles[i][2]];
-        const TexCoord& t1 = texcoords[triangles[i][0]];
-        TexCoord t2 = texcoords[triangles[i][1]];
-        TexCoord t3 = texcoords[triangles[i][2]];
-        if (fixMergedUVSeams)
+        for (std::size_t i = begin; i < end; ++i)
         {
-            for (Size j=0; j<TexCoord::size(); ++j)
+            const Coord& v1 = vertices[triangles[i][0]];
+            const Coord& v2 = vertices[triangles[i][1]];
+            const Coord& v3 = vertices[triangles[i][2]];
+            const TexCoord& t1 = texcoords[triangles[i][0]];
+            TexCoord t2 = texcoords[triangles[i][1]];
+            TexCoord t3 = texcoords[triangles[i][2]];
+            if (fixMergedUVSeams)
             {
-                t2[j] += helper::rnear(t1[j]-t2[j]);
-                t3[j] += helper::rnear(t1[j]-t3[j]);
+                for (Size j=0; j<TexCoord::size(); ++j)
+                {
+                    t2[j] += helper::rnear(t1[j]-t2[j]);
+                    t3[j] += helper::rnear(t1[j]-t3[j]);
+                }
             }
+            m_slotTangents[i] = computeTangent(v1, v2, v3, t1, t2, t3);
         }
-        const Coord t = computeTangent(v1, v2, v3, t1, t2, t3);
-        const Coord b = computeBitangent(v1, v2, v3, t1, t2, t3);
-
-        tangents[triangles[i][0]] += t;
-        tangents[triangles[i][1]] += t;
-        tangents[triangles[i][2]] += t;
-        bitangents[triangles[i][0]] += b;
-        bitangents[triangles[i][1]] += b;
-        bitangents[triangles[i][2]] += b;
-    }
+    });
 
-    for (std::size_t i = 0; i < quads.size() ; i++)
+    forEachIndexRange(quads.size(), [&](const std::size_t begin, const std::size_t end)
     {
-        const Coord& v1 = vertices[quads[i][0]];
-        const Coord& v2 = vertices[quads[i][1]];
-        const Coord& v3 = vertices[quads[i][2]];
-        const Coord& v4 = vertices[quads[i][3]];
-        const TexCoord& t1 = texcoords[quads[i][0]];
-        const TexCoord& t2 = texcoords[quads[i][1]];
-        const TexCoord& t3 = texcoords[quads[i][2]];
-        const TexCoord& t4 = texcoords[quads[i][3]];
-
-        // Too many options how to split a quad into two triangles...
-        Coord t123 = computeTangent  (v1, v2, v3, t1, t2, t3);
-        Coord b123 = computeBitangent(v1, v2, v2, t1, t2, t3);
-
-        Coord t234 = computeTangent  (v2, v3, v4, t2, t3, t4);
-        Coord b234 = computeBitangent(v2, v3, v4, t2, t3, t4);
-
-        Coord t341 = computeTangent  (v3, v4, v1, t3, t4, t1);
-        Coord b341 = computeBitangent(v3, v4, v1, t3, t4, t1);
-
-        Coord t412 = computeTangent  (v4, v1, v2, t4, t1, t2);
-        Coord b412 = computeBitangent(v4, v1, v2, t4, t1, t2);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const Coord& v1 = vertices[quads[i][0]];
+            const Coord& v2 = vertices[quads[i][1]];
+            const Coord& v3 = vertices[quads[i][2]];
+            const Coord& v4 = vertices[quads[i][3]];
+            const TexCoord& t1 = texcoords[quads[i][0]];
+            const TexCoord& t2 = texcoords[quads[i][1]];
+            const TexCoord& t3 = texcoords[quads[i][2]];
+            const TexCoord& t4 = texcoords[quads[i][3]];
+
+            // Too many options how to split a quad into two triangles...
+            const Coord t123 = computeTangent(v1, v2, v3, t1, t2, t3);
+            const Coord t234 = computeTangent(v2, v3, v4, t2, t3, t4);
+            const Coord t341 = computeTangent(v3, v4, v1, t3, t4, t1);
+            const Coord t412 = computeTangent(v4, v1, v2, t4, t1, t2);
+
+            const std::size_t slot = nbTriangles + 4 * i;
+            m_slotTangents[slot    ] = t123        + t341 + t412;
+            m_slotTangents[slot + 1] = t123 + t234        + t412;
+            m_slotTangents[slot + 2] = t123 + t234 + t341;
+            m_slotTangents[slot + 3] =        t234 + t341 + t412;
+        }
+    });
 
-        tangents  [quads[i][0]] += t123        + t341 + t412;
-        bitangents[quads[i][0]] += b123        + b341 + b412;
-        tangents  [quads[i][1]] += t123 + t234        + t412;
-        bitangents[quads[i][1]] += b123 + b234        + b412;
-        tangents  [quads[i][2]] += t123 + t234 + t341;
-        bitangents[quads[i][2]] += b123 + b234 + b341;
-        tangents  [quads[i][3]] +=        t234 + t341 + t412;
-        bitangents[quads[i][3]] +=        b234 + b341 + b412;
-    }
-    for (std::size_t i = 0; i < vertices.size(); i++)
+    forEachIndexRange(vertices.size(), [&](const std::size_t begin, const std::size_t end)
     {
-        const Coord& n = normals[i];
-        Coord& t = tangents[i];
-        Coord& b = bitangents[i];
-
-        b = sofa::type::cross(n, t.normalized());
-        t = sofa::type::cross(b, n);
-    }
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Coord t;
+            for (auto k = m_vertexContributions.begin[i]; k < m_vertexContributions.begin[i + 1]; ++k)
+            {
+                t += m_slotTangents[m_vertexContributions.slots[k]];
+            }
 
+            const Coord& n = normals[i];
+            const Coord b = sofa::type::cross(n, t.normalized());
+            tangents[i] = sofa::type::cross(b, n);
+            bitangents[i] = b;
+        }
+    });
 }
 
 void VisualModelImpl::computeBBox(const core::ExecParams*, bool)
@@ -90,6 +90,7 @@ public:
     Data<bool> m_handleDynamicTopology; ///< True if topological changes should be handled
     Data<bool> m_fixMergedUVSeams; ///< True if UV seams should be handled even when duplicate UVs are merged
     Data<bool> m_keepLines; ///< keep and draw lines (false by default)
+    Data<bool> d_parallel; ///< Compute the normals and tangents in parallel
 
     Data< VecCoord > m_vertices2; ///< vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)
     core::topology::PointData< VecTexCoord > m_vtexcoords; ///< coordinates of the texture
@@ -404,6 +405,43 @@ protected:
 
     /// Internal buffer similar to @sa m_dirtyTriangles but to be used by topolgy Data @sa m_quads callback when points are removed.
     std::set< sofa::core::topology::BaseMeshTopology::QuadID> m_dirtyQuads;
+
+    /// Contributions of the faces to the normals or tangents, grouped by vertex so that each vertex gathers its
+    /// own contributions (without concurrent writes when computed in parallel). The contributions are indexed
+    /// by slots: one slot per triangle, followed by one slot per quad corner.
+    struct FaceContributions
+    {
+        /// the slots contributing to the vertex i are slots[begin[i]] to slots[begin[i+1]-1], in the order
+        /// of the faces
+        type::vector<visual_index_type> begin;
+        type::vector<visual_index_type> slots;
+
+        /// vertexTarget gives the index to which the contributions to each vertex go (the vertex itself if empty)
+        void build(const VecVisualTriangle& triangles, const VecVisualQuad& quads,
+                   const type::vector<visual_index_type>& vertexTarget, std::size_t nbTargets);
+    };
+
+    /// Rebuild the face contributions if the faces or the vertices changed. Returns true if they were rebuilt.
+    bool updateFaceContributions();
+
+    /// Call f(begin, end) on ranges of [0, size), in parallel if requested
+    template<class Function>
+    void forEachIndexRange(std::size_t size, const Function& f);
+
+    FaceContributions m_vertexContributions; ///< contributions to each vertex
+    FaceContributions m_normalContributions; ///< contributions to each normal index, if m_vertNormIdx is used
+    int m_facesCounter[3] {-1, -1, -1}; ///< counters of the triangles, quads and normal indices of the contributions
+    std::size_t m_contributionsNbVertices {0};
+
+    VecCoord m_slotNormals; ///< normal contributed by each slot
+    VecCoord m_slotTangents; ///< tangent contributed by each slot
+
+    /// Positions of the last computation of the normals: only the normals around the moved vertices are updated
+    VecCoord m_normalsPositions;
+    type::vector<char> m_movedVertices;
+    type::vector<char> m_dirtySlots;
+    VecDeriv m_indexedNormals; ///< normals by normal index, if m_vertNormIdx is used
+    int m_normalsCounter {-1}; ///< counter of the normals after their last computation
 };
 
 
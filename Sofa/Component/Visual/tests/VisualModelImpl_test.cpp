@@ -120,4 +120,88 @@ TEST( VisualModelImpl_test , checkThatMembersAreCorrectlyConstructed )
     ASSERT_EQ(1u, visualModel.xforms.size());
 }
 
+/// Normals accumulated face by face, as a reference
+component::visual::VisualModelImpl::VecDeriv referenceNormals(const component::visual::VisualModelImpl::VecCoord& x,
+                                                              const component::visual::VisualModelImpl::VecVisualTriangle& triangles,
+                                                              const component::visual::VisualModelImpl::VecVisualQuad& quads)
+{
+    component::visual::VisualModelImpl::VecDeriv normals(x.size());
+    for (const auto& t : triangles)
+    {
+        const auto n = cross(x[t[1]] - x[t[0]], x[t[2]] - x[t[0]]);
+        normals[t[0]] += n;
+        normals[t[1]] += n;
+        normals[t[2]] += n;
+    }
+    for (const auto& q : quads)
+    {
+        normals[q[0]] += cross(x[q[1]] - x[q[0]], x[q[3]] - x[q[0]]);
+        normals[q[1]] += cross(x[q[2]] - x[q[1]], x[q[0]] - x[q[1]]);
+        normals[q[2]] += cross(x[q[3]] - x[q[2]], x[q[1]] - x[q[2]]);
+        normals[q[3]] += cross(x[q[0]] - x[q[3]], x[q[2]] - x[q[3]]);
+    }
+    for (auto& n : normals)
+    {
+        n.normalize();
+    }
+    return normals;
+}
+
+TEST( VisualModelImpl_test , computeNormals )
+{
+    using VisualModelImpl = component::visual::VisualModelImpl;
+
+    for (const bool parallel : {false, true})
+    {
+        StubVisualModelImpl visualModel;
+        visualModel.d_parallel.setValue(parallel);
+
+        // a grid of 10x10 vertices, made of triangles on its first half and quads on the other one
+        constexpr unsigned int n = 10;
+        VisualModelImpl::VecCoord x;
+        for (unsigned int j = 0; j < n; ++j)
+            for (unsigned int i = 0; i < n; ++i)
+                x.emplace_back(i, j, 0.1 * ((i * 7 + j * 3) % 5));
+
+        VisualModelImpl::VecVisualTriangle triangles;
+        VisualModelImpl::VecVisualQuad quads;
+        for (unsigned int j = 0; j + 1 < n; ++j)
+        {
+            for (unsigned int i = 0; i + 1 < n; ++i)
+            {
+                const unsigned int v = j * n + i;
+                if (i < n / 2)
+                {
+                    triangles.push_back({v, v + 1, v + n + 1});
+                    triangles.push_back({v, v + n + 1, v + n});
+                }
+                else
+                {
+                    quads.push_back({v, v + 1, v + n + 1, v + n});
+                }
+            }
+        }
+
+        visualModel.setVertices(&x);
+        visualModel.setTriangles(&triangles);
+        visualModel.setQuads(&quads);
+
+        visualModel.computeNormals();
+        EXPECT_EQ(visualModel.getVnormals(), referenceNormals(x, triangles, quads));
+
+        // only the normals around the moved vertices are updated
+        x[12] += VisualModelImpl::Coord(0.2, -0.1, 0.5);
+        x[77] += VisualModelImpl::Coord(0.0, 0.3, -0.4);
+        visualModel.setVertices(&x);
+        visualModel.computeNormals();
+        EXPECT_EQ(visualModel.getVnormals(), referenceNormals(x, triangles, quads));
+
+        // a modification of the faces updates all the normals
+        std::swap(triangles[3][1], triangles[3][2]);
+        visualModel.setTriangles(&triangles);
+        visualModel.computeNormals();
+        EXPECT_EQ(visualModel.getVnormals(), referenceNormals(x, triangles, quads));
+    }
+}
+
 } //sofa
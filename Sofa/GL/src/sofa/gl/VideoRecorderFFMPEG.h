@@ -61,7 +61,12 @@ public:
 
     bool init(const std::string& ffmpeg_exec_filepath, const std::string& filename, int width, int height, unsigned int framerate, unsigned int bitrate, const std::string& codec="");
 
+    /// Read the current viewport and add it to the video
     void addFrame();
+
+    /// Add a frame read by the caller: RGBA pixels of the size given to init, rows from bottom to top.
+    /// OpenGL is not used: the frame can be added from another thread than the rendering one.
+    void addFrame(const unsigned char* viewportPixels);
     void saveVideo();
     void finishVideo();
 
@@ -26,6 +26,7 @@
 #include <sofa/simulation/Simulation.h>
 #include <sofa/simulation/UpdateContextVisitor.h>
 #include <sofa/simulation/Node.h>
+#include <sofa/simulation/SceneSnapshot.h>
 #include <sofa/helper/system/SetDirectory.h>
 #include <sofa/gui/common/ArgumentParser.h>
 
@@ -34,6 +35,7 @@
 #include <fstream>
 #include <string>
 #include <iomanip>
+#include <cmath>
 #include <sofa/gui/batch/ProgressBar.h>
 
 
@@ -59,9 +61,17 @@ int BatchGUI::mainLoop()
 {
     if (groot)
     {   
-        if (nbIter != -1)
+        // a restarted simulation stops at the end time of the original one
+        const signed int nbIterations = nbIter == -1 ? -1 : nbIter - m_nbRestoredIterations;
+        if (nbIter != -1 && nbIterations <= 0)
+        {
+            msg_info("BatchGUI") << "The " << nbIter << " iterations were already computed before the checkpoint." << msgendl;
+            return 0;
+        }
+
+        if (nbIterations != -1)
         {   
-            msg_info("BatchGUI") << "Computing " << nbIter << " iterations." << msgendl;
+            msg_info("BatchGUI") << "Computing " << nbIterations << " iterations." << msgendl;
         }
         else
         {
@@ -81,12 +91,12 @@ int BatchGUI::mainLoop()
         std::unique_ptr<ProgressBar> progressBar;
         if (!hideProgressBar)
         {
-            progressBar = std::make_unique<ProgressBar>(nbIter);
+            progressBar = std::make_unique<ProgressBar>(nbIterations);
         }
 
-        while (i <= nbIter || nbIter == -1)
+        while (i <= nbIterations || nbIterations == -1)
         {
-            if (i != nbIter)
+            if (i != nbIterations)
             {
                 AdvancedTimer::begin("Animate");
 
@@ -99,7 +109,7 @@ int BatchGUI::mainLoop()
                 }
             }
 
-            if ( i == nbIter || (nbIter == -1 && i%1000 == 0) )
+            if ( i == nbIterations || (nbIterations == -1 && i%1000 == 0) )
             {
                 t = sofa::helper::system::thread::CTime::getFastTime()-t;
                 rt = sofa::helper::system::thread::CTime::getRefTime()-rt;
@@ -107,7 +117,7 @@ int BatchGUI::mainLoop()
                 msg_info("BatchGUI") << i << " iterations done in " << ((double)t)/((double)tfreq) << " s ( " << (((double)tfreq)*i)/((double)t) << " FPS)." << msgendl;
                 msg_info("BatchGUI") << i << " iterations done in " << ((double)rt)/((double)rtfreq) << " s ( " << (((double)rtfreq)*i)/((double)rt) << " FPS)." << msgendl;
                 
-                if (nbIter == -1) // Additional message for infinite iterations
+                if (nbIterations == -1) // Additional message for infinite iterations
                 {
                      msg_info("BatchGUI") << "Press Ctrl + C (linux)/ Command + period (mac) to stop " << msgendl;
                 }
@@ -140,6 +150,39 @@ void BatchGUI::setScene(sofa::simulation::Node::SPtr groot, const char* filename
     this->filename = (filename?filename:"");
 
     resetScene();
+
+    if (!restartFilename.empty())
+    {
+        restart(restartFilename);
+    }
+}
+
+bool BatchGUI::restart(const std::string& checkpointFilename)
+{
+    m_nbRestoredIterations = 0;
+
+    sofa::simulation::Node* root = currentSimulation();
+    if (!root)
+    {
+        return false;
+    }
+
+    sofa::simulation::SceneSnapshot snapshot;
+    if (!snapshot.load(checkpointFilename) || !snapshot.restore(root))
+    {
+        msg_error("BatchGUI") << "Cannot restart from the checkpoint '" << checkpointFilename << "'";
+        return false;
+    }
+
+    // the scene is reset at time 0 before being restored
+    if (root->getDt() > 0)
+    {
+        m_nbRestoredIterations = static_cast<signed int>(std::lround(root->getTime() / root->getDt()));
+    }
+
+    msg_info("BatchGUI") << "Restarted from the checkpoint '" << checkpointFilename << "' at time " << root->getTime()
+                         << " (" << m_nbRestoredIterations << " iterations)" << msgendl;
+    return true;
 }
 
 
@@ -203,6 +246,11 @@ int BatchGUI::RegisterGUIParameters(ArgumentParser* argumentParser)
         "hideProgressBar",
         "if defined, hides the progress bar"
     );
+    argumentParser->addArgument(
+        cxxopts::value<std::string>(restartFilename),
+        "restart",
+        "(only batch) Checkpoint file to restart the simulation from (see the Checkpoint component)"
+    );
     return 0;
 }
 
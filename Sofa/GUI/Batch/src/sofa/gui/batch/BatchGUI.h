@@ -49,6 +49,10 @@ public:
 
     void resetScene();
 
+    /// Restore the scene from a checkpoint file (see SceneSnapshot). Returns false if it cannot be restored.
+    /// The iterations done before the checkpoint are deduced from its time, and not computed again by mainLoop.
+    bool restart(const std::string& checkpointFilename);
+
     int mainLoop() override;
     void redraw() override;
     int closeGUI() override;
@@ -81,9 +85,12 @@ protected:
 
     sofa::simulation::NodeSPtr groot;
     std::string filename;
+    /// Number of iterations done before the checkpoint the simulation restarted from
+    signed int m_nbRestoredIterations { 0 };
     static signed int nbIter;
     static std::string nbIterInp;
     inline static bool hideProgressBar { false };
+    inline static std::string restartFilename;
 
     /// Return true if the timer output string has a json string and the timer is setup to output json
     static bool canExportJson(const std::string& timerOutputStr, const std::string& timerId);
@@ -0,0 +1,124 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <sofa/gui/batch/BatchGUI.h>
+#include <sofa/simulation/DefaultAnimationLoop.h>
+#include <sofa/simulation/SceneSnapshot.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/Node.h>
+
+#include <filesystem>
+
+namespace sofa
+{
+
+using gui::batch::BatchGUI;
+using simulation::Node;
+
+/// Gives access to the command line options of the batch GUI
+class BatchGUITest : public BatchGUI
+{
+public:
+    ~BatchGUITest() override = default;
+
+    static void setOptions(signed int nbIterations, const std::string& checkpointFilename)
+    {
+        nbIter = nbIterations;
+        restartFilename = checkpointFilename;
+        hideProgressBar = true;
+    }
+};
+
+struct BatchGUI_test : public BaseTest
+{
+    Node::SPtr root;
+    std::string checkpointFilename;
+
+    void onSetUp() override
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+        root->setDt(0.01);
+        root->addObject(core::objectmodel::New<simulation::DefaultAnimationLoop>());
+        simulation::node::initRoot(root.get());
+
+        checkpointFilename = (std::filesystem::temp_directory_path() / "BatchGUI_test.snapshot").string();
+    }
+
+    void onTearDown() override
+    {
+        BatchGUITest::setOptions(BatchGUI::DEFAULT_NUMBER_OF_ITERATIONS, "");
+        std::filesystem::remove(checkpointFilename);
+        simulation::node::unload(root);
+    }
+
+    /// Animate the scene by the given number of steps, and save it in the checkpoint file
+    void saveCheckpoint(unsigned int nbSteps)
+    {
+        for (unsigned int i = 0; i < nbSteps; ++i)
+        {
+            simulation::node::animate(root.get());
+        }
+
+        simulation::SceneSnapshot snapshot;
+        snapshot.capture(root.get());
+        ASSERT_TRUE(snapshot.save(checkpointFilename));
+    }
+};
+
+TEST_F(BatchGUI_test, restartStopsAtTheOriginalEndTime)
+{
+    saveCheckpoint(3);
+
+    BatchGUITest::setOptions(10, checkpointFilename);
+    BatchGUITest gui;
+    gui.setScene(root);
+    EXPECT_NEAR(root->getTime(), 0.03, 1e-12);
+
+    gui.mainLoop();
+    EXPECT_NEAR(root->getTime(), 0.1, 1e-12);
+}
+
+TEST_F(BatchGUI_test, restartAfterTheOriginalEndTime)
+{
+    saveCheckpoint(3);
+
+    BatchGUITest::setOptions(2, checkpointFilename);
+    BatchGUITest gui;
+    gui.setScene(root);
+
+    gui.mainLoop();
+    EXPECT_NEAR(root->getTime(), 0.03, 1e-12);
+}
+
+TEST_F(BatchGUI_test, noRestart)
+{
+    BatchGUITest::setOptions(10, "");
+    BatchGUITest gui;
+    gui.setScene(root);
+
+    gui.mainLoop();
+    EXPECT_NEAR(root->getTime(), 0.1, 1e-12);
+}
+
+} // namespace sofa
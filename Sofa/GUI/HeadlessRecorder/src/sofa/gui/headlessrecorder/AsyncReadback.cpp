@@ -0,0 +1,126 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/gui/headlessrecorder/AsyncReadback.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+
+namespace sofa::gui::hrecorder
+{
+
+AsyncReadback::~AsyncReadback()
+{
+    release();
+}
+
+void AsyncReadback::init(int width, int height, std::size_t nbBuffers)
+{
+    release();
+
+    m_width = width;
+    m_height = height;
+    const auto bufferSize = static_cast<GLsizeiptr>(width) * static_cast<GLsizeiptr>(height) * 4;
+
+    m_buffers.resize(std::max<std::size_t>(nbBuffers, 1));
+    m_frameIndices.assign(m_buffers.size(), -1);
+    m_next = 0;
+
+    glGenBuffers(static_cast<GLsizei>(m_buffers.size()), m_buffers.data());
+    for (const GLuint buffer : m_buffers)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void AsyncReadback::release()
+{
+    if (!m_buffers.empty())
+    {
+        glDeleteBuffers(static_cast<GLsizei>(m_buffers.size()), m_buffers.data());
+        m_buffers.clear();
+        m_frameIndices.clear();
+    }
+}
+
+void AsyncReadback::read(int frameIndex, FrameEncoder& encoder)
+{
+    if (m_buffers.empty())
+    {
+        return;
+    }
+
+    if (m_frameIndices[m_next] >= 0)
+    {
+        complete(m_next, encoder);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[m_next]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    // with a pixel pack buffer bound, the last parameter is an offset in the buffer and the call does not wait for the transfer
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_frameIndices[m_next] = frameIndex;
+    m_next = (m_next + 1) % m_buffers.size();
+}
+
+void AsyncReadback::flush(FrameEncoder& encoder)
+{
+    // m_next is the oldest buffer
+    for (std::size_t i = 0; i < m_buffers.size(); ++i)
+    {
+        const std::size_t buffer = (m_next + i) % m_buffers.size();
+        if (m_frameIndices[buffer] >= 0)
+        {
+            complete(buffer, encoder);
+        }
+    }
+}
+
+void AsyncReadback::complete(std::size_t buffer, FrameEncoder& encoder)
+{
+    Frame frame = encoder.acquireFrame(m_width, m_height);
+    frame.index = m_frameIndices[buffer];
+    m_frameIndices[buffer] = -1;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[buffer]);
+    const auto* pixels = static_cast<const unsigned char*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    if (pixels)
+    {
+        std::copy(pixels, pixels + frame.pixels.size(), frame.pixels.begin());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!pixels)
+    {
+        msg_error("HeadlessRecorder") << "Could not map the pixel buffer of frame " << frame.index;
+        return;
+    }
+
+    // pushed once the buffer is unmapped: push blocks while the encoder queue is full
+    encoder.push(std::move(frame));
+}
+
+} // namespace sofa::gui::hrecorder
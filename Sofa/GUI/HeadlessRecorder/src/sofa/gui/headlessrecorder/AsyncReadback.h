@@ -0,0 +1,72 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/gui/headlessrecorder/config.h>
+#include <sofa/gui/headlessrecorder/FrameEncoder.h>
+#include <sofa/gl/gl.h>
+
+#include <vector>
+
+namespace sofa::gui::hrecorder
+{
+
+/**
+ * Reads the rendered frames back from the GPU without stalling the rendering thread.
+ *
+ * glReadPixels targets a ring of pixel buffer objects, so that it only starts the transfer
+ * and returns immediately. A buffer is mapped (and its frame handed to the encoder) only when
+ * it is needed again, nbBuffers frames later, by which time the transfer is done.
+ */
+class SOFA_GUI_HEADLESSRECORDER_API AsyncReadback
+{
+public:
+    AsyncReadback() = default;
+    ~AsyncReadback();
+
+    AsyncReadback(const AsyncReadback&) = delete;
+    AsyncReadback& operator=(const AsyncReadback&) = delete;
+
+    /// Allocate nbBuffers pixel buffers of width x height RGBA pixels. Requires a current OpenGL context.
+    void init(int width, int height, std::size_t nbBuffers = 3);
+
+    /// Delete the pixel buffers. Pending frames are lost: call flush before.
+    void release();
+
+    /// Start the transfer of the current read buffer. If all the pixel buffers are in use,
+    /// the oldest transfer is completed first and its frame is pushed to the encoder.
+    void read(int frameIndex, FrameEncoder& encoder);
+
+    /// Complete all the pending transfers and push their frames to the encoder, in order
+    void flush(FrameEncoder& encoder);
+
+private:
+    void complete(std::size_t buffer, FrameEncoder& encoder);
+
+    int m_width { 0 };
+    int m_height { 0 };
+    std::vector<GLuint> m_buffers;
+    std::vector<int> m_frameIndices; ///< frame being transferred in each buffer, -1 if none
+    std::size_t m_next { 0 };
+};
+
+} // namespace sofa::gui::hrecorder
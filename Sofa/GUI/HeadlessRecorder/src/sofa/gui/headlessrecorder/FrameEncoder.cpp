@@ -0,0 +1,120 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/gui/headlessrecorder/FrameEncoder.h>
+
+#include <algorithm>
+
+namespace sofa::gui::hrecorder
+{
+
+FrameEncoder::FrameEncoder(Writer writer, std::size_t maxQueuedFrames)
+    : m_writer(std::move(writer))
+    , m_maxQueuedFrames(std::max<std::size_t>(maxQueuedFrames, 1))
+    , m_thread(&FrameEncoder::run, this)
+{
+}
+
+FrameEncoder::~FrameEncoder()
+{
+    finish();
+}
+
+Frame FrameEncoder::acquireFrame(int width, int height)
+{
+    Frame frame;
+    frame.width = width;
+    frame.height = height;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_freeBuffers.empty())
+        {
+            frame.pixels = std::move(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+    }
+    frame.pixels.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+    return frame;
+}
+
+void FrameEncoder::push(Frame&& frame)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_frameWritten.wait(lock, [this] { return m_queue.size() < m_maxQueuedFrames || m_stop; });
+        if (m_stop)
+        {
+            return;
+        }
+        m_queue.push_back(std::move(frame));
+    }
+    m_frameQueued.notify_one();
+}
+
+void FrameEncoder::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_frameQueued.notify_one();
+    m_frameWritten.notify_all();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+std::size_t FrameEncoder::getNbWrittenFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbWrittenFrames;
+}
+
+void FrameEncoder::run()
+{
+    while (true)
+    {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frameQueued.wait(lock, [this] { return !m_queue.empty() || m_stop; });
+            if (m_queue.empty())
+            {
+                // stop requested and every queued frame has been written
+                return;
+            }
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        m_writer(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_nbWrittenFrames;
+            m_freeBuffers.push_back(std::move(frame.pixels));
+        }
+        m_frameWritten.notify_all();
+    }
+}
+
+} // namespace sofa::gui::hrecorder
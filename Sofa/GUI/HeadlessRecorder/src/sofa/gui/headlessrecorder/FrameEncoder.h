@@ -0,0 +1,93 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/gui/headlessrecorder/config.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sofa::gui::hrecorder
+{
+
+/// A rendered frame: RGBA pixels, 8 bits per channel, rows from bottom to top (OpenGL order)
+struct Frame
+{
+    int index { 0 };
+    int width { 0 };
+    int height { 0 };
+    std::vector<unsigned char> pixels;
+};
+
+/**
+ * Writes frames on a dedicated thread, so that the simulation does not wait for the encoding.
+ *
+ * Frames are queued by the rendering thread and handed in order to the writer function by the
+ * encoder thread. The queue is bounded: pushing a frame blocks while maxQueuedFrames frames are
+ * waiting, which keeps the memory bounded when the writer is slower than the simulation.
+ * The pixel buffers of the written frames are recycled by acquireFrame.
+ */
+class SOFA_GUI_HEADLESSRECORDER_API FrameEncoder
+{
+public:
+    using Writer = std::function<void(const Frame&)>;
+
+    explicit FrameEncoder(Writer writer, std::size_t maxQueuedFrames = 8);
+    ~FrameEncoder();
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    /// Get a frame to fill, reusing the pixel buffer of an already written frame if any
+    Frame acquireFrame(int width, int height);
+
+    /// Queue a frame to be written. Blocks while the queue is full.
+    void push(Frame&& frame);
+
+    /// Wait until all the queued frames are written, then stop the encoder thread
+    void finish();
+
+    std::size_t getNbWrittenFrames() const;
+
+private:
+    void run();
+
+    Writer m_writer;
+    std::size_t m_maxQueuedFrames;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_frameQueued;
+    std::condition_variable m_frameWritten;
+    std::deque<Frame> m_queue;
+    std::vector<std::vector<unsigned char> > m_freeBuffers;
+    std::size_t m_nbWrittenFrames { 0 };
+    bool m_stop { false };
+
+    std::thread m_thread;
+};
+
+} // namespace sofa::gui::hrecorder
@@ -34,6 +34,7 @@ using sofa::helper::system::SetDirectory;
 #include <sofa/component/visual/InteractiveCamera.h>
 #include <thread>
 #include <chrono>
+#include <fstream>
 
 namespace sofa::gui::hrecorder
 {
@@ -45,6 +46,8 @@ unsigned int HeadlessRecorder::fps = 60;
 std::string HeadlessRecorder::fileName = "tmp";
 bool HeadlessRecorder::saveAsVideo = false;
 bool HeadlessRecorder::saveAsScreenShot = false;
+std::string HeadlessRecorder::pictureFormat = "png";
+unsigned int HeadlessRecorder::nbReadbackBuffers = 3;
 bool HeadlessRecorder::recordUntilStopAnimate = false;
 
 std::string HeadlessRecorder::recordTypeRaw = "wallclocktime";
@@ -71,7 +74,7 @@ HeadlessRecorder::HeadlessRecorder()
     : groot(nullptr)
     , m_nFrames(0)
     , initTexturesDone(false)
-    , requestVideoRecorderInit(true)
+    , m_recordingFinished(false)
     , m_backgroundColor{0,0,0,0}
 {
     vparams = core::visual::VisualParams::defaultInstance();
@@ -83,6 +86,8 @@ HeadlessRecorder::HeadlessRecorder()
 
 HeadlessRecorder::~HeadlessRecorder()
 {
+    finishRecording();
+    m_readback.release();
     glDeleteFramebuffers(1, &fbo);
     glDeleteRenderbuffers(1, &rbo_color);
     glDeleteRenderbuffers(1, &rbo_depth);
@@ -116,6 +121,8 @@ int HeadlessRecorder::RegisterGUIParameters(common::ArgumentParser* argumentPars
 
     argumentParser->addArgument(cxxopts::value<bool>(saveAsScreenShot)->default_value("false")->implicit_value("true"),
                                 "picture", "enable picture mode (save as png)");
+    argumentParser->addArgument(cxxopts::value<std::string>(pictureFormat)->default_value("png"),
+                                "pictureformat", "(only HeadLessRecorder) format of the pictures: \"png\", or \"raw\" (RGBA pixels, 8 bits per channel, rows from bottom to top, no header)");
     argumentParser->addArgument(cxxopts::value<bool>(saveAsVideo)->default_value("false")->implicit_value("true"),
                                 "video", "enable video mode (save as avi, x264)");
     argumentParser->addArgument(cxxopts::value<std::string>(fileName)->default_value(ss.str()),
@@ -128,6 +135,8 @@ int HeadlessRecorder::RegisterGUIParameters(common::ArgumentParser* argumentPars
                                 "height", "(only HeadLessRecorder) video or picture height");
     argumentParser->addArgument(cxxopts::value<unsigned int>(fps)->default_value("60"),
                                 "fps", "(only HeadLessRecorder) define how many frame per second HeadlessRecorder will generate");
+    argumentParser->addArgument(cxxopts::value<unsigned int>(nbReadbackBuffers)->default_value("3"),
+                                "readbackbuffers", "(only HeadLessRecorder) number of frames read back from the GPU concurrently; 1 waits for each frame before simulating the next step");
     argumentParser->addArgument(cxxopts::value<bool>(recordUntilStopAnimate)->default_value("false")->implicit_value("true"),
                                 "recordUntilEndAnimate", "(only HeadLessRecorder) recording until the end of animation does not care how many seconds have been set");
     argumentParser->addArgument(cxxopts::value<std::string>(recordTypeRaw)->default_value("wallclocktime"),
@@ -369,6 +378,7 @@ int HeadlessRecorder::mainLoop()
             std::this_thread::sleep_for(std::chrono::seconds(10));
         }
     }
+    finishRecording();
     msg_info("HeadlessRecorder") << "Recording time: " << recordTimeInSeconds << " seconds at: " << fps << " fps.";
     return 0;
 }
@@ -604,25 +614,97 @@ void HeadlessRecorder::setViewerResolution(int width, int height)
 // -----------------------------------------------------------------
 void HeadlessRecorder::record()
 {
-    if (saveAsScreenShot)
+    if (!m_encoder)
+        initRecording();
+    if (m_recordingFinished)
+        return;
+
+    if (!saveAsScreenShot && !canRecord())
     {
-        std::stringstream ss;
-        ss << std::setw(8) << std::setfill('0') << m_nFrames;
+        finishRecording();
+        return;
+    }
 
-        std::string pngFilename = fileName + ss.str() + ".png" ;
-        m_screencapture.saveScreen(pngFilename, 0);
+    // only starts the transfer: the frame is written by the encoder thread a few frames later
+    m_readback.read(m_nFrames, *m_encoder);
+}
+
+void HeadlessRecorder::initRecording()
+{
+    FrameEncoder::Writer writer;
+    if (saveAsScreenShot)
+    {
+        if (pictureFormat != "raw" && !helper::io::Image::FactoryImage::getInstance()->hasKey(pictureFormat))
+        {
+            msg_error("HeadlessRecorder") << "Could not write " << pictureFormat << " image format (no support found)";
+            m_recordingFinished = true;
+            return;
+        }
+        writer = [this](const Frame& frame) { writePicture(frame); };
     }
-    else if (saveAsVideo)
+    else
     {
-        if (requestVideoRecorderInit)
-            initVideoRecorder();
-        if (canRecord()) {
-            //m_videorecorder->encodeFrame();
-            m_videorecorder.addFrame();
-        } else {
-            //m_videorecorder->stop();
-            m_videorecorder.finishVideo();
+        initVideoRecorder();
+        writer = [this](const Frame& frame) { m_videorecorder.addFrame(frame.pixels.data()); };
+    }
+
+    m_readback.init(s_width, s_height, nbReadbackBuffers);
+    m_encoder = std::make_unique<FrameEncoder>(std::move(writer));
+}
+
+void HeadlessRecorder::finishRecording()
+{
+    if (m_recordingFinished || !m_encoder)
+        return;
+    m_recordingFinished = true;
+
+    m_readback.flush(*m_encoder);
+    m_encoder->finish();
+    if (!saveAsScreenShot)
+        m_videorecorder.finishVideo();
+
+    msg_info("HeadlessRecorder") << m_encoder->getNbWrittenFrames() << " frames written.";
+}
+
+// Called by the encoder thread
+void HeadlessRecorder::writePicture(const Frame& frame) const
+{
+    std::stringstream ss;
+    ss << std::setw(8) << std::setfill('0') << frame.index;
+    const std::string pictureFilename = fileName + ss.str() + "." + pictureFormat;
+
+    if (pictureFormat == "raw")
+    {
+        std::ofstream file(pictureFilename, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(frame.pixels.data()), static_cast<std::streamsize>(frame.pixels.size()));
+        if (!file)
+        {
+            msg_error("HeadlessRecorder") << "Could not write " << pictureFilename;
         }
+        return;
+    }
+
+    std::unique_ptr<helper::io::Image> img(helper::io::Image::FactoryImage::getInstance()->createObject(pictureFormat, ""));
+    if (!img)
+    {
+        msg_error("HeadlessRecorder") << "Could not create a " << pictureFormat << " image";
+        return;
+    }
+
+    // same layout as the pictures saved by sofa::gl::Capture: RGB, rows from bottom to top
+    img->init(frame.width, frame.height, 1, 1, helper::io::Image::UNORM8, helper::io::Image::RGB);
+    unsigned char* rgb = img->getPixels();
+    const std::size_t nbPixels = static_cast<std::size_t>(frame.width) * static_cast<std::size_t>(frame.height);
+    for (std::size_t i = 0; i < nbPixels; ++i)
+    {
+        rgb[3 * i + 0] = frame.pixels[4 * i + 0];
+        rgb[3 * i + 1] = frame.pixels[4 * i + 1];
+        rgb[3 * i + 2] = frame.pixels[4 * i + 2];
+    }
+
+    if (!img->save(pictureFilename, 0))
+    {
+        msg_error("HeadlessRecorder") << "Unknown error while saving image to " << pictureFilename;
     }
 }
 
@@ -647,7 +729,6 @@ void HeadlessRecorder::initVideoRecorder()
     std::string codec = "yuv444p";
     m_videorecorder.init(ffmpeg_exec_path, videoFilename, s_width, s_height, fps, bitrate, codec);
     //m_videorecorder->start();
-    requestVideoRecorderInit = false;
 }
 
 void HeadlessRecorder::setBackgroundColor(const type::RGBAColor &color)
@@ -47,7 +47,8 @@
 #include <sofa/helper/system/SetDirectory.h>
 
 #include <sofa/gl/VideoRecorderFFMPEG.h>
-#include <sofa/gl/Capture.h>
+#include <sofa/gui/headlessrecorder/AsyncReadback.h>
+#include <sofa/gui/headlessrecorder/FrameEncoder.h>
 
 namespace sofa::gui::hrecorder
 {
@@ -98,6 +99,9 @@ private:
     void calcProjection();
 
     void initVideoRecorder();
+    void initRecording();
+    void finishRecording();
+    void writePicture(const Frame& frame) const;
 
     VisualParams* vparams;
     DrawToolGL   drawTool;
@@ -113,8 +117,11 @@ private:
     GLuint rbo_color{}, rbo_depth{};
     double lastProjectionMatrix[16]{};
     bool initTexturesDone;
-    bool requestVideoRecorderInit;
-    sofa::gl::Capture m_screencapture;
+    bool m_recordingFinished;
+
+    /// frames are read back asynchronously, then written by the encoder thread
+    AsyncReadback m_readback;
+    std::unique_ptr<FrameEncoder> m_encoder;
     type::RGBAColor m_backgroundColor;
 
 
@@ -123,6 +130,8 @@ private:
     static unsigned int fps;
     static std::string fileName;
     static bool saveAsScreenShot, saveAsVideo;
+    static std::string pictureFormat;
+    static unsigned int nbReadbackBuffers;
     static HeadlessRecorder instance;
     static std::string recordTypeRaw;
     static RecordMode recordType;
@@ -0,0 +1,157 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/gui/headlessrecorder/FrameEncoder.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+
+using sofa::gui::hrecorder::Frame;
+using sofa::gui::hrecorder::FrameEncoder;
+
+/// Wait until the condition is true, at most a few seconds. Returns the condition.
+template<class Condition>
+bool waitFor(const Condition& condition)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+TEST(FrameEncoder, framesAreWrittenInOrder)
+{
+    std::vector<int> writtenIndices;
+    FrameEncoder encoder([&writtenIndices](const Frame& frame)
+    {
+        writtenIndices.push_back(frame.index);
+    });
+
+    for (int i = 0; i < 50; ++i)
+    {
+        Frame frame = encoder.acquireFrame(4, 2);
+        frame.index = i;
+        encoder.push(std::move(frame));
+    }
+    encoder.finish();
+
+    ASSERT_EQ(writtenIndices.size(), 50);
+    for (int i = 0; i < 50; ++i)
+    {
+        EXPECT_EQ(writtenIndices[i], i);
+    }
+}
+
+TEST(FrameEncoder, finishDrainsThePendingFrames)
+{
+    std::size_t nbWritten = 0;
+    FrameEncoder encoder([&nbWritten](const Frame&)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ++nbWritten;
+    }, 16);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        Frame frame = encoder.acquireFrame(4, 2);
+        frame.index = i;
+        encoder.push(std::move(frame));
+    }
+
+    // the frames still queued are written before the encoder thread stops
+    encoder.finish();
+    EXPECT_EQ(nbWritten, 10u);
+    EXPECT_EQ(encoder.getNbWrittenFrames(), 10u);
+
+    // the frames pushed after finish are dropped
+    encoder.push(encoder.acquireFrame(4, 2));
+    EXPECT_EQ(encoder.getNbWrittenFrames(), 10u);
+}
+
+TEST(FrameEncoder, pushBlocksWhileTheQueueIsFull)
+{
+    std::atomic<bool> writerBlocked { true };
+    FrameEncoder encoder([&writerBlocked](const Frame&)
+    {
+        while (writerBlocked)
+        {
+            std::this_thread::yield();
+        }
+    }, 2);
+
+    std::atomic<int> nbPushed { 0 };
+    std::thread producer([&encoder, &nbPushed]()
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            Frame frame = encoder.acquireFrame(4, 2);
+            frame.index = i;
+            encoder.push(std::move(frame));
+            ++nbPushed;
+        }
+    });
+
+    // one frame is being written and two are queued: the next push waits
+    ASSERT_TRUE(waitFor([&nbPushed] { return nbPushed == 3; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(nbPushed, 3);
+
+    writerBlocked = false;
+    producer.join();
+    encoder.finish();
+    EXPECT_EQ(nbPushed, 6);
+    EXPECT_EQ(encoder.getNbWrittenFrames(), 6u);
+}
+
+TEST(FrameEncoder, pixelBuffersAreRecycled)
+{
+    std::atomic<const unsigned char*> writtenPixels { nullptr };
+    FrameEncoder encoder([&writtenPixels](const Frame& frame)
+    {
+        writtenPixels = frame.pixels.data();
+    });
+
+    Frame frame = encoder.acquireFrame(8, 4);
+    EXPECT_EQ(frame.pixels.size(), 8u * 4u * 4u);
+    encoder.push(std::move(frame));
+    ASSERT_TRUE(waitFor([&encoder] { return encoder.getNbWrittenFrames() == 1; }));
+
+    // the buffer of the written frame is reused by the next frame
+    const Frame nextFrame = encoder.acquireFrame(8, 4);
+    EXPECT_EQ(nextFrame.pixels.data(), writtenPixels.load());
+    EXPECT_EQ(nextFrame.pixels.size(), 8u * 4u * 4u);
+
+    // no buffer is available any more
+    const Frame otherFrame = encoder.acquireFrame(8, 4);
+    EXPECT_NE(otherFrame.pixels.data(), writtenPixels.load());
+}
+
+} // namespace
@@ -34,11 +34,24 @@ ObjectFactory::~ObjectFactory()
 {
 }
 
+ObjectFactory::ClassEntry::SPtr ObjectFactory::findEntry(const std::string& classname) const
+{
+    const auto it = m_entryIndex.find(classname);
+    return it != m_entryIndex.end() ? it->second : nullptr;
+}
+
+void ObjectFactory::setEntry(const std::string& name, ClassEntry::SPtr entry)
+{
+    registry[name] = entry;
+    m_entryIndex[name] = entry;
+}
+
 ObjectFactory::ClassEntry& ObjectFactory::getEntry(std::string classname)
 {
     if (registry.find(classname) == registry.end()) {
-        registry[classname] = ClassEntry::SPtr(new ClassEntry);
-        registry[classname]->className = classname;
+        const ClassEntry::SPtr entry(new ClassEntry);
+        entry->className = classname;
+        setEntry(classname, entry);
     }
 
     return *registry[classname];
@@ -47,21 +60,17 @@ ObjectFactory::ClassEntry& ObjectFactory::getEntry(std::string classname)
 /// Test if a creator exists for a given classname
 bool ObjectFactory::hasCreator(std::string classname)
 {
-    const ClassEntryMap::iterator it = registry.find(classname);
-    if (it == registry.end())
-        return false;
-    const ClassEntry::SPtr entry = it->second;
-    return (!entry->creatorMap.empty());
+    const ClassEntry::SPtr entry = findEntry(classname);
+    return entry && !entry->creatorMap.empty();
 }
 
 std::string ObjectFactory::shortName(std::string classname)
 {
     std::string shortname;
 
-    const ClassEntryMap::iterator it = registry.find(classname);
-    if (it != registry.end())
+    const ClassEntry::SPtr entry = findEntry(classname);
+    if (entry)
     {
-        const ClassEntry::SPtr entry = it->second;
         if(!entry->creatorMap.empty())
         {
             const CreatorMap::iterator myit = entry->creatorMap.begin();
@@ -83,8 +92,8 @@ bool ObjectFactory::addAlias(std::string name, std::string target, bool force,
         return false;
     }
 
-    const ClassEntry::SPtr& pointedEntry = it->second;
-    ClassEntry::SPtr& aliasEntry = registry[name];
+    const ClassEntry::SPtr pointedEntry = it->second;
+    const ClassEntry::SPtr aliasEntry = findEntry(name);
 
     // Check that the alias does not already exist, unless 'force' is true
     if (aliasEntry.get()!=nullptr && !force)
@@ -94,18 +103,17 @@ bool ObjectFactory::addAlias(std::string name, std::string target, bool force,
     }
 
     if (previous) {
-        const ClassEntry::SPtr& entry = aliasEntry;
-        *previous = entry;
+        *previous = aliasEntry;
     }
 
-    registry[name] = pointedEntry;
+    setEntry(name, pointedEntry);
     pointedEntry->aliases.insert(name);
     return true;
 }
 
 void ObjectFactory::resetAlias(std::string name, ClassEntry::SPtr previous)
 {
-    registry[name] = previous;
+    setEntry(name, previous);
 }
 
 
@@ -166,10 +174,9 @@ objectmodel::BaseObject::SPtr ObjectFactory::createObject(objectmodel::BaseConte
     arg->clearErrors();
 
     // For every classes in the registery
-    ClassEntryMap::iterator it = registry.find(classname);
-    if (it != registry.end()) // Found the classname
+    entry = findEntry(classname);
+    if (entry) // Found the classname
     {
-        entry = it->second;
         // If no template has been given or if the template does not exist, first try with the default one
         if(templatename.empty() || entry->creatorMap.find(templatename) == entry->creatorMap.end())
             templatename = entry->defaultTemplate;
@@ -217,7 +224,7 @@ objectmodel::BaseObject::SPtr ObjectFactory::createObject(objectmodel::BaseConte
         using sofa::helper::lifecycle::ComponentChange;
         using sofa::helper::lifecycle::uncreatableComponents;
         using sofa::helper::lifecycle::movedComponents;
-        if(it == registry.end())
+        if(!entry)
         {
             arg->logError("The object '" + classname + "' is not in the factory.");
             auto uuncreatableComponent = uncreatableComponents.find(classname);
@@ -341,17 +348,87 @@ objectmodel::BaseObject::SPtr ObjectFactory::createObject(objectmodel::BaseConte
         msg_warning(object.get()) << w;
     }
 
+    processCreatedObject(object.get(), *entry, arg);
+
+    /// We managed to create an object but there is error message in the log. Thus we emit them
+    /// as warning to this object.
+    if(!deprecatedTemplates.empty())
+    {
+        msg_deprecated(object.get()) << sofa::helper::join(deprecatedTemplates, msgendl) ;
+    }
+
+    return object;
+}
+
+std::vector<objectmodel::BaseObject::SPtr> ObjectFactory::createObjects(objectmodel::BaseContext* context, std::vector<objectmodel::BaseObjectDescription>& args)
+{
+    std::vector<objectmodel::BaseObject::SPtr> objects;
+    objects.reserve(args.size());
+    if (args.empty())
+    {
+        return objects;
+    }
+
+    objects.push_back(createObject(context, &args.front()));
+
+    // The creator which created the first object is used for all the following ones of the same type and template.
+    // canCreate does not check the template attribute: it accepts the descriptions with another template.
+    const std::string type = args.front().getAttribute("type", "");
+    const std::string templateName = args.front().getAttribute("template", "");
+    ClassEntry::SPtr entry;
+    Creator::SPtr creator;
+    if (objects.front())
+    {
+        std::string classname = type;
+        const auto renamedComponent = sofa::helper::lifecycle::renamedComponents.find(classname);
+        if (renamedComponent != sofa::helper::lifecycle::renamedComponents.end())
+        {
+            classname = renamedComponent->second.getNewName();
+        }
+        entry = findEntry(classname);
+        if (entry)
+        {
+            const auto it = entry->creatorMap.find(objects.front()->getTemplateName());
+            if (it != entry->creatorMap.end())
+            {
+                creator = it->second;
+            }
+        }
+    }
+
+    for (std::size_t i = 1; i < args.size(); ++i)
+    {
+        objectmodel::BaseObjectDescription* arg = &args[i];
+        if (creator && arg->getAttribute("type", "") == type && arg->getAttribute("template", "") == templateName
+            && creator->canCreate(context, arg))
+        {
+            objectmodel::BaseObject::SPtr object = creator->createInstance(context, arg);
+            processCreatedObject(object.get(), *entry, arg);
+            objects.push_back(object);
+        }
+        else
+        {
+            arg->clearErrors();
+            objects.push_back(createObject(context, arg));
+        }
+    }
+
+    return objects;
+}
+
+void ObjectFactory::processCreatedObject(objectmodel::BaseObject* object, ClassEntry& entry, objectmodel::BaseObjectDescription* arg)
+{
     ////////////////////////// This code is emitting a warning messages if the scene is loaded
     if( m_callbackOnCreate )
-        m_callbackOnCreate(object.get(), arg);
+        m_callbackOnCreate(object, arg);
 
     ///////////////////////// All this code is just there to implement the MakeDataAlias component.
     std::vector<std::string> todelete;
-    for(auto& kv : entry->m_dataAlias)
+    for(auto& kv : entry.m_dataAlias)
     {
         if(object->findData(kv.first)==nullptr)
         {
-            msg_warning(object.get()) << "The object '"<< (object->getClassName()) <<"' does not have an alias named '"<< kv.first <<"'.  "
+            msg_warning(object) << "The object '"<< (object->getClassName()) <<"' does not have an alias named '"<< kv.first <<"'.  "
                                       << "To remove this error message you need to use a valid data name for the 'dataname field'. ";
 
             todelete.push_back(kv.first);
@@ -360,10 +437,10 @@ objectmodel::BaseObject::SPtr ObjectFactory::createObject(objectmodel::BaseConte
 
     for(auto& todeletename : todelete)
     {
-        entry->m_dataAlias.erase( entry->m_dataAlias.find(todeletename) ) ;
+        entry.m_dataAlias.erase( entry.m_dataAlias.find(todeletename) ) ;
     }
 
-    for(auto& kv : entry->m_dataAlias)
+    for(auto& kv : entry.m_dataAlias)
     {
         objectmodel::BaseObjectDescription newdesc;
         for(std::string& alias : kv.second){
@@ -377,15 +454,6 @@ objectmodel::BaseObject::SPtr ObjectFactory::createObject(objectmodel::BaseConte
         }
         object->parse(&newdesc);
     }
-
-    /// We managed to create an object but there is error message in the log. Thus we emit them
-    /// as warning to this object.
-    if(!deprecatedTemplates.empty())
-    {
-        msg_deprecated(object.get()) << sofa::helper::join(deprecatedTemplates, msgendl) ;
-    }
-
-    return object;
 }
 
 ObjectFactory* ObjectFactory::getInstance()
@@ -24,6 +24,7 @@
 #include <sofa/core/objectmodel/BaseObject.h>
 #include <sofa/core/objectmodel/BaseClassNameHelper.h>
 #include <numeric>
+#include <unordered_map>
 #include <sofa/helper/Utils.h>
 #include <sofa/url.h>
 
@@ -99,8 +100,19 @@ public:
 protected:
     /// Main class registry
     ClassEntryMap registry;
+    /// Hashed index of the registry, used for the lookups done at each object creation
+    std::unordered_map<std::string, ClassEntry::SPtr> m_entryIndex;
     OnCreateCallback m_callbackOnCreate ;
 
+    /// Find the entry registered for a class name (or alias), nullptr if there is none
+    ClassEntry::SPtr findEntry(const std::string& classname) const;
+
+    /// Set the entry registered for a name, in the registry and in its index
+    void setEntry(const std::string& name, ClassEntry::SPtr entry);
+
+    /// Finalize an object created from the given entry: creation callback and Data aliases
+    void processCreatedObject(objectmodel::BaseObject* object, ClassEntry& entry, objectmodel::BaseObjectDescription* arg);
+
 public:
 
     ~ObjectFactory();
@@ -150,6 +162,13 @@ public:
     /// Create an object given a context and a description.
     objectmodel::BaseObject::SPtr createObject(objectmodel::BaseContext* context, objectmodel::BaseObjectDescription* arg);
 
+    /// Create several objects of the same type and template in a context.
+    ///
+    /// The class and its template are resolved, and the creator is selected, only for the first description: the
+    /// following ones with the same type and template attributes reuse this creator as long as it accepts them. The returned vector contains one object per
+    /// description, nullptr for the ones which could not be created (their errors are logged in the description).
+    std::vector<objectmodel::BaseObject::SPtr> createObjects(objectmodel::BaseContext* context, std::vector<objectmodel::BaseObjectDescription>& args);
+
     /// Get the ObjectFactory singleton instance
     static ObjectFactory* getInstance();
 
@@ -76,6 +76,14 @@ public:
     /// Solve the system as constructed using the previous methods
     virtual void solveSystem() = 0;
 
+    /// Set the tolerance on the relative residual |b - Ax| / |b| for the next call to solveSystem only.
+    /// It is used by inexact Newton methods to adapt the accuracy of each linear solve.
+    /// Returns false if the solver does not support it (e.g. direct solvers): the system is then solved as usual.
+    virtual bool setNextRelativeTolerance(SReal /*tolerance*/) { return false; }
+
+    /// Number of iterations performed during the last call to solveSystem (0 for direct solvers)
+    virtual unsigned int getNbIterations() const { return 0; }
+
     ///
     virtual void init_partial_solve() { msg_warning() << "partial_solve is not implemented yet."; }
 
@@ -93,6 +93,9 @@ public:
 
     void reinit() override;
 
+    /// The loading only fills the outputs of the loader
+    bool isInitThreadSafe() const override { return true; }
+
     virtual bool load() final;
 
     /// Apply Homogeneous transformation to the positions
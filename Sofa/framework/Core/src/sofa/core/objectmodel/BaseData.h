@@ -259,6 +259,15 @@ public:
     bool copyValueFrom(const BaseData* data);
     bool updateValueFromLink(const BaseData* data);
 
+    /// Share the memory of the value of another %Data of the same type, instead of holding an identical copy.
+    ///
+    /// Only possible for the types stored with copy-on-write: the memory is duplicated when one of the %Data is
+    /// modified. As the value is considered unchanged, the counter and the outputs are not updated: the two values
+    /// must already be equal. The previous value is released: no reference to it must be kept (e.g. by an
+    /// initialized component).
+    /// @return true if the memory is shared.
+    bool shareValueFrom(const BaseData* data) { return doShareValueFrom(data); }
+
     /// Help message
     std::string help {""};
     /// Owner class
@@ -306,6 +315,7 @@ private:
 
     virtual bool doCopyValueFrom(const BaseData* parent) = 0;
     virtual bool doSetValueFromLink(const BaseData* parent) = 0;
+    virtual bool doShareValueFrom(const BaseData* /*data*/) { return false; }
 
     virtual bool doIsExactSameDataType(const BaseData* parent) = 0;
     virtual const void* doGetValueVoidPtr() const = 0;
@@ -24,6 +24,7 @@
 #include <sofa/core/objectmodel/BaseNode.h>
 #include <sofa/core/objectmodel/Event.h>
 #include <sofa/core/objectmodel/KeypressedEvent.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 #include <sofa/core/topology/Topology.h>
 #include <sofa/helper/TagFactory.h>
 #include <iostream>
@@ -56,6 +57,8 @@ BaseObject::BaseObject()
 
 BaseObject::~BaseObject()
 {
+    delete m_performanceCounters.load(std::memory_order_acquire);
+
     assert(l_master.get() == nullptr); // an object that is still a slave should not be able to be deleted, as at least one smart pointer points to it
     for(auto& slave : l_slaves)
     {
@@ -382,6 +385,25 @@ std::string BaseObject::getPathName() const {
     return result;
 }
 
+PerformanceCounters& BaseObject::getPerformanceCounters()
+{
+    PerformanceCounters* counters = m_performanceCounters.load(std::memory_order_acquire);
+    if (counters == nullptr)
+    {
+        // the counters may be used for the first time from several threads: only one allocation is kept
+        auto* newCounters = new PerformanceCounters(this);
+        if (m_performanceCounters.compare_exchange_strong(counters, newCounters, std::memory_order_acq_rel))
+        {
+            counters = newCounters;
+        }
+        else
+        {
+            delete newCounters;
+        }
+    }
+    return *counters;
+}
+
 } // namespace objectmodel
 
 } // namespace core
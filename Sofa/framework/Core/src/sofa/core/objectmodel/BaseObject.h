@@ -24,10 +24,14 @@
 #include <sofa/core/objectmodel/BaseContext.h>
 #include <sofa/core/DataTracker.h>
 #include <sofa/core/fwd.h>
+#include <memory>
+#include <atomic>
 
 namespace sofa::core::objectmodel
 {
 
+class PerformanceCounters;
+
 /**
  *  \brief Base class for simulation components.
  *
@@ -80,6 +84,11 @@ public:
     /// Initialization method called at graph creation and modification, during bottom-up traversal.
     virtual void bwdInit();
 
+    /// Return true if init() and bwdInit() can run concurrently with the initialization of other components,
+    /// i.e. if they only modify this object and read its inputs. It allows the parallel initialization of a
+    /// scene (see InitTaskGraph) to run them in parallel, otherwise they are run one at a time.
+    virtual bool isInitThreadSafe() const { return false; }
+
     /// Update method called when variables used in precomputation are modified.
     virtual void reinit();
 
@@ -174,6 +183,18 @@ public:
     /// Return the full path name of this object
     virtual std::string getPathName() const override;
 
+    /// @name performance
+    ///   Counters of the calls made on this object by the mechanical visitors (see PerformanceCounters)
+    /// @{
+
+    /// Counters of this object, created on first use. It can be called concurrently.
+    PerformanceCounters& getPerformanceCounters();
+
+    /// Counters of this object, nullptr if they were never used
+    const PerformanceCounters* findPerformanceCounters() const { return m_performanceCounters.load(std::memory_order_acquire); }
+
+    /// @}
+
     /// @name internalupdate
     ///   Methods related to tracking of data and the internal update
     /// @{
@@ -181,6 +202,9 @@ private:
     /// Tracker for all component Data linked to internal variables
     sofa::core::DataTracker m_internalDataTracker;
 
+    /// Only the measured objects allocate their counters
+    std::atomic<PerformanceCounters*> m_performanceCounters { nullptr };
+
 protected:
     /// Method called to add the Data to the DataTracker (listing the Data to track)
     void trackInternalData(const BaseData &data);
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <chrono>
 #include <sofa/core/objectmodel/DDGNode.h>
 #include <sofa/helper/BackTrace.h>
 namespace sofa::core::objectmodel
@@ -46,20 +47,16 @@ DDGNode::~DDGNode()
 
 void DDGNode::setDirtyValue()
 {
-    bool& dirtyValue = dirtyFlags.dirtyValue;
-    if (!dirtyValue)
+    if (!dirtyFlags.dirtyValue.exchange(true))
     {
-        dirtyValue = true;
         setDirtyOutputs();
     }
 }
 
 void DDGNode::setDirtyOutputs()
 {
-    bool& dirtyOutputs = dirtyFlags.dirtyOutputs;
-    if (!dirtyOutputs)
+    if (!dirtyFlags.dirtyOutputs.exchange(true))
     {
-        dirtyOutputs = true;
         for(DDGLinkIterator it=outputs.begin(), itend=outputs.end(); it != itend; ++it)
         {
             (*it)->setDirtyValue();
@@ -69,10 +66,8 @@ void DDGNode::setDirtyOutputs()
 
 void DDGNode::cleanDirty()
 {
-    bool& dirtyValue = dirtyFlags.dirtyValue;
-    if (dirtyValue)
+    if (dirtyFlags.dirtyValue.exchange(false))
     {
-        dirtyValue = false;
         cleanDirtyOutputsOfInputs();
     }
 }
@@ -86,7 +81,7 @@ void DDGNode::notifyEndEdit()
 void DDGNode::cleanDirtyOutputsOfInputs()
 {
     for(const auto it : inputs)
-        it->dirtyFlags.dirtyOutputs = false;
+        it->dirtyFlags.dirtyOutputs.store(false);
 }
 
 void DDGNode::addInput(DDGNode* n)
@@ -144,10 +139,55 @@ const DDGNode::DDGLinkContainer& DDGNode::getOutputs()
 
 void DDGNode::updateIfDirty() const
 {
+    const std::thread::id currentThread = std::this_thread::get_id();
+
+    /// update() cleans the node before it writes its value: a clean node is only up to date when
+    /// no other thread is updating it. The dirty flag is read first, as the updating thread is set
+    /// before the node is cleaned.
+    const bool dirty = isDirty();
+    const std::thread::id updatingThread = m_updatingThread.load(std::memory_order_acquire);
+
+    if (updatingThread == currentThread)
+    {
+        /// re-entrant call, from the update of this node
+        if (dirty)
+        {
+            const_cast <DDGNode*> (this)->update();
+        }
+        return;
+    }
+
+    if (!dirty && updatingThread == std::thread::id())
+        return;
+
+    /// wait for the update running in another thread, if any: the CAS is only attempted once the
+    /// node looks free, and the waiting thread first yields, then sleeps, as an update can be long
+    unsigned int nbWaits = 0;
+    const auto wait = [&nbWaits]()
+    {
+        if (++nbWaits < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    };
+
+    std::thread::id noThread;
+    while (!m_updatingThread.compare_exchange_weak(noThread, currentThread, std::memory_order_acquire))
+    {
+        do
+        {
+            wait();
+        } while (m_updatingThread.load(std::memory_order_relaxed) != std::thread::id());
+        noThread = std::thread::id();
+    }
+
+    /// another thread may have updated the node while waiting
     if (isDirty())
     {
         const_cast <DDGNode*> (this)->update();
     }
+
+    m_updatingThread.store(std::thread::id(), std::memory_order_release);
 }
 
 void DDGNode::doAddInput(DDGNode* n)
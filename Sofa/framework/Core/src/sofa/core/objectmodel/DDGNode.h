@@ -24,6 +24,8 @@
 #include <sofa/core/config.h>
 #include <sofa/core/fwd.h>
 #include <vector>
+#include <atomic>
+#include <thread>
 
 namespace sofa::core::objectmodel
 {
@@ -35,6 +37,10 @@ class DDGNode;
  * The data dependency graph is used to update the data when
  * some of other changes and it is at the root of the implementation
  * of the data update mecanisme as well as DataEngines.
+ *
+ * Dirty flags are atomic and concurrent calls to updateIfDirty() are serialized,
+ * so that a node can be read from several threads. Modifying a node and its
+ * graph remains reserved to one thread at a time.
  */
 class SOFA_CORE_API DDGNode
 {
@@ -70,7 +76,7 @@ public:
     virtual void update() = 0;
 
     /// Returns true if the DDGNode needs to be updated
-    bool isDirty() const { return dirtyFlags.dirtyValue; }
+    bool isDirty() const { return dirtyFlags.dirtyValue.load(std::memory_order_acquire); }
 
     /// Indicate the value needs to be updated
     virtual void setDirtyValue();
@@ -85,6 +91,7 @@ public:
     virtual void notifyEndEdit();
 
     /// Utility method to call update if necessary. This method should be called before reading of writing the value of this node.
+    /// It can be called concurrently: only one thread updates the node, the others wait for the update to be done.
     void updateIfDirty() const;
 
 protected:
@@ -103,10 +110,13 @@ private:
 
     struct DirtyFlags
     {
-        bool dirtyValue {false};
-        bool dirtyOutputs {false};
+        std::atomic<bool> dirtyValue {false};
+        std::atomic<bool> dirtyOutputs {false};
     };
     DirtyFlags dirtyFlags;
+
+    /// Thread currently running update() from updateIfDirty(), if any
+    mutable std::atomic<std::thread::id> m_updatingThread;
 };
 
 } // namespace sofa::core::objectmodel
@@ -24,6 +24,7 @@
 #include <sofa/core/config.h>
 #include <sofa/core/objectmodel/BaseData.h>
 #include <sofa/helper/StringUtils.h>
+#include <sofa/helper/NumberParser.h>
 #include <sofa/helper/accessor.h>
 #include <istream>
 #include <sofa/core/objectmodel/DataContentValue.h>
@@ -32,6 +33,44 @@ namespace sofa
 namespace core::objectmodel
 {
 
+namespace details
+{
+
+/// Vectors of numbers, or of Vec of numbers, which values can be read without streams (see Data::read)
+template<class T>
+struct NumberSequence
+{
+    static constexpr bool isNumberSequence = false;
+};
+
+template<class TReal>
+struct NumberSequence<sofa::type::vector<TReal>>
+{
+    using Real = TReal;
+    static constexpr std::size_t itemSize = 1;
+    static constexpr bool isNumberSequence = helper::isParsableNumber<TReal>;
+
+    static void set(TReal& item, const Real* values) { item = values[0]; }
+};
+
+template<sofa::Size N, class TReal>
+struct NumberSequence<sofa::type::vector<sofa::type::Vec<N, TReal>>>
+{
+    using Real = TReal;
+    static constexpr std::size_t itemSize = N;
+    static constexpr bool isNumberSequence = helper::isParsableNumber<TReal>;
+
+    static void set(sofa::type::Vec<N, TReal>& item, const Real* values)
+    {
+        for (sofa::Size i = 0; i < N; ++i)
+        {
+            item[i] = values[i];
+        }
+    }
+};
+
+} // namespace details
+
 /** \brief Container that holds a variable for a component.
  *
  * This is a fundamental class template in Sofa.  Data are used to encapsulated
@@ -162,9 +201,7 @@ public:
     /// regardless of the current status of this value: no dirtiness check
     virtual T* beginWriteOnly()
     {
-        m_counter++;
-        m_isSet=true;
-        BaseData::setDirtyOutputs();
+        setEdited();
         return m_value.beginEdit();
     }
 
@@ -177,7 +214,17 @@ public:
     /// @warning writeOnly (the Data is not updated before being set)
     void setValue(const T& value)
     {
-        *beginWriteOnly()=value;
+        setEdited();
+        m_value.setValue(value);
+        endEdit();
+    }
+
+    /// @warning writeOnly (the Data is not updated before being set)
+    /// The given value is moved into the Data: nothing is copied, even if the previous value was shared.
+    void setValue(T&& value)
+    {
+        setEdited();
+        m_value.setValue(std::move(value));
         endEdit();
     }
 
@@ -225,12 +272,25 @@ protected:
 
     std::istream& readValue(std::istream& in);
 
+    /// Mark the value as modified, before it is changed
+    void setEdited()
+    {
+        m_counter++;
+        m_isSet=true;
+        BaseData::setDirtyOutputs();
+    }
+
+    /// Read a vector of numbers given as a plain sequence of numbers, without stream. Returns false, leaving the
+    /// value unchanged, if the string contains anything else.
+    bool readNumberSequence(const std::string& s);
+
 private:
 
 
     bool doIsExactSameDataType(const BaseData* parent) override;
     bool doCopyValueFrom(const BaseData* parent) override;
     bool doSetValueFromLink(const BaseData* parent) override;
+    bool doShareValueFrom(const BaseData* data) override;
     const void* doGetValueVoidPtr() const override { return &getValue(); }
     void* doBeginEditVoidPtr() override  { return beginEdit(); }
     void doEndEditVoidPtr() override  { endEdit(); }
@@ -299,6 +359,15 @@ bool Data<T>::read(const std::string& s)
         BaseData::endEditVoidPtr();
         return resized;
     }
+    if constexpr (details::NumberSequence<T>::isNumberSequence)
+    {
+        // fast path for the large vectors of numbers, the stream operators handle any other syntax
+        if (readNumberSequence(s))
+        {
+            return true;
+        }
+    }
+
     std::istringstream istr( s.c_str() );
 
     // capture std::cerr output (if any)
@@ -321,6 +390,35 @@ bool Data<T>::read(const std::string& s)
     return true;
 }
 
+template <class T>
+bool Data<T>::readNumberSequence(const std::string& s)
+{
+    using Sequence = details::NumberSequence<T>;
+    if constexpr (Sequence::isNumberSequence)
+    {
+        std::vector<typename Sequence::Real> values;
+        if (!helper::parseNumbers(s, values) || values.size() % Sequence::itemSize != 0)
+        {
+            return false;
+        }
+
+        T value;
+        value.resize(values.size() / Sequence::itemSize);
+        for (std::size_t i = 0; i < value.size(); ++i)
+        {
+            Sequence::set(value[i], values.data() + i * Sequence::itemSize);
+        }
+        updateIfDirty();
+        setValue(std::move(value));
+        return true;
+    }
+    else
+    {
+        SOFA_UNUSED(s);
+        return false;
+    }
+}
+
 template <class T>
 bool Data<T>::copyValueFrom(const Data<T>* data)
 {
@@ -353,6 +451,21 @@ bool Data<T>::doSetValueFromLink(const BaseData* data)
 }
 
 
+template <class T>
+bool Data<T>::doShareValueFrom(const BaseData* data)
+{
+    if constexpr (isCopyOnWrite())
+    {
+        const Data<T>* typedata = dynamic_cast<const Data<T>*>(data);
+        if (typedata && typedata != this)
+        {
+            m_value = typedata->m_value;
+            return true;
+        }
+    }
+    return false;
+}
+
 template <class T>
 bool Data<T>::doIsExactSameDataType(const BaseData* parent)
 {
@@ -23,4 +23,41 @@
 
 #include <sofa/core/objectmodel/DataContentValue.h>
 
-/// Everything is in the .h file.
+#include <atomic>
+
+namespace sofa::core::objectmodel
+{
+
+namespace
+{
+std::atomic<std::size_t> nbShares { 0 };
+std::atomic<std::size_t> nbCopies { 0 };
+}
+
+std::size_t CopyOnWriteStatistics::getNbShares()
+{
+    return nbShares.load(std::memory_order_relaxed);
+}
+
+std::size_t CopyOnWriteStatistics::getNbCopies()
+{
+    return nbCopies.load(std::memory_order_relaxed);
+}
+
+void CopyOnWriteStatistics::reset()
+{
+    nbShares.store(0, std::memory_order_relaxed);
+    nbCopies.store(0, std::memory_order_relaxed);
+}
+
+void CopyOnWriteStatistics::addShare()
+{
+    nbShares.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CopyOnWriteStatistics::addCopy()
+{
+    nbCopies.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace sofa::core::objectmodel
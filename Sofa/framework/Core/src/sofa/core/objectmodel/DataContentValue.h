@@ -21,12 +21,31 @@
 ******************************************************************************/
 #pragma once
 
-#include <sofa/config.h>
+#include <sofa/core/config.h>
+#include <atomic>
 #include <memory>
+#include <utility>
 
 namespace sofa::core::objectmodel
 {
 
+/// Counters of the copy-on-write Data contents, to measure how much memory is shared between Data, and how
+/// often a shared value has to be duplicated because one of the Data sharing it is modified.
+class SOFA_CORE_API CopyOnWriteStatistics
+{
+public:
+    /// Number of times a Data content started to share the value of another one, instead of copying it
+    static std::size_t getNbShares();
+
+    /// Number of times a shared value was duplicated before being modified
+    static std::size_t getNbCopies();
+
+    static void reset();
+
+    static void addShare();
+    static void addCopy();
+};
+
 /// To handle the Data link:
 /// - CopyOnWrite==false: an independent copy (duplicated memory)
 /// - CopyOnWrite==true: shared memory while the Data is not modified (in that case the memory is duplicated to get an independent copy)
@@ -67,6 +86,10 @@ public:
     {
         data = value;
     }
+    void setValue(T&& value)
+    {
+        data = std::move(value);
+    }
     void release()
     {
     }
@@ -92,6 +115,7 @@ public:
     DataContentValue(const DataContentValue& dc)
         : ptr(dc.ptr) // start with shared memory
     {
+        CopyOnWriteStatistics::addShare();
     }
 
     ~DataContentValue()
@@ -101,9 +125,10 @@ public:
     DataContentValue& operator=(const DataContentValue& dc )
     {
         //avoid self reference
-        if(&dc != this)
+        if(&dc != this && dc.ptr != ptr)
         {
             ptr = dc.ptr;
+            CopyOnWriteStatistics::addShare();
         }
 
         return *this;
@@ -111,9 +136,10 @@ public:
 
     T* beginEdit()
     {
-        if(!(ptr.use_count() == 1))
+        if(!isUnique())
         {
             ptr.reset(new T(*ptr)); // a priori the Data will be modified -> copy
+            CopyOnWriteStatistics::addCopy();
         }
         return ptr.get();
     }
@@ -129,7 +155,7 @@ public:
 
     void setValue(const T& value)
     {
-        if(!ptr.unique())
+        if(!isUnique())
         {
             ptr.reset(new T(value)); // the Data is modified -> copy
         }
@@ -139,10 +165,36 @@ public:
         }
     }
 
+    void setValue(T&& value)
+    {
+        if(!isUnique())
+        {
+            ptr.reset(new T(std::move(value))); // the shared value is left untouched, nothing to copy
+        }
+        else
+        {
+            *ptr = std::move(value);
+        }
+    }
+
     void release()
     {
         ptr.reset();
     }
+
+private:
+    /// true if no other Data shares the value, which can then be modified in place.
+    /// The value may have been shared with Data modified in other threads (e.g. in concurrent scenes): the
+    /// acquire fence orders their last accesses to the value, before they released it, before its modification.
+    bool isUnique() const
+    {
+        if (ptr.use_count() != 1)
+        {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
 };
 
 
@@ -0,0 +1,202 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/objectmodel/PerformanceCounters.h>
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/BaseMapping.h>
+
+namespace sofa::core::objectmodel
+{
+
+std::atomic<int> PerformanceCounters::s_nbEnabled { 0 };
+std::atomic<bool> PerformanceCounters::s_countingBytes { false };
+
+PerformanceCounters::PerformanceCounters(BaseObject* owner)
+    : m_owner(owner)
+{
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+    for (auto& data : m_data)
+    {
+        if (data)
+        {
+            m_owner->removeData(data.get());
+        }
+    }
+}
+
+void PerformanceCounters::enable()
+{
+    s_nbEnabled.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerformanceCounters::disable()
+{
+    int nbEnabled = s_nbEnabled.load(std::memory_order_relaxed);
+    while (nbEnabled > 0 && !s_nbEnabled.compare_exchange_weak(nbEnabled, nbEnabled - 1, std::memory_order_relaxed))
+    {
+    }
+}
+
+void PerformanceCounters::setCountingBytes(bool countingBytes)
+{
+    s_countingBytes.store(countingBytes, std::memory_order_relaxed);
+}
+
+const char* PerformanceCounters::getName(PerformanceCounterType type)
+{
+    switch (type)
+    {
+        case PerformanceCounterType::AddForce:             return "addForce";
+        case PerformanceCounterType::AddDForce:            return "addDForce";
+        case PerformanceCounterType::Apply:                return "apply";
+        case PerformanceCounterType::ApplyJ:               return "applyJ";
+        case PerformanceCounterType::ApplyJT:              return "applyJT";
+        case PerformanceCounterType::BuildStiffnessMatrix: return "buildStiffnessMatrix";
+        default:                                           return "unknown";
+    }
+}
+
+namespace
+{
+std::size_t getStateBytes(const behavior::BaseMechanicalState* state, unsigned int nbCoordVectors, unsigned int nbDerivVectors)
+{
+    if (!state)
+        return 0;
+    return static_cast<std::size_t>(state->getSize())
+        * (nbCoordVectors * state->getCoordDimension() + nbDerivVectors * state->getDerivDimension())
+        * sizeof(SReal);
+}
+}
+
+std::size_t PerformanceCounters::getForceFieldBytes(const behavior::BaseForceField* forceField, unsigned int nbCoordVectors, unsigned int nbDerivVectors)
+{
+    std::size_t bytes = 0;
+    for (const auto& state : forceField->getMechanicalStates())
+    {
+        bytes += getStateBytes(state, nbCoordVectors, nbDerivVectors);
+    }
+    return bytes;
+}
+
+std::size_t PerformanceCounters::getMappingBytes(BaseMapping* mapping, bool derivVectors)
+{
+    const unsigned int nbCoordVectors = derivVectors ? 0 : 1;
+    const unsigned int nbDerivVectors = derivVectors ? 1 : 0;
+
+    std::size_t bytes = 0;
+    for (const auto* state : mapping->getMechFrom())
+    {
+        bytes += getStateBytes(state, nbCoordVectors, nbDerivVectors);
+    }
+    for (const auto* state : mapping->getMechTo())
+    {
+        bytes += getStateBytes(state, nbCoordVectors, nbDerivVectors);
+    }
+    return bytes;
+}
+
+void PerformanceCounters::add(PerformanceCounterType type, double time, std::size_t bytes)
+{
+    const auto index = static_cast<std::size_t>(type);
+    if (index >= NbTypes)
+        return;
+
+    const auto timeNs = static_cast<std::uint64_t>(time * 1e6);
+
+    Accumulator& accumulator = m_accumulators[index];
+    accumulator.nbCalls.fetch_add(1, std::memory_order_relaxed);
+    accumulator.totalTime.fetch_add(timeNs, std::memory_order_relaxed);
+    accumulator.lastTime.store(timeNs, std::memory_order_relaxed);
+    accumulator.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+bool PerformanceCounters::isMeasured(PerformanceCounterType type) const
+{
+    const auto index = static_cast<std::size_t>(type);
+    return index < NbTypes && m_accumulators[index].nbCalls.load(std::memory_order_relaxed) != 0;
+}
+
+PerformanceCounter PerformanceCounters::get(PerformanceCounterType type) const
+{
+    const auto index = static_cast<std::size_t>(type);
+    if (index >= NbTypes)
+        return PerformanceCounter();
+
+    const Accumulator& accumulator = m_accumulators[index];
+    return PerformanceCounter(
+        static_cast<double>(accumulator.nbCalls.load(std::memory_order_relaxed)),
+        static_cast<double>(accumulator.totalTime.load(std::memory_order_relaxed)) * 1e-6,
+        static_cast<double>(accumulator.lastTime.load(std::memory_order_relaxed)) * 1e-6,
+        static_cast<double>(accumulator.bytes.load(std::memory_order_relaxed)));
+}
+
+void PerformanceCounters::reset()
+{
+    for (Accumulator& accumulator : m_accumulators)
+    {
+        accumulator.nbCalls.store(0, std::memory_order_relaxed);
+        accumulator.totalTime.store(0, std::memory_order_relaxed);
+        accumulator.lastTime.store(0, std::memory_order_relaxed);
+        accumulator.bytes.store(0, std::memory_order_relaxed);
+    }
+    publish();
+}
+
+void PerformanceCounters::registerData()
+{
+    for (std::size_t i = 0; i < NbTypes; ++i)
+    {
+        auto& data = m_data[i];
+        if (!data)
+        {
+            data = std::make_unique<Data<PerformanceCounter> >(
+                "Performance counter: number of calls, cumulative time (ms), time of the last call (ms), "
+                "cumulative bytes of state vectors accessed", true, true);
+            data->setGroup("Performance");
+            m_owner->addData(data.get(), std::string("perf_") + getName(static_cast<PerformanceCounterType>(i)));
+        }
+    }
+    publish();
+}
+
+void PerformanceCounters::publish()
+{
+    for (std::size_t i = 0; i < NbTypes; ++i)
+    {
+        if (m_data[i])
+        {
+            m_data[i]->setValue(get(static_cast<PerformanceCounterType>(i)));
+        }
+    }
+}
+
+void PerformanceCounters::Scope::stop()
+{
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - m_start;
+    m_object->getPerformanceCounters().add(m_type, duration.count(), m_bytes);
+}
+
+} // namespace sofa::core::objectmodel
@@ -0,0 +1,188 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/core/config.h>
+#include <sofa/core/fwd.h>
+#include <sofa/core/objectmodel/Data.h>
+#include <sofa/type/Vec.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace sofa::core::objectmodel
+{
+
+/// Calls of the mechanical visitors measured by the performance counters
+enum class PerformanceCounterType : std::uint8_t
+{
+    AddForce,
+    AddDForce,
+    Apply,
+    ApplyJ,
+    ApplyJT,
+    BuildStiffnessMatrix,
+    NbTypes
+};
+
+/// Statistics on the calls of one type:
+/// [number of calls, cumulative wall time (ms), wall time of the last call (ms), cumulative bytes]
+using PerformanceCounter = sofa::type::Vec<4, double>;
+
+/**
+ * Performance counters of a component.
+ *
+ * When the counters are enabled, the mechanical visitors measure the calls they make on each
+ * component (addForce, addDForce, apply, applyJ, applyJT and buildStiffnessMatrix). The measures
+ * are accumulated in atomic counters, so that the calls can be measured concurrently.
+ *
+ * The statistics of each type of call can be exposed in a read-only Data named "perf_<call>".
+ * The Data are registered by registerData() and updated by publish(), which must not be called
+ * concurrently with the measured calls (e.g. at initialization and at the end of a time step).
+ *
+ * The bytes are an estimation of the size of the state vectors read and written by the calls.
+ * They are only counted if setCountingBytes(true) has been called.
+ */
+class SOFA_CORE_API PerformanceCounters
+{
+public:
+    explicit PerformanceCounters(BaseObject* owner);
+    ~PerformanceCounters();
+
+    PerformanceCounters(const PerformanceCounters&) = delete;
+    PerformanceCounters& operator=(const PerformanceCounters&) = delete;
+
+    static bool isEnabled() { return s_nbEnabled.load(std::memory_order_relaxed) > 0; }
+
+    /// Enables the counters, until the matching call to disable(). The counters are enabled while at
+    /// least one client needs them.
+    static void enable();
+    static void disable();
+
+    static bool isCountingBytes() { return s_countingBytes.load(std::memory_order_relaxed); }
+    static void setCountingBytes(bool countingBytes);
+
+    /// Name of the type of call, as used in the name of the Data
+    static const char* getName(PerformanceCounterType type);
+
+    /// Estimated bytes of nbCoordVectors position vectors and nbDerivVectors derivative vectors
+    /// in each mechanical state of the force field
+    static std::size_t getForceFieldBytes(const behavior::BaseForceField* forceField, unsigned int nbCoordVectors, unsigned int nbDerivVectors);
+
+    /// Estimated bytes of one position (or derivative) vector in each input and output state of the mapping
+    static std::size_t getMappingBytes(BaseMapping* mapping, bool derivVectors);
+
+    /// Thread-safe: records a call of the given type, with its wall time in ms
+    void add(PerformanceCounterType type, double time, std::size_t bytes);
+
+    /// true if a call of the given type has been measured since the last reset
+    bool isMeasured(PerformanceCounterType type) const;
+
+    /// Statistics of the calls of the given type
+    PerformanceCounter get(PerformanceCounterType type) const;
+
+    /// Resets all the statistics to 0
+    void reset();
+
+    /// Registers the Data "perf_<call>" in the owner, if they are not registered yet
+    void registerData();
+
+    /// Copies the current statistics in the registered Data
+    void publish();
+
+    /**
+     * Measures the wall time of a call, from construction to destruction, if the performance
+     * counters are enabled.
+     * Example:
+     * {
+     *     PerformanceCounters::Scope scope(ff, PerformanceCounterType::AddForce);
+     *     ff->addForce(mparams, res);
+     * }
+     */
+    class SOFA_CORE_API Scope
+    {
+    public:
+        Scope(BaseObject* object, PerformanceCounterType type, std::size_t bytes = 0)
+            : m_object(isEnabled() ? object : nullptr), m_type(type), m_bytes(bytes)
+        {
+            if (m_object)
+                m_start = std::chrono::steady_clock::now();
+        }
+        ~Scope()
+        {
+            if (m_object)
+                stop();
+        }
+        /// The bytes are only computed, by calling bytes(), if they are counted
+        template<class BytesFunction, class = std::enable_if_t<std::is_invocable_r_v<std::size_t, BytesFunction> > >
+        Scope(BaseObject* object, PerformanceCounterType type, BytesFunction&& bytes)
+            : Scope(object, type)
+        {
+            if (m_object && isCountingBytes())
+            {
+                m_bytes = bytes();
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /// true if the call is measured
+        bool isActive() const { return m_object != nullptr; }
+
+        /// Sets the number of bytes counted for the call
+        void setBytes(std::size_t bytes) { m_bytes = bytes; }
+
+    private:
+        void stop();
+
+        BaseObject* m_object;
+        PerformanceCounterType m_type;
+        std::size_t m_bytes;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+protected:
+    static constexpr std::size_t NbTypes = static_cast<std::size_t>(PerformanceCounterType::NbTypes);
+
+    /// Statistics of one type of call, accumulated by the measuring threads
+    struct Accumulator
+    {
+        std::atomic<std::uint64_t> nbCalls { 0 };
+        std::atomic<std::uint64_t> totalTime { 0 }; ///< ns
+        std::atomic<std::uint64_t> lastTime { 0 }; ///< ns
+        std::atomic<std::uint64_t> bytes { 0 };
+    };
+
+    BaseObject* m_owner;
+    std::array<Accumulator, NbTypes> m_accumulators;
+    std::array<std::unique_ptr<Data<PerformanceCounter> >, NbTypes> m_data;
+
+    static std::atomic<int> s_nbEnabled;
+    static std::atomic<bool> s_countingBytes;
+};
+
+} // namespace sofa::core::objectmodel
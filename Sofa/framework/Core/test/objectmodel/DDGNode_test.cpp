@@ -26,6 +26,14 @@ using sofa::testing::BaseTest ;
 #include <sofa/core/objectmodel/DDGNode.h>
 using sofa::core::objectmodel::DDGNode;
 
+#include <sofa/core/objectmodel/Data.h>
+using sofa::core::objectmodel::Data;
+
+#include <sofa/type/vector.h>
+
+#include <thread>
+#include <chrono>
+
 class DDGNodeTestClass : public DDGNode
 {
 public:
@@ -41,6 +49,20 @@ public:
     }
 };
 
+/// Counts the updates, which take some time, and cleans itself when updated
+class DDGNodeCountingTestClass : public DDGNode
+{
+public:
+    std::atomic<int> m_cptUpdate {0};
+
+    void update() override
+    {
+        ++m_cptUpdate;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cleanDirty();
+    }
+};
+
 class DDGNode_test: public BaseTest
 {
 public:
@@ -183,3 +205,66 @@ TEST_F(DDGNode_test, propagationScenario3)
     EXPECT_EQ(m_ddgnode1.m_cpt, 1);
     EXPECT_EQ(m_ddgnode2.m_cpt, 1);
 }
+
+TEST_F(DDGNode_test, concurrentUpdateIfDirty)
+{
+    DDGNodeCountingTestClass output;
+    output.addInput(&m_ddgnode2);
+    output.updateIfDirty();
+    output.m_cptUpdate = 0;
+
+    m_ddgnode2.setDirtyOutputs();
+    ASSERT_TRUE(output.isDirty());
+
+    std::vector<std::thread> readers;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        readers.emplace_back([&output]() { output.updateIfDirty(); });
+    }
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_FALSE(output.isDirty());
+    EXPECT_EQ(output.m_cptUpdate.load(), 1);
+}
+
+/// Data update their value after being cleaned: a reader must not see a clean Data before the
+/// value copied from its parent is complete
+TEST_F(DDGNode_test, concurrentDataParentChain)
+{
+    Data<sofa::type::vector<int>> parent;
+    Data<sofa::type::vector<int>> child;
+    Data<sofa::type::vector<int>> grandChild;
+    child.setParent(&parent);
+    grandChild.setParent(&child);
+
+    constexpr std::size_t nbValues = 1 << 18;
+    for (int round = 0; round < 10; ++round)
+    {
+        parent.setValue(sofa::type::vector<int>(nbValues, round));
+        ASSERT_TRUE(grandChild.isDirty());
+
+        std::atomic<int> nbErrors {0};
+        std::vector<std::thread> readers;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            readers.emplace_back([&grandChild, &nbErrors, round]()
+            {
+                const auto& values = grandChild.getValue();
+                if (values.size() != nbValues || values.front() != round || values.back() != round)
+                {
+                    ++nbErrors;
+                }
+            });
+        }
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        EXPECT_EQ(nbErrors.load(), 0) << "round " << round;
+        EXPECT_FALSE(grandChild.isDirty());
+    }
+}
@@ -110,3 +110,37 @@ TEST_F(DataLink_test, updateFromParent)
     ASSERT_TRUE(data2.isDirty());    ///< it is dirty as the parent's value has changed but there we no getValue, so update was not done
     ASSERT_EQ(data1.getValue(), data2.getValue());
 }
+
+/// Linked vectors share their memory until one of them is modified
+TEST_F(DataLink_test, copyOnWriteSharing)
+{
+    using sofa::core::objectmodel::CopyOnWriteStatistics;
+    using VecCoord = sofa::type::vector<Vec3d>;
+
+    Data<VecCoord> source;
+    Data<VecCoord> stage1;
+    Data<VecCoord> stage2;
+    stage1.setParent(&source);
+    stage2.setParent(&stage1);
+
+    CopyOnWriteStatistics::reset();
+    source.setValue(VecCoord(1000, Vec3d(1.0, 2.0, 3.0)));
+    ASSERT_EQ(stage2.getValue().size(), 1000u);
+    EXPECT_EQ(&source.getValue(), &stage1.getValue());
+    EXPECT_EQ(&source.getValue(), &stage2.getValue());
+    EXPECT_EQ(CopyOnWriteStatistics::getNbCopies(), 0u);
+
+    /// a new value is moved into the source, the previous one is still used by the stages, nothing is copied
+    source.setValue(VecCoord(10, Vec3d(0.0, 0.0, 1.0)));
+    EXPECT_EQ(CopyOnWriteStatistics::getNbCopies(), 0u);
+    ASSERT_EQ(stage2.getValue().size(), 10u);
+    EXPECT_EQ(&source.getValue(), &stage2.getValue());
+
+    /// modifying a stage duplicates the shared value for this stage only
+    sofa::helper::WriteAccessor<Data<VecCoord>> stage2Value = stage2;
+    stage2Value[0] = Vec3d(4.0, 5.0, 6.0);
+    EXPECT_EQ(CopyOnWriteStatistics::getNbCopies(), 1u);
+    EXPECT_NE(&source.getValue(), &stage2.getValue());
+    EXPECT_EQ(source.getValue()[0], Vec3d(0.0, 0.0, 1.0));
+    EXPECT_EQ(&source.getValue(), &stage1.getValue());
+}
@@ -90,4 +90,24 @@ TEST_F(Data_test, getNameWithValueTypeInfo)
         EXPECT_EQ(dataVectorVec3.getValueTypeInfo()->name(), "vector<Vec3f>");
     }
 }
+
+TEST_F(Data_test, readNumberSequence)
+{
+    ASSERT_TRUE(dataVectorVec3.read("0 1 2\n 3.5 -4 5e-1"));
+    ASSERT_EQ(dataVectorVec3.getValue().size(), 2u);
+    EXPECT_EQ(dataVectorVec3.getValue()[0], sofa::type::Vec3(0, 1, 2));
+    EXPECT_EQ(dataVectorVec3.getValue()[1], sofa::type::Vec3(3.5, -4, 0.5));
+
+    // an incomplete Vec3 is still an error
+    EXPECT_FALSE(dataVectorVec3.read("0 1 2 3"));
+
+    // the syntax which is not a plain sequence of numbers is still read by the stream operators
+    Data<sofa::type::vector<int>> dataVectorInt;
+    ASSERT_TRUE(dataVectorInt.read("1-3 7"));
+    EXPECT_EQ(dataVectorInt.getValue(), sofa::type::vector<int>({1, 2, 3, 7}));
+
+    Data<sofa::type::vector<double>> dataVectorDouble;
+    ASSERT_TRUE(dataVectorDouble.read("+1 2"));
+    EXPECT_EQ(dataVectorDouble.getValue(), sofa::type::vector<double>({1, 2}));
+}
 }// namespace sofa
@@ -0,0 +1,154 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
+#include <sofa/testing/BaseTest.h>
+
+namespace
+{
+
+using sofa::core::objectmodel::BaseObject;
+using sofa::core::objectmodel::PerformanceCounter;
+using sofa::core::objectmodel::PerformanceCounters;
+using sofa::core::objectmodel::PerformanceCounterType;
+
+class PerformanceCountersObject : public BaseObject
+{
+public:
+    SOFA_CLASS(PerformanceCountersObject, BaseObject);
+};
+
+class PerformanceCounters_test : public sofa::testing::BaseTest
+{
+public:
+    void onTearDown() override
+    {
+        while (PerformanceCounters::isEnabled())
+        {
+            PerformanceCounters::disable();
+        }
+        PerformanceCounters::setCountingBytes(false);
+    }
+};
+
+TEST_F(PerformanceCounters_test, disabled)
+{
+    const auto object = sofa::core::objectmodel::New<PerformanceCountersObject>();
+
+    EXPECT_FALSE(PerformanceCounters::isEnabled());
+    {
+        PerformanceCounters::Scope scope(object.get(), PerformanceCounterType::AddForce);
+        EXPECT_FALSE(scope.isActive());
+    }
+
+    // the counters are not allocated for the components which are not measured
+    EXPECT_EQ(object->findPerformanceCounters(), nullptr);
+    EXPECT_FALSE(object->getPerformanceCounters().isMeasured(PerformanceCounterType::AddForce));
+
+    // nothing is added to the components which are not measured
+    EXPECT_EQ(object->findData("perf_addForce"), nullptr);
+}
+
+TEST_F(PerformanceCounters_test, enable)
+{
+    // the activation is counted
+    PerformanceCounters::enable();
+    PerformanceCounters::enable();
+    EXPECT_TRUE(PerformanceCounters::isEnabled());
+
+    PerformanceCounters::disable();
+    EXPECT_TRUE(PerformanceCounters::isEnabled());
+
+    PerformanceCounters::disable();
+    EXPECT_FALSE(PerformanceCounters::isEnabled());
+
+    PerformanceCounters::disable();
+    EXPECT_FALSE(PerformanceCounters::isEnabled());
+    PerformanceCounters::enable();
+    EXPECT_TRUE(PerformanceCounters::isEnabled());
+}
+
+TEST_F(PerformanceCounters_test, scope)
+{
+    const auto object = sofa::core::objectmodel::New<PerformanceCountersObject>();
+    PerformanceCounters& counters = object->getPerformanceCounters();
+
+    PerformanceCounters::enable();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        PerformanceCounters::Scope scope(object.get(), PerformanceCounterType::AddForce, [] { return std::size_t(64); });
+        EXPECT_TRUE(scope.isActive());
+    }
+
+    ASSERT_TRUE(counters.isMeasured(PerformanceCounterType::AddForce));
+    PerformanceCounter counter = counters.get(PerformanceCounterType::AddForce);
+    EXPECT_EQ(counter[0], 3);
+    EXPECT_GE(counter[1], counter[2]);
+    EXPECT_GE(counter[2], 0);
+
+    // bytes are only counted on demand
+    EXPECT_EQ(counter[3], 0);
+
+    // the other types of calls are not measured
+    EXPECT_FALSE(counters.isMeasured(PerformanceCounterType::ApplyJT));
+
+    // the measures do not modify the Data of the component
+    EXPECT_EQ(object->findData("perf_addForce"), nullptr);
+
+    PerformanceCounters::setCountingBytes(true);
+    {
+        PerformanceCounters::Scope scope(object.get(), PerformanceCounterType::AddForce, [] { return std::size_t(64); });
+    }
+    counter = counters.get(PerformanceCounterType::AddForce);
+    EXPECT_EQ(counter[0], 4);
+    EXPECT_EQ(counter[3], 64);
+
+    counters.reset();
+    counter = counters.get(PerformanceCounterType::AddForce);
+    EXPECT_EQ(counter[0], 0);
+    EXPECT_EQ(counter[1], 0);
+    EXPECT_FALSE(counters.isMeasured(PerformanceCounterType::AddForce));
+}
+
+TEST_F(PerformanceCounters_test, publish)
+{
+    const auto object = sofa::core::objectmodel::New<PerformanceCountersObject>();
+    PerformanceCounters& counters = object->getPerformanceCounters();
+
+    counters.registerData();
+    const auto* data = dynamic_cast<const sofa::core::objectmodel::Data<PerformanceCounter>*>(object->findData("perf_addForce"));
+    ASSERT_NE(data, nullptr);
+    EXPECT_TRUE(data->isReadOnly());
+    EXPECT_NE(object->findData("perf_applyJT"), nullptr);
+
+    PerformanceCounters::enable();
+    {
+        PerformanceCounters::Scope scope(object.get(), PerformanceCounterType::AddForce);
+    }
+
+    // the Data are only updated on publication
+    EXPECT_EQ(data->getValue()[0], 0);
+    counters.publish();
+    EXPECT_EQ(data->getValue()[0], 1);
+}
+
+} // namespace
@@ -23,6 +23,7 @@
 
 #include <sofa/helper/logging/Messaging.h>
 #include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/TraceRecorder.h>
 #include <sofa/type/vector.h>
 #include <json.h>
 
@@ -151,6 +152,45 @@ std::pair<AdvancedTimer::SyncCallBack,void*> AdvancedTimer::setSyncCallBack(Sync
     return old;
 }
 
+namespace
+{
+
+/// Appends a record to the records of the current timer of the thread, if any
+void addRecord(Record::Type type, unsigned int id, unsigned int obj, double val, bool sync)
+{
+    type::vector<Record>* curRecords = getCurRecords();
+    if (!curRecords) return;
+    if (sync && syncCallBack) (*syncCallBack)(syncCallBackData);
+    Record r;
+    r.time = CTime::getTime();
+    r.type = type;
+    r.id = id;
+    r.obj = obj;
+    r.val = val;
+    curRecords->push_back(r);
+}
+
+/// Name of an id in the TraceRecorder. The ids of AdvancedTimer are specific to each thread,
+/// so the correspondence is cached per thread.
+template<class Base>
+std::uint32_t getTraceName(AdvancedTimer::Id<Base> id)
+{
+    thread_local std::vector<std::uint32_t> traceNames;
+    const unsigned int index = id;
+    if (index == 0) return 0;
+    if (index >= traceNames.size())
+    {
+        traceNames.resize(index + 1, 0);
+    }
+    if (traceNames[index] == 0)
+    {
+        traceNames[index] = TraceRecorder::intern(static_cast<std::string>(id));
+    }
+    return traceNames[index];
+}
+
+} // anonymous namespace
+
 void AdvancedTimer::clear()
 {
     setCurRecords(nullptr);
@@ -208,6 +248,9 @@ void AdvancedTimer::setInterval(IdTimer id, int val)
 
 void AdvancedTimer::begin(IdTimer id)
 {
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::begin(getTraceName(id));
+
     std::stack<AdvancedTimer::IdTimer>& curTimer = getCurTimer();
     curTimer.push(id);
     TimerData& data = timers[curTimer.top()];
@@ -245,6 +288,9 @@ void AdvancedTimer::end(IdTimer id, std::ostream& result)
         msg_error("AdvancedTimer::end") << "timer[" << id << "] does not correspond to last call to begin(" << curTimer.top() << ")" ;
         return;
     }
+
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(getTraceName(id));
     type::vector<Record>* curRecords = getCurRecords();
     if (curRecords)
     {
@@ -290,6 +336,9 @@ void AdvancedTimer::end(IdTimer id)
         return;
     }
 
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(getTraceName(id));
+
     TimerData& dataT = timers[id];
     if (dataT.timerOutputType == GUI || dataT.timerOutputType == LJSON || dataT.timerOutputType == JSON)
     {
@@ -356,116 +405,73 @@ bool AdvancedTimer::isActive()
 
 void AdvancedTimer::stepBegin(IdStep id)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_BEGIN;
-    r.id = id;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::begin(getTraceName(id));
+    addRecord(Record::RSTEP_BEGIN, id, 0, 0, false);
 }
 
 void AdvancedTimer::stepBegin(IdStep id, IdObj obj)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_BEGIN;
-    r.id = id;
-    r.obj = obj;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::begin(getTraceName(id), getTraceName(obj));
+    addRecord(Record::RSTEP_BEGIN, id, obj, 0, false);
 }
 
 void AdvancedTimer::stepEnd  (IdStep id)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_END;
-    r.id = id;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(getTraceName(id));
+    addRecord(Record::RSTEP_END, id, 0, 0, true);
 }
 
 void AdvancedTimer::stepEnd  (IdStep id, IdObj obj)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_END;
-    r.id = id;
-    r.obj = obj;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(getTraceName(id), getTraceName(obj));
+    addRecord(Record::RSTEP_END, id, obj, 0, false);
 }
 
 void AdvancedTimer::stepNext (IdStep prevId, IdStep nextId)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_END;
-    r.id = prevId;
-    curRecords->push_back(r);
-    r.type = Record::RSTEP_BEGIN;
-    r.id = nextId;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+    {
+        TraceRecorder::end(getTraceName(prevId));
+        TraceRecorder::begin(getTraceName(nextId));
+    }
+    addRecord(Record::RSTEP_END, prevId, 0, 0, true);
+    addRecord(Record::RSTEP_BEGIN, nextId, 0, 0, false);
 }
 
 void AdvancedTimer::step     (IdStep id)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP;
-    r.id = id;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(getTraceName(id));
+    addRecord(Record::RSTEP, id, 0, 0, true);
 }
 
 void AdvancedTimer::step     (IdStep id, IdObj obj)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP;
-    r.id = id;
-    r.obj = obj;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(getTraceName(id), getTraceName(obj));
+    addRecord(Record::RSTEP, id, obj, 0, true);
 }
 
 void AdvancedTimer::valSet(IdVal id, double val)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RVAL_SET;
-    r.id = id;
-    r.val = val;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::counter(getTraceName(id), val);
+    addRecord(Record::RVAL_SET, id, 0, val, false);
 }
 
 void AdvancedTimer::valAdd(IdVal id, double val)
 {
-    type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RVAL_ADD;
-    r.id = id;
-    r.val = val;
-    curRecords->push_back(r);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(getTraceName(id), 0, val);
+    addRecord(Record::RVAL_ADD, id, 0, val, false);
 }
 
-// API using strings instead of Id, to remove the need for Id creation when no timing is recorded
+// API using strings instead of Id, to remove the need for Id creation when no timing is recorded.
+// The TraceRecorder interns the strings itself, without creating the Ids.
 
 void AdvancedTimer::begin(const char* idStr)
 {
@@ -479,86 +485,102 @@ void AdvancedTimer::end(const char* idStr)
 
 void AdvancedTimer::stepBegin(const char* idStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepBegin(IdStep(idStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::begin(TraceRecorder::intern(idStr));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_BEGIN, IdStep(idStr), 0, 0, false);
 }
 
 void AdvancedTimer::stepBegin(const char* idStr, const char* objStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepBegin(IdStep(idStr), IdObj(objStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::begin(TraceRecorder::intern(idStr), TraceRecorder::intern(objStr ? objStr : ""));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_BEGIN, IdStep(idStr), IdObj(objStr), 0, false);
 }
 
 void AdvancedTimer::stepBegin(const char* idStr, const std::string& objStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepBegin(IdStep(idStr), IdObj(objStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::begin(TraceRecorder::intern(idStr), TraceRecorder::intern(objStr));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_BEGIN, IdStep(idStr), IdObj(objStr), 0, false);
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepEnd  (IdStep(idStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(TraceRecorder::intern(idStr));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_END, IdStep(idStr), 0, 0, true);
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr, const char* objStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepEnd  (IdStep(idStr), IdObj(objStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(TraceRecorder::intern(idStr), TraceRecorder::intern(objStr ? objStr : ""));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_END, IdStep(idStr), IdObj(objStr), 0, false);
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr, const std::string& objStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepEnd  (IdStep(idStr), IdObj(objStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::end(TraceRecorder::intern(idStr), TraceRecorder::intern(objStr));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_END, IdStep(idStr), IdObj(objStr), 0, false);
 }
 
 void AdvancedTimer::stepNext (const char* prevIdStr, const char* nextIdStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    stepNext (IdStep(prevIdStr), IdStep(nextIdStr));
+    if (TraceRecorder::isEnabled())
+    {
+        TraceRecorder::end(TraceRecorder::intern(prevIdStr));
+        TraceRecorder::begin(TraceRecorder::intern(nextIdStr));
+    }
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP_END, IdStep(prevIdStr), 0, 0, true);
+    addRecord(Record::RSTEP_BEGIN, IdStep(nextIdStr), 0, 0, false);
 }
 
 void AdvancedTimer::step     (const char* idStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    step     (IdStep(idStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(TraceRecorder::intern(idStr));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP, IdStep(idStr), 0, 0, true);
 }
 
 void AdvancedTimer::step     (const char* idStr, const char* objStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    step     (IdStep(idStr), IdObj(objStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(TraceRecorder::intern(idStr), TraceRecorder::intern(objStr ? objStr : ""));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP, IdStep(idStr), IdObj(objStr), 0, true);
 }
 
 void AdvancedTimer::step     (const char* idStr, const std::string& objStr)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    step     (IdStep(idStr), IdObj(objStr));
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(TraceRecorder::intern(idStr), TraceRecorder::intern(objStr));
+    if (!getCurRecords()) return;
+    addRecord(Record::RSTEP, IdStep(idStr), IdObj(objStr), 0, true);
 }
 
 void AdvancedTimer::valSet(const char* idStr, double val)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    valSet(IdVal(idStr),val);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::counter(TraceRecorder::intern(idStr), val);
+    if (!getCurRecords()) return;
+    addRecord(Record::RVAL_SET, IdVal(idStr), 0, val, false);
 }
 
 void AdvancedTimer::valAdd(const char* idStr, double val)
 {
-    const type::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    valAdd(IdVal(idStr),val);
+    if (TraceRecorder::isEnabled())
+        TraceRecorder::instant(TraceRecorder::intern(idStr), 0, val);
+    if (!getCurRecords()) return;
+    addRecord(Record::RVAL_ADD, IdVal(idStr), 0, val, false);
 }
 
 void TimerData::clear()
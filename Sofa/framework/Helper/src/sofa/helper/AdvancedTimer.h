@@ -81,6 +81,11 @@ namespace sofa::helper
   * When reloading/reseting the simulation:
     AdvancedTimer::clear();
 
+  * To record a trace of all the steps, values and timers of all the threads, viewable in
+    chrome://tracing or Perfetto (see TraceRecorder):
+    TraceRecorder::setEnabled(true);
+    ...
+    TraceRecorder::exportChromeTrace("trace.json");
 
   The produced stats will looks like:
 
@@ -0,0 +1,86 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace sofa::helper
+{
+
+/// Types of the numbers which can be read by parseNumbers
+template<class T>
+inline constexpr bool isParsableNumber = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && (sizeof(T) > 1)
+#if !defined(__cpp_lib_to_chars)
+    // floating-point std::from_chars is not available in this standard library
+    && std::is_integral_v<T>
+#endif
+    ;
+
+/**
+ * Read a sequence of numbers separated by white spaces, using std::from_chars (no stream, no locale).
+ *
+ * Only plain numbers are accepted: as soon as a token is not entirely a number of type T (range notation "1-5",
+ * leading '+', value out of range, ...), false is returned, so that the caller can fall back on the stream
+ * operators, which remain the reference syntax.
+ */
+template<class T>
+bool parseNumbers(std::string_view text, std::vector<T>& values)
+{
+    static_assert(isParsableNumber<T>, "parseNumbers only reads integral and floating-point numbers");
+
+    const auto isSpace = [](const char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    };
+
+    values.clear();
+    const char* current = text.data();
+    const char* const end = current + text.size();
+    while (true)
+    {
+        while (current != end && isSpace(*current))
+        {
+            ++current;
+        }
+        if (current == end)
+        {
+            return true;
+        }
+
+        T value {};
+        const auto [next, error] = std::from_chars(current, end, value);
+        if (error != std::errc() || (next != end && !isSpace(*next)))
+        {
+            return false;
+        }
+        values.push_back(value);
+        current = next;
+    }
+}
+
+} // namespace sofa::helper
@@ -0,0 +1,455 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/TraceRecorder.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+namespace sofa::helper
+{
+
+std::atomic<bool> TraceRecorder::s_enabled { false };
+
+namespace
+{
+
+/// Slot of the ring buffer, protected by a sequence lock: the event is stored in atomic words,
+/// so that a reader copying the slot while the owning thread overwrites it gets a torn copy
+/// instead of a data race, and the sequence number tells it to discard this copy.
+struct EventSlot
+{
+    static_assert(std::is_trivially_copyable_v<TraceEvent>);
+    static constexpr std::size_t nbWords = (sizeof(TraceEvent) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    /// 2i+1 while the i-th event of the thread is written in the slot, 2i+2 once it is written
+    std::atomic<std::uint64_t> sequence { 0 };
+    std::array<std::atomic<std::uint64_t>, nbWords> words {};
+
+    void write(std::uint64_t index, const TraceEvent& event)
+    {
+        std::array<std::uint64_t, nbWords> data {};
+        std::memcpy(data.data(), &event, sizeof(TraceEvent));
+
+        sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t w = 0; w < nbWords; ++w)
+            words[w].store(data[w], std::memory_order_relaxed);
+        sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    /// Copy the index-th event of the thread, return false if the slot does not hold it
+    /// (yet or anymore), or if it was overwritten during the copy
+    bool read(std::uint64_t index, TraceEvent& event) const
+    {
+        const std::uint64_t expected = 2 * index + 2;
+        if (sequence.load(std::memory_order_acquire) != expected)
+            return false;
+
+        std::array<std::uint64_t, nbWords> data;
+        for (std::size_t w = 0; w < nbWords; ++w)
+            data[w] = words[w].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != expected)
+            return false;
+
+        std::memcpy(static_cast<void*>(&event), data.data(), sizeof(TraceEvent));
+        return true;
+    }
+};
+
+/// Ring buffer of the events of one thread. Only the owning thread writes in it.
+struct ThreadBuffer
+{
+    ThreadBuffer(std::size_t capacity, std::size_t index)
+        : events(std::max<std::size_t>(capacity, 1)), threadIndex(index)
+    {}
+
+    std::vector<EventSlot> events;
+    std::atomic<std::uint64_t> head { 0 };  ///< total number of events written
+    std::atomic<std::uint64_t> first { 0 }; ///< index of the first event not discarded by clear()
+    std::size_t threadIndex;
+    std::string threadName;                 ///< protected by the registry mutex
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+    std::size_t capacity { 1 << 16 };
+
+    std::deque<std::string> names { std::string() };
+    std::unordered_map<std::string_view, std::uint32_t> ids { { std::string_view(), 0 } };
+};
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+/// The buffers are owned by the registry, so that the events of the threads which ended can still
+/// be exported
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local std::string t_threadName;
+
+ThreadBuffer& getThreadBuffer()
+{
+    if (!t_buffer)
+    {
+        Registry& registry = getRegistry();
+        const std::scoped_lock lock(registry.mutex);
+        registry.buffers.push_back(std::make_unique<ThreadBuffer>(registry.capacity, registry.buffers.size()));
+        t_buffer = registry.buffers.back().get();
+        t_buffer->threadName = t_threadName;
+    }
+    return *t_buffer;
+}
+
+void writeJsonString(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (const char c : str)
+    {
+        switch (c)
+        {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                }
+                else
+                {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+/// Enables the recorder at startup, and exports the trace at exit, if SOFA_TRACE_FILE is set
+struct EnvironmentTrace
+{
+    EnvironmentTrace()
+    {
+        getRegistry();
+        if (const char* capacity = std::getenv("SOFA_TRACE_CAPACITY"); capacity && *capacity)
+        {
+            TraceRecorder::setCapacity(static_cast<std::size_t>(std::atoll(capacity)));
+        }
+        if (const char* file = std::getenv("SOFA_TRACE_FILE"); file && *file)
+        {
+            filename = file;
+            TraceRecorder::setEnabled(true);
+        }
+    }
+    ~EnvironmentTrace()
+    {
+        if (!filename.empty())
+        {
+            TraceRecorder::setEnabled(false);
+            TraceRecorder::exportChromeTrace(filename);
+        }
+    }
+    std::string filename;
+};
+
+const EnvironmentTrace environmentTrace;
+
+} // anonymous namespace
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setCapacity(std::size_t nbEvents)
+{
+    Registry& registry = getRegistry();
+    const std::scoped_lock lock(registry.mutex);
+    registry.capacity = std::max<std::size_t>(nbEvents, 1);
+}
+
+std::size_t TraceRecorder::getCapacity()
+{
+    Registry& registry = getRegistry();
+    const std::scoped_lock lock(registry.mutex);
+    return registry.capacity;
+}
+
+void TraceRecorder::setThreadName(const std::string& name)
+{
+    // the buffer is only allocated when the thread records its first event
+    t_threadName = name;
+    if (t_buffer)
+    {
+        Registry& registry = getRegistry();
+        const std::scoped_lock lock(registry.mutex);
+        t_buffer->threadName = name;
+    }
+}
+
+std::uint32_t TraceRecorder::intern(std::string_view name)
+{
+    if (name.empty())
+        return 0;
+
+    // the keys of the cache point to the names stored in the registry, which are never moved
+    thread_local std::unordered_map<std::string_view, std::uint32_t> cache;
+    if (const auto it = cache.find(name); it != cache.end())
+        return it->second;
+
+    Registry& registry = getRegistry();
+    std::uint32_t id;
+    std::string_view stored;
+    {
+        const std::scoped_lock lock(registry.mutex);
+        if (const auto it = registry.ids.find(name); it != registry.ids.end())
+        {
+            stored = it->first;
+            id = it->second;
+        }
+        else
+        {
+            id = static_cast<std::uint32_t>(registry.names.size());
+            stored = registry.names.emplace_back(name);
+            registry.ids.emplace(stored, id);
+        }
+    }
+    cache.emplace(stored, id);
+    return id;
+}
+
+std::string TraceRecorder::getName(std::uint32_t id)
+{
+    Registry& registry = getRegistry();
+    const std::scoped_lock lock(registry.mutex);
+    return id < registry.names.size() ? registry.names[id] : std::string();
+}
+
+void TraceRecorder::record(TraceEvent::Phase phase, std::uint32_t name, std::uint32_t object, double value)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    TraceEvent event;
+    event.timestamp = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    event.name = name;
+    event.object = object;
+    event.value = value;
+    event.phase = phase;
+
+    const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % buffer.events.size()].write(head, event);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void TraceRecorder::begin(std::uint32_t name, std::uint32_t object)
+{
+    record(TraceEvent::Phase::Begin, name, object, 0);
+}
+
+void TraceRecorder::end(std::uint32_t name, std::uint32_t object)
+{
+    record(TraceEvent::Phase::End, name, object, 0);
+}
+
+void TraceRecorder::instant(std::uint32_t name, std::uint32_t object, double value)
+{
+    record(TraceEvent::Phase::Instant, name, object, value);
+}
+
+void TraceRecorder::counter(std::uint32_t name, double value)
+{
+    record(TraceEvent::Phase::Counter, name, 0, value);
+}
+
+std::vector<TraceRecorder::ThreadEvents> TraceRecorder::getEvents()
+{
+    Registry& registry = getRegistry();
+    const std::scoped_lock lock(registry.mutex);
+
+    std::vector<ThreadEvents> result;
+    result.reserve(registry.buffers.size());
+    for (const auto& buffer : registry.buffers)
+    {
+        const std::uint64_t capacity = buffer->events.size();
+        const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const std::uint64_t first = buffer->first.load(std::memory_order_relaxed);
+        const std::uint64_t oldest = head > capacity ? head - capacity : 0;
+        const std::uint64_t begin = std::max(first, oldest);
+
+        ThreadEvents& threadEvents = result.emplace_back();
+        threadEvents.threadIndex = buffer->threadIndex;
+        threadEvents.threadName = buffer->threadName;
+        threadEvents.events.reserve(head - begin);
+
+        // the events that the owning thread overwrites while they are copied are discarded
+        std::uint64_t nbLost = begin - first;
+        for (std::uint64_t i = begin; i < head; ++i)
+        {
+            TraceEvent event;
+            if (buffer->events[i % capacity].read(i, event))
+                threadEvents.events.push_back(event);
+            else
+                ++nbLost;
+        }
+        threadEvents.nbOverwritten = nbLost;
+    }
+    return result;
+}
+
+void TraceRecorder::clear()
+{
+    Registry& registry = getRegistry();
+    const std::scoped_lock lock(registry.mutex);
+    for (const auto& buffer : registry.buffers)
+    {
+        buffer->first.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void TraceRecorder::exportChromeTrace(std::ostream& out)
+{
+    const std::vector<ThreadEvents> threads = getEvents();
+
+    // names are resolved once, outside of the loop on the events
+    std::vector<std::string> names;
+    {
+        Registry& registry = getRegistry();
+        const std::scoped_lock lock(registry.mutex);
+        names.assign(registry.names.begin(), registry.names.end());
+    }
+    const auto getEventName = [&names](std::uint32_t id) -> const std::string&
+    {
+        static const std::string unknown("unknown");
+        return id < names.size() ? names[id] : unknown;
+    };
+
+    const auto flags = out.flags();
+    const auto precision = out.precision(17);
+    const auto fill = out.fill('0');
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool firstEvent = true;
+    const auto separator = [&out, &firstEvent]()
+    {
+        out << (firstEvent ? "\n" : ",\n");
+        firstEvent = false;
+    };
+
+    for (const ThreadEvents& thread : threads)
+    {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread.threadIndex << ",\"args\":{\"name\":";
+        writeJsonString(out, thread.threadName.empty() ? "Thread " + std::to_string(thread.threadIndex) : thread.threadName);
+        out << "}}";
+
+        // end events whose begin event has been overwritten are skipped
+        std::size_t depth = 0;
+        for (const TraceEvent& event : thread.events)
+        {
+            if (event.phase == TraceEvent::Phase::End)
+            {
+                if (depth == 0)
+                    continue;
+                --depth;
+            }
+            else if (event.phase == TraceEvent::Phase::Begin)
+            {
+                ++depth;
+            }
+
+            separator();
+            out << "{\"name\":";
+            writeJsonString(out, getEventName(event.name));
+            out << ",\"cat\":\"sofa\",\"ph\":";
+            switch (event.phase)
+            {
+                case TraceEvent::Phase::Begin:   out << "\"B\""; break;
+                case TraceEvent::Phase::End:     out << "\"E\""; break;
+                case TraceEvent::Phase::Instant: out << "\"i\",\"s\":\"t\""; break;
+                case TraceEvent::Phase::Counter: out << "\"C\""; break;
+            }
+            // timestamps are in microseconds
+            out << ",\"ts\":" << event.timestamp / 1000 << '.' << std::setw(3) << event.timestamp % 1000
+                << ",\"pid\":0,\"tid\":" << thread.threadIndex;
+
+            if (event.phase == TraceEvent::Phase::Counter || event.phase == TraceEvent::Phase::Instant)
+            {
+                // NaN and infinity are not valid JSON numbers
+                out << ",\"args\":{\"value\":";
+                if (std::isfinite(event.value))
+                    out << event.value;
+                else
+                    out << "null";
+                if (event.object)
+                {
+                    out << ",\"object\":";
+                    writeJsonString(out, getEventName(event.object));
+                }
+                out << "}";
+            }
+            else if (event.object)
+            {
+                out << ",\"args\":{\"object\":";
+                writeJsonString(out, getEventName(event.object));
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+    out.fill(fill);
+}
+
+bool TraceRecorder::exportChromeTrace(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    exportChromeTrace(file);
+    return file.good();
+}
+
+} // namespace sofa::helper
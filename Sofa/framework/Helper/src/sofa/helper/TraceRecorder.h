@@ -0,0 +1,137 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sofa::helper
+{
+
+/// Event recorded by the TraceRecorder. Names are interned, so that an event is a small trivially
+/// copyable structure written in a ring buffer without any allocation.
+struct TraceEvent
+{
+    enum class Phase : std::uint8_t { Begin, End, Instant, Counter };
+
+    std::uint64_t timestamp { 0 }; ///< nanoseconds elapsed since the recorder was loaded
+    std::uint32_t name { 0 };      ///< interned name of the step, timer or value
+    std::uint32_t object { 0 };    ///< interned name of the object the event refers to, 0 if none
+    double value { 0 };            ///< value of the counters
+    Phase phase { Phase::Instant };
+};
+
+/**
+ * Low-overhead event recorder, used as the tracing backend of AdvancedTimer.
+ *
+ * Each thread writes its events in its own fixed-size ring buffer: once the names are interned,
+ * recording an event neither locks nor allocates, and the oldest events are overwritten when
+ * the buffer is full. Recording is therefore possible from any thread, including the workers of
+ * the task scheduler, and cheap enough to stay enabled during production runs.
+ *
+ * The events are exported in the Chrome trace-event JSON format, which can be opened in
+ * chrome://tracing or https://ui.perfetto.dev, with one lane per thread.
+ *
+ * Tracing is enabled with setEnabled(true), or at startup by setting the environment variable
+ * SOFA_TRACE_FILE: the trace is then written in this file when the program exits.
+ * The capacity of the buffers can be set with the environment variable SOFA_TRACE_CAPACITY.
+ */
+class SOFA_HELPER_API TraceRecorder
+{
+public:
+    /// Events stored for one thread, oldest first
+    struct ThreadEvents
+    {
+        std::size_t threadIndex { 0 };
+        std::string threadName;
+        std::vector<TraceEvent> events;
+        std::uint64_t nbOverwritten { 0 }; ///< number of events lost because the buffer was full
+    };
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    /// Number of events kept per thread. It applies to the threads that did not record any event yet.
+    static void setCapacity(std::size_t nbEvents);
+    static std::size_t getCapacity();
+
+    /// Name of the lane of the calling thread in the exported trace
+    static void setThreadName(const std::string& name);
+
+    /// Id of the name, registered on first use. The ids are shared by all the threads, and 0 is
+    /// the id of the empty name.
+    static std::uint32_t intern(std::string_view name);
+    static std::string getName(std::uint32_t id);
+
+    static void begin(std::uint32_t name, std::uint32_t object = 0);
+    static void end(std::uint32_t name, std::uint32_t object = 0);
+    static void instant(std::uint32_t name, std::uint32_t object = 0, double value = 0);
+    static void counter(std::uint32_t name, double value);
+
+    /// Copy of the events currently stored by all the threads.
+    /// Events recorded concurrently to this call may be missing from the copy, and the events
+    /// overwritten while they are copied are counted in nbOverwritten instead of being torn.
+    static std::vector<ThreadEvents> getEvents();
+
+    /// Discard all the events recorded so far
+    static void clear();
+
+    static void exportChromeTrace(std::ostream& out);
+    static bool exportChromeTrace(const std::string& filename);
+
+    /// Scoped (RAII) begin/end pair of events
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(std::uint32_t name, std::uint32_t object = 0)
+            : m_name(name), m_object(object), m_recorded(isEnabled())
+        {
+            if (m_recorded)
+                begin(m_name, m_object);
+        }
+        ~ScopedEvent()
+        {
+            if (m_recorded)
+                end(m_name, m_object);
+        }
+        ScopedEvent(const ScopedEvent&) = delete;
+        ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+    private:
+        std::uint32_t m_name;
+        std::uint32_t m_object;
+        bool m_recorded;
+    };
+
+protected:
+    static void record(TraceEvent::Phase phase, std::uint32_t name, std::uint32_t object, double value);
+
+    static std::atomic<bool> s_enabled;
+};
+
+} // namespace sofa::helper
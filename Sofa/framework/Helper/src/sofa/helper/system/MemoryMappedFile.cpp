@@ -0,0 +1,150 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/system/MemoryMappedFile.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#ifdef WIN32
+# include <Windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace sofa::helper::system
+{
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename)
+{
+    open(filename);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+#ifdef WIN32
+
+bool MemoryMappedFile::open(const std::string& filename)
+{
+    close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        msg_error("MemoryMappedFile") << "Cannot open the file " << filename;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        msg_error("MemoryMappedFile") << "Cannot map the empty file " << filename;
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        msg_error("MemoryMappedFile") << "Cannot map the file " << filename;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = data;
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    m_filename = filename;
+    return true;
+}
+
+void MemoryMappedFile::close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_filename.clear();
+}
+
+#else
+
+bool MemoryMappedFile::open(const std::string& filename)
+{
+    close();
+
+    const int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        msg_error("MemoryMappedFile") << "Cannot open the file " << filename;
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        msg_error("MemoryMappedFile") << "Cannot map the empty file " << filename;
+        ::close(file);
+        return false;
+    }
+
+    // the mapping stays valid after the file descriptor is closed
+    void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED)
+    {
+        msg_error("MemoryMappedFile") << "Cannot map the file " << filename;
+        return false;
+    }
+
+    m_data = data;
+    m_size = static_cast<std::size_t>(status.st_size);
+    m_filename = filename;
+    return true;
+}
+
+void MemoryMappedFile::close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<void*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_filename.clear();
+}
+
+#endif
+
+} // namespace sofa::helper::system
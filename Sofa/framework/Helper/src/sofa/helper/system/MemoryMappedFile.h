@@ -0,0 +1,68 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+#include <string>
+
+namespace sofa::helper::system
+{
+
+/**
+   @brief Read-only memory mapping of a file.
+
+   The pages of the file are loaded lazily by the operating system when they are accessed, and they are shared
+   between all the mappings of the same file, within a process or across processes.
+*/
+class SOFA_HELPER_API MemoryMappedFile
+{
+public:
+    MemoryMappedFile() = default;
+    explicit MemoryMappedFile(const std::string& filename);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /// Map the whole file, after unmapping the previous one. Returns false in case of failure.
+    bool open(const std::string& filename);
+
+    /// Unmap the file
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    const void* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    const std::string& filename() const { return m_filename; }
+
+private:
+    const void* m_data { nullptr };
+    std::size_t m_size { 0 };
+    std::string m_filename;
+#ifdef WIN32
+    void* m_file { nullptr };
+    void* m_mapping { nullptr };
+#endif
+};
+
+} // namespace sofa::helper::system
@@ -0,0 +1,68 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/NumberParser.h>
+#include <gtest/gtest.h>
+
+namespace sofa
+{
+
+TEST(NumberParser, integers)
+{
+    std::vector<int> values;
+    EXPECT_TRUE(helper::parseNumbers("1 -2\t3\n  42 ", values));
+    EXPECT_EQ(values, std::vector<int>({1, -2, 3, 42}));
+
+    EXPECT_TRUE(helper::parseNumbers("", values));
+    EXPECT_TRUE(values.empty());
+
+    EXPECT_TRUE(helper::parseNumbers("   ", values));
+    EXPECT_TRUE(values.empty());
+}
+
+TEST(NumberParser, reals)
+{
+    std::vector<double> values;
+    EXPECT_TRUE(helper::parseNumbers("0.5 -1e-3 2 .25", values));
+    ASSERT_EQ(values.size(), 4u);
+    EXPECT_DOUBLE_EQ(values[0], 0.5);
+    EXPECT_DOUBLE_EQ(values[1], -1e-3);
+    EXPECT_DOUBLE_EQ(values[2], 2.0);
+    EXPECT_DOUBLE_EQ(values[3], 0.25);
+}
+
+TEST(NumberParser, rejectedTokens)
+{
+    std::vector<int> integers;
+    EXPECT_FALSE(helper::parseNumbers("1 2-5", integers));
+    EXPECT_FALSE(helper::parseNumbers("1 a", integers));
+    EXPECT_FALSE(helper::parseNumbers("+1", integers));
+    EXPECT_FALSE(helper::parseNumbers("1.5", integers));
+    EXPECT_FALSE(helper::parseNumbers("99999999999", integers));
+
+    std::vector<unsigned int> unsignedIntegers;
+    EXPECT_FALSE(helper::parseNumbers("-1", unsignedIntegers));
+
+    std::vector<double> reals;
+    EXPECT_FALSE(helper::parseNumbers("1,5", reals));
+}
+
+}
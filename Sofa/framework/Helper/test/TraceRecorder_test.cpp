@@ -0,0 +1,239 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/helper/TraceRecorder.h>
+
+#include <atomic>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+using sofa::helper::TraceRecorder;
+using sofa::helper::TraceEvent;
+
+namespace
+{
+
+struct TraceRecorder_test : public ::testing::Test
+{
+    void SetUp() override
+    {
+        TraceRecorder::clear();
+        TraceRecorder::setEnabled(true);
+    }
+    void TearDown() override
+    {
+        TraceRecorder::setEnabled(false);
+        TraceRecorder::clear();
+    }
+
+    /// Events recorded by the calling thread
+    static std::vector<TraceEvent> getEvents(const std::string& threadName)
+    {
+        for (const auto& thread : TraceRecorder::getEvents())
+        {
+            if (thread.threadName == threadName)
+                return thread.events;
+        }
+        return {};
+    }
+};
+
+TEST_F(TraceRecorder_test, intern)
+{
+    EXPECT_EQ(TraceRecorder::intern(""), 0u);
+
+    const auto id = TraceRecorder::intern("TraceRecorder_test::intern");
+    EXPECT_NE(id, 0u);
+    EXPECT_EQ(TraceRecorder::intern(std::string("TraceRecorder_test::intern")), id);
+    EXPECT_EQ(TraceRecorder::getName(id), "TraceRecorder_test::intern");
+
+    // ids are shared by all the threads
+    std::uint32_t otherThreadId = 0;
+    std::thread([&otherThreadId] { otherThreadId = TraceRecorder::intern("TraceRecorder_test::intern"); }).join();
+    EXPECT_EQ(otherThreadId, id);
+}
+
+TEST_F(TraceRecorder_test, record)
+{
+    TraceRecorder::setThreadName("TraceRecorder_test::record");
+    const auto step = TraceRecorder::intern("step");
+    const auto object = TraceRecorder::intern("object");
+    const auto value = TraceRecorder::intern("value");
+
+    {
+        TraceRecorder::ScopedEvent event(step, object);
+        TraceRecorder::counter(value, 42);
+    }
+
+    const auto events = getEvents("TraceRecorder_test::record");
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].phase, TraceEvent::Phase::Begin);
+    EXPECT_EQ(events[0].name, step);
+    EXPECT_EQ(events[0].object, object);
+    EXPECT_EQ(events[1].phase, TraceEvent::Phase::Counter);
+    EXPECT_EQ(events[1].value, 42);
+    EXPECT_EQ(events[2].phase, TraceEvent::Phase::End);
+    EXPECT_LE(events[0].timestamp, events[1].timestamp);
+    EXPECT_LE(events[1].timestamp, events[2].timestamp);
+
+    TraceRecorder::clear();
+    EXPECT_TRUE(getEvents("TraceRecorder_test::record").empty());
+
+    // nothing is recorded when the recorder is disabled
+    TraceRecorder::setEnabled(false);
+    {
+        TraceRecorder::ScopedEvent event(step);
+    }
+    EXPECT_TRUE(getEvents("TraceRecorder_test::record").empty());
+}
+
+TEST_F(TraceRecorder_test, ringBuffer)
+{
+    const auto capacity = TraceRecorder::getCapacity();
+    TraceRecorder::setCapacity(16);
+
+    // the capacity applies to the threads which did not record yet
+    std::thread([]
+    {
+        TraceRecorder::setThreadName("TraceRecorder_test::ringBuffer");
+        for (unsigned int i = 0; i < 100; ++i)
+        {
+            TraceRecorder::instant(TraceRecorder::intern("instant"), 0, i);
+        }
+    }).join();
+    TraceRecorder::setCapacity(capacity);
+
+    bool found = false;
+    for (const auto& thread : TraceRecorder::getEvents())
+    {
+        if (thread.threadName == "TraceRecorder_test::ringBuffer")
+        {
+            found = true;
+            ASSERT_EQ(thread.events.size(), 16u);
+            EXPECT_EQ(thread.nbOverwritten, 84u);
+            EXPECT_EQ(thread.events.front().value, 84);
+            EXPECT_EQ(thread.events.back().value, 99);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST_F(TraceRecorder_test, concurrentRead)
+{
+    const auto capacity = TraceRecorder::getCapacity();
+    TraceRecorder::setCapacity(16);
+
+    // the recording thread overwrites its small buffer while the events are copied: each copied
+    // event must be one that was recorded, not a mix of two of them
+    std::atomic<bool> recording { true };
+    std::thread recorder([&recording]
+    {
+        TraceRecorder::setThreadName("TraceRecorder_test::concurrentRead");
+        const auto instant = TraceRecorder::intern("instant");
+        for (std::uint32_t i = 0; i < 200000; ++i)
+        {
+            TraceRecorder::instant(instant, i, i);
+        }
+        recording = false;
+    });
+
+    std::size_t nbRead = 0;
+    std::size_t nbInvalid = 0;
+    do
+    {
+        for (const auto& thread : TraceRecorder::getEvents())
+        {
+            if (thread.threadName != "TraceRecorder_test::concurrentRead")
+                continue;
+
+            double previous = -1;
+            for (const TraceEvent& event : thread.events)
+            {
+                const bool valid = event.phase == TraceEvent::Phase::Instant
+                        && static_cast<double>(event.object) == event.value
+                        && previous < event.value;
+                nbInvalid += !valid;
+                previous = event.value;
+            }
+            EXPECT_LE(thread.events.size(), 16u);
+            nbRead += thread.events.size();
+        }
+    } while (recording);
+    recorder.join();
+    TraceRecorder::setCapacity(capacity);
+
+    EXPECT_GT(nbRead, 0u);
+    EXPECT_EQ(nbInvalid, 0u);
+}
+
+TEST_F(TraceRecorder_test, exportNonFiniteValues)
+{
+    TraceRecorder::setThreadName("TraceRecorder_test::exportNonFiniteValues");
+    TraceRecorder::counter(TraceRecorder::intern("nan counter"), std::numeric_limits<double>::quiet_NaN());
+    TraceRecorder::counter(TraceRecorder::intern("inf counter"), std::numeric_limits<double>::infinity());
+    TraceRecorder::instant(TraceRecorder::intern("finite instant"), 0, 0.5);
+
+    std::ostringstream out;
+    TraceRecorder::exportChromeTrace(out);
+    const std::string trace = out.str();
+
+    // NaN and infinity are not valid JSON numbers
+    const auto valueOf = [&trace](const std::string& name)
+    {
+        const auto pos = trace.find("\"value\":", trace.find("\"name\":\"" + name + "\""));
+        return pos == std::string::npos ? std::string() : trace.substr(pos + 8, 4);
+    };
+    EXPECT_EQ(valueOf("nan counter"), "null");
+    EXPECT_EQ(valueOf("inf counter"), "null");
+    EXPECT_EQ(valueOf("finite instant").substr(0, 3), "0.5");
+}
+
+TEST_F(TraceRecorder_test, exportChromeTrace)
+{
+    TraceRecorder::setThreadName("TraceRecorder_test::\"export\"");
+    const auto step = TraceRecorder::intern("exported step");
+
+    // an end event without its begin event is not exported
+    TraceRecorder::end(step);
+    TraceRecorder::begin(step);
+    TraceRecorder::end(step);
+
+    std::ostringstream out;
+    TraceRecorder::exportChromeTrace(out);
+    const std::string trace = out.str();
+
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"TraceRecorder_test::\\\"export\\\"\"}"), std::string::npos);
+
+    std::size_t nbBegin = 0, nbEnd = 0;
+    for (std::size_t pos = 0; (pos = trace.find("\"name\":\"exported step\",\"cat\":\"sofa\",\"ph\":\"", pos)) != std::string::npos; ++pos)
+    {
+        const char phase = trace[trace.find("\"ph\":\"", pos) + 6];
+        nbBegin += phase == 'B';
+        nbEnd += phase == 'E';
+    }
+    EXPECT_EQ(nbBegin, 1u);
+    EXPECT_EQ(nbEnd, 1u);
+}
+
+} // namespace
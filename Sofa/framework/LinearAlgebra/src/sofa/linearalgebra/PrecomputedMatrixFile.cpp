@@ -0,0 +1,286 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_LINEARALGEBRA_PRECOMPUTEDMATRIXFILE_CPP
+#include <sofa/linearalgebra/PrecomputedMatrixFile.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace sofa::linearalgebra
+{
+
+namespace
+{
+constexpr char fileTag[16] = { 'S','O','F','A','_','P','R','E','C','O','M','P','U','T','E','D' };
+
+template<class Scalar, class Real>
+void writeValues(std::ofstream& file, const Real* values, std::size_t count)
+{
+    if constexpr (std::is_same_v<Scalar, Real>)
+    {
+        file.write(reinterpret_cast<const char*>(values), std::streamsize(count * sizeof(Scalar)));
+    }
+    else
+    {
+        const std::vector<Scalar> converted(values, values + count);
+        file.write(reinterpret_cast<const char*>(converted.data()), std::streamsize(count * sizeof(Scalar)));
+    }
+}
+
+template<class Scalar, class Real>
+bool writeMatrix(std::ofstream& file, const Real* data, std::size_t nbRows, std::size_t nbCols, const PrecomputedMatrixFile::Options& options)
+{
+    using Matrix = Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    using MatrixMap = Eigen::Map<const Matrix, Eigen::Unaligned, Eigen::OuterStride<> >;
+
+    const std::size_t blockSize = options.blockSize;
+    if (blockSize == 0)
+    {
+        writeValues<Scalar>(file, data, nbRows * nbCols);
+        return file.good();
+    }
+
+    const std::size_t nbBlockRows = (nbRows + blockSize - 1) / blockSize;
+    const std::size_t nbBlockCols = (nbCols + blockSize - 1) / blockSize;
+
+    // the table of blocks is written once all the blocks are compressed
+    const std::streampos tablePosition = file.tellp();
+    std::vector<std::uint64_t> table(2 * nbBlockRows * nbBlockCols, 0);
+    file.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(std::uint64_t)));
+
+    const Real maxValue = MatrixMap(data, Eigen::Index(nbRows), Eigen::Index(nbCols), Eigen::OuterStride<>(Eigen::Index(nbCols))).cwiseAbs().maxCoeff();
+    const Real threshold = Real(options.tolerance) * maxValue;
+
+    std::uint64_t offset = 0;
+    Matrix values;
+    for (std::size_t bi = 0; bi < nbBlockRows; ++bi)
+    {
+        for (std::size_t bj = 0; bj < nbBlockCols; ++bj)
+        {
+            const std::size_t rows = std::min(blockSize, nbRows - bi * blockSize);
+            const std::size_t cols = std::min(blockSize, nbCols - bj * blockSize);
+            const MatrixMap block(data + bi * blockSize * nbCols + bj * blockSize, Eigen::Index(rows), Eigen::Index(cols), Eigen::OuterStride<>(Eigen::Index(nbCols)));
+
+            std::int64_t rank = -1;
+            if (bi != bj)
+            {
+                const Eigen::JacobiSVD<Matrix> svd(block, Eigen::ComputeThinU | Eigen::ComputeThinV);
+                const auto& singularValues = svd.singularValues();
+                Eigen::Index k = 0;
+                while (k < singularValues.size() && singularValues(k) > threshold)
+                {
+                    ++k;
+                }
+
+                if (std::size_t(k) * (rows + cols) < rows * cols)
+                {
+                    rank = k;
+                    values.resize(Eigen::Index(rows + cols), k);
+                    values.topRows(Eigen::Index(rows)) = svd.matrixU().leftCols(k) * singularValues.head(k).asDiagonal();
+                    values.bottomRows(Eigen::Index(cols)) = svd.matrixV().leftCols(k);
+                }
+            }
+            if (rank < 0)
+            {
+                values = block;
+            }
+
+            table[2 * (bi * nbBlockCols + bj)] = offset;
+            table[2 * (bi * nbBlockCols + bj) + 1] = static_cast<std::uint64_t>(rank);
+            writeValues<Scalar>(file, values.data(), std::size_t(values.size()));
+            offset += std::uint64_t(values.size());
+        }
+    }
+
+    file.seekp(tablePosition);
+    file.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(std::uint64_t)));
+    return file.good();
+}
+}
+
+template<class Real>
+bool PrecomputedMatrixFile::write(const std::string& filename, const Real* data, Index nbRows, Index nbCols, const Options& options)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        msg_error("PrecomputedMatrixFile") << "Cannot write the file " << filename;
+        return false;
+    }
+
+    Header header {};
+    std::memcpy(header.tag, fileTag, sizeof(fileTag));
+    header.version = s_version;
+    header.scalarSize = options.singlePrecision ? sizeof(float) : sizeof(double);
+    header.nbRows = nbRows;
+    header.nbCols = nbCols;
+    header.blockSize = options.blockSize;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const bool written = options.singlePrecision
+        ? writeMatrix<float>(file, data, nbRows, nbCols, options)
+        : writeMatrix<double>(file, data, nbRows, nbCols, options);
+
+    if (!written)
+    {
+        msg_error("PrecomputedMatrixFile") << "Failed to write the file " << filename;
+    }
+    return written;
+}
+
+template SOFA_LINEARALGEBRA_API bool PrecomputedMatrixFile::write<float>(const std::string&, const float*, Index, Index, const Options&);
+template SOFA_LINEARALGEBRA_API bool PrecomputedMatrixFile::write<double>(const std::string&, const double*, Index, Index, const Options&);
+
+bool PrecomputedMatrixFile::hasFileTag(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    char tag[sizeof(fileTag)] {};
+    file.read(tag, sizeof(tag));
+    return file.good() && std::memcmp(tag, fileTag, sizeof(fileTag)) == 0;
+}
+
+bool PrecomputedMatrixFile::hasValidHeader(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    Header header {};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return file.good() && std::memcmp(header.tag, fileTag, sizeof(fileTag)) == 0 && header.version == s_version
+        && (header.scalarSize == sizeof(float) || header.scalarSize == sizeof(double));
+}
+
+bool PrecomputedMatrixFile::open(const std::string& filename)
+{
+    close();
+
+    if (!hasValidHeader(filename) || !m_file.open(filename) || m_file.size() < sizeof(Header))
+    {
+        msg_error("PrecomputedMatrixFile") << "The file " << filename << " does not contain a precomputed matrix";
+        m_file.close();
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(m_file.data());
+    const Header* header = reinterpret_cast<const Header*>(bytes);
+    const char* values = bytes + sizeof(Header);
+
+    // all the sizes read from the file are checked against the size of the file, without overflow
+    const auto multiply = [](std::uint64_t a, std::uint64_t b, std::uint64_t& product)
+    {
+        if (b != 0 && a > std::numeric_limits<std::uint64_t>::max() / b)
+            return false;
+        product = a * b;
+        return true;
+    };
+
+    std::uint64_t payloadSize = m_file.size() - sizeof(Header);
+    bool valid = true;
+
+    if (header->blockSize == 0)
+    {
+        std::uint64_t nbValues = 0;
+        valid = multiply(header->nbRows, header->nbCols, nbValues) && nbValues <= payloadSize / header->scalarSize;
+    }
+    else
+    {
+        const std::uint64_t blockSize = header->blockSize;
+        const std::uint64_t nbBlockRows = header->nbRows / blockSize + (header->nbRows % blockSize != 0);
+        const std::uint64_t nbBlockCols = header->nbCols / blockSize + (header->nbCols % blockSize != 0);
+
+        std::uint64_t nbBlocks = 0;
+        std::uint64_t tableSize = 0;
+        valid = multiply(nbBlockRows, nbBlockCols, nbBlocks) && multiply(nbBlocks, sizeof(Block), tableSize)
+            && tableSize <= payloadSize;
+
+        if (valid)
+        {
+            m_blocks = reinterpret_cast<const Block*>(values);
+            m_nbBlockCols = nbBlockCols;
+            values += tableSize;
+            payloadSize -= tableSize;
+
+            // each block must be entirely inside the file
+            const std::uint64_t nbPayloadValues = payloadSize / header->scalarSize;
+            for (std::uint64_t bi = 0; bi < nbBlockRows && valid; ++bi)
+            {
+                const std::uint64_t rows = std::min(blockSize, header->nbRows - bi * blockSize);
+                for (std::uint64_t bj = 0; bj < nbBlockCols && valid; ++bj)
+                {
+                    const std::uint64_t cols = std::min(blockSize, header->nbCols - bj * blockSize);
+                    const Block& block = m_blocks[bi * nbBlockCols + bj];
+
+                    std::uint64_t nbValues = 0;
+                    if (block.rank < 0)
+                    {
+                        valid = multiply(rows, cols, nbValues);
+                    }
+                    else
+                    {
+                        valid = std::uint64_t(block.rank) <= std::min(rows, cols)
+                            && multiply(std::uint64_t(block.rank), rows + cols, nbValues);
+                    }
+                    valid = valid && block.offset <= nbPayloadValues && nbValues <= nbPayloadValues - block.offset;
+                }
+            }
+        }
+    }
+
+    if (!valid)
+    {
+        msg_error("PrecomputedMatrixFile") << "The file " << filename << " is truncated or corrupted";
+        close();
+        return false;
+    }
+
+    m_header = header;
+    m_values = values;
+    return true;
+}
+
+void PrecomputedMatrixFile::close()
+{
+    m_file.close();
+    m_header = nullptr;
+    m_blocks = nullptr;
+    m_values = nullptr;
+    m_nbBlockCols = 0;
+}
+
+void PrecomputedMatrixFile::getRow(Index i, Index j, Index count, SReal* values) const
+{
+    if (const double* d = data<double>())
+    {
+        std::copy_n(d + i * m_header->nbCols + j, count, values);
+        return;
+    }
+    for (Index k = 0; k < count; ++k)
+    {
+        values[k] = element(i, j + k);
+    }
+}
+
+} // namespace sofa::linearalgebra
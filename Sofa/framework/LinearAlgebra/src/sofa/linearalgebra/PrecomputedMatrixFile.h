@@ -0,0 +1,171 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/linearalgebra/config.h>
+
+#include <sofa/helper/system/MemoryMappedFile.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace sofa::linearalgebra
+{
+
+/**
+ * Dense matrix precomputed once and stored in a file, read through a memory mapping.
+ *
+ * The file is never loaded as a whole: the pages holding the accessed values are loaded on demand, and they are
+ * shared by all the instances mapping the same file, in the same process or in other processes.
+ * The values can be stored in single precision, and the matrix can be compressed by blocks: the diagonal blocks
+ * are stored as dense blocks, while the other blocks are replaced by a low-rank approximation U*V^T when it is
+ * smaller. The far-field blocks of compliance matrices, coupling distant degrees of freedom, are smooth and
+ * typically have a very low rank.
+ */
+class SOFA_LINEARALGEBRA_API PrecomputedMatrixFile
+{
+public:
+    using Index = std::size_t;
+
+    struct Options
+    {
+        /// Store the values as float instead of double
+        bool singlePrecision { false };
+
+        /// Size of the compressed blocks (0 for no compression)
+        Index blockSize { 0 };
+
+        /// Singular values of a block under tolerance * (largest absolute value of the matrix) are dropped
+        SReal tolerance { 0 };
+    };
+
+    /// Write a dense row-major matrix. Returns false in case of failure.
+    template<class Real>
+    static bool write(const std::string& filename, const Real* data, Index nbRows, Index nbCols, const Options& options);
+
+    /// Returns true if the file starts with the tag of PrecomputedMatrixFile, whether it is valid or not
+    static bool hasFileTag(const std::string& filename);
+
+    /// Returns true if the file has been written by a supported version of PrecomputedMatrixFile
+    static bool hasValidHeader(const std::string& filename);
+
+    /// Map the file. Returns false in case of failure, or if the file is truncated or corrupted.
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    Index rowSize() const { return m_header ? Index(m_header->nbRows) : 0; }
+    Index colSize() const { return m_header ? Index(m_header->nbCols) : 0; }
+    bool isSinglePrecision() const { return m_header && m_header->scalarSize == sizeof(float); }
+    bool isCompressed() const { return m_header && m_header->blockSize != 0; }
+
+    /// Size of the file, in bytes
+    std::size_t storageSize() const { return m_file.size(); }
+
+    /// The values, row by row, if they are stored as a non compressed matrix of Real. nullptr otherwise.
+    template<class Real>
+    const Real* data() const
+    {
+        return (m_header && m_header->blockSize == 0 && m_header->scalarSize == sizeof(Real)) ? static_cast<const Real*>(m_values) : nullptr;
+    }
+
+    /// Value of the entry (i,j), whatever the storage
+    SReal element(Index i, Index j) const
+    {
+        return m_header->scalarSize == sizeof(float) ? element<float>(i, j) : element<double>(i, j);
+    }
+
+    /// Values of the entries (i,j) to (i,j+count-1)
+    void getRow(Index i, Index j, Index count, SReal* values) const;
+
+protected:
+    struct Header
+    {
+        char tag[16];
+        std::uint32_t version;
+        std::uint32_t scalarSize;
+        std::uint64_t nbRows;
+        std::uint64_t nbCols;
+        std::uint64_t blockSize;
+        std::uint64_t reserved[2];
+    };
+
+    /// Storage of a block of a compressed matrix
+    struct Block
+    {
+        std::uint64_t offset; ///< position of the first value of the block, in number of values
+        std::int64_t rank;    ///< rank of the approximation, or -1 for a dense block
+    };
+
+    static constexpr std::uint32_t s_version = 1;
+
+    template<class Scalar>
+    SReal element(Index i, Index j) const;
+
+    helper::system::MemoryMappedFile m_file;
+    const Header* m_header { nullptr };
+    const Block* m_blocks { nullptr };
+    const void* m_values { nullptr };
+    Index m_nbBlockCols { 0 };
+};
+
+template<class Scalar>
+SReal PrecomputedMatrixFile::element(Index i, Index j) const
+{
+    const Scalar* values = static_cast<const Scalar*>(m_values);
+    const Index blockSize = Index(m_header->blockSize);
+    if (blockSize == 0)
+    {
+        return SReal(values[i * m_header->nbCols + j]);
+    }
+
+    const Index bi = i / blockSize;
+    const Index bj = j / blockSize;
+    const Index li = i - bi * blockSize;
+    const Index lj = j - bj * blockSize;
+    const Block& block = m_blocks[bi * m_nbBlockCols + bj];
+    const Scalar* blockValues = values + block.offset;
+
+    if (block.rank < 0)
+    {
+        const Index nbCols = std::min<Index>(blockSize, Index(m_header->nbCols) - bj * blockSize);
+        return SReal(blockValues[li * nbCols + lj]);
+    }
+
+    // U (rows x rank) followed by V (cols x rank)
+    const Index rank = Index(block.rank);
+    const Index nbRows = std::min<Index>(blockSize, Index(m_header->nbRows) - bi * blockSize);
+    const Scalar* u = blockValues + li * rank;
+    const Scalar* v = blockValues + nbRows * rank + lj * rank;
+    SReal value = 0;
+    for (Index k = 0; k < rank; ++k)
+    {
+        value += SReal(u[k]) * SReal(v[k]);
+    }
+    return value;
+}
+
+#if !defined(SOFA_LINEARALGEBRA_PRECOMPUTEDMATRIXFILE_CPP)
+extern template SOFA_LINEARALGEBRA_API bool PrecomputedMatrixFile::write<float>(const std::string&, const float*, Index, Index, const Options&);
+extern template SOFA_LINEARALGEBRA_API bool PrecomputedMatrixFile::write<double>(const std::string&, const double*, Index, Index, const Options&);
+#endif
+
+} // namespace sofa::linearalgebra
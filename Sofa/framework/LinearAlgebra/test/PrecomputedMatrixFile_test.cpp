@@ -0,0 +1,168 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/linearalgebra/PrecomputedMatrixFile.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace sofa
+{
+
+using sofa::linearalgebra::PrecomputedMatrixFile;
+
+class PrecomputedMatrixFile_test : public ::testing::Test
+{
+public:
+    static constexpr std::size_t n = 50;
+
+    void SetUp() override
+    {
+        filename = (std::filesystem::temp_directory_path() / "PrecomputedMatrixFile_test.mcomp").string();
+
+        // smooth symmetric kernel, similar to a compliance matrix: low-rank far from the diagonal
+        matrix.resize(n * n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                matrix[i * n + j] = 1.0 / (1.0 + std::abs(double(i) - double(j)));
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(filename);
+    }
+
+    /// Write the matrix with the given options, map it and returns the largest error
+    SReal roundTrip(const PrecomputedMatrixFile::Options& options, PrecomputedMatrixFile& file)
+    {
+        EXPECT_TRUE(PrecomputedMatrixFile::write(filename, matrix.data(), n, n, options));
+        EXPECT_TRUE(PrecomputedMatrixFile::hasValidHeader(filename));
+        EXPECT_TRUE(file.open(filename));
+        EXPECT_EQ(file.rowSize(), n);
+        EXPECT_EQ(file.colSize(), n);
+
+        SReal error = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                error = std::max(error, SReal(std::abs(file.element(i, j) - matrix[i * n + j])));
+            }
+        }
+
+        std::vector<SReal> row(n - 5);
+        file.getRow(7, 5, row.size(), row.data());
+        for (std::size_t j = 0; j < row.size(); ++j)
+        {
+            error = std::max(error, SReal(std::abs(row[j] - matrix[7 * n + 5 + j])));
+        }
+        return error;
+    }
+
+    std::string filename;
+    std::vector<double> matrix;
+};
+
+TEST_F(PrecomputedMatrixFile_test, dense)
+{
+    PrecomputedMatrixFile file;
+    EXPECT_EQ(roundTrip({}, file), 0);
+    EXPECT_FALSE(file.isCompressed());
+    EXPECT_FALSE(file.isSinglePrecision());
+    ASSERT_NE(file.data<double>(), nullptr);
+    EXPECT_EQ(file.data<double>()[3 * n + 4], matrix[3 * n + 4]);
+    EXPECT_EQ(file.data<float>(), nullptr);
+}
+
+TEST_F(PrecomputedMatrixFile_test, singlePrecision)
+{
+    PrecomputedMatrixFile::Options options;
+    options.singlePrecision = true;
+
+    PrecomputedMatrixFile file;
+    EXPECT_LT(roundTrip(options, file), 1e-6);
+    EXPECT_TRUE(file.isSinglePrecision());
+    EXPECT_NE(file.data<float>(), nullptr);
+    EXPECT_EQ(file.data<double>(), nullptr);
+    EXPECT_LT(file.storageSize(), n * n * sizeof(double));
+}
+
+TEST_F(PrecomputedMatrixFile_test, compressed)
+{
+    PrecomputedMatrixFile::Options options;
+    options.blockSize = 8;
+    options.tolerance = 1e-6;
+
+    PrecomputedMatrixFile file;
+    EXPECT_LT(roundTrip(options, file), 1e-5);
+    EXPECT_TRUE(file.isCompressed());
+    EXPECT_EQ(file.data<double>(), nullptr);
+}
+
+TEST_F(PrecomputedMatrixFile_test, invalidFile)
+{
+    PrecomputedMatrixFile file;
+    EXPECT_FALSE(PrecomputedMatrixFile::hasFileTag(filename));
+    EXPECT_FALSE(PrecomputedMatrixFile::hasValidHeader(filename));
+    EXPECT_FALSE(file.open(filename));
+    EXPECT_FALSE(file.isOpen());
+}
+
+TEST_F(PrecomputedMatrixFile_test, truncatedCompressedFile)
+{
+    PrecomputedMatrixFile::Options options;
+    options.blockSize = 8;
+    options.tolerance = 1e-6;
+    ASSERT_TRUE(PrecomputedMatrixFile::write(filename, matrix.data(), n, n, options));
+
+    // the table of blocks is complete, but not the values of the last blocks
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - sizeof(double));
+
+    PrecomputedMatrixFile file;
+    EXPECT_TRUE(PrecomputedMatrixFile::hasFileTag(filename));
+    EXPECT_FALSE(file.open(filename));
+    EXPECT_FALSE(file.isOpen());
+}
+
+TEST_F(PrecomputedMatrixFile_test, invalidScalarSize)
+{
+    ASSERT_TRUE(PrecomputedMatrixFile::write(filename, matrix.data(), n, n, {}));
+
+    // scalarSize follows the tag and the version
+    {
+        std::fstream stream(filename, std::ios::in | std::ios::out | std::ios::binary);
+        const std::uint32_t scalarSize = 2;
+        stream.seekp(16 + sizeof(std::uint32_t));
+        stream.write(reinterpret_cast<const char*>(&scalarSize), sizeof(scalarSize));
+    }
+
+    PrecomputedMatrixFile file;
+    EXPECT_TRUE(PrecomputedMatrixFile::hasFileTag(filename));
+    EXPECT_FALSE(PrecomputedMatrixFile::hasValidHeader(filename));
+    EXPECT_FALSE(file.open(filename));
+}
+
+}
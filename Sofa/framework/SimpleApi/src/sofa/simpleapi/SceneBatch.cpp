@@ -0,0 +1,326 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simpleapi/SceneBatch.h>
+
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Visitor.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/loader/BaseLoader.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/defaulttype/AbstractTypeInfo.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace sofa::simpleapi
+{
+
+namespace
+{
+
+/// Records the nodes in the top-down traversal order
+class BatchNodeVisitor : public simulation::Visitor
+{
+public:
+    explicit BatchNodeVisitor(sofa::type::vector<Node*>& nodes)
+        : Visitor(core::execparams::defaultInstance())
+        , m_nodes(nodes)
+    {}
+
+    Result processNodeTopDown(simulation::Node* node) override
+    {
+        m_nodes.push_back(node);
+        return RESULT_CONTINUE;
+    }
+
+    const char* getClassName() const override { return "BatchNodeVisitor"; }
+
+private:
+    sofa::type::vector<Node*>& m_nodes;
+};
+
+sofa::type::vector<Node*> collectNodes(Node* root)
+{
+    sofa::type::vector<Node*> nodes;
+    BatchNodeVisitor visitor(nodes);
+    root->execute(visitor);
+    return nodes;
+}
+
+bool haveSameStructure(const sofa::type::vector<Node*>& nodes0, const sofa::type::vector<Node*>& nodes1)
+{
+    if (nodes0.size() != nodes1.size())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < nodes0.size(); ++i)
+    {
+        if (nodes0[i]->getName() != nodes1[i]->getName() || nodes0[i]->object.size() != nodes1[i]->object.size())
+        {
+            return false;
+        }
+        for (std::size_t j = 0; j < nodes0[i]->object.size(); ++j)
+        {
+            const auto* object0 = nodes0[i]->object[j].get();
+            const auto* object1 = nodes1[i]->object[j].get();
+            if (object0->getName() != object1->getName() || object0->getClass() != object1->getClass())
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool haveSameValue(const core::objectmodel::BaseData* data0, const core::objectmodel::BaseData* data1)
+{
+    const sofa::defaulttype::AbstractTypeInfo* typeInfo = data0->getValueTypeInfo();
+    const void* value0 = data0->getValueVoidPtr();
+    const void* value1 = data1->getValueVoidPtr();
+
+    const bool raw = typeInfo && typeInfo->ValidInfo() && typeInfo->SimpleLayout() && !typeInfo->Text()
+                     && (typeInfo->FixedSize() || (typeInfo->Container() && typeInfo->BaseType()->FixedSize()));
+    if (raw)
+    {
+        const sofa::Size size = typeInfo->size(value0);
+        if (size != typeInfo->size(value1))
+        {
+            return false;
+        }
+        const void* values0 = typeInfo->getValuePtr(value0);
+        const void* values1 = typeInfo->getValuePtr(value1);
+        if (values0 != nullptr && values1 != nullptr)
+        {
+            return std::memcmp(values0, values1, std::size_t(size) * typeInfo->byteSize()) == 0;
+        }
+    }
+    return data0->getValueString() == data1->getValueString();
+}
+
+/// The Data which are not modified during the simulation: the inputs of the loaders, the topologies and the
+/// rest positions of the mechanical states
+bool isConstantData(const core::objectmodel::BaseObject* owner, const core::objectmodel::BaseData* data)
+{
+    if (dynamic_cast<const core::loader::BaseLoader*>(owner) || dynamic_cast<const core::topology::BaseMeshTopology*>(owner))
+    {
+        return true;
+    }
+    return dynamic_cast<const core::behavior::BaseMechanicalState*>(owner) && data->getName() == "rest_position";
+}
+
+std::size_t shareData(const core::objectmodel::BaseObject* owner0, core::objectmodel::BaseObject* owner1)
+{
+    std::size_t nbShared = 0;
+    const auto& fields0 = owner0->getDataFields();
+    const auto& fields1 = owner1->getDataFields();
+    for (std::size_t i = 0; i < fields0.size() && i < fields1.size(); ++i)
+    {
+        core::objectmodel::BaseData* data1 = fields1[i];
+        if (data1->getParent() == nullptr && fields0[i]->getName() == data1->getName() && isConstantData(owner1, data1)
+            && haveSameValue(fields0[i], data1) && data1->shareValueFrom(fields0[i]))
+        {
+            ++nbShared;
+        }
+    }
+    return nbShared;
+}
+
+}
+
+SceneBatch::~SceneBatch()
+{
+    unload();
+}
+
+bool SceneBatch::load(const std::string& filename, const sofa::type::vector<Overrides>& instances)
+{
+    bool success = true;
+    for (const auto& overrides : instances)
+    {
+        const NodeSPtr root = simulation::node::load(filename);
+        if (!root)
+        {
+            return false;
+        }
+        success = addInstance(root, overrides) && success;
+    }
+    return success;
+}
+
+bool SceneBatch::addInstance(NodeSPtr root, const Overrides& overrides)
+{
+    bool success = true;
+    for (const auto& [path, value] : overrides)
+    {
+        core::objectmodel::BaseData* data = findData(root.get(), path);
+        if (data == nullptr || !data->read(value))
+        {
+            msg_error("SceneBatch") << "Cannot set '" << value << "' to the Data '" << path << "' of the instance " << m_instances.size();
+            success = false;
+        }
+    }
+    m_instances.push_back(root);
+    return success;
+}
+
+template<class Function>
+void SceneBatch::forEachInstance(simulation::TaskScheduler* taskScheduler, const Function& function)
+{
+    if (m_instances.empty())
+    {
+        return;
+    }
+
+    function(m_instances.front().get());
+
+    if (taskScheduler == nullptr || taskScheduler->getThreadCount() < 2)
+    {
+        for (std::size_t i = 1; i < m_instances.size(); ++i)
+        {
+            function(m_instances[i].get());
+        }
+        return;
+    }
+
+    simulation::parallelForEach(*taskScheduler, std::size_t(1), m_instances.size(), [this, &function](std::size_t i)
+    {
+        function(m_instances[i].get());
+    });
+}
+
+void SceneBatch::init()
+{
+    // the Data are shared before the initialization, so that no component refers to a replaced value
+    const std::size_t nbShared = shareIdenticalData();
+
+    // the components of the same type may share registries or caches during their initialization
+    // (e.g. the inverse matrices of PrecomputedConstraintCorrection): the instances are not initialized
+    // in parallel
+    for (const auto& root : m_instances)
+    {
+        simulation::node::initRoot(root.get());
+    }
+
+    msg_info("SceneBatch") << m_instances.size() << " instances initialized, " << nbShared << " Data shared with the first instance";
+}
+
+std::size_t SceneBatch::shareIdenticalData()
+{
+    if (m_instances.size() < 2)
+    {
+        return 0;
+    }
+
+    const sofa::type::vector<Node*> nodes0 = collectNodes(m_instances.front().get());
+
+    std::size_t nbShared = 0;
+    for (std::size_t k = 1; k < m_instances.size(); ++k)
+    {
+        const sofa::type::vector<Node*> nodes = collectNodes(m_instances[k].get());
+        if (!haveSameStructure(nodes0, nodes))
+        {
+            msg_warning("SceneBatch") << "The instance " << k << " has a different graph than the first one: its Data are not shared";
+            continue;
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            for (std::size_t j = 0; j < nodes[i]->object.size(); ++j)
+            {
+                nbShared += shareData(nodes0[i]->object[j].get(), nodes[i]->object[j].get());
+            }
+        }
+    }
+    return nbShared;
+}
+
+void SceneBatch::animate(simulation::TaskScheduler* taskScheduler, std::size_t nbSteps, SReal dt)
+{
+    forEachInstance(taskScheduler, [nbSteps, dt](Node* root)
+    {
+        for (std::size_t step = 0; step < nbSteps; ++step)
+        {
+            simulation::node::animate(root, dt);
+        }
+    });
+}
+
+sofa::type::vector<std::string> SceneBatch::getValues(const std::string& dataPath) const
+{
+    sofa::type::vector<std::string> values;
+    values.reserve(m_instances.size());
+    for (const auto& root : m_instances)
+    {
+        const core::objectmodel::BaseData* data = findData(root.get(), dataPath);
+        values.push_back(data ? data->getValueString() : std::string());
+    }
+    return values;
+}
+
+void SceneBatch::unload()
+{
+    for (const auto& root : m_instances)
+    {
+        simulation::node::unload(root);
+    }
+    m_instances.clear();
+}
+
+core::objectmodel::BaseData* SceneBatch::findData(Node* root, const std::string& dataPath)
+{
+    const auto dot = dataPath.rfind('.');
+    if (root == nullptr || dot == std::string::npos)
+    {
+        return nullptr;
+    }
+
+    const std::string objectPath = dataPath.substr(0, dot);
+    const auto slash = objectPath.rfind('/');
+    const std::string objectName = slash == std::string::npos ? objectPath : objectPath.substr(slash + 1);
+
+    Node* node = root;
+    if (slash != std::string::npos)
+    {
+        std::size_t begin = 0;
+        while (node != nullptr && begin < slash)
+        {
+            const auto end = std::min(objectPath.find('/', begin), slash);
+            if (end > begin)
+            {
+                node = node->getChild(objectPath.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+    }
+    if (node == nullptr)
+    {
+        return nullptr;
+    }
+
+    core::objectmodel::Base* owner = objectName.empty() ? static_cast<core::objectmodel::Base*>(node) : node->getObject(objectName);
+    return owner ? owner->findData(dataPath.substr(dot + 1)) : nullptr;
+}
+
+} // namespace sofa::simpleapi
@@ -0,0 +1,107 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simpleapi/config.h>
+
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/fwd.h>
+#include <sofa/type/vector.h>
+
+#include <map>
+#include <string>
+
+namespace sofa::simulation
+{
+    class TaskScheduler;
+}
+
+namespace sofa::simpleapi
+{
+
+using sofa::simulation::Node;
+using sofa::simulation::NodeSPtr;
+
+/**
+ * Several instances of a scene, simulated concurrently in the same process, for parameter sweeps.
+ *
+ * Each instance is a copy of the same scene graph, with its own Data values overridden (Young modulus, boundary
+ * conditions, ...). The instances are initialized one after the other, as the initialization of several instances
+ * of the same scene is not thread-safe (registries and caches shared between the components of the same type),
+ * then animated in parallel on a task scheduler: one task per instance. Before the initialization, the Data which are not modified during the simulation (inputs of the
+ * loaders, topologies, rest positions) and have the same value in all the instances share their memory: it is
+ * duplicated only for the instances modifying it (copy-on-write), e.g. during their initialization.
+ *
+ * The Data are designated by their path from the root node: "child/subchild/object.data", or
+ * "child/subchild/.data" for the Data of a node.
+ */
+class SOFA_SIMPLEAPI_API SceneBatch
+{
+public:
+    /// Values given to Data before initialization, by path of the Data
+    using Overrides = std::map<std::string, std::string>;
+
+    SceneBatch() = default;
+    ~SceneBatch();
+
+    SceneBatch(const SceneBatch&) = delete;
+    SceneBatch& operator=(const SceneBatch&) = delete;
+
+    /// Load one instance of the scene file per given set of overrides. Returns false if an instance cannot be
+    /// loaded, or an override cannot be applied.
+    bool load(const std::string& filename, const sofa::type::vector<Overrides>& instances);
+
+    /// Add a graph which is not initialized yet, after applying the given overrides
+    bool addInstance(NodeSPtr root, const Overrides& overrides = {});
+
+    /// Share the memory of the identical Data of the instances, then initialize all the instances, sequentially
+    void init();
+
+    /// Share the memory of the Data which are not modified during the simulation and which values are identical
+    /// in all the instances. To be called before the initialization: the components may refer to the values of the
+    /// Data once initialized. Returns the number of Data shared with the first instance.
+    std::size_t shareIdenticalData();
+
+    /// Animate all the instances by the given number of time steps
+    void animate(simulation::TaskScheduler* taskScheduler, std::size_t nbSteps = 1, SReal dt = 0);
+
+    /// Value of the given Data in each instance (empty if the Data is not found)
+    sofa::type::vector<std::string> getValues(const std::string& dataPath) const;
+
+    std::size_t size() const { return m_instances.size(); }
+    Node* getInstance(std::size_t index) const { return m_instances[index].get(); }
+
+    void unload();
+
+    /// Find a Data from its path
+    static core::objectmodel::BaseData* findData(Node* root, const std::string& dataPath);
+
+protected:
+    /// Run the given function for each instance. The first instance is processed before the other ones, in
+    /// parallel, so that it creates the global resources shared by all of them (timers, factories, ...).
+    template<class Function>
+    void forEachInstance(simulation::TaskScheduler* taskScheduler, const Function& function);
+
+    sofa::type::vector<NodeSPtr> m_instances;
+};
+
+} // namespace sofa::simpleapi
@@ -117,6 +117,46 @@ BaseObject::SPtr createObject(Node::SPtr parent, const std::string& type, const
     return createObject(parent, desc);
 }
 
+std::vector<BaseObject::SPtr> createObjects(Node::SPtr parent, const std::string& type, std::size_t count,
+                                           const std::map<std::string, std::vector<std::string>>& columns)
+{
+    for(auto& kv : columns)
+    {
+        if (kv.second.size() != 1 && kv.second.size() != count)
+        {
+            msg_error(parent.get()) << "Cannot create " << count << " objects of type '" << type << "': "
+                                    << kv.second.size() << " values are given for '" << kv.first << "'";
+            return {};
+        }
+    }
+
+    /// temporarily, the name is set to the type name.
+    /// if a "name" column is provided, it will overwrite it.
+    std::vector<BaseObjectDescription> descriptions(count, BaseObjectDescription(type.c_str(), type.c_str()));
+    for(auto& kv : columns)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            descriptions[i].setAttribute(kv.first, kv.second.size() == 1 ? kv.second.front() : kv.second[i]);
+        }
+    }
+
+    std::vector<BaseObject::SPtr> objects = ObjectFactory::getInstance()->createObjects(parent.get(), descriptions);
+    for (std::size_t i = 0; i < objects.size(); ++i)
+    {
+        if (objects[i] == nullptr)
+        {
+            std::stringstream msg;
+            msg << "Component '" << descriptions[i].getName() << "' of type '" << type << "' failed:" << msgendl ;
+            for (const auto& error : descriptions[i].getErrors())
+                msg << " " << error << msgendl ;
+            msg_error(parent.get()) << msg.str() ;
+        }
+    }
+
+    return objects;
+}
+
 Node::SPtr createChild(Node::SPtr node, const std::string& name, const std::map<std::string, std::string>& params)
 {
     BaseObjectDescription desc(name.c_str(), "Node");
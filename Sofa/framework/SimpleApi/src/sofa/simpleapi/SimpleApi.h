@@ -29,6 +29,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <vector>
 
 namespace sofa::simpleapi
 {
@@ -60,6 +61,13 @@ sofa::core::sptr<BaseObject> SOFA_SIMPLEAPI_API createObject(NodeSPtr node, Base
 sofa::core::sptr<BaseObject> SOFA_SIMPLEAPI_API createObject( NodeSPtr node, const std::string& type,
     const std::map<std::string, std::string>& params = std::map<std::string, std::string>{} );
 
+///@brief create several sofa objects of the given type in the provided node.
+///The parameter "columns" gives the Data values column-wise: for each Data, either one value shared by all the
+///objects, or one value per object. The type and template are resolved once for all the objects with the template
+///of the first one (see ObjectFactory::createObjects).
+std::vector<sofa::core::sptr<BaseObject>> SOFA_SIMPLEAPI_API createObjects( NodeSPtr node, const std::string& type, std::size_t count,
+    const std::map<std::string, std::vector<std::string>>& columns = std::map<std::string, std::vector<std::string>>{} );
+
 ///@brief create a child to the provided nodeof given name.
 ///The parameter "params" is for passing specific data argument to the created object.
 NodeSPtr SOFA_SIMPLEAPI_API createChild( NodeSPtr node, const std::string& name,
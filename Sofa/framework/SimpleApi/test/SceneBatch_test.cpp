@@ -0,0 +1,118 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest ;
+
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simpleapi/SceneBatch.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+using namespace sofa ;
+using namespace sofa::simpleapi ;
+
+class SceneBatch_test : public BaseSimulationTest
+{
+public:
+    void onSetUp() override
+    {
+        simpleapi::importPlugin("Sofa.Component.StateContainer");
+        simpleapi::importPlugin("Sofa.Component.Topology.Container.Constant");
+    }
+
+    static NodeSPtr createInstance()
+    {
+        const Simulation::SPtr simu = createSimulation("DAG") ;
+        const Node::SPtr root = createRootNode(simu, "root") ;
+        const Node::SPtr child = createChild(root, "child") ;
+        createObject(child, "MeshTopology", {
+                         {"name", "topology"},
+                         {"triangles", "0 1 2"}
+                     });
+        createObject(child, "MechanicalObject", {
+                         {"name", "dofs"},
+                         {"position", "0 0 0  1 0 0  0 1 0"},
+                         {"rest_position", "0 0 0  1 0 0  0 1 0"}
+                     });
+        return root;
+    }
+};
+
+TEST_F(SceneBatch_test, findData )
+{
+    const NodeSPtr root = createInstance();
+    EXPECT_NE(SceneBatch::findData(root.get(), "child/dofs.position"), nullptr);
+    EXPECT_NE(SceneBatch::findData(root.get(), "child/.name"), nullptr);
+    EXPECT_NE(SceneBatch::findData(root.get(), ".dt"), nullptr);
+    EXPECT_EQ(SceneBatch::findData(root.get(), "child/dofs.unknown"), nullptr);
+    EXPECT_EQ(SceneBatch::findData(root.get(), "unknown/dofs.position"), nullptr);
+    EXPECT_EQ(SceneBatch::findData(root.get(), "child/dofs"), nullptr);
+}
+
+TEST_F(SceneBatch_test, overridesAndSharing )
+{
+    auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    SceneBatch batch;
+    EXPECT_TRUE(batch.addInstance(createInstance()));
+    EXPECT_TRUE(batch.addInstance(createInstance(), {{"child/dofs.position", "0 0 0  2 0 0  0 2 0"}}));
+    EXPECT_TRUE(batch.addInstance(createInstance(), {{".dt", "0.5"}}));
+    EXPECT_FALSE(batch.addInstance(createInstance(), {{"child/dofs.unknown", "1"}}));
+    ASSERT_EQ(batch.size(), 4u);
+
+    batch.init();
+
+    const auto positions = batch.getValues("child/dofs.position");
+    ASSERT_EQ(positions.size(), 4u);
+    EXPECT_EQ(positions[0], positions[2]);
+    EXPECT_NE(positions[0], positions[1]);
+
+    const auto dts = batch.getValues(".dt");
+    EXPECT_EQ(dts[2], "0.5");
+    EXPECT_NE(dts[0], dts[2]);
+
+    // the topology is not modified by the initialization: it is still shared
+    auto* triangles0 = SceneBatch::findData(batch.getInstance(0), "child/topology.triangles");
+    auto* triangles1 = SceneBatch::findData(batch.getInstance(1), "child/topology.triangles");
+    ASSERT_NE(triangles0, nullptr);
+    ASSERT_NE(triangles1, nullptr);
+    EXPECT_EQ(triangles0->getValueVoidPtr(), triangles1->getValueVoidPtr());
+
+    // a modification duplicates the shared value for the modified instance only
+    const std::string triangles = triangles0->getValueString();
+    ASSERT_TRUE(triangles1->read("2 1 0"));
+    EXPECT_NE(triangles0->getValueVoidPtr(), triangles1->getValueVoidPtr());
+    EXPECT_EQ(triangles0->getValueString(), triangles);
+
+    // the Data modified during the simulation are not shared
+    EXPECT_NE(SceneBatch::findData(batch.getInstance(0), "child/dofs.position")->getValueVoidPtr(),
+              SceneBatch::findData(batch.getInstance(2), "child/dofs.position")->getValueVoidPtr());
+
+    batch.animate(taskScheduler, 2);
+    EXPECT_EQ(batch.getValues("child/dofs.position")[1], positions[1]);
+
+    batch.unload();
+    EXPECT_EQ(batch.size(), 0u);
+}
@@ -31,6 +31,7 @@ class SimpleApi_test : public BaseSimulationTest
 public:
     bool testParamAPI();
     bool testParamString();
+    bool testCreateObjects();
 };
 
 bool SimpleApi_test::testParamAPI()
@@ -80,6 +81,60 @@ bool SimpleApi_test::testParamString()
     return true;
 }
 
+bool SimpleApi_test::testCreateObjects()
+{
+    const Simulation::SPtr simu = createSimulation("DAG") ;
+    const Node::SPtr root = createRootNode(simu, "root") ;
+
+    simpleapi::importPlugin("Sofa.Component.StateContainer");
+
+    constexpr std::size_t count = 100;
+    std::vector<std::string> names, positions;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        names.push_back("dofs" + std::to_string(i));
+        positions.push_back(std::to_string(i) + " 0 0");
+    }
+
+    const auto objects = createObjects(root, "MechanicalObject", count, {
+                                           {"name", names},
+                                           {"position", positions},
+                                           {"template", {"Vec3"}}
+                                       });
+
+    EXPECT_EQ(objects.size(), count) ;
+    EXPECT_EQ(root->object.size(), count) ;
+    for (std::size_t i = 0; i < objects.size(); ++i)
+    {
+        EXPECT_NE(objects[i], nullptr) ;
+        if (objects[i])
+        {
+            EXPECT_EQ(objects[i]->getName(), names[i]) ;
+            EXPECT_EQ(objects[i]->findData("position")->getValueString(), positions[i]) ;
+        }
+    }
+
+    /// a template given per object is not replaced by the template of the first object
+    const auto templatedObjects = createObjects(root, "MechanicalObject", 3, {
+                                                    {"template", {"Vec3", "Vec2", "Vec3"}}
+                                                });
+    EXPECT_EQ(templatedObjects.size(), 3) ;
+    for (const auto& object : templatedObjects)
+    {
+        EXPECT_NE(object, nullptr) ;
+    }
+    if (templatedObjects.size() == 3 && templatedObjects[0] && templatedObjects[1] && templatedObjects[2])
+    {
+        EXPECT_NE(templatedObjects[1]->getTemplateName(), templatedObjects[0]->getTemplateName()) ;
+        EXPECT_EQ(templatedObjects[2]->getTemplateName(), templatedObjects[0]->getTemplateName()) ;
+    }
+
+    /// the number of values of each column has to be 1 or the number of objects
+    EXPECT_MSG_EMIT(Error) ;
+    EXPECT_TRUE(createObjects(root, "MechanicalObject", 3, {{"name", {"a", "b"}}}).empty()) ;
+
+    return true;
+}
 
 TEST_F(SimpleApi_test, testParamAPI )
 {
@@ -90,3 +145,8 @@ TEST_F(SimpleApi_test, createParamString )
 {
     ASSERT_TRUE( testParamString() );
 }
+
+TEST_F(SimpleApi_test, createObjects )
+{
+    ASSERT_TRUE( testCreateObjects() );
+}
@@ -0,0 +1,412 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/InitTaskGraph.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Visitor.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/CpuTaskStatus.h>
+#include <sofa/core/loader/BaseLoader.h>
+#include <sofa/type/BoundingBox.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace sofa::simulation
+{
+
+namespace
+{
+
+/// Records the nodes in the order they are traversed by InitVisitor
+class NodeOrderVisitor : public Visitor
+{
+public:
+    NodeOrderVisitor(sofa::type::vector<Node*>& topDown, sofa::type::vector<Node*>& bottomUp)
+        : Visitor(core::execparams::defaultInstance())
+        , m_topDown(topDown)
+        , m_bottomUp(bottomUp)
+    {}
+
+    Result processNodeTopDown(simulation::Node* node) override
+    {
+        m_topDown.push_back(node);
+        return RESULT_CONTINUE;
+    }
+
+    void processNodeBottomUp(simulation::Node* node) override
+    {
+        m_bottomUp.push_back(node);
+    }
+
+    const char* getClassName() const override { return "NodeOrderVisitor"; }
+
+private:
+    sofa::type::vector<Node*>& m_topDown;
+    sofa::type::vector<Node*>& m_bottomUp;
+};
+
+bool isLoader(const core::objectmodel::BaseObject* object)
+{
+    return dynamic_cast<const core::loader::BaseLoader*>(object) != nullptr;
+}
+
+}
+
+InitTaskGraph::InitTaskGraph(Node* root)
+    : m_root(root)
+{
+    collectNodes();
+
+    buildInitTasks();
+    buildBwdInitTasks();
+}
+
+void InitTaskGraph::addDependency(sofa::type::vector<Task>& tasks, std::size_t from, std::size_t to)
+{
+    auto& predecessors = tasks[to].predecessors;
+    if (from != to && std::find(predecessors.begin(), predecessors.end(), from) == predecessors.end())
+    {
+        predecessors.push_back(from);
+        tasks[from].successors.push_back(to);
+    }
+}
+
+void InitTaskGraph::addExplicitDependencies(sofa::type::vector<Task>& tasks, std::size_t taskId,
+                                            const std::map<const core::objectmodel::Base*, std::size_t>& objectTasks)
+{
+    const auto addDependencyTo = [&](const core::objectmodel::Base* target)
+    {
+        const auto it = objectTasks.find(target);
+        // the dependencies on the next components are ignored, as they are by the sequential initialization
+        if (it != objectTasks.end() && it->second < taskId)
+        {
+            addDependency(tasks, it->second, taskId);
+        }
+    };
+
+    const core::objectmodel::BaseObject* object = tasks[taskId].object;
+    for (const core::objectmodel::BaseData* data : object->getDataFields())
+    {
+        if (const core::objectmodel::BaseData* parent = data->getParent())
+        {
+            addDependencyTo(parent->getOwner());
+        }
+    }
+    for (const core::objectmodel::BaseLink* link : object->getLinks())
+    {
+        for (std::size_t i = 0; i < link->getSize(); ++i)
+        {
+            addDependencyTo(link->getLinkedBase(i));
+        }
+    }
+}
+
+void InitTaskGraph::buildInitTasks()
+{
+    std::map<const core::objectmodel::Base*, std::size_t> objectTasks;
+    std::map<const Node*, sofa::type::vector<std::size_t> > nodeExits;
+
+    for (Node* node : m_topDownNodes)
+    {
+        const std::size_t nodeTask = m_initTasks.size();
+        m_initTasks.push_back({node, nullptr, {}, {}});
+
+        for (const core::objectmodel::BaseNode* parent : node->getParents())
+        {
+            const auto it = nodeExits.find(static_cast<const Node*>(parent));
+            if (it != nodeExits.end())
+            {
+                for (const std::size_t exit : it->second)
+                {
+                    addDependency(m_initTasks, exit, nodeTask);
+                }
+            }
+        }
+
+        std::size_t lastOrdered = nodeTask;
+        sofa::type::vector<std::size_t> loaders;
+        for (const auto& object : node->object)
+        {
+            const std::size_t objectTask = m_initTasks.size();
+            m_initTasks.push_back({node, object.get(), {}, {}});
+            addExplicitDependencies(m_initTasks, objectTask, objectTasks);
+            objectTasks[object.get()] = objectTask;
+
+            if (isLoader(object.get()))
+            {
+                // a loader only depends on its node and its inputs
+                addDependency(m_initTasks, nodeTask, objectTask);
+                loaders.push_back(objectTask);
+            }
+            else
+            {
+                addDependency(m_initTasks, lastOrdered, objectTask);
+                for (const std::size_t loader : loaders)
+                {
+                    addDependency(m_initTasks, loader, objectTask);
+                }
+                loaders.clear();
+                lastOrdered = objectTask;
+            }
+        }
+
+        auto& exits = nodeExits[node];
+        exits = loaders;
+        exits.push_back(lastOrdered);
+    }
+}
+
+void InitTaskGraph::buildBwdInitTasks()
+{
+    std::map<const core::objectmodel::Base*, std::size_t> objectTasks;
+    std::map<const Node*, sofa::type::vector<std::size_t> > nodeExits;
+
+    for (Node* node : m_bottomUpNodes)
+    {
+        sofa::type::vector<std::size_t> previous;
+        for (const core::objectmodel::BaseNode* child : node->getChildren())
+        {
+            const auto it = nodeExits.find(static_cast<const Node*>(child));
+            if (it != nodeExits.end())
+            {
+                previous.insert(previous.end(), it->second.begin(), it->second.end());
+            }
+        }
+
+        for (auto it = node->object.rbegin(); it != node->object.rend(); ++it)
+        {
+            const std::size_t objectTask = m_bwdInitTasks.size();
+            m_bwdInitTasks.push_back({node, it->get(), {}, {}});
+            addExplicitDependencies(m_bwdInitTasks, objectTask, objectTasks);
+            objectTasks[it->get()] = objectTask;
+
+            for (const std::size_t p : previous)
+            {
+                addDependency(m_bwdInitTasks, p, objectTask);
+            }
+            previous.clear();
+            previous.push_back(objectTask);
+        }
+
+        nodeExits[node] = previous;
+    }
+}
+
+void InitTaskGraph::execute(const sofa::type::vector<Task>& tasks, TaskScheduler* taskScheduler,
+                            const std::function<void(const Task&)>& function)
+{
+    if (taskScheduler == nullptr || taskScheduler->getThreadCount() < 2)
+    {
+        // the graph order is compatible with the dependencies
+        for (const Task& task : tasks)
+        {
+            function(task);
+        }
+        return;
+    }
+
+    const std::unique_ptr<std::atomic<std::size_t>[]> remaining(new std::atomic<std::size_t>[tasks.size()]);
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+    {
+        remaining[i].store(tasks[i].predecessors.size(), std::memory_order_relaxed);
+    }
+
+    CpuTaskStatus status;
+
+    // the tasks that are not thread-safe are run one at a time, by the calling thread
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::size_t> sequentialTasks;
+    std::size_t nbCompletedTasks = 0;
+
+    std::function<void(std::size_t)> schedule;
+
+    const auto complete = [&](std::size_t taskId)
+    {
+        // the successors are scheduled before the completion, so that the status stays busy until all the
+        // parallel tasks are done
+        for (const std::size_t successor : tasks[taskId].successors)
+        {
+            if (remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                schedule(successor);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++nbCompletedTasks;
+        condition.notify_one();
+    };
+
+    schedule = [&](std::size_t taskId)
+    {
+        if (isThreadSafe(tasks[taskId]))
+        {
+            taskScheduler->addTask(status, [&, taskId]()
+            {
+                function(tasks[taskId]);
+                complete(taskId);
+            });
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sequentialTasks.push_back(taskId);
+            condition.notify_one();
+        }
+    };
+
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+    {
+        if (tasks[i].predecessors.empty())
+        {
+            schedule(i);
+        }
+    }
+
+    while (true)
+    {
+        std::size_t taskId;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() { return !sequentialTasks.empty() || nbCompletedTasks == tasks.size(); });
+            if (sequentialTasks.empty())
+            {
+                break;
+            }
+            taskId = sequentialTasks.front();
+            sequentialTasks.pop_front();
+        }
+
+        function(tasks[taskId]);
+        complete(taskId);
+    }
+
+    taskScheduler->workUntilDone(&status);
+}
+
+bool InitTaskGraph::isThreadSafe(const Task& task)
+{
+    return task.object == nullptr || task.object->isInitThreadSafe();
+}
+
+void InitTaskGraph::collectNodes()
+{
+    m_topDownNodes.clear();
+    m_bottomUpNodes.clear();
+
+    NodeOrderVisitor visitor(m_topDownNodes, m_bottomUpNodes);
+    m_root->execute(visitor);
+}
+
+void InitTaskGraph::run(TaskScheduler* taskScheduler)
+{
+    const core::ExecParams* params = core::execparams::defaultInstance();
+
+    execute(m_initTasks, taskScheduler, [params](const Task& task)
+    {
+        if (task.object == nullptr)
+        {
+            task.node->initialize();
+            return;
+        }
+
+        task.object->init();
+        if (isLoader(task.object))
+        {
+            // the loaders can defer the loading until their outputs are read: load now, in parallel
+            for (const core::objectmodel::BaseData* data : task.object->getDataFields())
+            {
+                data->updateIfDirty();
+            }
+        }
+        task.object->computeBBox(params, true);
+    });
+
+    // the components and nodes created by the initialization of other components are initialized sequentially,
+    // like in InitVisitor
+    std::set<const Node*> initializedNodes;
+    std::set<const core::objectmodel::BaseObject*> initialized;
+    for (const Task& task : m_initTasks)
+    {
+        initializedNodes.insert(task.node);
+        initialized.insert(task.object);
+    }
+
+    collectNodes();
+
+    sofa::type::vector<Task> createdObjects;
+    for (Node* node : m_topDownNodes)
+    {
+        if (initializedNodes.insert(node).second)
+        {
+            node->initialize();
+        }
+
+        for (std::size_t i = 0; i < node->object.size(); ++i)
+        {
+            core::objectmodel::BaseObject* object = node->object[i].get();
+            if (initialized.insert(object).second)
+            {
+                object->init();
+                object->computeBBox(params, true);
+                createdObjects.push_back({node, object, {}, {}});
+            }
+        }
+    }
+
+    for (auto it = createdObjects.rbegin(); it != createdObjects.rend(); ++it)
+    {
+        it->object->bwdInit();
+    }
+
+    execute(m_bwdInitTasks, taskScheduler, [](const Task& task)
+    {
+        task.object->bwdInit();
+    });
+
+    for (Node* node : m_topDownNodes)
+    {
+        sofa::type::BoundingBox* nodeBBox = node->f_bbox.beginEdit();
+        if (!node->f_bbox.isSet())
+        {
+            nodeBBox->invalidate();
+        }
+        for (const auto& object : node->object)
+        {
+            nodeBBox->include(object->f_bbox.getValue());
+        }
+        node->f_bbox.endEdit();
+    }
+
+    for (Node* node : m_bottomUpNodes)
+    {
+        node->setDefaultVisualContextValue();
+    }
+}
+
+} // namespace sofa::simulation
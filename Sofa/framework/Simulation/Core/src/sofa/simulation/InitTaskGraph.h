@@ -0,0 +1,119 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/config.h>
+#include <sofa/core/fwd.h>
+#include <sofa/type/vector.h>
+#include <functional>
+#include <map>
+
+namespace sofa::simulation
+{
+
+class Node;
+class TaskScheduler;
+
+/**
+ * Initialization of a scene graph equivalent to InitVisitor, where the components that do not depend on
+ * each other are initialized in parallel.
+ *
+ * The dependencies are derived from the graph order, as it is followed by InitVisitor, and from the links
+ * between components:
+ * - a node is initialized after the components of its parents,
+ * - in a node, a component is initialized after the previous components, except the loaders, which only
+ *   depend on the node and on their explicit inputs,
+ * - a component is initialized after the components targeted by its links, and the owners of the parents of
+ *   its Data, if they come first in the graph order.
+ *
+ * The backward initialization (bwdInit) follows the reverse order: in a node, a component after the next
+ * components and the children nodes. Independent sub-graphs are processed in parallel.
+ *
+ * Unlike InitVisitor, all the init calls are done before the first bwdInit call: InitVisitor runs the bwdInit
+ * of a sub-graph before the init of the next sibling sub-graph. A component whose init reads a state set by
+ * the bwdInit of a component of a previous sibling sub-graph must not be initialized with parallelInit.
+ *
+ * Only the nodes and the components declaring a thread-safe initialization (see
+ * BaseObject::isInitThreadSafe) are initialized in parallel. The other components are initialized one at a
+ * time, by the calling thread, as they may share some state with other components (e.g. static registries).
+ *
+ * Once initialized, the pending lazy updates of the outputs of a component (such as the file parsing of the
+ * loaders) are computed in its task, instead of being deferred to the first component reading them.
+ */
+class SOFA_SIMULATION_CORE_API InitTaskGraph
+{
+public:
+    explicit InitTaskGraph(Node* root);
+
+    /// Initialize the graph. The tasks are run sequentially, in the graph order, without a task scheduler
+    /// with several threads.
+    void run(TaskScheduler* taskScheduler);
+
+    /// A task: the initialization of a node (object is nullptr) or a component
+    struct Task
+    {
+        Node* node { nullptr };
+        core::objectmodel::BaseObject* object { nullptr };
+
+        /// Tasks to complete before this one, all in the graph order before this one
+        sofa::type::vector<std::size_t> predecessors;
+        sofa::type::vector<std::size_t> successors;
+    };
+
+    /// Tasks of the forward initialization, in the graph order
+    const sofa::type::vector<Task>& getInitTasks() const { return m_initTasks; }
+
+    /// Tasks of the backward initialization, in the graph order
+    const sofa::type::vector<Task>& getBwdInitTasks() const { return m_bwdInitTasks; }
+
+    /// Run the given tasks in a dependency order. The tasks that are not thread-safe are run one at a time,
+    /// by the calling thread.
+    static void execute(const sofa::type::vector<Task>& tasks, TaskScheduler* taskScheduler,
+                        const std::function<void(const Task&)>& function);
+
+    /// Return true if the task can run concurrently with the other tasks
+    static bool isThreadSafe(const Task& task);
+
+protected:
+    /// Collect the nodes of the graph, in the traversal orders of InitVisitor
+    void collectNodes();
+
+    void buildInitTasks();
+    void buildBwdInitTasks();
+
+    /// Add the dependencies of the task to the components it reads
+    static void addExplicitDependencies(sofa::type::vector<Task>& tasks, std::size_t taskId,
+                                        const std::map<const core::objectmodel::Base*, std::size_t>& objectTasks);
+
+    static void addDependency(sofa::type::vector<Task>& tasks, std::size_t from, std::size_t to);
+
+    Node* m_root { nullptr };
+
+    /// Nodes in the top-down and bottom-up traversal orders
+    sofa::type::vector<Node*> m_topDownNodes;
+    sofa::type::vector<Node*> m_bottomUpNodes;
+
+    sofa::type::vector<Task> m_initTasks;
+    sofa::type::vector<Task> m_bwdInitTasks;
+};
+
+} // namespace sofa::simulation
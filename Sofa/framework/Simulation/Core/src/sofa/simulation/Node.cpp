@@ -107,6 +107,7 @@ Node::Node(const std::string& name)
     , mechanicalMapping(initLink("mechanicalMapping", "The MechanicalMapping attached to this node"))
     , mass(initLink("mass", "The Mass attached to this node"))
     , collisionPipeline(initLink("collisionPipeline", "The collision Pipeline attached to this node"))
+    , d_parallelInit(initData(&d_parallelInit, false, "parallelInit", "Initialize the independent components of the graph in parallel, on the task scheduler, when this node is initialized. All the components are initialized before the backward initialization of any of them, whereas the default initialization runs the backward initialization of a sub-graph before initializing the next sibling sub-graph"))
 
     , debug_(false)
     , initialized(false)
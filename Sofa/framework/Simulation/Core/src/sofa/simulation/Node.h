@@ -264,6 +264,11 @@ public:
     NodeSingle<sofa::core::collision::Pipeline> collisionPipeline;
     /// @}
 
+    /// Initialize the independent components of the graph in parallel (see InitTaskGraph). All the components
+    /// are initialized (init) before the backward initialization (bwdInit) of any of them, including in the
+    /// sibling sub-graphs processed one after the other by InitVisitor.
+    Data<bool> d_parallelInit;
+
     /// @name Set/get objects
     /// @{
 
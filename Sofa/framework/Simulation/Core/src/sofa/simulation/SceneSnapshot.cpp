@@ -0,0 +1,424 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/SceneSnapshot.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Visitor.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/core/objectmodel/BaseLink.h>
+#include <sofa/defaulttype/AbstractTypeInfo.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace sofa::simulation
+{
+
+namespace
+{
+
+constexpr char SnapshotTag[16] = "SOFA_SNAPSHOT";
+
+/// Records the nodes in the top-down traversal order
+class SnapshotNodeVisitor : public Visitor
+{
+public:
+    explicit SnapshotNodeVisitor(sofa::type::vector<Node*>& nodes)
+        : Visitor(core::execparams::defaultInstance())
+        , m_nodes(nodes)
+    {}
+
+    Result processNodeTopDown(simulation::Node* node) override
+    {
+        m_nodes.push_back(node);
+        return RESULT_CONTINUE;
+    }
+
+    const char* getClassName() const override { return "SnapshotNodeVisitor"; }
+
+private:
+    sofa::type::vector<Node*>& m_nodes;
+};
+
+sofa::type::vector<Node*> collectNodes(Node* root)
+{
+    sofa::type::vector<Node*> nodes;
+    SnapshotNodeVisitor visitor(nodes);
+    root->execute(visitor);
+    return nodes;
+}
+
+/// True if the value of the Data can be copied as a block of memory
+bool isRaw(const sofa::defaulttype::AbstractTypeInfo* typeInfo)
+{
+    if (typeInfo == nullptr || !typeInfo->ValidInfo() || !typeInfo->SimpleLayout() || typeInfo->Text())
+    {
+        return false;
+    }
+    return typeInfo->FixedSize() || (typeInfo->Container() && typeInfo->BaseType()->FixedSize());
+}
+
+void recordData(const core::objectmodel::Base* owner, sofa::type::vector<SceneSnapshot::DataRecord>& records)
+{
+    for (const core::objectmodel::BaseData* data : owner->getDataFields())
+    {
+        if (data->getParent() != nullptr)
+        {
+            continue;
+        }
+
+        SceneSnapshot::DataRecord record;
+        record.name = data->getName();
+
+        const sofa::defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+        const void* value = data->getValueVoidPtr();
+        const void* values = isRaw(typeInfo) ? typeInfo->getValuePtr(value) : nullptr;
+        const sofa::Size size = values ? typeInfo->size(value) : 0;
+        if (values != nullptr || (isRaw(typeInfo) && size == 0))
+        {
+            record.raw = true;
+            record.size = size;
+            record.value.assign(static_cast<const char*>(values), std::size_t(size) * typeInfo->byteSize());
+        }
+        else
+        {
+            record.value = data->getValueString();
+        }
+        records.push_back(std::move(record));
+    }
+}
+
+/// True if the Data has the recorded value
+bool hasValue(const core::objectmodel::BaseData* data, const SceneSnapshot::DataRecord& record)
+{
+    if (!record.raw)
+    {
+        return data->getValueString() == record.value;
+    }
+
+    const sofa::defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+    const void* value = data->getValueVoidPtr();
+    return typeInfo->size(value) == record.size
+        && (record.value.empty() || std::memcmp(typeInfo->getValuePtr(value), record.value.data(), record.value.size()) == 0);
+}
+
+void restoreData(core::objectmodel::Base* owner, const sofa::type::vector<SceneSnapshot::DataRecord>& records)
+{
+    for (const auto& record : records)
+    {
+        core::objectmodel::BaseData* data = owner->findData(record.name);
+        if (data == nullptr || data->getParent() != nullptr || hasValue(data, record))
+        {
+            continue;
+        }
+
+        if (!record.raw)
+        {
+            data->read(record.value);
+            continue;
+        }
+
+        const sofa::defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+        void* value = data->beginEditVoidPtr();
+        typeInfo->setSize(value, record.size);
+        if (typeInfo->size(value) == record.size && std::size_t(record.size) * typeInfo->byteSize() == record.value.size())
+        {
+            if (!record.value.empty())
+            {
+                std::memcpy(typeInfo->getValuePtr(value), record.value.data(), record.value.size());
+            }
+        }
+        else
+        {
+            msg_error(owner) << "Cannot restore the value of the Data '" << record.name << "' from the snapshot: its type differs.";
+        }
+        data->endEditVoidPtr();
+    }
+}
+
+template<class T>
+void write(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write(std::ostream& out, const std::string& value)
+{
+    write(out, std::uint64_t(value.size()));
+    out.write(value.data(), std::streamsize(value.size()));
+}
+
+void write(std::ostream& out, const sofa::type::vector<SceneSnapshot::DataRecord>& records)
+{
+    write(out, std::uint64_t(records.size()));
+    for (const auto& record : records)
+    {
+        write(out, record.name);
+        write(out, std::uint8_t(record.raw));
+        write(out, std::uint64_t(record.size));
+        write(out, record.value);
+    }
+}
+
+template<class T>
+bool read(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return bool(in);
+}
+
+bool read(std::istream& in, std::string& value)
+{
+    std::uint64_t size = 0;
+    if (!read(in, size))
+    {
+        return false;
+    }
+
+    // do not trust a corrupted size: read by chunks, until the end of the file
+    value.clear();
+    constexpr std::uint64_t chunkSize = 1 << 20;
+    while (size > 0 && in)
+    {
+        const std::size_t offset = value.size();
+        const std::size_t count = std::size_t(std::min(size, chunkSize));
+        value.resize(offset + count);
+        in.read(value.data() + offset, std::streamsize(count));
+        size -= count;
+    }
+    return bool(in);
+}
+
+bool read(std::istream& in, sofa::type::vector<SceneSnapshot::DataRecord>& records)
+{
+    std::uint64_t nbRecords = 0;
+    if (!read(in, nbRecords))
+    {
+        return false;
+    }
+
+    records.clear();
+    for (std::uint64_t i = 0; i < nbRecords && in; ++i)
+    {
+        SceneSnapshot::DataRecord record;
+        std::uint8_t raw = 0;
+        std::uint64_t size = 0;
+        if (read(in, record.name) && read(in, raw) && read(in, size) && read(in, record.value))
+        {
+            record.raw = raw != 0;
+            record.size = sofa::Size(size);
+            records.push_back(std::move(record));
+        }
+    }
+    return bool(in);
+}
+
+}
+
+void SceneSnapshot::capture(Node* root)
+{
+    m_nodes.clear();
+    for (Node* node : collectNodes(root))
+    {
+        NodeRecord nodeRecord;
+        nodeRecord.path = node->getPathName();
+        recordData(node, nodeRecord.data);
+
+        for (const auto& object : node->object)
+        {
+            ObjectRecord objectRecord;
+            objectRecord.name = object->getName();
+            objectRecord.className = object->getClassName();
+            objectRecord.templateName = object->getTemplateName();
+            recordData(object.get(), objectRecord.data);
+
+            for (const core::objectmodel::BaseLink* link : object->getLinks())
+            {
+                // the double links are maintained by the graph structure
+                if (!link->isDoubleLink())
+                {
+                    objectRecord.links.push_back({link->getName(), link->getValueString()});
+                }
+            }
+            nodeRecord.objects.push_back(std::move(objectRecord));
+        }
+        m_nodes.push_back(std::move(nodeRecord));
+    }
+}
+
+bool SceneSnapshot::restore(Node* root) const
+{
+    const sofa::type::vector<Node*> nodes = collectNodes(root);
+
+    // check the structure before modifying anything
+    if (nodes.size() != m_nodes.size())
+    {
+        msg_error("SceneSnapshot") << "The snapshot contains " << m_nodes.size() << " nodes, the graph " << nodes.size();
+        return false;
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        const NodeRecord& nodeRecord = m_nodes[i];
+        if (nodes[i]->getPathName() != nodeRecord.path || nodes[i]->object.size() != nodeRecord.objects.size())
+        {
+            msg_error("SceneSnapshot") << "The node '" << nodes[i]->getPathName() << "' does not match the snapshot node '" << nodeRecord.path << "'";
+            return false;
+        }
+        for (std::size_t j = 0; j < nodeRecord.objects.size(); ++j)
+        {
+            const core::objectmodel::BaseObject* object = nodes[i]->object[j].get();
+            if (object->getName() != nodeRecord.objects[j].name || object->getClassName() != nodeRecord.objects[j].className
+                || object->getTemplateName() != nodeRecord.objects[j].templateName)
+            {
+                msg_error("SceneSnapshot") << "The component '" << object->getPathName() << "' does not match the snapshot component '"
+                                           << nodeRecord.path << "/" << nodeRecord.objects[j].name << "'";
+                return false;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        restoreData(nodes[i], m_nodes[i].data);
+        for (std::size_t j = 0; j < m_nodes[i].objects.size(); ++j)
+        {
+            core::objectmodel::BaseObject* object = nodes[i]->object[j].get();
+            const ObjectRecord& objectRecord = m_nodes[i].objects[j];
+            restoreData(object, objectRecord.data);
+
+            for (const auto& linkRecord : objectRecord.links)
+            {
+                core::objectmodel::BaseLink* link = object->findLink(linkRecord.name);
+                if (link != nullptr && link->getValueString() != linkRecord.value)
+                {
+                    link->read(linkRecord.value);
+                    link->updateLinks();
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool SceneSnapshot::save(const std::string& filename) const
+{
+    std::ofstream out(filename, std::ios::out | std::ios::binary);
+    if (!out)
+    {
+        msg_error("SceneSnapshot") << "Cannot open '" << filename << "' for writing";
+        return false;
+    }
+
+    out.write(SnapshotTag, sizeof(SnapshotTag));
+    write(out, std::uint32_t(Version));
+    write(out, std::uint64_t(m_nodes.size()));
+    for (const auto& nodeRecord : m_nodes)
+    {
+        write(out, nodeRecord.path);
+        write(out, nodeRecord.data);
+        write(out, std::uint64_t(nodeRecord.objects.size()));
+        for (const auto& objectRecord : nodeRecord.objects)
+        {
+            write(out, objectRecord.name);
+            write(out, objectRecord.className);
+            write(out, objectRecord.templateName);
+            write(out, objectRecord.data);
+            write(out, std::uint64_t(objectRecord.links.size()));
+            for (const auto& linkRecord : objectRecord.links)
+            {
+                write(out, linkRecord.name);
+                write(out, linkRecord.value);
+            }
+        }
+    }
+    return bool(out);
+}
+
+bool SceneSnapshot::load(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    char tag[sizeof(SnapshotTag)] {};
+    std::uint32_t version = 0;
+    if (!in || !in.read(tag, sizeof(tag)) || std::memcmp(tag, SnapshotTag, sizeof(tag)) != 0 || !read(in, version))
+    {
+        msg_error("SceneSnapshot") << "'" << filename << "' is not a scene snapshot";
+        return false;
+    }
+    if (version != Version)
+    {
+        msg_error("SceneSnapshot") << "'" << filename << "' has the version " << version << ", expected " << Version;
+        return false;
+    }
+
+    sofa::type::vector<NodeRecord> nodes;
+    std::uint64_t nbNodes = 0;
+    read(in, nbNodes);
+    for (std::uint64_t i = 0; i < nbNodes && in; ++i)
+    {
+        NodeRecord nodeRecord;
+        std::uint64_t nbObjects = 0;
+        read(in, nodeRecord.path);
+        read(in, nodeRecord.data);
+        read(in, nbObjects);
+        for (std::uint64_t j = 0; j < nbObjects && in; ++j)
+        {
+            ObjectRecord objectRecord;
+            std::uint64_t nbLinks = 0;
+            read(in, objectRecord.name);
+            read(in, objectRecord.className);
+            read(in, objectRecord.templateName);
+            read(in, objectRecord.data);
+            read(in, nbLinks);
+            for (std::uint64_t k = 0; k < nbLinks && in; ++k)
+            {
+                LinkRecord linkRecord;
+                read(in, linkRecord.name);
+                read(in, linkRecord.value);
+                objectRecord.links.push_back(std::move(linkRecord));
+            }
+            nodeRecord.objects.push_back(std::move(objectRecord));
+        }
+        nodes.push_back(std::move(nodeRecord));
+    }
+
+    if (!in)
+    {
+        msg_error("SceneSnapshot") << "'" << filename << "' is truncated";
+        return false;
+    }
+
+    m_nodes = std::move(nodes);
+    return true;
+}
+
+std::size_t SceneSnapshot::getNbObjects() const
+{
+    std::size_t nbObjects = 0;
+    for (const auto& nodeRecord : m_nodes)
+    {
+        nbObjects += nodeRecord.objects.size();
+    }
+    return nbObjects;
+}
+
+} // namespace sofa::simulation
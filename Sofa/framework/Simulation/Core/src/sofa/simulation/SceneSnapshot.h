@@ -0,0 +1,110 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/config.h>
+#include <sofa/core/fwd.h>
+#include <sofa/type/vector.h>
+#include <string>
+
+namespace sofa::simulation
+{
+
+class Node;
+
+/**
+ * Snapshot of the values of all the Data and Links of an initialized scene graph, which can be restored in the
+ * same graph (same nodes and components), or saved to a versioned binary file and restored in another instance
+ * of the scene.
+ *
+ * The Data which value can be copied as a block of memory (vectors of positions, topological elements, ...) are
+ * stored as raw bytes; the other ones as text. The Data linked to a parent Data are not stored, since their
+ * value comes from their parent.
+ *
+ * Only the Data which value differs from the snapshot are modified during the restoration, so that the
+ * components tracking their inputs (such as the loaders) do not recompute anything when it is not required.
+ * The internal buffers which are not stored in Data are not part of the snapshot.
+ */
+class SOFA_SIMULATION_CORE_API SceneSnapshot
+{
+public:
+    /// Record the values of the graph rooted at the given node
+    void capture(Node* root);
+
+    /// Restore the recorded values. Returns false, and leaves the graph unchanged, if its structure differs
+    /// from the recorded one.
+    bool restore(Node* root) const;
+
+    /// Write the snapshot in a binary file
+    bool save(const std::string& filename) const;
+
+    /// Read a snapshot written by save
+    bool load(const std::string& filename);
+
+    bool empty() const { return m_nodes.empty(); }
+    void clear() { m_nodes.clear(); }
+
+    /// Number of nodes and components recorded
+    std::size_t getNbNodes() const { return m_nodes.size(); }
+    std::size_t getNbObjects() const;
+
+    static constexpr unsigned int Version = 1;
+
+    struct DataRecord
+    {
+        std::string name;
+        /// true if value stores the raw bytes of the value, false if it stores its text
+        bool raw { false };
+        /// number of values of a raw value, as given by the type info
+        sofa::Size size { 0 };
+        std::string value;
+    };
+
+    struct LinkRecord
+    {
+        std::string name;
+        std::string value;
+    };
+
+    struct ObjectRecord
+    {
+        std::string name;
+        std::string className;
+        std::string templateName;
+        sofa::type::vector<DataRecord> data;
+        sofa::type::vector<LinkRecord> links;
+    };
+
+    struct NodeRecord
+    {
+        std::string path;
+        sofa::type::vector<DataRecord> data;
+        sofa::type::vector<ObjectRecord> objects;
+    };
+
+    const sofa::type::vector<NodeRecord>& getNodes() const { return m_nodes; }
+
+protected:
+    sofa::type::vector<NodeRecord> m_nodes;
+};
+
+} // namespace sofa::simulation
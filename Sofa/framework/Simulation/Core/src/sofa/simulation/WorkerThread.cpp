@@ -21,6 +21,7 @@
 ******************************************************************************/
 #include <sofa/simulation/WorkerThread.h>
 #include <sofa/simulation/DefaultTaskScheduler.h>
+#include <sofa/helper/TraceRecorder.h>
 
 #include <cassert>
 #include <mutex>
@@ -80,6 +81,7 @@ void WorkerThread::run(void)
         widestr.c_str()
         );
 #endif
+    helper::TraceRecorder::setThreadName(m_name);
 
     //workerThreadIndex = this;
     //TaskSchedulerDefault::_threads[std::this_thread::get_id()] = this;
@@ -153,6 +155,9 @@ void WorkerThread::runTask(Task *task)
     m_currentStatus = task->getStatus();
 
     {
+        static const std::uint32_t taskTraceName = helper::TraceRecorder::intern("Task");
+        helper::TraceRecorder::ScopedEvent traceEvent(taskTraceName);
+
         if (task->run() & Task::MemoryAlloc::Dynamic)
         {
             // pooled memory: call destructor and free
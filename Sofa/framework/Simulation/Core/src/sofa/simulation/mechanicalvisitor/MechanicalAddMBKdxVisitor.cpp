@@ -23,10 +23,14 @@
 #include <sofa/simulation/mechanicalvisitor/MechanicalAddMBKdxVisitor.h>
 
 #include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalAddMBKdxVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* /*mm*/)
 {
     return RESULT_CONTINUE;
@@ -51,7 +55,11 @@ void MechanicalAddMBKdxVisitor::bwdMechanicalMapping(simulation::Node* /*node*/,
 {
     if (accumulate)
     {
-        map->applyJT(mparams, res, res);
+        {
+            PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJT,
+                [map] { return PerformanceCounters::getMappingBytes(map, true); });
+            map->applyJT(mparams, res, res);
+        }
         if( mparams->kFactor() ) map->applyDJT(mparams, res, res);
     }
 }
@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalComputeContactForceVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalComputeContactForceVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* mm)
 {
     mm->accumulateForce(this->params, res.getId(mm));
@@ -41,6 +45,8 @@ Visitor::Result MechanicalComputeContactForceVisitor::fwdMappedMechanicalState(s
 
 void MechanicalComputeContactForceVisitor::bwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
+    PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJT,
+        [map] { return PerformanceCounters::getMappingBytes(map, true); });
     map->applyJT(mparams, res, res);
 }
 
@@ -23,10 +23,14 @@
 #include <sofa/simulation/mechanicalvisitor/MechanicalComputeDfVisitor.h>
 
 #include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalComputeDfVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* /* mm */)
 {
     //<TO REMOVE>
@@ -40,7 +44,12 @@ Visitor::Result MechanicalComputeDfVisitor::fwdMappedMechanicalState(simulation:
 
 Visitor::Result MechanicalComputeDfVisitor::fwdForceField(simulation::Node* /*node*/, core::behavior::BaseForceField* ff)
 {
-    if( !ff->isCompliance.getValue() ) ff->addDForce(this->mparams, res);
+    if( !ff->isCompliance.getValue() )
+    {
+        PerformanceCounters::Scope performance(ff, PerformanceCounterType::AddDForce,
+            [ff] { return PerformanceCounters::getForceFieldBytes(ff, 0, 2); });
+        ff->addDForce(this->mparams, res);
+    }
     return RESULT_CONTINUE;
 }
 
@@ -48,7 +57,11 @@ void MechanicalComputeDfVisitor::bwdMechanicalMapping(simulation::Node* /*node*/
 {
     if (accumulate)
     {
-        map->applyJT(mparams, res, res);  // apply material stiffness: variation of force below the mapping
+        {
+            PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJT,
+                [map] { return PerformanceCounters::getMappingBytes(map, true); });
+            map->applyJT(mparams, res, res);  // apply material stiffness: variation of force below the mapping
+        }
         if( mparams->kFactor() ) map->applyDJT(mparams, res, res); // apply geometric stiffness: variation due to a change of mapping, with a constant force below the mapping
     }
 }
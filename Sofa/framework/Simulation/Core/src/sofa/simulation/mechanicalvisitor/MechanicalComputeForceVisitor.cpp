@@ -23,10 +23,14 @@
 #include <sofa/simulation/mechanicalvisitor/MechanicalComputeForceVisitor.h>
 
 #include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalComputeForceVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* mm)
 {
     mm->accumulateForce(this->params, res.getId(mm));
@@ -43,8 +47,12 @@ Visitor::Result MechanicalComputeForceVisitor::fwdMappedMechanicalState(simulati
 
 Visitor::Result MechanicalComputeForceVisitor::fwdForceField(simulation::Node* /*node*/, core::behavior::BaseForceField* ff)
 {
-    if( !neglectingCompliance || !ff->isCompliance.getValue() ) 
+    if( !neglectingCompliance || !ff->isCompliance.getValue() )
+    {
+        PerformanceCounters::Scope performance(ff, PerformanceCounterType::AddForce,
+            [ff] { return PerformanceCounters::getForceFieldBytes(ff, 1, 2); });
         ff->addForce(this->mparams, res);
+    }
 
     return RESULT_CONTINUE;
 }
@@ -53,6 +61,8 @@ void MechanicalComputeForceVisitor::bwdMechanicalMapping(simulation::Node* /*nod
 {
     if (accumulate)
     {
+        PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJT,
+            [map] { return PerformanceCounters::getMappingBytes(map, true); });
         map->applyJT(mparams, res, res);
     }
 }
@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateDxAndResetForceVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalPropagateDxAndResetForceVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* mm)
 {
     mm->resetForce(this->params, f.getId(mm));
@@ -34,6 +38,8 @@ Visitor::Result MechanicalPropagateDxAndResetForceVisitor::fwdMechanicalState(si
 
 Visitor::Result MechanicalPropagateDxAndResetForceVisitor::fwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
+    PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJ,
+        [map] { return PerformanceCounters::getMappingBytes(map, true); });
     map->applyJ(mparams, dx, dx);
 
     return RESULT_CONTINUE;
@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateDxVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalPropagateDxVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* /*mm*/)
 {
     //<TO REMOVE>
@@ -34,6 +38,8 @@ Visitor::Result MechanicalPropagateDxVisitor::fwdMechanicalState(simulation::Nod
 
 Visitor::Result MechanicalPropagateDxVisitor::fwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
+    PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJ,
+        [map] { return PerformanceCounters::getMappingBytes(map, true); });
     map->applyJ(mparams, dx, dx);
 
     return RESULT_CONTINUE;
@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndResetForceVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 Visitor::Result MechanicalPropagateOnlyPositionAndResetForceVisitor::fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* mm)
 {
     mm->resetForce(this->params, f.getId(mm));
@@ -34,6 +38,8 @@ Visitor::Result MechanicalPropagateOnlyPositionAndResetForceVisitor::fwdMechanic
 
 Visitor::Result MechanicalPropagateOnlyPositionAndResetForceVisitor::fwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
+    PerformanceCounters::Scope performance(map, PerformanceCounterType::Apply,
+        [map] { return PerformanceCounters::getMappingBytes(map, false); });
     map->apply(mparams, x, x);
 
     return RESULT_CONTINUE;
@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 MechanicalPropagateOnlyPositionAndVelocityVisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor(
         const sofa::core::MechanicalParams* mparams,
         SReal time, core::MultiVecCoordId x, core::MultiVecDerivId v)
@@ -42,8 +46,16 @@ Visitor::Result MechanicalPropagateOnlyPositionAndVelocityVisitor::fwdMechanical
 
 Visitor::Result MechanicalPropagateOnlyPositionAndVelocityVisitor::fwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
-    map->apply(mparams, x, x);
-    map->applyJ(mparams, v, v);
+    {
+        PerformanceCounters::Scope performance(map, PerformanceCounterType::Apply,
+            [map] { return PerformanceCounters::getMappingBytes(map, false); });
+        map->apply(mparams, x, x);
+    }
+    {
+        PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJ,
+            [map] { return PerformanceCounters::getMappingBytes(map, true); });
+        map->applyJ(mparams, v, v);
+    }
 
     return RESULT_CONTINUE;
 }
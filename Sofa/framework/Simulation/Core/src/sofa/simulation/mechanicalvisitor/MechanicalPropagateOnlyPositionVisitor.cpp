@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 MechanicalPropagateOnlyPositionVisitor::MechanicalPropagateOnlyPositionVisitor(const sofa::core::MechanicalParams* mparams, SReal t, core::MultiVecCoordId x)
         : MechanicalVisitor(mparams) , t(t), x(x)
 {
@@ -40,6 +44,8 @@ Visitor::Result MechanicalPropagateOnlyPositionVisitor::fwdMechanicalState(simul
 
 Visitor::Result MechanicalPropagateOnlyPositionVisitor::fwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
+    PerformanceCounters::Scope performance(map, PerformanceCounterType::Apply,
+        [map] { return PerformanceCounters::getMappingBytes(map, false); });
     map->apply(mparams, x, x);
 
     return RESULT_CONTINUE;
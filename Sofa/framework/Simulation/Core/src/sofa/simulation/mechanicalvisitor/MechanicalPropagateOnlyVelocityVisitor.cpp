@@ -21,10 +21,14 @@
 ******************************************************************************/
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyVelocityVisitor.h>
+#include <sofa/core/objectmodel/PerformanceCounters.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
 
+using core::objectmodel::PerformanceCounters;
+using core::objectmodel::PerformanceCounterType;
+
 MechanicalPropagateOnlyVelocityVisitor::MechanicalPropagateOnlyVelocityVisitor(
         const sofa::core::MechanicalParams* mparams,
         SReal time, core::MultiVecDerivId v)
@@ -42,6 +46,8 @@ Visitor::Result MechanicalPropagateOnlyVelocityVisitor::fwdMechanicalState(simul
 
 Visitor::Result MechanicalPropagateOnlyVelocityVisitor::fwdMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map)
 {
+    PerformanceCounters::Scope performance(map, PerformanceCounterType::ApplyJ,
+        [map] { return PerformanceCounters::getMappingBytes(map, true); });
     map->applyJ(mparams, v, v);
 
     return RESULT_CONTINUE;
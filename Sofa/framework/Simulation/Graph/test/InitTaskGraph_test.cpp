@@ -0,0 +1,346 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/InitTaskGraph.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/core/loader/BaseLoader.h>
+
+#include <atomic>
+#include <thread>
+
+namespace sofa
+{
+
+using simulation::InitTaskGraph;
+using simulation::Node;
+
+static std::atomic<int> initCounter { 0 };
+
+/// Component recording when it is initialized
+template<class Base>
+struct InitRecorder : public Base
+{
+    SOFA_CLASS(InitRecorder, Base);
+
+    Data<int> d_input;
+    Data<int> d_output;
+    int initStamp { -1 };
+    int bwdInitStamp { -1 };
+    bool threadSafe { true };
+    std::thread::id initThread;
+    std::thread::id bwdInitThread;
+
+    InitRecorder()
+        : d_input(this->initData(&d_input, 0, "input", "input"))
+        , d_output(this->initData(&d_output, 0, "output", "output"))
+    {}
+
+    void init() override
+    {
+        initStamp = initCounter++;
+        initThread = std::this_thread::get_id();
+        d_output.setValue(d_input.getValue() + 1);
+    }
+
+    void bwdInit() override
+    {
+        bwdInitStamp = initCounter++;
+        bwdInitThread = std::this_thread::get_id();
+    }
+
+    bool isInitThreadSafe() const override { return threadSafe; }
+
+    bool load() { return true; }
+};
+
+struct TestLoader : public InitRecorder<core::loader::BaseLoader>
+{
+    SOFA_CLASS(TestLoader, SOFA_TEMPLATE(InitRecorder, core::loader::BaseLoader));
+};
+
+using Recorder = InitRecorder<core::objectmodel::BaseObject>;
+
+/// Component creating a child node with a component during its initialization
+struct NodeCreator : public core::objectmodel::BaseObject
+{
+    SOFA_CLASS(NodeCreator, core::objectmodel::BaseObject);
+
+    Node::SPtr createdNode;
+    Recorder::SPtr createdObject;
+
+    void init() override
+    {
+        Node* node = static_cast<Node*>(this->getContext());
+        createdNode = node->createChild("created");
+        createdObject = core::objectmodel::New<Recorder>();
+        createdNode->addObject(createdObject);
+    }
+};
+
+struct InitTaskGraph_test : public BaseTest
+{
+    Node::SPtr root;
+    Node::SPtr child1;
+    Node::SPtr child2;
+    Recorder::SPtr rootObject;
+    TestLoader::SPtr loader1;
+    TestLoader::SPtr loader2;
+    Recorder::SPtr child1Object;
+    Recorder::SPtr child2Object;
+
+    void onSetUp() override
+    {
+        initCounter = 0;
+
+        // root: rootObject
+        //   child1: loader1, loader2, child1Object (reading loader2)
+        //   child2: child2Object (reading child1Object)
+        root = simulation::getSimulation()->createNewGraph("root");
+        child1 = root->createChild("child1");
+        child2 = root->createChild("child2");
+
+        rootObject = core::objectmodel::New<Recorder>();
+        root->addObject(rootObject);
+
+        loader1 = core::objectmodel::New<TestLoader>();
+        loader2 = core::objectmodel::New<TestLoader>();
+        child1Object = core::objectmodel::New<Recorder>();
+        child1->addObject(loader1);
+        child1->addObject(loader2);
+        child1->addObject(child1Object);
+        child1Object->d_input.setParent(&loader2->d_output);
+
+        child2Object = core::objectmodel::New<Recorder>();
+        child2->addObject(child2Object);
+        child2Object->d_input.setParent(&child1Object->d_output);
+    }
+
+    void onTearDown() override
+    {
+        simulation::node::unload(root);
+    }
+
+    static std::size_t findTask(const sofa::type::vector<InitTaskGraph::Task>& tasks, const core::objectmodel::BaseObject* object)
+    {
+        for (std::size_t i = 0; i < tasks.size(); ++i)
+        {
+            if (tasks[i].object == object)
+            {
+                return i;
+            }
+        }
+        return tasks.size();
+    }
+
+    static bool dependsOn(const sofa::type::vector<InitTaskGraph::Task>& tasks, std::size_t task, std::size_t dependency)
+    {
+        // transitive dependency: the predecessors are before in the graph order
+        if (task == dependency)
+        {
+            return true;
+        }
+        for (const std::size_t p : tasks[task].predecessors)
+        {
+            if (p >= dependency && dependsOn(tasks, p, dependency))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Checks that the stamps are compatible with the dependencies
+    template<class GetStamp>
+    static void checkOrder(const sofa::type::vector<InitTaskGraph::Task>& tasks, GetStamp stamp)
+    {
+        for (const auto& task : tasks)
+        {
+            for (const std::size_t p : task.predecessors)
+            {
+                if (task.object && tasks[p].object)
+                {
+                    EXPECT_LT(stamp(tasks[p].object), stamp(task.object)) << tasks[p].object->getName() << " / " << task.object->getName();
+                }
+            }
+        }
+    }
+};
+
+TEST_F(InitTaskGraph_test, initDependencies)
+{
+    const InitTaskGraph graph(root.get());
+    const auto& tasks = graph.getInitTasks();
+
+    // 3 nodes, 5 components
+    ASSERT_EQ(tasks.size(), 8);
+
+    const auto root = findTask(tasks, rootObject.get());
+    const auto l1 = findTask(tasks, loader1.get());
+    const auto l2 = findTask(tasks, loader2.get());
+    const auto c1 = findTask(tasks, child1Object.get());
+    const auto c2 = findTask(tasks, child2Object.get());
+
+    EXPECT_TRUE(dependsOn(tasks, l1, root));
+    EXPECT_TRUE(dependsOn(tasks, c2, root));
+
+    // the loaders are independent
+    EXPECT_FALSE(dependsOn(tasks, l2, l1));
+    EXPECT_TRUE(dependsOn(tasks, c1, l1));
+    EXPECT_TRUE(dependsOn(tasks, c1, l2));
+
+    // the sibling nodes are only ordered by the Data link
+    EXPECT_TRUE(dependsOn(tasks, c2, c1));
+    EXPECT_FALSE(dependsOn(tasks, c2, l1));
+}
+
+TEST_F(InitTaskGraph_test, bwdInitDependencies)
+{
+    const InitTaskGraph graph(root.get());
+    const auto& tasks = graph.getBwdInitTasks();
+
+    ASSERT_EQ(tasks.size(), 5);
+
+    const auto root = findTask(tasks, rootObject.get());
+    const auto l1 = findTask(tasks, loader1.get());
+    const auto l2 = findTask(tasks, loader2.get());
+    const auto c1 = findTask(tasks, child1Object.get());
+
+    // reverse order in a node, children before their parent
+    EXPECT_TRUE(dependsOn(tasks, l1, l2));
+    EXPECT_TRUE(dependsOn(tasks, l2, c1));
+    EXPECT_TRUE(dependsOn(tasks, root, l1));
+    EXPECT_TRUE(dependsOn(tasks, root, findTask(tasks, child2Object.get())));
+}
+
+TEST_F(InitTaskGraph_test, sequentialRun)
+{
+    InitTaskGraph graph(root.get());
+    graph.run(nullptr);
+
+    // sequential: same order as InitVisitor
+    EXPECT_EQ(rootObject->initStamp, 0);
+    EXPECT_EQ(loader1->initStamp, 1);
+    EXPECT_EQ(loader2->initStamp, 2);
+    EXPECT_EQ(child1Object->initStamp, 3);
+    EXPECT_EQ(child2Object->initStamp, 4);
+    EXPECT_EQ(child2Object->d_input.getValue(), 2);
+    EXPECT_TRUE(child1->isInitialized());
+}
+
+TEST_F(InitTaskGraph_test, parallelRun)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    taskScheduler->init(4);
+
+    InitTaskGraph graph(root.get());
+    graph.run(taskScheduler);
+
+    const auto initStamp = [](const core::objectmodel::BaseObject* o)
+    {
+        const auto* loader = dynamic_cast<const TestLoader*>(o);
+        return loader ? loader->initStamp : static_cast<const Recorder*>(o)->initStamp;
+    };
+    const auto bwdInitStamp = [](const core::objectmodel::BaseObject* o)
+    {
+        const auto* loader = dynamic_cast<const TestLoader*>(o);
+        return loader ? loader->bwdInitStamp : static_cast<const Recorder*>(o)->bwdInitStamp;
+    };
+
+    const std::vector<const core::objectmodel::BaseObject*> objects {
+        rootObject.get(), loader1.get(), loader2.get(), child1Object.get(), child2Object.get() };
+    for (const auto* object : objects)
+    {
+        EXPECT_GE(initStamp(object), 0);
+        EXPECT_GE(bwdInitStamp(object), 0);
+    }
+
+    checkOrder(graph.getInitTasks(), initStamp);
+    checkOrder(graph.getBwdInitTasks(), bwdInitStamp);
+
+    EXPECT_EQ(child2Object->d_input.getValue(), 2);
+    EXPECT_TRUE(child2->isInitialized());
+
+    taskScheduler->stop();
+}
+
+TEST_F(InitTaskGraph_test, nodeInit)
+{
+    root->d_parallelInit.setValue(true);
+    simulation::node::init(root.get());
+
+    EXPECT_GE(rootObject->initStamp, 0);
+    EXPECT_GE(child2Object->initStamp, 0);
+    EXPECT_GT(child2Object->initStamp, child1Object->initStamp);
+    EXPECT_GE(loader1->bwdInitStamp, 0);
+    EXPECT_EQ(child2Object->d_input.getValue(), 2);
+}
+
+TEST_F(InitTaskGraph_test, parallelRunNotThreadSafe)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    taskScheduler->init(4);
+
+    rootObject->threadSafe = false;
+    child1Object->threadSafe = false;
+
+    InitTaskGraph graph(root.get());
+    graph.run(taskScheduler);
+
+    // the components that are not thread-safe are initialized by the calling thread
+    EXPECT_EQ(rootObject->initThread, std::this_thread::get_id());
+    EXPECT_EQ(rootObject->bwdInitThread, std::this_thread::get_id());
+    EXPECT_EQ(child1Object->initThread, std::this_thread::get_id());
+    EXPECT_EQ(child1Object->bwdInitThread, std::this_thread::get_id());
+
+    EXPECT_GT(child1Object->initStamp, loader2->initStamp);
+    EXPECT_GT(child2Object->initStamp, child1Object->initStamp);
+    EXPECT_EQ(child2Object->d_input.getValue(), 2);
+
+    taskScheduler->stop();
+}
+
+TEST_F(InitTaskGraph_test, createdNodes)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    taskScheduler->init(4);
+
+    const auto creator = core::objectmodel::New<NodeCreator>();
+    child2->addObject(creator);
+
+    InitTaskGraph graph(root.get());
+    graph.run(taskScheduler);
+
+    // the node created during the initialization is initialized, as by InitVisitor
+    ASSERT_NE(creator->createdNode, nullptr);
+    EXPECT_TRUE(creator->createdNode->isInitialized());
+    EXPECT_GE(creator->createdObject->initStamp, 0);
+    EXPECT_GE(creator->createdObject->bwdInitStamp, 0);
+
+    taskScheduler->stop();
+}
+
+}
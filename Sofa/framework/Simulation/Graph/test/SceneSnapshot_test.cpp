@@ -0,0 +1,150 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <sofa/testing/TestMessageHandler.h>
+
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/simulation/SceneSnapshot.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+
+#include <filesystem>
+
+namespace sofa
+{
+
+using simulation::SceneSnapshot;
+using simulation::Node;
+typedef sofa::component::statecontainer::MechanicalObject<defaulttype::Vec3Types> MechanicalObject3;
+
+struct SceneSnapshot_test : public BaseTest
+{
+    Node::SPtr root;
+    Node::SPtr child;
+    MechanicalObject3::SPtr dofs;
+
+    void onSetUp() override
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+        child = root->createChild("child");
+
+        dofs = core::objectmodel::New<MechanicalObject3>();
+        dofs->setName("dofs");
+        child->addObject(dofs);
+        dofs->resize(3);
+
+        auto x = dofs->writePositions();
+        x[0] = type::Vec3(0, 0, 0);
+        x[1] = type::Vec3(1, 0, 0);
+        x[2] = type::Vec3(0, 1, 0);
+    }
+
+    void onTearDown() override
+    {
+        simulation::node::unload(root);
+    }
+
+    void modify()
+    {
+        dofs->resize(5);
+        dofs->writePositions()[1] = type::Vec3(4, 5, 6);
+        root->setTime(2.5);
+        dofs->showObject.setValue(true);
+    }
+
+    void checkRestored()
+    {
+        const auto x = dofs->readPositions();
+        ASSERT_EQ(x.size(), 3);
+        EXPECT_EQ(x[1], type::Vec3(1, 0, 0));
+        EXPECT_EQ(root->getTime(), 0);
+        EXPECT_FALSE(dofs->showObject.getValue());
+    }
+};
+
+TEST_F(SceneSnapshot_test, captureRestore)
+{
+    SceneSnapshot snapshot;
+    snapshot.capture(root.get());
+    EXPECT_EQ(snapshot.getNbNodes(), 2);
+    EXPECT_EQ(snapshot.getNbObjects(), 1);
+
+    modify();
+    EXPECT_TRUE(snapshot.restore(root.get()));
+    checkRestored();
+}
+
+TEST_F(SceneSnapshot_test, unchangedDataAreNotModified)
+{
+    SceneSnapshot snapshot;
+    snapshot.capture(root.get());
+
+    const int counter = dofs->x.getCounter();
+    EXPECT_TRUE(snapshot.restore(root.get()));
+    EXPECT_EQ(dofs->x.getCounter(), counter);
+}
+
+TEST_F(SceneSnapshot_test, saveLoad)
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "SceneSnapshot_test.snapshot").string();
+
+    SceneSnapshot saved;
+    saved.capture(root.get());
+    EXPECT_TRUE(saved.save(filename));
+
+    modify();
+
+    SceneSnapshot loaded;
+    EXPECT_TRUE(loaded.load(filename));
+    EXPECT_EQ(loaded.getNbObjects(), 1);
+    EXPECT_TRUE(loaded.restore(root.get()));
+    checkRestored();
+
+    std::filesystem::remove(filename);
+}
+
+TEST_F(SceneSnapshot_test, differentGraph)
+{
+    SceneSnapshot snapshot;
+    snapshot.capture(root.get());
+
+    modify();
+    child->addObject(core::objectmodel::New<MechanicalObject3>());
+
+    {
+        EXPECT_MSG_EMIT(Error);
+        EXPECT_FALSE(snapshot.restore(root.get()));
+    }
+    EXPECT_EQ(dofs->readPositions().size(), 5);
+}
+
+TEST_F(SceneSnapshot_test, invalidFile)
+{
+    EXPECT_MSG_EMIT(Error);
+    SceneSnapshot snapshot;
+    EXPECT_FALSE(snapshot.load("nonexistent.snapshot"));
+    EXPECT_TRUE(snapshot.empty());
+}
+
+}
@@ -182,7 +182,9 @@ void ParallelHexahedronFEMForceField<DataTypes>::computeTaskForceLarge(RDataRefV
     }
 
     sofa::type::Vec<24, Real> F; //forces
-    this->computeForce( F, D, elementStiffnesses[elementId] ); // compute force on element
+    // the stiffness matrices may be shared between congruent elements (see shareStiffnessMatrices)
+    const auto stiffnessId = this->m_stiffnessClasses.empty() ? elementId : this->m_stiffnessClasses[elementId];
+    this->computeForce( F, D, elementStiffnesses[stiffnessId] ); // compute force on element
 
     for(int w=0; w<8; ++w)
         OutF[w] += this->_rotations[elementId].multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2]  ) );
@@ -219,7 +221,6 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
          {
              auto elementId = std::distance(indexedElements.begin(), range.start);
              auto elementsDfIt = m_elementsDf.begin() + elementId;
-             auto elementStiffnessesIt = elementStiffnesses.begin() + elementId;
              auto rotationIt = this->_rotations.begin() + elementId;
 
              for (auto it = range.start; it != range.end; ++it, ++elementId)
@@ -240,7 +241,8 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
                  }
 
                  // F = K * X
-                 this->computeForce(F, X, *elementStiffnessesIt++);
+                 const auto stiffnessId = this->m_stiffnessClasses.empty() ? elementId : this->m_stiffnessClasses[elementId];
+                 this->computeForce(F, X, elementStiffnesses[stiffnessId]);
 
                  sofa::type::Vec<8, Deriv>& df = *elementsDfIt++;
                  for (sofa::Size w = 0; w < 8; ++w)
@@ -46,6 +46,7 @@ using sofa::scenechecking::SceneCheckerListener;
 #include <sofa/helper/Factory.h>
 #include <sofa/helper/cast.h>
 #include <sofa/helper/BackTrace.h>
+#include <sofa/helper/TraceRecorder.h>
 #include <sofa/helper/system/FileRepository.h>
 #include <sofa/helper/system/FileSystem.h>
 using sofa::helper::system::FileSystem;
@@ -127,6 +128,9 @@ int main(int argc, char** argv)
 
     sofa::helper::BackTrace::autodump();
 
+    // name of the lane of the main thread in the exported traces (see SOFA_TRACE_FILE)
+    sofa::helper::TraceRecorder::setThreadName("Main");
+
 #ifdef WIN32
     {
         HANDLE hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
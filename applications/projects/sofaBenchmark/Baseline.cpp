@@ -0,0 +1,117 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Baseline.h"
+
+#include <sofa/helper/logging/Messaging.h>
+
+#include <json.h>
+
+#include <fstream>
+
+namespace sofa::benchmark
+{
+
+using sofa::helper::json;
+
+namespace
+{
+
+const char* const stepsPerSecondCounter = "steps_per_second";
+
+} // anonymous namespace
+
+bool readBaseline(const std::string& filename, StepsPerSecond& baseline)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        msg_error("sofaBenchmark") << "Cannot open the baseline file " << filename;
+        return false;
+    }
+
+    json content;
+    try
+    {
+        file >> content;
+    }
+    catch (const json::exception& e)
+    {
+        msg_error("sofaBenchmark") << "Cannot parse the baseline file " << filename << ": " << e.what();
+        return false;
+    }
+
+    const auto benchmarks = content.find("benchmarks");
+    if (benchmarks == content.end() || !benchmarks->is_array())
+    {
+        msg_error("sofaBenchmark") << "The baseline file " << filename << " does not contain any benchmark";
+        return false;
+    }
+
+    for (const auto& run : *benchmarks)
+    {
+        if (run.value("run_type", "iteration") != "iteration")
+            continue;
+
+        const auto name = run.find("name");
+        const auto value = run.find(stepsPerSecondCounter);
+        if (name != run.end() && value != run.end() && value->is_number())
+        {
+            baseline[name->get<std::string>()] = value->get<double>();
+        }
+    }
+    return true;
+}
+
+std::vector<Regression> compareToBaseline(const StepsPerSecond& baseline, const StepsPerSecond& current, double tolerance)
+{
+    std::vector<Regression> regressions;
+    for (const auto& [name, value] : current)
+    {
+        const auto it = baseline.find(name);
+        if (it == baseline.end())
+            continue;
+
+        if (value < it->second * (1.0 - tolerance))
+        {
+            regressions.push_back({name, it->second, value});
+        }
+    }
+    return regressions;
+}
+
+void RecordingReporter::ReportRuns(const std::vector<Run>& reports)
+{
+    for (const auto& run : reports)
+    {
+        if (run.run_type != Run::RT_Iteration)
+            continue;
+
+        const auto counter = run.counters.find(stepsPerSecondCounter);
+        if (counter != run.counters.end())
+        {
+            m_stepsPerSecond[run.benchmark_name()] = counter->second.value;
+        }
+    }
+    ::benchmark::ConsoleReporter::ReportRuns(reports);
+}
+
+} // namespace sofa::benchmark
@@ -0,0 +1,68 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sofa::benchmark
+{
+
+/// Number of time steps per second, by benchmark name
+using StepsPerSecond = std::map<std::string, double>;
+
+/**
+ * Reads a baseline written by a previous run with --benchmark_out=<file> --benchmark_out_format=json.
+ * Only the "steps_per_second" counter of the non-aggregate runs is read.
+ * Returns false if the file cannot be read or parsed.
+ */
+bool readBaseline(const std::string& filename, StepsPerSecond& baseline);
+
+struct Regression
+{
+    std::string name;
+    double baseline;
+    double current;
+};
+
+/**
+ * Lists the benchmarks whose number of steps per second dropped by more than @tolerance
+ * (relative, e.g. 0.1 for 10%) compared to the baseline. Benchmarks missing in the baseline are ignored.
+ */
+std::vector<Regression> compareToBaseline(const StepsPerSecond& baseline, const StepsPerSecond& current, double tolerance);
+
+/// Console reporter which also keeps the number of steps per second of each run
+class RecordingReporter : public ::benchmark::ConsoleReporter
+{
+public:
+    void ReportRuns(const std::vector<Run>& reports) override;
+
+    const StepsPerSecond& getStepsPerSecond() const { return m_stepsPerSecond; }
+
+private:
+    StepsPerSecond m_stepsPerSecond;
+};
+
+} // namespace sofa::benchmark
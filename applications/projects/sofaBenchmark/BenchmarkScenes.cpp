@@ -0,0 +1,166 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/Node.h>
+
+#include <algorithm>
+
+namespace sofa::benchmark
+{
+
+using sofa::simpleapi::createChild;
+using sofa::simpleapi::createObject;
+using sofa::simpleapi::str;
+
+namespace
+{
+
+std::string vec3(double x, double y, double z)
+{
+    return str(x) + " " + str(y) + " " + str(z);
+}
+
+simulation::NodeSPtr createRoot()
+{
+    auto root = sofa::simpleapi::createRootNode(sofa::simulation::getSimulation(), "root",
+        {{"dt", "0.01"}, {"gravity", "0 -9.81 0"}});
+    createObject(root, "DefaultAnimationLoop");
+    return root;
+}
+
+void addSolvers(simulation::NodeSPtr node, const SceneParameters& parameters)
+{
+    createObject(node, "EulerImplicitSolver", {{"rayleighStiffness", "0.1"}, {"rayleighMass", "0.1"}});
+    switch (parameters.linearSolver)
+    {
+        case LinearSolverType::CG:
+            createObject(node, parameters.parallel ? "ParallelCGLinearSolver" : "CGLinearSolver",
+                {{"iterations", "25"}, {"tolerance", "1e-9"}, {"threshold", "1e-9"}});
+            break;
+        case LinearSolverType::SparseLDL:
+            createObject(node, "SparseLDLSolver", {{"template", "CompressedRowSparseMatrixMat3x3"}});
+            break;
+        case LinearSolverType::EigenLDLT:
+            createObject(node, "EigenSimplicialLDLT");
+            break;
+    }
+}
+
+/// Beam of tetrahedra along z, fixed at z = 0, with nx * ny * nz hexahedra split into 6 tetrahedra
+void addTetrahedronBeam(simulation::NodeSPtr node, unsigned int nx, unsigned int ny, unsigned int nz, bool parallel)
+{
+    createObject(node, "RegularGridTopology", {{"name", "grid"},
+        {"min", vec3(0, 0, 0)}, {"max", vec3(nx, ny, nz)}, {"n", str(nx + 1) + " " + str(ny + 1) + " " + str(nz + 1)}});
+    createObject(node, "MechanicalObject", {{"name", "dofs"}, {"template", "Vec3"}});
+
+    createObject(node, "TetrahedronSetTopologyContainer", {{"name", "tetrahedra"}});
+    createObject(node, "TetrahedronSetTopologyModifier");
+    createObject(node, "Hexa2TetraTopologicalMapping", {{"input", "@grid"}, {"output", "@tetrahedra"}});
+
+    createObject(node, "DiagonalMass", {{"massDensity", "0.2"}, {"topology", "@tetrahedra"}});
+    createObject(node, parallel ? "ParallelTetrahedronFEMForceField" : "TetrahedronFEMForceField",
+        {{"youngModulus", "1000"}, {"poissonRatio", "0.4"}, {"method", "large"}, {"topology", "@tetrahedra"}});
+
+    createObject(node, "BoxROI", {{"name", "fixedBox"}, {"box", vec3(-0.1, -0.1, -0.1) + " " + vec3(nx + 0.1, ny + 0.1, 0.1)}});
+    createObject(node, "FixedProjectiveConstraint", {{"indices", "@fixedBox.indices"}});
+}
+
+} // anonymous namespace
+
+std::string toString(LinearSolverType solver)
+{
+    switch (solver)
+    {
+        case LinearSolverType::CG:        return "CG";
+        case LinearSolverType::SparseLDL: return "SparseLDL";
+        case LinearSolverType::EigenLDLT: return "EigenLDLT";
+    }
+    return "unknown";
+}
+
+bool importScenePlugins(bool parallel)
+{
+    sofa::simpleapi::importPlugin("Sofa.Component");
+    return !parallel || sofa::simpleapi::importPlugin("MultiThreading");
+}
+
+simulation::NodeSPtr createTetrahedronFEMScene(const SceneParameters& parameters)
+{
+    auto root = createRoot();
+    auto beam = createChild(root, "beam");
+    addSolvers(beam, parameters);
+    addTetrahedronBeam(beam, parameters.size, parameters.size, 4 * parameters.size, parameters.parallel);
+    return root;
+}
+
+simulation::NodeSPtr createContactScene(const SceneParameters& parameters)
+{
+    auto root = createRoot();
+    const unsigned int size = std::max(parameters.size, 2u);
+
+    createObject(root, "CollisionPipeline");
+    createObject(root, parameters.parallel ? "ParallelBruteForceBroadPhase" : "BruteForceBroadPhase");
+    createObject(root, parameters.parallel ? "ParallelBVHNarrowPhase" : "BVHNarrowPhase");
+    createObject(root, "NewProximityIntersection", {{"alarmDistance", "0.3"}, {"contactDistance", "0.1"}});
+    createObject(root, "CollisionResponse", {{"response", "PenalityContactForceField"}});
+
+    auto particles = createChild(root, "particles");
+    addSolvers(particles, parameters);
+    createObject(particles, "RegularGridTopology", {{"name", "grid"},
+        {"min", vec3(0, 0.5, 0)}, {"max", vec3(size - 1, 1.5, size - 1)}, {"n", str(size) + " 2 " + str(size)}});
+    createObject(particles, "MechanicalObject", {{"name", "dofs"}, {"template", "Vec3"}});
+    createObject(particles, "UniformMass", {{"totalMass", str(0.1 * size * size)}});
+    createObject(particles, "SphereCollisionModel", {{"radius", "0.4"}});
+
+    // two upward triangles under the particles
+    const double low = -1.0;
+    const double high = size;
+    auto floor = createChild(root, "floor");
+    createObject(floor, "MeshTopology", {
+        {"position", vec3(low, 0, low) + " " + vec3(high, 0, low) + " " + vec3(high, 0, high) + " " + vec3(low, 0, high)},
+        {"triangles", "0 2 1 0 3 2"}});
+    createObject(floor, "MechanicalObject", {{"name", "dofs"}, {"template", "Vec3"}});
+    createObject(floor, "TriangleCollisionModel", {{"moving", "false"}, {"simulated", "false"}});
+
+    return root;
+}
+
+simulation::NodeSPtr createMappedVerticesScene(const SceneParameters& parameters)
+{
+    auto root = createRoot();
+    auto beam = createChild(root, "beam");
+    addSolvers(beam, parameters);
+    addTetrahedronBeam(beam, 2, 2, 8, parameters.parallel);
+
+    const unsigned int size = std::max(parameters.size, 2u);
+    auto mapped = createChild(beam, "mapped");
+    createObject(mapped, "RegularGridTopology", {{"name", "grid"},
+        {"min", vec3(0.05, 0.05, 0.05)}, {"max", vec3(1.95, 1.95, 7.95)}, {"n", str(size) + " " + str(size) + " " + str(size)}});
+    createObject(mapped, "MechanicalObject", {{"name", "dofs"}, {"template", "Vec3"}});
+    createObject(mapped, "BarycentricMapping");
+
+    return root;
+}
+
+} // namespace sofa::benchmark
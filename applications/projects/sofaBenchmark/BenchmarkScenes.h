@@ -0,0 +1,68 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/fwd.h>
+
+#include <string>
+#include <vector>
+
+namespace sofa::benchmark
+{
+
+/// Linear solvers available in the generated scenes
+enum class LinearSolverType
+{
+    CG,
+    SparseLDL,
+    EigenLDLT
+};
+
+std::string toString(LinearSolverType solver);
+
+/// Parameters of a generated scene
+struct SceneParameters
+{
+    /// Size of the scene: number of cells along the smallest side of the FEM grids, number of
+    /// particles along a side of the contact grid, or number of mapped vertices along a side
+    unsigned int size { 4 };
+
+    LinearSolverType linearSolver { LinearSolverType::CG };
+
+    /// If true, the parallel implementations of the MultiThreading plugin are used when available
+    bool parallel { false };
+};
+
+/// Beam of tetrahedral finite elements, with 6 * size * size * 4 * size tetrahedra
+simulation::NodeSPtr createTetrahedronFEMScene(const SceneParameters& parameters);
+
+/// size * size * 2 particles falling on a plane, with penalty contacts
+simulation::NodeSPtr createContactScene(const SceneParameters& parameters);
+
+/// Coarse FEM beam with size * size * size vertices mapped by a BarycentricMapping
+simulation::NodeSPtr createMappedVerticesScene(const SceneParameters& parameters);
+
+/// Loads the plugins required by the generated scenes. Returns false if the parallel
+/// implementations are requested but not available.
+bool importScenePlugins(bool parallel);
+
+} // namespace sofa::benchmark
@@ -0,0 +1,272 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Baseline.h"
+#include "BenchmarkScenes.h"
+#include "SceneBenchmark.h"
+
+#include <sofa/component/init.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/helper/system/PluginManager.h>
+#include <sofa/helper/StringUtils.h>
+#include <sofa/helper/TraceRecorder.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/common/init.h>
+#include <sofa/simulation/graph/init.h>
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using sofa::benchmark::LinearSolverType;
+using sofa::benchmark::SceneParameters;
+
+struct Options
+{
+    std::vector<std::string> sceneFiles;
+    std::vector<std::string> plugins;
+    std::vector<unsigned int> sizes { 2, 4, 8 };
+    std::vector<unsigned int> threads { 1 };
+    std::string baseline;
+    double tolerance { 0.1 };
+    bool generatedScenes { true };
+};
+
+void printUsage()
+{
+    std::cout << "Usage: sofaBenchmark [options] [google benchmark options]\n"
+                 "  --scene=<file>        benchmark a scene file (can be repeated)\n"
+                 "  --plugin=<name>       load a plugin before loading the scene files (can be repeated)\n"
+                 "  --no-generated        do not run the generated scenes\n"
+                 "  --sizes=<s1,s2,...>   sizes of the generated scenes (default: 2,4,8)\n"
+                 "  --threads=<t1,t2,...> numbers of threads (default: 1)\n"
+                 "  --baseline=<file>     compare to a previous run saved with --benchmark_out=<file>\n"
+                 "  --tolerance=<ratio>   allowed relative drop of steps per second (default: 0.1)\n"
+              << std::endl;
+}
+
+std::vector<unsigned int> parseList(const std::string& value)
+{
+    std::vector<unsigned int> list;
+    for (const auto& item : sofa::helper::split(value, ','))
+    {
+        list.push_back(static_cast<unsigned int>(std::stoul(item)));
+    }
+    return list;
+}
+
+/// Extracts the options of this application from the command line, and leaves the other ones to Google Benchmark
+bool parseOptions(int& argc, char** argv, Options& options)
+{
+    int nbRemaining = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+
+        try
+        {
+            if (arg.rfind("--scene=", 0) == 0)
+                options.sceneFiles.push_back(value());
+            else if (arg.rfind("--plugin=", 0) == 0)
+                options.plugins.push_back(value());
+            else if (arg == "--no-generated")
+                options.generatedScenes = false;
+            else if (arg.rfind("--sizes=", 0) == 0)
+                options.sizes = parseList(value());
+            else if (arg.rfind("--threads=", 0) == 0)
+                options.threads = parseList(value());
+            else if (arg.rfind("--baseline=", 0) == 0)
+                options.baseline = value();
+            else if (arg.rfind("--tolerance=", 0) == 0)
+                options.tolerance = std::stod(value());
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage();
+                argv[nbRemaining++] = argv[i];
+            }
+            else
+                argv[nbRemaining++] = argv[i];
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid value in " << arg << std::endl;
+            return false;
+        }
+    }
+    argc = nbRemaining;
+    return true;
+}
+
+void registerGeneratedScenes(const Options& options, bool parallelAvailable)
+{
+    using Creator = sofa::simulation::NodeSPtr(*)(const SceneParameters&);
+    const std::vector<std::pair<std::string, Creator>> scenes {
+        {"TetrahedronFEM", &sofa::benchmark::createTetrahedronFEMScene},
+        {"Contact", &sofa::benchmark::createContactScene},
+        {"MappedVertices", &sofa::benchmark::createMappedVerticesScene}
+    };
+    const std::vector<LinearSolverType> solvers { LinearSolverType::CG, LinearSolverType::SparseLDL, LinearSolverType::EigenLDLT };
+
+    for (const auto& [sceneName, creator] : scenes)
+    {
+        for (const auto solver : solvers)
+        {
+            // the linear solver is only swept on the scene where it dominates
+            if (solver != LinearSolverType::CG && creator != &sofa::benchmark::createTetrahedronFEMScene)
+                continue;
+
+            for (const auto size : options.sizes)
+            {
+                for (const auto nbThreads : options.threads)
+                {
+                    if (nbThreads != 1 && !parallelAvailable)
+                        continue;
+
+                    SceneParameters parameters;
+                    parameters.size = size;
+                    parameters.linearSolver = solver;
+                    parameters.parallel = nbThreads != 1;
+
+                    const std::string name = sceneName + "/solver:" + sofa::benchmark::toString(solver)
+                        + "/size:" + std::to_string(size) + "/threads:" + std::to_string(nbThreads);
+
+                    ::benchmark::RegisterBenchmark(name.c_str(),
+                        [creator = creator, parameters, nbThreads = nbThreads](::benchmark::State& state)
+                        {
+                            sofa::benchmark::runSceneBenchmark(state, [&]() { return creator(parameters); }, nbThreads);
+                        })->Unit(::benchmark::kMillisecond);
+                }
+            }
+        }
+    }
+}
+
+void registerSceneFiles(const Options& options, bool parallelAvailable)
+{
+    for (const auto& filename : options.sceneFiles)
+    {
+        for (const auto nbThreads : options.threads)
+        {
+            if (nbThreads != 1 && !parallelAvailable)
+                continue;
+
+            const std::string name = "Scene/" + filename + "/threads:" + std::to_string(nbThreads);
+            ::benchmark::RegisterBenchmark(name.c_str(),
+                [filename = filename, nbThreads = nbThreads](::benchmark::State& state)
+                {
+                    sofa::benchmark::runSceneFileBenchmark(state, filename, nbThreads);
+                })->Unit(::benchmark::kMillisecond);
+        }
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    // name of the lane of the main thread in the exported traces (see SOFA_TRACE_FILE)
+    sofa::helper::TraceRecorder::setThreadName("Main");
+
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        printUsage();
+        return 1;
+    }
+
+    sofa::simulation::common::init();
+    sofa::simulation::graph::init();
+    sofa::component::init();
+
+    bool parallelAvailable = false;
+    for (const auto nbThreads : options.threads)
+    {
+        if (nbThreads != 1)
+        {
+            parallelAvailable = sofa::benchmark::importScenePlugins(true);
+            if (!parallelAvailable)
+            {
+                msg_warning("sofaBenchmark") << "The MultiThreading plugin is not available: "
+                                                "the benchmarks on more than one thread are skipped";
+            }
+            break;
+        }
+    }
+    if (!parallelAvailable)
+    {
+        sofa::benchmark::importScenePlugins(false);
+    }
+
+    for (const auto& plugin : options.plugins)
+    {
+        sofa::helper::system::PluginManager::getInstance().loadPlugin(plugin);
+    }
+    sofa::helper::system::PluginManager::getInstance().init();
+
+    if (options.generatedScenes)
+    {
+        registerGeneratedScenes(options, parallelAvailable);
+    }
+    registerSceneFiles(options, parallelAvailable);
+
+    sofa::benchmark::RecordingReporter reporter;
+    ::benchmark::RunSpecifiedBenchmarks(&reporter);
+    ::benchmark::Shutdown();
+
+    int returnCode = 0;
+    if (!options.baseline.empty())
+    {
+        sofa::benchmark::StepsPerSecond baseline;
+        if (!sofa::benchmark::readBaseline(options.baseline, baseline))
+        {
+            returnCode = 1;
+        }
+        else
+        {
+            const auto regressions = sofa::benchmark::compareToBaseline(baseline, reporter.getStepsPerSecond(), options.tolerance);
+            for (const auto& regression : regressions)
+            {
+                std::cout << "REGRESSION " << regression.name << ": " << regression.current
+                          << " steps/s (baseline: " << regression.baseline << " steps/s)" << std::endl;
+            }
+            std::cout << regressions.size() << " regression(s) over " << reporter.getStepsPerSecond().size()
+                      << " benchmark(s) with a tolerance of " << options.tolerance * 100 << "%" << std::endl;
+            returnCode = regressions.empty() ? 0 : 1;
+        }
+    }
+
+    sofa::simulation::common::cleanup();
+    sofa::simulation::graph::cleanup();
+    return returnCode;
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "SceneBenchmark.h"
+
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/system/FileRepository.h>
+#include <sofa/helper/system/thread/CTime.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+
+#if defined(WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#endif
+
+namespace sofa::benchmark
+{
+
+using sofa::helper::AdvancedTimer;
+
+namespace
+{
+
+const char* const timerName = "Animate";
+
+void initTaskScheduler(unsigned int nbThreads)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    if (taskScheduler->getThreadCount() != nbThreads || nbThreads == 0)
+    {
+        taskScheduler->init(nbThreads);
+    }
+}
+
+void setupTimer()
+{
+    AdvancedTimer::clear();
+    AdvancedTimer::setEnabled(timerName, true);
+    // statistics accumulate over all the iterations and are never printed
+    AdvancedTimer::setInterval(timerName, std::numeric_limits<int>::max());
+    AdvancedTimer::setOutputType(timerName, "stdout");
+}
+
+/// Mean duration per time step of the phases at the first level under the "Animate" timer
+void setPhaseCounters(::benchmark::State& state)
+{
+    const auto steps = AdvancedTimer::getStepData(timerName, false);
+    const double ticksToMs = 1000.0 / static_cast<double>(sofa::helper::system::thread::CTime::getTicksPerSec());
+
+    // the timer does not keep statistics on its first iteration: the number of measured steps is
+    // the number of iterations of the top-level entry
+    double nbSteps = 1.0;
+    for (const auto& [id, data] : steps)
+    {
+        if (data.level == 0)
+        {
+            nbSteps = std::max(nbSteps, static_cast<double>(data.numIt));
+        }
+    }
+
+    // several steps may share the same label (e.g. one per object): merge them
+    std::map<std::string, double> phases;
+    for (const auto& [id, data] : steps)
+    {
+        if (data.level != 1 || data.label.empty())
+            continue;
+        phases[data.label] += static_cast<double>(data.ttotal) * ticksToMs / nbSteps;
+    }
+
+    for (const auto& [label, ms] : phases)
+    {
+        std::string name = label;
+        std::replace(name.begin(), name.end(), ' ', '_');
+        state.counters[name + "_ms"] = ms;
+    }
+}
+
+void runAnimationLoop(::benchmark::State& state, simulation::Node* root, std::size_t baselineResidentSetSize)
+{
+    const SReal dt = root->getDt();
+    setupTimer();
+
+    for (auto _ : state)
+    {
+        AdvancedTimer::begin(timerName);
+        simulation::node::animate(root, dt);
+        AdvancedTimer::end(timerName);
+    }
+
+    state.counters["steps_per_second"] = ::benchmark::Counter(
+        static_cast<double>(state.iterations()), ::benchmark::Counter::kIsRate);
+    setPhaseCounters(state);
+    const std::size_t residentSetSize = getCurrentResidentSetSize();
+    state.counters["rss_MB"] = residentSetSize > baselineResidentSetSize ?
+        static_cast<double>(residentSetSize - baselineResidentSetSize) / (1024.0 * 1024.0) : 0.0;
+    state.counters["peak_rss_process_MB"] = static_cast<double>(getPeakResidentSetSize()) / (1024.0 * 1024.0);
+
+    AdvancedTimer::setEnabled(timerName, false);
+    AdvancedTimer::clear();
+}
+
+} // anonymous namespace
+
+void runSceneBenchmark(::benchmark::State& state, const SceneCreator& createScene, unsigned int nbThreads)
+{
+    initTaskScheduler(nbThreads);
+    const std::size_t baselineResidentSetSize = getCurrentResidentSetSize();
+
+    const simulation::NodeSPtr root = createScene();
+    if (!root)
+    {
+        state.SkipWithError("Failed to create the scene");
+        return;
+    }
+    simulation::node::initRoot(root.get());
+
+    runAnimationLoop(state, root.get(), baselineResidentSetSize);
+
+    simulation::node::unload(root);
+}
+
+void runSceneFileBenchmark(::benchmark::State& state, const std::string& filename, unsigned int nbThreads)
+{
+    initTaskScheduler(nbThreads);
+    const std::size_t baselineResidentSetSize = getCurrentResidentSetSize();
+
+    std::string path = filename;
+    if (!sofa::helper::system::DataRepository.findFile(path))
+    {
+        state.SkipWithError(("Cannot find the scene file " + filename).c_str());
+        return;
+    }
+
+    const simulation::NodeSPtr root = simulation::node::load(path);
+    if (!root)
+    {
+        state.SkipWithError(("Failed to load the scene file " + path).c_str());
+        return;
+    }
+    simulation::node::initRoot(root.get());
+
+    runAnimationLoop(state, root.get(), baselineResidentSetSize);
+
+    simulation::node::unload(root);
+}
+
+std::size_t getPeakResidentSetSize()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<std::size_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss); // bytes
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+std::size_t getCurrentResidentSetSize()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<std::size_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(info.resident_size);
+#else
+    // second field of statm: number of resident pages
+    std::ifstream statm("/proc/self/statm");
+    std::size_t size = 0;
+    std::size_t resident = 0;
+    if (!(statm >> size >> resident))
+    {
+        return 0;
+    }
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // namespace sofa::benchmark
@@ -0,0 +1,63 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/fwd.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace sofa::benchmark
+{
+
+using SceneCreator = std::function<simulation::NodeSPtr()>;
+
+/**
+ * Benchmarks the time steps of the scene returned by @createScene.
+ *
+ * The loop mirrors the one of the BatchGUI: each iteration of the benchmark is one call to
+ * animate, enclosed in the "Animate" AdvancedTimer. The scene creation and its initialization are
+ * not measured. The following counters are reported:
+ * - steps_per_second: number of time steps per second of wall-clock time
+ * - <phase>_ms: mean duration (per time step) of each top-level phase measured by the AdvancedTimer
+ * - rss_MB: growth of the resident set size of the process during the benchmark, from the creation
+ *   of the scene to the last time step
+ * - peak_rss_process_MB: peak resident set size of the process since its start. It is cumulative
+ *   over all the benchmarks run before this one.
+ *
+ * The task scheduler is initialized on @nbThreads threads (0 for the number of cores).
+ */
+void runSceneBenchmark(::benchmark::State& state, const SceneCreator& createScene, unsigned int nbThreads);
+
+/// Same as @runSceneBenchmark on a scene file loaded as runSofa would load it
+void runSceneFileBenchmark(::benchmark::State& state, const std::string& filename, unsigned int nbThreads);
+
+/// Peak resident set size of the process since its start, in bytes. Returns 0 if it is not available on the platform.
+std::size_t getPeakResidentSetSize();
+
+/// Current resident set size of the process, in bytes. Returns 0 if it is not available on the platform.
+std::size_t getCurrentResidentSetSize();
+
+} // namespace sofa::benchmark